@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "block_cache.h"
+
+#include <algorithm>
+
+#include "opcodes.h"
+
+// Returns the last address of the cacheable memory region the given address is located in.
+static u16 GetRegionEnd(u16 adr) {
+  if (adr <= 0x3FFF)
+    return 0x3FFF;
+  if (adr <= 0x7FFF)
+    return 0x7FFF;
+  if (0xC000 <= adr && adr <= 0xDFFF)
+    return 0xDFFF;
+  return 0xFFFE;
+}
+
+bool BlockCache::IsCacheable(u16 adr) {
+  return (adr <= 0x7FFF) || (0xC000 <= adr && adr <= 0xDFFF) || (0xFF80 <= adr && adr <= 0xFFFE);
+}
+
+u8 BlockCache::GetInstrLength(u8 opcode) {
+  return kOpcodes[opcode].length;
+}
+
+bool BlockCache::EndsBlock(u8 opcode) {
+  switch (opcode) {
+  case 0x10:  // STOP
+  case 0x18:  // JR i8
+  case 0x20:  // JR NZ,i8
+  case 0x28:  // JR Z,i8
+  case 0x30:  // JR NC,i8
+  case 0x38:  // JR C,i8
+  case 0x76:  // HALT
+  case 0xC0:  // RET NZ
+  case 0xC2:  // JP NZ,u16
+  case 0xC3:  // JP u16
+  case 0xC4:  // CALL NZ,u16
+  case 0xC7:  // RST 00h
+  case 0xC8:  // RET Z
+  case 0xC9:  // RET
+  case 0xCA:  // JP Z,u16
+  case 0xCC:  // CALL Z,u16
+  case 0xCD:  // CALL u16
+  case 0xCF:  // RST 08h
+  case 0xD0:  // RET NC
+  case 0xD2:  // JP NC,u16
+  case 0xD3:  // Semihosting
+  case 0xD4:  // CALL NC,u16
+  case 0xD7:  // RST 10h
+  case 0xD8:  // RET C
+  case 0xD9:  // RETI
+  case 0xDA:  // JP C,u16
+  case 0xDB:  // Undefined
+  case 0xDC:  // CALL C,u16
+  case 0xDD:  // Undefined
+  case 0xDF:  // RST 18h
+  case 0xE3:  // Undefined
+  case 0xE4:  // Undefined
+  case 0xE7:  // RST 20h
+  case 0xE9:  // JP HL
+  case 0xEB:  // Undefined
+  case 0xEC:  // Undefined
+  case 0xED:  // Undefined
+  case 0xEF:  // RST 28h
+  case 0xF4:  // Undefined
+  case 0xF7:  // RST 30h
+  case 0xFB:  // EI
+  case 0xFC:  // Undefined
+  case 0xFD:  // Undefined
+  case 0xFF:  // RST 38h
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Registers and flags read or written by an instruction of an idle loop.
+// The bit indices of the 8-bit registers match the register encoding of the opcodes.
+enum LoopDep : u16 {
+  kDepB = 1 << 0,
+  kDepC = 1 << 1,
+  kDepD = 1 << 2,
+  kDepE = 1 << 3,
+  kDepH = 1 << 4,
+  kDepL = 1 << 5,
+  kDepA = 1 << 7,
+  kDepFlagZ = 1 << 8,
+  kDepFlagN = 1 << 9,
+  kDepFlagH = 1 << 10,
+  kDepFlagC = 1 << 11,
+  kDepFlags = kDepFlagZ | kDepFlagN | kDepFlagH | kDepFlagC,
+};
+
+struct LoopInstr {
+  u16 reads;
+  u16 writes;
+};
+
+// Register operand of an opcode. Index 6 is (HL).
+static u16 GetRegDep(uint reg_ind) {
+  return (reg_ind == 6) ? (kDepH | kDepL) : static_cast<u16>(1u << reg_ind);
+}
+
+// ALU operations with A: ADD, ADC, SUB, SBC, AND, XOR, OR, CP.
+static LoopInstr DescribeAlu(uint alu_op, u16 operand) {
+  const bool with_carry = (alu_op == 1) || (alu_op == 3);
+  const bool is_cp = (alu_op == 7);
+  return {static_cast<u16>(kDepA | operand | (with_carry ? kDepFlagC : 0)),
+          static_cast<u16>(kDepFlags | (is_cp ? 0 : kDepA))};
+}
+
+// Describes an instruction that may be part of an idle loop, i.e., one that only reads memory and
+// modifies registers. Returns false for all other instructions.
+static bool DescribeLoopInstr(const BlockCache::DecodedInstr& instr, LoopInstr* info) {
+  const u8 op = instr.bytes[0];
+  if (op == 0x00) {  // NOP
+    *info = {0, 0};
+  } else if (op == 0x0A || op == 0x1A) {  // LD A,(BC); LD A,(DE)
+    *info = {static_cast<u16>(op == 0x0A ? (kDepB | kDepC) : (kDepD | kDepE)), kDepA};
+  } else if ((op & 0xC7) == 0x06 && op != 0x36) {  // LD reg,u8
+    *info = {0, GetRegDep(op >> 3)};
+  } else if (0x40 <= op && op <= 0x7F && (op & 0xF8) != 0x70) {  // LD reg,reg; LD reg,(HL)
+    *info = {GetRegDep(op & 7), GetRegDep((op >> 3) & 7)};
+  } else if (0x80 <= op && op <= 0xBF) {  // ALU A,reg; ALU A,(HL)
+    *info = DescribeAlu((op >> 3) & 7, GetRegDep(op & 7));
+  } else if ((op & 0xC7) == 0xC6) {  // ALU A,u8
+    *info = DescribeAlu((op >> 3) & 7, 0);
+  } else if (op == 0xF0) {  // LDH A,(u8)
+    *info = {0, kDepA};
+  } else if (op == 0xF2) {  // LD A,(C)
+    *info = {kDepC, kDepA};
+  } else if (op == 0xFA) {  // LD A,(u16)
+    *info = {0, kDepA};
+  } else if (op == 0xCB && 0x40 <= instr.bytes[1] && instr.bytes[1] <= 0x7F) {  // BIT n,reg; BIT n,(HL)
+    const uint reg_ind = instr.bytes[1] & 7;
+    *info = {GetRegDep(reg_ind), kDepFlagZ | kDepFlagN | kDepFlagH};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Describes a jump that may close an idle loop. Returns false for all other instructions.
+static bool DescribeLoopBranch(const BlockCache::DecodedInstr& instr, u16* target, LoopInstr* info) {
+  const u8 op = instr.bytes[0];
+  const u16 imm16 = instr.bytes[1] | (instr.bytes[2] << 8);
+  const u16 rel_target = static_cast<u16>(instr.adr + 2 + static_cast<i8>(instr.bytes[1]));
+  const u16 cond = (op & 0x10) ? kDepFlagC : kDepFlagZ;
+  switch (op) {
+  case 0x18:  // JR i8
+    *target = rel_target;
+    *info = {0, 0};
+    return true;
+  case 0x20:  // JR NZ,i8
+  case 0x28:  // JR Z,i8
+  case 0x30:  // JR NC,i8
+  case 0x38:  // JR C,i8
+    *target = rel_target;
+    *info = {cond, 0};
+    return true;
+  case 0xC3:  // JP u16
+    *target = imm16;
+    *info = {0, 0};
+    return true;
+  case 0xC2:  // JP NZ,u16
+  case 0xCA:  // JP Z,u16
+  case 0xD2:  // JP NC,u16
+  case 0xDA:  // JP C,u16
+    *target = imm16;
+    *info = {cond, 0};
+    return true;
+  default:
+    return false;
+  }
+}
+
+u32 BlockCache::GetIdleLoopCycles(const Block& block) {
+  std::array<LoopInstr, kMaxBlockInstrs> infos;
+  const size_t num_instrs = block.instrs.size();
+  u16 target;
+  if (!DescribeLoopBranch(block.instrs.back(), &target, &infos[num_instrs - 1]) || target != block.start_adr)
+    return 0;
+
+  u16 all_writes = 0;
+  u32 cycles = block.instrs.back().info->cycles_taken;
+  for (size_t i = 0; i < num_instrs - 1; ++i) {
+    if (!DescribeLoopInstr(block.instrs[i], &infos[i]))
+      return 0;
+    all_writes |= infos[i].writes;
+    cycles += block.instrs[i].info->cycles;
+  }
+
+  // A register that is modified by the loop must not carry a value from one iteration into the next.
+  u16 written = 0;
+  for (size_t i = 0; i < num_instrs; ++i) {
+    if (infos[i].reads & all_writes & ~written)
+      return 0;
+    written |= infos[i].writes;
+  }
+  return cycles;
+}
+
+BlockCache::Block* BlockCache::Find(u16 adr, u16 bank) const {
+  auto it = blocks_.find(MakeKey(adr, bank));
+  return (it == blocks_.end()) ? nullptr : it->second.get();
+}
+
+BlockCache::Block* BlockCache::Build(u16 adr, u16 bank, const std::function<u8(u16)>& read_byte) {
+  assert(IsCacheable(adr));
+  const u16 region_end = GetRegionEnd(adr);
+  auto block = std::make_unique<Block>();
+  block->start_adr = adr;
+  block->bank = bank;
+
+  uint cur_adr = adr;
+  while (block->instrs.size() < kMaxBlockInstrs) {
+    DecodedInstr instr{static_cast<u16>(cur_adr), 0, {0, 0, 0}};
+    instr.bytes[0] = read_byte(static_cast<u16>(cur_adr));
+    instr.length = GetInstrLength(instr.bytes[0]);
+    if (cur_adr + instr.length - 1 > region_end)
+      break;
+    for (uint i = 1; i < instr.length; ++i)
+      instr.bytes[i] = read_byte(static_cast<u16>(cur_adr + i));
+    instr.info = &GetOpcodeInfo(instr.bytes);
+    instr.handler = GetOpcodeIndex(*instr.info);
+    block->instrs.push_back(instr);
+    cur_adr += instr.length;
+    if (EndsBlock(instr.bytes[0]) || cur_adr > region_end)
+      break;
+  }
+
+  if (block->instrs.empty())
+    return nullptr;
+
+  block->end_adr = static_cast<u16>(cur_adr - 1);
+  block->idle_loop_cycles = GetIdleLoopCycles(*block);
+  const u32 key = MakeKey(adr, bank);
+  for (uint page = block->start_adr >> 8; page <= (block->end_adr >> 8u); ++page) {
+    page_keys_[page].push_back(key);
+    UpdateCodePage(page);
+  }
+
+  Block* result = block.get();
+  blocks_[key] = std::move(block);
+  return result;
+}
+
+bool BlockCache::Invalidate(u16 from, u16 to) {
+  bool removed = false;
+  for (uint page = from >> 8; page <= (to >> 8u); ++page) {
+    const std::vector<u32> keys = page_keys_[page];
+    for (u32 key : keys) {
+      auto it = blocks_.find(key);
+      if (it == blocks_.end())
+        continue;
+      const Block& block = *it->second;
+      if (block.end_adr < from || block.start_adr > to)
+        continue;
+
+      for (uint p = block.start_adr >> 8; p <= (block.end_adr >> 8u); ++p) {
+        std::erase(page_keys_[p], key);
+        UpdateCodePage(p);
+      }
+      blocks_.erase(it);
+      removed = true;
+    }
+  }
+  return removed;
+}
+
+void BlockCache::Clear() {
+  blocks_.clear();
+  for (auto& keys : page_keys_)
+    keys.clear();
+  code_pages_.fill(0);
+}
+
+void BlockCache::UpdateCodePage(uint page) {
+  const u8 has_code = !page_keys_[page].empty();
+  code_pages_[page] = has_code;
+  if (0xC0 <= page && page <= 0xDD)  // Echo RAM.
+    code_pages_[page + 0x20] = has_code;
+}
+
+size_t BlockCache::Size() const {
+  return blocks_.size();
+}
@@ -0,0 +1,100 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Cache of pre-decoded basic blocks for the CPU.
+ * A block is a straight sequence of instructions that ends with a control flow
+ * instruction (jumps, calls, returns, ...) or when reaching the end of a memory region.
+ * Blocks are keyed by their start address and the ROM bank they were decoded from,
+ * so that code of different banks at 0x4000-0x7FFF doesn't collide.
+ * Only code in ROM, WRAM, and HRAM is cached. Writes into RAM must be reported via
+ * InvalidateWrite(), so that self-modifying code works. Writes can't change the ROM,
+ * changes of its mapping (bank switches, boot ROM unmapping) are reported via Invalidate().
+ ******************************************************************************/
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "opcodes.h"
+
+struct JitContext;
+
+class BlockCache {
+ public:
+  struct DecodedInstr {
+    u16 adr;      // Address of the opcode.
+    u8 length;    // Length of the instruction in bytes.
+    u8 bytes[3];  // Opcode followed by the operands.
+    // Index of the interpreter's handler and of info in kOpcodeTable (0x100-0x1FF for CB-prefixed opcodes).
+    u16 handler = 0;
+    const OpcodeInfo* info = nullptr;  // Cycles, ...
+  };
+
+  struct Block {
+    u16 start_adr;
+    u16 end_adr;  // Address of the last byte of the last instruction.
+    u16 bank;
+    std::vector<DecodedInstr> instrs;
+
+    // Translated code of the block, see Jit.
+    u32 exec_count = 0;
+    bool translation_failed = false;
+    u32 (*native_code)(JitContext* ctx) = nullptr;
+    u32 native_max_cycles = 0;
+
+    // Clock cycles of one iteration if the block is an idle loop, 0 otherwise.
+    // An idle loop jumps back to its own start and doesn't have any side effects. Every register it reads
+    // is either constant during the loop or written before in the same iteration. Hence, all iterations
+    // behave the same until some other module changes the memory the loop reads (LY, STAT, IF, ...).
+    u32 idle_loop_cycles = 0;
+  };
+
+  // Maximum number of instructions per block.
+  static constexpr size_t kMaxBlockInstrs = 64;
+
+  // Returns true if code at the given address can be cached.
+  static bool IsCacheable(u16 adr);
+  // Returns true if the given address is in the switchable ROM bank.
+  static bool IsBankSwitched(u16 adr) { return (0x4000 <= adr) && (adr <= 0x7FFF); }
+  // Returns the length of an instruction in bytes, including the 0xCB prefix.
+  static u8 GetInstrLength(u8 opcode);
+  // Returns true if the given opcode ends a block.
+  static bool EndsBlock(u8 opcode);
+  // Returns the clock cycles of one iteration if the block is an idle loop, 0 otherwise.
+  static u32 GetIdleLoopCycles(const Block& block);
+
+  // Returns the block starting at the given address or nullptr if there is none.
+  Block* Find(u16 adr, u16 bank) const;
+  // Decodes a new block starting at the given address.
+  // Returns nullptr if not even one instruction fits into the memory region.
+  Block* Build(u16 adr, u16 bank, const std::function<u8(u16)>& read_byte);
+  // Removes all blocks that overlap with [from, to] regardless of their bank.
+  // Returns true if at least one block was removed.
+  bool Invalidate(u16 from, u16 to);
+  // Has to be called for every write into memory. Returns true if a block was removed.
+  bool InvalidateWrite(u16 adr) {
+    adr = (0xE000 <= adr && adr <= 0xFDFF) ? adr - 0x2000 : adr;  // Echo RAM.
+    if (adr <= 0x7FFF || page_keys_[adr >> 8].empty())
+      return false;
+    return Invalidate(adr, adr);
+  }
+  void Clear();
+  size_t Size() const;
+  // Non-zero for each 256 byte page that has cached code, including the echo RAM pages of cached WRAM code.
+  // Writes into the other pages can't change cached code and don't need to call InvalidateWrite().
+  const u8* GetCodePages() const { return code_pages_.data(); }
+
+ private:
+  static u32 MakeKey(u16 adr, u16 bank) { return (static_cast<u32>(bank) << 16) | adr; }
+  void UpdateCodePage(uint page);
+
+  std::unordered_map<u32, std::unique_ptr<Block>> blocks_;
+  // Keys of all blocks that have code in the respective 256 byte page.
+  std::array<std::vector<u32>, 256> page_keys_;
+  std::array<u8, 256> code_pages_{};
+};
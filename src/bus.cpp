@@ -5,7 +5,16 @@
 
 #include "bus.h"
 
-Bus::Bus(sc_module_name name) : sc_module(name) {
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+Bus::Bus(sc_module_name name) : sc_module(name), unmapped_socket_("unmapped_socket"), fine_table_(1) {
+  unmapped_socket_.register_b_transport(this, &Bus::UnmappedTransport);
+  unmapped_socket_.register_transport_dbg(this, &Bus::UnmappedTransportDbg);
+  unmapped_socket_.register_get_direct_mem_ptr(this, &Bus::UnmappedGetDirectMemPtr);
+  ConnectSlave(&unmapped_socket_, 0x0000, 0xFFFF, true);  // Index kUnmapped. All pages start with row 0.
 }
 
 void Bus::AddBusMaster(tlm::tlm_initiator_socket<gb_const::kBusDataWidth>* init_sock) {
@@ -20,52 +29,140 @@ void Bus::AddBusMaster(tlm::tlm_initiator_socket<gb_const::kBusDataWidth>* init_
   bus_master_vec_.push_back(targ_sock);
 }
 
-void Bus::AddBusSlave(tlm::tlm_target_socket<gb_const::kBusDataWidth>* targ_sock, u16 addr_from, u16 addr_to) {
+void Bus::AddBusSlave(tlm::tlm_target_socket<gb_const::kBusDataWidth>* targ_sock, u16 addr_from, u16 addr_to,
+                      bool bursts) {
+  if (addr_from > addr_to)
+    throw std::runtime_error(std::format("Empty bus range 0x{:04x}-0x{:04x} for '{}'", addr_from, addr_to,
+                                         targ_sock->basename()));
+  if (bus_slave_vec_.size() > std::numeric_limits<u8>::max())
+    throw std::runtime_error("Too many bus slaves");
+  for (u32 adr = addr_from; adr <= addr_to; ++adr) {
+    const BusSlave& other = DecodeSlave(adr);
+    if (&other != &bus_slave_vec_[kUnmapped]) {
+      throw std::runtime_error(
+          std::format("Bus range 0x{:04x}-0x{:04x} of '{}' overlaps with 0x{:04x}-0x{:04x} of '{}'", addr_from,
+                      addr_to, targ_sock->basename(), other.addr_from, other.addr_to, other.socket->basename()));
+    }
+  }
+
+  const u8 ind = static_cast<u8>(bus_slave_vec_.size());
+  ConnectSlave(targ_sock, addr_from, addr_to, bursts);
+
+  for (size_t page = addr_from / kPageSize; page <= addr_to / kPageSize; ++page) {
+    FineRow row = fine_table_[page_table_[page]];
+    const u32 page_start = page * kPageSize;
+    for (u32 adr = std::max<u32>(addr_from, page_start); adr <= std::min<u32>(addr_to, page_start + kPageSize - 1);
+         ++adr) {
+      row[adr % kPageSize] = ind;
+    }
+    // Reuse an identical row, so pages of the same slave share one.
+    auto it = std::find(fine_table_.begin(), fine_table_.end(), row);
+    if (it == fine_table_.end()) {
+      if (fine_table_.size() > std::numeric_limits<u8>::max())
+        throw std::runtime_error("Too many split pages on the bus");
+      it = fine_table_.insert(it, row);
+    }
+    page_table_[page] = static_cast<u8>(it - fine_table_.begin());
+  }
+}
+
+void Bus::ConnectSlave(tlm::tlm_target_socket<gb_const::kBusDataWidth>* targ_sock, u16 addr_from, u16 addr_to,
+                       bool bursts) {
   string name = string(targ_sock->basename()) + "_bus_slave_socket_" + std::to_string(bus_slave_vec_.size());
-  auto init_sock = std::make_shared<tlm_utils::simple_initiator_socket<Bus, gb_const::kBusDataWidth>>(name.c_str());
+  auto init_sock =
+      std::make_shared<tlm_utils::simple_initiator_socket_tagged<Bus, gb_const::kBusDataWidth>>(name.c_str());
 
+  init_sock->register_invalidate_direct_mem_ptr(this, &Bus::invalidate_direct_mem_ptr,
+                                                static_cast<int>(bus_slave_vec_.size()));
   init_sock->bind(*targ_sock);
 
-  bus_slave_vec_.push_back(BusSlave{addr_from, addr_to, init_sock});
+  bus_slave_vec_.push_back(BusSlave{addr_from, addr_to, bursts, init_sock});
+}
+
+template <typename Func>
+uint Bus::TransportBurst(tlm::tlm_generic_payload& trans, Func forward) {
+  if (trans.get_address() + trans.get_data_length() > 0x10000) {
+    trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+    return 0;
+  }
+
+  auto same_slave_size = [this](sc_dt::uint64 adr) {
+    const BusSlave* slave = &DecodeSlave(adr);
+    uint size = 1;
+    while (adr + size <= 0xFFFF && &DecodeSlave(adr + size) == slave)
+      ++size;
+    return size;
+  };
+  return SplitBurst(trans, same_slave_size, [&](tlm::tlm_generic_payload& part) {
+    const u16 adr = static_cast<u16>(part.get_address());
+    const BusSlave& slave = DecodeSlave(adr);
+    part.set_address(adr - slave.addr_from);
+    if (slave.bursts)
+      forward(part, slave);
+    else
+      SplitBurst(part, [](sc_dt::uint64) { return 1u; }, [&](tlm::tlm_generic_payload& byte) { forward(byte, slave); });
+  });
 }
 
 void Bus::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+  if (trans.get_data_length() > 1) [[unlikely]] {
+    TransportBurst(trans, [&](tlm::tlm_generic_payload& part, const BusSlave& slave) {
+      (*slave.socket)->b_transport(part, delay);
+    });
+    return;
+  }
+
   const u16 adr = static_cast<u16>(trans.get_address());
+  const BusSlave& slave = DecodeSlave(adr);
+  trans.set_address(adr - slave.addr_from);
+  (*slave.socket)->b_transport(trans, delay);
+}
 
-  for (const auto& slave : bus_slave_vec_) {
-    if ((slave.addr_from <= adr) && (adr <= slave.addr_to)) {
-      trans.set_address(adr - slave.addr_from);
-      (*slave.socket)->b_transport(trans, delay);
-      return;
-    }
+uint Bus::transport_dbg(tlm::tlm_generic_payload& trans) {
+  if (trans.get_data_length() > 1) {
+    return TransportBurst(trans, [](tlm::tlm_generic_payload& part, const BusSlave& slave) {
+      (*slave.socket)->transport_dbg(part);
+    });
   }
 
-  trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+  const u16 adr = static_cast<u16>(trans.get_address());
+  const BusSlave& slave = DecodeSlave(adr);
+  trans.set_address(adr - slave.addr_from);
+  return (*slave.socket)->transport_dbg(trans);
 }
 
-uint Bus::transport_dbg(tlm::tlm_generic_payload& trans) {
+bool Bus::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
   const u16 adr = static_cast<u16>(trans.get_address());
+  const BusSlave& slave = DecodeSlave(adr);
+  trans.set_address(adr - slave.addr_from);
+  if (!(*slave.socket)->get_direct_mem_ptr(trans, dmi_data))
+    return false;
+  // The slave's memory may be larger than its bus range. Never grant beyond the range.
+  dmi_data.set_end_address(std::min<sc_dt::uint64>(dmi_data.get_end_address(), slave.addr_to - slave.addr_from));
+  return true;
+}
 
-  for (const auto& slave : bus_slave_vec_) {
-    if ((slave.addr_from <= adr) && (adr <= slave.addr_to)) {
-      trans.set_address(adr - slave.addr_from);
-      return (*slave.socket)->transport_dbg(trans);
-    }
-  }
+void Bus::UnmappedTransport(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
+  trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+}
 
+uint Bus::UnmappedTransportDbg(tlm::tlm_generic_payload& trans) {
   trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
   return 0;
 }
 
-bool Bus::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
-  const u16 adr = static_cast<u16>(trans.get_address());
+bool Bus::UnmappedGetDirectMemPtr(tlm::tlm_generic_payload& trans [[maybe_unused]],
+                                  tlm::tlm_dmi& dmi_data [[maybe_unused]]) {
+  return false;
+}
 
-  for (const auto& slave : bus_slave_vec_) {
-    if (slave.addr_from <= adr && adr <= slave.addr_to) {
-      trans.set_address(adr - slave.addr_from);
-      return (*slave.socket)->get_direct_mem_ptr(trans, dmi_data);
-    }
-  }
+void Bus::invalidate_direct_mem_ptr(int id, sc_dt::uint64 start, sc_dt::uint64 end) {
+  const BusSlave& slave = bus_slave_vec_[id];
+  // Clamp before adding, so (0, ~0) doesn't wrap.
+  const sc_dt::uint64 size = slave.addr_to - slave.addr_from;
+  const sc_dt::uint64 from = std::min<sc_dt::uint64>(start, size + 1) + slave.addr_from;
+  const sc_dt::uint64 to = std::min<sc_dt::uint64>(end, size) + slave.addr_from;
 
-  return false;
+  for (auto& master : bus_master_vec_)
+    (*master)->invalidate_direct_mem_ptr(from, to);
 }
@@ -10,8 +10,19 @@
  * For example, if there is a target with a range of 0x1000-0x1FFF and
  * the initiator sends a payload to address 0x1500, the target will receive a payload
  * with address 0x0500.
+ * DMI invalidations of slaves are forwarded to all masters with absolute addresses.
+ * Slaves must not overlap. Unmapped addresses respond with TLM_ADDRESS_ERROR_RESPONSE.
+ * Bursts (data length > 1) are split at the boundaries of the slaves. Slaves that don't
+ * support bursts receive them byte by byte. A burst stops at the first erroneous part.
+ *
+ * Address decoding is a two-level table lookup without any branches:
+ * The page table maps the upper byte of an address to a row of the fine table,
+ * which holds the slave index for each lower byte. Pages that belong to a single
+ * slave share the same row, so only split pages (like 0xFF00-0xFFFF) need their own.
+ * Unmapped addresses are decoded to an internal slave that answers with an error.
  ******************************************************************************/
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -31,19 +42,48 @@ struct Bus : public sc_module {
   void operator=(Bus const&) = delete;
 
   void AddBusMaster(tlm::tlm_initiator_socket<gb_const::kBusDataWidth>* init_sock);
-  void AddBusSlave(tlm::tlm_target_socket<gb_const::kBusDataWidth>* targ_sock, u16 addr_from, u16 addr_to);
+  // Throws a std::runtime_error if the range is empty or overlaps with another slave.
+  // Set bursts if the slave handles transactions with a data length > 1.
+  void AddBusSlave(tlm::tlm_target_socket<gb_const::kBusDataWidth>* targ_sock, u16 addr_from, u16 addr_to,
+                   bool bursts = false);
 
   // SystemC Interfaces
   void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
   uint transport_dbg(tlm::tlm_generic_payload& trans);
   bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data);
+  void invalidate_direct_mem_ptr(int id, sc_dt::uint64 start, sc_dt::uint64 end);
 
  private:
+  constexpr static size_t kPageSize = 256;
+  constexpr static size_t kNumPages = 0x10000 / kPageSize;
+  constexpr static u8 kUnmapped = 0;  // Index of the internal slave for unmapped addresses.
+
   struct BusSlave {
     u16 addr_from;
     u16 addr_to;
-    std::shared_ptr<tlm_utils::simple_initiator_socket<Bus, gb_const::kBusDataWidth>> socket;
+    bool bursts;
+    std::shared_ptr<tlm_utils::simple_initiator_socket_tagged<Bus, gb_const::kBusDataWidth>> socket;
   };
+  using FineRow = std::array<u8, kPageSize>;
+
+  void ConnectSlave(tlm::tlm_target_socket<gb_const::kBusDataWidth>* targ_sock, u16 addr_from, u16 addr_to,
+                    bool bursts);
+  const BusSlave& DecodeSlave(u16 adr) const {
+    return bus_slave_vec_[fine_table_[page_table_[adr / kPageSize]][adr % kPageSize]];
+  }
+
+  // Splits a burst and calls forward(part, slave) for each part. Returns the number of transferred bytes.
+  template <typename Func>
+  uint TransportBurst(tlm::tlm_generic_payload& trans, Func forward);
+
+  // Transport functions of the internal slave for unmapped addresses.
+  void UnmappedTransport(tlm::tlm_generic_payload& trans, sc_time& delay);
+  uint UnmappedTransportDbg(tlm::tlm_generic_payload& trans);
+  bool UnmappedGetDirectMemPtr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data);
+
   std::vector<std::shared_ptr<tlm_utils::simple_target_socket<Bus, gb_const::kBusDataWidth>>> bus_master_vec_;
   std::vector<BusSlave> bus_slave_vec_;
+  tlm_utils::simple_target_socket<Bus, gb_const::kBusDataWidth> unmapped_socket_;
+  std::array<u8, kNumPages> page_table_{};  // Page -> row of fine_table_.
+  std::vector<FineRow> fine_table_;         // Row -> slave index for each address of a page.
 };
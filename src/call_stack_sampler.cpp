@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "call_stack_sampler.h"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+
+namespace {
+const std::array<const char*, 5> kInterruptNames = {"VBlank", "LCDC", "Timer", "Serial", "Joypad"};
+}  // namespace
+
+CallStackSampler::CallStackSampler(u64 sample_cycles) : sample_cycles_(std::max<u64>(sample_cycles, 1)) {
+  frames_.reserve(kMaxDepth);
+  stack_.reserve(kMaxDepth + 1);
+}
+
+void CallStackSampler::Push(u32 id, u16 sp) {
+  // A new frame at the same or a higher stack address means the frames there were left without RET.
+  Return(sp);
+  if (frames_.size() == kMaxDepth)
+    frames_.erase(frames_.begin());
+  frames_.push_back({id, sp});
+}
+
+void CallStackSampler::Call(u16 bank, u16 adr, u16 sp) {
+  Push(SymbolTable::MakeKey(bank, adr), sp);
+}
+
+void CallStackSampler::Interrupt(u16 adr, u16 sp) {
+  const u32 ind = (adr - 0x40) / 8;
+  if (adr < 0x40 || adr % 8 != 0 || ind >= kInterruptNames.size())
+    return;  // Not an interrupt vector.
+  Push(kRootId | ind, sp);
+}
+
+void CallStackSampler::Return(u16 sp) {
+  while (!frames_.empty() && frames_.back().sp <= sp)
+    frames_.pop_back();
+}
+
+// The stack starts at the innermost interrupt service routine, if there is one.
+void CallStackSampler::Sample(u64 num) {
+  size_t first = frames_.size();
+  while (first > 0 && !(frames_[first - 1].id & kRootId))
+    --first;
+  stack_.clear();
+  if (first == 0)
+    stack_.push_back(kMainId);
+  else
+    --first;
+  for (size_t i = first; i < frames_.size(); ++i)
+    stack_.push_back(frames_[i].id);
+  samples_[stack_] += num;
+  num_samples_ += num;
+}
+
+void CallStackSampler::WriteFolded(std::ostream& os, const SymbolTable& symbols) const {
+  for (const auto& [stack, num] : samples_) {
+    string line;
+    for (u32 id : stack) {
+      if (!line.empty())
+        line += ';';
+      if (id == kMainId) {
+        line += "main";
+      } else if (id & kRootId) {
+        line += kInterruptNames[id & ~kRootId];
+      } else {
+        const u16 bank = id >> 16;
+        const u16 adr = id & 0xFFFF;
+        const string name = symbols.GetName(bank, adr);
+        line += name.empty() ? std::format("{:02x}:{:04x}", bank, adr) : name;
+      }
+    }
+    os << std::format("{} {}\n", line, num);
+  }
+}
+
+void CallStackSampler::WriteFile(const std::filesystem::path& path, const SymbolTable& symbols) const {
+  std::ofstream file(path);
+  WriteFolded(file, symbols);
+  std::cout << std::format("Wrote {} call stack samples to '{}'\n", num_samples_, path.string());
+}
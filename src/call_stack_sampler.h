@@ -0,0 +1,75 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * The CallStackSampler keeps a shadow call stack of the emulated program and
+ * samples it every N emulated clock cycles. The CPU reports CALL, RST, and
+ * interrupt dispatch as calls and RET and RETI as returns.
+ * On exit, the samples are written as folded stacks, which can be turned into a
+ * flame graph: https://github.com/brendangregg/FlameGraph
+ * Interrupt service routines are roots of their own (e.g., "VBlank;01:4000 42").
+ * Everything else is below the root "main".
+ ******************************************************************************/
+
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "common.h"
+#include "symbol_table.h"
+
+class CallStackSampler {
+ public:
+  // Deeper stacks lose their outermost frames. Prevents unbounded growth if a game never returns.
+  constexpr static size_t kMaxDepth = 64;
+
+  explicit CallStackSampler(u64 sample_cycles);
+
+  // Pushes a frame for a call of the function at adr. sp points to the pushed return address.
+  // The bank only matters for addresses of the switchable ROM bank (0x4000-0x7FFF).
+  void Call(u16 bank, u16 adr, u16 sp);
+  // Pushes a root frame for the interrupt service routine at adr (0x40, 0x48, ..., 0x60).
+  void Interrupt(u16 adr, u16 sp);
+  // Pops all frames whose return address is at or below sp. Called before RET or RETI pops its
+  // return address. Also pops frames whose return address a game discarded instead of returning.
+  void Return(u16 sp);
+
+  // Advances the emulated time. Takes a sample of the current stack every sample_cycles clock cycles.
+  void AddCycles(u64 cycles) {
+    cycles_since_sample_ += cycles;
+    if (cycles_since_sample_ >= sample_cycles_) [[unlikely]] {
+      Sample(cycles_since_sample_ / sample_cycles_);
+      cycles_since_sample_ %= sample_cycles_;
+    }
+  }
+
+  size_t GetDepth() const { return frames_.size(); }
+  u64 GetNumSamples() const { return num_samples_; }
+
+  // Writes one line per sampled stack, e.g., "main;Main;01:4000 17". Frames are named by the
+  // labels of the symbol table or by bank:address if there's no label.
+  void WriteFolded(std::ostream& os, const SymbolTable& symbols) const;
+  void WriteFile(const std::filesystem::path& path, const SymbolTable& symbols) const;
+
+ private:
+  // Ids of functions are SymbolTable::MakeKey(bank, adr). Roots have the upper bit set.
+  constexpr static u32 kRootId = 0x80000000;
+  constexpr static u32 kMainId = kRootId | 0xFF;
+
+  struct Frame {
+    u32 id;
+    u16 sp;
+  };
+
+  void Push(u32 id, u16 sp);
+  void Sample(u64 num);
+
+  u64 sample_cycles_;
+  u64 cycles_since_sample_ = 0;
+  u64 num_samples_ = 0;
+  std::vector<Frame> frames_;
+  std::vector<u32> stack_;  // Ids of the sampled stack. Kept to avoid allocations.
+  std::map<std::vector<u32>, u64> samples_;
+};
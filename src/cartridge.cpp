@@ -4,7 +4,8 @@
  ******************************************************************************/
 #include "cartridge.h"
 
-#include <ctime>
+#include <algorithm>
+#include <cstring>
 #include <format>
 #include <string>
 
@@ -22,31 +23,49 @@ static void LoadBootRom(GenericMemory& mem, const std::filesystem::path& boot_pa
   }
 }
 
-Cartridge::BankSwitchedMem::BankSwitchedMem(sc_module_name name, uint num_banks, uint bank_size)
-    : GenericMemory(bank_size * num_banks, name), num_banks_(num_banks), bank_size_(bank_size) {
-  DoBankSwitch(0);
+Cartridge::BankSwitchedMem::BankSwitchedMem(sc_module_name name, uint num_banks, uint bank_size, u8* data,
+                                             uint bank_ind)
+    : GenericMemory(bank_size * num_banks, name, data),
+      current_bank_ind_(bank_ind),
+      num_banks_(num_banks),
+      bank_size_(bank_size),
+      bank_data_(data_ + bank_ind * bank_size) {
+  assert(bank_ind < num_banks);
 }
 
-void Cartridge::BankSwitchedMem::DoBankSwitch(u8 index) {
-  assert(index < num_banks_);
+// The cartridge only wires as many bank bits as it needs, so the upper bits of the index are ignored.
+// Initiators that cached the content of the previous bank (DMI, decoded code)
+// are informed via the backward path.
+void Cartridge::BankSwitchedMem::DoBankSwitch(u16 index) {
+  index %= num_banks_;
+  if (index == current_bank_ind_)
+    return;
   bank_data_ = &data_[index * bank_size_];
   current_bank_ind_ = index;
+  InvalidateDirectMemPtr(targ_socket, 0, bank_size_ - 1);
 }
 
-u8 Cartridge::BankSwitchedMem::GetCurrentBankIndex() {
+u16 Cartridge::BankSwitchedMem::GetCurrentBankIndex() {
   return current_bank_ind_;
 }
 
+void Cartridge::BankSwitchedMem::SetDataPtr(u8* data) {
+  GenericMemory::SetDataPtr(data);
+  bank_data_ = &data_[current_bank_ind_ * bank_size_];
+  InvalidateDirectMemPtr(targ_socket, 0, bank_size_ - 1);
+}
+
 void Cartridge::BankSwitchedMem::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
   u16 adr = static_cast<u16>(trans.get_address());
-  assert(adr < bank_size_);
+  const size_t length = std::max<size_t>(trans.get_data_length(), 1);
+  assert(adr + length <= bank_size_);
   tlm::tlm_command cmd = trans.get_command();
   unsigned char* ptr = trans.get_data_ptr();
   if (cmd == tlm::TLM_READ_COMMAND) {
-    *ptr = bank_data_[adr];
+    std::memcpy(ptr, &bank_data_[adr], length);
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
   } else if (cmd == tlm::TLM_WRITE_COMMAND) {
-    bank_data_[adr] = *ptr;
+    std::memcpy(&bank_data_[adr], ptr, length);
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
   } else {
     trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
@@ -56,20 +75,36 @@ void Cartridge::BankSwitchedMem::b_transport(tlm::tlm_generic_payload& trans, sc
 uint Cartridge::BankSwitchedMem::transport_dbg(tlm::tlm_generic_payload& trans) {
   sc_time delay = SC_ZERO_TIME;
   b_transport(trans, delay);
-  return 1;
+  return std::max<uint>(trans.get_data_length(), 1);
+}
+
+bool Cartridge::BankSwitchedMem::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+  u16 adr = static_cast<u16>(trans.get_address());
+  assert(adr < bank_size_);
+  dmi_data.allow_read_write();
+  dmi_data.set_start_address(0);
+  dmi_data.set_end_address(bank_size_ - 1);
+  dmi_data.set_dmi_ptr(reinterpret_cast<unsigned char*>(&bank_data_[adr]));
+  return true;
 }
 
-Cartridge::MemoryBankCtrler::MemoryBankCtrler(uint num_rom_banks, uint num_ram_banks, bool symbol_file)
-    : rom_low(0x4000, "rom_low"),
-      rom_high("rom_high", num_rom_banks, 0x4000),
+// rom_high starts with bank 1 switched in.
+Cartridge::MemoryBankCtrler::MemoryBankCtrler(const std::filesystem::path& game_path, uint num_rom_banks,
+                                              uint num_ram_banks, bool symbol_file)
+    : rom_file_(std::make_unique<MappedFile>(game_path, 0x4000 * num_rom_banks)),
+      boot_overlay_(std::make_unique<MappedFile>(game_path, 0x4000)),
+      rom_low(0x4000, "rom_low", boot_overlay_->GetData()),
+      rom_high("rom_high", num_rom_banks, 0x4000, rom_file_->GetData(), 1),
       ext_ram("ext_ram", num_ram_banks, 0x2000),
       ram_ind_(0),
       rom_ind_(0) {
-  rom_socket_in.register_b_transport(this, &MemoryBankCtrler::b_transport_rom);
-  ram_socket_in.register_b_transport(this, &MemoryBankCtrler::b_transport_ram);
   rom_socket_in.register_transport_dbg(this, &MemoryBankCtrler::transport_dbg_rom);
   ram_socket_in.register_transport_dbg(this, &MemoryBankCtrler::transport_dbg_ram);
   rom_socket_in.register_get_direct_mem_ptr(this, &MemoryBankCtrler::get_direct_mem_ptr);
+  ram_socket_in.register_get_direct_mem_ptr(this, &MemoryBankCtrler::get_direct_mem_ptr_ram);
+  rom_low_socket_out.register_invalidate_direct_mem_ptr(this, &MemoryBankCtrler::invalidate_direct_mem_ptr_rom_low);
+  rom_high_socket_out.register_invalidate_direct_mem_ptr(this, &MemoryBankCtrler::invalidate_direct_mem_ptr_rom_high);
+  ram_socket_out.register_invalidate_direct_mem_ptr(this, &MemoryBankCtrler::invalidate_direct_mem_ptr_ram);
   rom_low_socket_out.bind(rom_low.targ_socket);
   rom_high_socket_out.bind(rom_high.targ_socket);
   ram_socket_out.bind(ext_ram.targ_socket);
@@ -88,42 +123,112 @@ Cartridge::MemoryBankCtrler::~MemoryBankCtrler() {
 }
 
 // When debugging, we'll allow writes into the ROM.
+// The current ROM bank is reported, since neither b_transport nor DMI reveal it.
 uint Cartridge::MemoryBankCtrler::transport_dbg_rom(tlm::tlm_generic_payload& trans) {
-  u16 adr = static_cast<u16>(trans.get_address());
-  assert(adr < 0x8000);
-  if (adr < 0x4000) {
-    rom_low_socket_out->transport_dbg(trans);
-  } else {
-    trans.set_address(adr - 0x4000);
-    rom_high_socket_out->transport_dbg(trans);
+  auto forward = [this](tlm::tlm_generic_payload& part) {
+    u16 adr = static_cast<u16>(part.get_address());
+    assert(adr < 0x8000);
+    if (adr < 0x4000) {
+      rom_low_socket_out->transport_dbg(part);
+    } else {
+      GbCommand* gbcmd;
+      part.get_extension<GbCommand>(gbcmd);
+      if (gbcmd)
+        gbcmd->rom_bank = rom_high.GetCurrentBankIndex();
+      part.set_address(adr - 0x4000);
+      rom_high_socket_out->transport_dbg(part);
+    }
+  };
+  if (trans.get_data_length() <= 1) {
+    forward(trans);
+    return 1;
   }
-  return 1;
+  return SplitBurst(trans, [](sc_dt::uint64 adr) { return 0x4000 - adr % 0x4000; }, forward);
 }
 
 uint Cartridge::MemoryBankCtrler::transport_dbg_ram(tlm::tlm_generic_payload& trans) {
   sc_time delay = SC_ZERO_TIME;
   b_transport_ram(trans, delay);
-  return 1;
+  return std::max<uint>(trans.get_data_length(), 1);
 }
 
+// The symbol file tracer needs to see every read, so there's no DMI with it.
 bool Cartridge::MemoryBankCtrler::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
   const u16 adr = static_cast<u16>(trans.get_address());
-  if (adr >= 0x4000u || symfile_tracer_) {
+  assert(adr < 0x8000);
+  if (symfile_tracer_)
     return false;
+
+  if (adr < 0x4000) {
+    dmi_data.set_start_address(0);
+    dmi_data.set_end_address(0x3FFFu);
+    dmi_data.set_dmi_ptr(reinterpret_cast<unsigned char*>(rom_low.GetDataPtr() + adr));
+  } else {
+    trans.set_address(adr - 0x4000);
+    const bool granted = rom_high_socket_out->get_direct_mem_ptr(trans, dmi_data);
+    trans.set_address(adr);
+    if (!granted)
+      return false;
+    dmi_data.set_start_address(dmi_data.get_start_address() + 0x4000);
+    dmi_data.set_end_address(dmi_data.get_end_address() + 0x4000);
   }
+  dmi_data.allow_read();  // Writes switch banks.
+  return true;
+}
 
-  dmi_data.allow_read();
-  dmi_data.set_start_address(0);
-  dmi_data.set_end_address(0x3FFFu);
-  dmi_data.set_dmi_ptr(reinterpret_cast<unsigned char*>(rom_low.GetDataPtr() + adr));
+bool Cartridge::MemoryBankCtrler::get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans [[maybe_unused]],
+                                                         tlm::tlm_dmi& dmi_data [[maybe_unused]]) {
+  return false;
+}
+
+void Cartridge::MemoryBankCtrler::InvalidateRamDmi() {
+  if (save_file_)
+    save_file_->EndDirectAccess();
+  InvalidateDirectMemPtr(ram_socket_in, 0, 0x1FFF);
+}
+
+void Cartridge::MemoryBankCtrler::LoadSaveFile(const std::filesystem::path& game_path,
+                                               std::chrono::milliseconds flush_interval, size_t extra_size) {
+  const std::filesystem::path path = game_path.filename().string() + string(".save");
+  if (std::filesystem::exists(path))
+    std::cout << std::format("Loading save state from file '{}'", path.string());
+  else
+    std::cout << std::format("Creating new save state file '{}'", path.string());
+  save_file_ = std::make_unique<SaveFile>(path, ext_ram.GetNumBanks() * 0x2000 + extra_size, flush_interval);
+  ext_ram.SetDataPtr(save_file_->GetData());
+}
+
+bool Cartridge::MemoryBankCtrler::GetDirectMemPtrRam(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+  if (!ram_socket_out->get_direct_mem_ptr(trans, dmi_data))
+    return false;
+  if (save_file_)
+    save_file_->BeginDirectAccess(ext_ram.GetCurrentBankIndex() * 0x2000, 0x2000);
   return true;
 }
 
+void Cartridge::MemoryBankCtrler::invalidate_direct_mem_ptr_rom_low(sc_dt::uint64 start, sc_dt::uint64 end) {
+  InvalidateDirectMemPtr(rom_socket_in, start, end);
+}
+
+void Cartridge::MemoryBankCtrler::invalidate_direct_mem_ptr_rom_high(sc_dt::uint64 start, sc_dt::uint64 end) {
+  InvalidateDirectMemPtr(rom_socket_in, start + 0x4000, end + 0x4000);
+}
+
+void Cartridge::MemoryBankCtrler::invalidate_direct_mem_ptr_ram(sc_dt::uint64 start, sc_dt::uint64 end) {
+  if (save_file_)
+    save_file_->EndDirectAccess();
+  InvalidateDirectMemPtr(ram_socket_in, start, end);
+}
+
 void Cartridge::MemoryBankCtrler::UnmapBootRom() {
-  rom_low.LoadFromFile(game_path_);
+  if (!boot_overlay_)
+    return;
+  rom_low.SetDataPtr(rom_file_->GetData());
+  boot_overlay_.reset();
+  InvalidateDirectMemPtr(rom_socket_in, 0, 0x3FFF);  // The boot ROM's code is gone.
 }
 
-u8 Cartridge::MemoryBankCtrler::GetRomInd() {
+u16 Cartridge::MemoryBankCtrler::GetRomInd() {
   return rom_ind_;
 }
 
@@ -133,42 +238,15 @@ u8 Cartridge::MemoryBankCtrler::GetRamInd() {
 
 Cartridge::Rom::Rom(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbole_file,
                     bool quick_boot)
-    : MemoryBankCtrler(1, 1, symbole_file) {
+    : MemoryBankCtrler(game_path, 2, 1, symbole_file) {
   assert(game_path != "");
   game_path_ = game_path;
-  rom_low.LoadFromFile(game_path);
   LoadBootRom(rom_low, boot_path, quick_boot);
-  rom_high.LoadFromFile(game_path, 0x4000);
-}
-
-void Cartridge::Rom::b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) {
-  u16 adr = static_cast<u16>(trans.get_address());
-  tlm::tlm_command cmd = trans.get_command();
-  assert(adr < 0x8000);
-  if (cmd == tlm::TLM_WRITE_COMMAND) {
-    // Some games like Tetris try to write in the ROM...
-    trans.set_response_status(tlm::TLM_OK_RESPONSE);
-    return;
-  }
-  GbCommand* gbcmd;
-  trans.get_extension<GbCommand>(gbcmd);
-  if (adr < 0x4000) {
-    if (gbcmd && symfile_tracer_)
-      if (gbcmd->cmd == GbCommand::kGbReadData)
-        symfile_tracer_->TraceAccess(0, adr);
-    rom_low_socket_out->b_transport(trans, delay);
-  } else {
-    if (gbcmd && symfile_tracer_)
-      if (gbcmd->cmd == GbCommand::kGbReadData)
-        symfile_tracer_->TraceAccess(rom_high.GetCurrentBankIndex(), adr);
-    trans.set_address(adr - 0x4000);
-    rom_high_socket_out->b_transport(trans, delay);
-  }
 }
 
 // There's no RAM for ROM-only games.
 // Yet some games like Alleyway try to write in the non-existing RAM...
-void Cartridge::Rom::b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
+void Cartridge::Rom::AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
   assert(static_cast<u16>(trans.get_address()) < 0x8000);
 
   tlm::tlm_command cmd = trans.get_command();
@@ -178,165 +256,147 @@ void Cartridge::Rom::b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& d
     return;
   } else if (cmd == tlm::TLM_READ_COMMAND) {
     unsigned char* data = trans.get_data_ptr();
-    *data = 0;
+    std::memset(data, 0, std::max<uint>(trans.get_data_length(), 1));
     std::cout << "[WARNING] Tried to read from non-existing RAM!" << std::endl;
   }
 }
 
-Cartridge::Mbc1::Mbc1(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbol_file,
-                      bool quick_boot)
-    : MemoryBankCtrler(128, 4, symbol_file),
+Cartridge::Mbc1::Mbc1(std::filesystem::path game_path, std::filesystem::path boot_path, uint num_rom_banks,
+                      uint num_ram_banks, bool symbol_file, bool quick_boot,
+                      std::chrono::milliseconds save_flush_interval)
+    : MemoryBankCtrler(game_path, num_rom_banks, num_ram_banks, symbol_file),
       rom_bank_low_bits(0),
       the_two_bits_(0),
       more_ram_mode_(false),
       ram_enabled_(false) {
   game_path_ = game_path;
-  rom_low.LoadFromFile(game_path);
   LoadBootRom(rom_low, boot_path, quick_boot);
-  rom_high.LoadFromFile(game_path, 0x4000);
-
-  save_file = game_path.filename().string() + string(".save");
-  if (std::filesystem::exists(save_file)) {
-    std::cout << std::format("Loading save state from file '{}'", save_file.string());
-    ext_ram.LoadFromFile(save_file);
-  } else {
-    std::cout << std::format("Creating new save state file '{}'", save_file.string());
-  }
+  LoadSaveFile(game_path, save_flush_interval);
 }
 
-Cartridge::Mbc1::~Mbc1() {
-  std::cout << std::format("Writing save state to file '{}'", save_file.string());
-  ext_ram.SaveToFile(save_file);
-}
-
-void Cartridge::Mbc1::b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) {
-  tlm::tlm_command cmd = trans.get_command();
-  u16 adr = static_cast<u16>(trans.get_address());
-  u8* ptr = reinterpret_cast<u8*>(trans.get_data_ptr());
-
+void Cartridge::Mbc1::WriteRegister(u16 adr, u8 data, const sc_time& delay [[maybe_unused]]) {
   assert(adr < 0x8000);
-  if (cmd == tlm::TLM_WRITE_COMMAND) {
-    if (adr <= 0x1FFF) {
-      ram_enabled_ = (*ptr & 0xA) == 0xA;
-    } else if (adr <= 0x3FFF) {
-      rom_bank_low_bits = 0b00011111 & *ptr;
-    } else if (adr <= 0x5FFF) {
-      the_two_bits_ = *ptr & 0b00000011;
-    } else if (adr <= 0x7FFF) {
-      more_ram_mode_ = static_cast<bool>(*ptr & 0b0000001);
-    }
-    rom_ind_ = rom_bank_low_bits | (more_ram_mode_ ? 0 : (the_two_bits_ << 5));
-    if (rom_ind_ == 0 || rom_ind_ == 0x20 || rom_ind_ == 0x40 || rom_ind_ == 0x60) {
-      rom_ind_ += 1;  // It's not a bug, it's a feature!
-    }
-    ram_ind_ = more_ram_mode_ ? the_two_bits_ : 0;
-    assert(0 < rom_ind_ && rom_ind_ < 128);
-    assert(more_ram_mode_ || (!more_ram_mode_ && (ram_ind_ == 0)));  // Only one bank in 4/32 Mode.
-    rom_high.DoBankSwitch(rom_ind_ - 1);
-    ext_ram.DoBankSwitch(ram_ind_);
+  if (adr <= 0x1FFF) {
+    const bool ram_enabled = (data & 0xA) == 0xA;
+    if (ram_enabled != ram_enabled_)
+      InvalidateRamDmi();
+    if (ram_enabled_ && !ram_enabled)
+      save_file_->RequestFlush();  // Games disable the RAM right after saving.
+    ram_enabled_ = ram_enabled;
+  } else if (adr <= 0x3FFF) {
+    rom_bank_low_bits = 0b00011111 & data;
+  } else if (adr <= 0x5FFF) {
+    the_two_bits_ = data & 0b00000011;
+  } else {
+    more_ram_mode_ = static_cast<bool>(data & 0b0000001);
   }
-  if (cmd == tlm::TLM_READ_COMMAND) {
-    GbCommand* gbcmd;
-    trans.get_extension<GbCommand>(gbcmd);
-    if (adr <= 0x3FFF) {
-      if (gbcmd && symfile_tracer_)
-        if (gbcmd->cmd == GbCommand::kGbReadData)
-          symfile_tracer_->TraceAccess(0, adr);
-      rom_low_socket_out->b_transport(trans, delay);
-    } else if (adr <= 0x7FFF) {
-      if (gbcmd && symfile_tracer_)
-        if (gbcmd->cmd == GbCommand::kGbReadData)
-          symfile_tracer_->TraceAccess(rom_high.GetCurrentBankIndex(), adr);
-      trans.set_address(adr - 0x4000);
-      rom_high_socket_out->b_transport(trans, delay);
-    }
+  rom_ind_ = rom_bank_low_bits | (more_ram_mode_ ? 0 : (the_two_bits_ << 5));
+  if (rom_ind_ == 0 || rom_ind_ == 0x20 || rom_ind_ == 0x40 || rom_ind_ == 0x60) {
+    rom_ind_ += 1;  // It's not a bug, it's a feature!
   }
+  ram_ind_ = more_ram_mode_ ? the_two_bits_ : 0;
+  assert(0 < rom_ind_ && rom_ind_ < 128);
+  assert(more_ram_mode_ || (!more_ram_mode_ && (ram_ind_ == 0)));  // Only one bank in 4/32 Mode.
+  rom_high.DoBankSwitch(rom_ind_);
+  ext_ram.DoBankSwitch(ram_ind_);
 }
 
-void Cartridge::Mbc1::b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) {
+void Cartridge::Mbc1::AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
   assert(static_cast<u16>(trans.get_address()) <= 0x1FFF);
   if (ram_enabled_) {
-    ram_socket_out->b_transport(trans, delay);
+    AccessExtRam(trans);
   } else {
     std::cout << "[WARNING] Tried to write into disabled RAM!" << std::endl;
   }
 }
 
-Cartridge::Mbc3::Mbc3(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbol_file,
-                      bool quick_boot)
-    : MemoryBankCtrler(128, 4, symbol_file),
+bool Cartridge::Mbc1::get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+  return ram_enabled_ && GetDirectMemPtrRam(trans, dmi_data);
+}
+
+// A saved RTC continues where it stopped. With the host's clock, it also catches up with the time in between.
+Cartridge::Mbc3::Mbc3(std::filesystem::path game_path, std::filesystem::path boot_path, uint num_rom_banks,
+                      uint num_ram_banks, bool has_rtc, bool symbol_file, bool quick_boot,
+                      std::chrono::milliseconds save_flush_interval, RtcSource rtc_source)
+    : MemoryBankCtrler(game_path, num_rom_banks, num_ram_banks, symbol_file),
       rtc_reg_(0),
       ram_rtc_enabled_(false),
       rtc_mapped_(false),
-      rtc_halted_(false) {
+      rtc_latch_(0xFF),
+      rtc_source_(rtc_source),
+      rtc_(GetRtcTime(SC_ZERO_TIME)),
+      rtc_state_(nullptr) {
   game_path_ = game_path;
-  rom_low.LoadFromFile(game_path);
   LoadBootRom(rom_low, boot_path, quick_boot);
-  rom_high.LoadFromFile(game_path, 0x4000);
+  LoadSaveFile(game_path, save_flush_interval, has_rtc ? Rtc::kStateSize : 0);
+  if (!has_rtc)
+    return;
 
-  save_file = game_path.filename().string() + string(".save");
-  if (std::filesystem::exists(save_file)) {
-    std::cout << std::format("Loading save state from file '{}'", save_file.string());
-    ext_ram.LoadFromFile(save_file);
-  } else {
-    std::cout << std::format("Creating new save state file '{}'", save_file.string());
-  }
+  rtc_state_ = save_file_->GetData() + ext_ram.GetNumBanks() * 0x2000;
+  const std::span<const u8, Rtc::kStateSize> state(rtc_state_, Rtc::kStateSize);
+  const i64 unix_time = Rtc::GetUnixTime(state);
+  if (unix_time > 0)
+    rtc_.LoadState(state, (rtc_source_ == RtcSource::kHost) ? unix_time * 1'000'000'000 : GetRtcTime(SC_ZERO_TIME));
 }
 
 Cartridge::Mbc3::~Mbc3() {
-  std::cout << std::format("Writing save state to file '{}'", save_file.string());
-  ext_ram.SaveToFile(save_file);
+  SaveRtc(SC_ZERO_TIME);
 }
 
-void Cartridge::Mbc3::b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) {
-  tlm::tlm_command cmd = trans.get_command();
-  u16 adr = static_cast<u16>(trans.get_address());
-  u8* ptr = reinterpret_cast<u8*>(trans.get_data_ptr());
+u64 Cartridge::Mbc3::GetRtcTime(const sc_time& delay) const {
+  if (rtc_source_ == RtcSource::kHost)
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  return static_cast<u64>((sc_time_stamp() + delay) / sc_time(1, SC_NS));
+}
+
+void Cartridge::Mbc3::SaveRtc(const sc_time& delay) {
+  if (!rtc_state_)
+    return;
+  const auto unix_time = std::chrono::system_clock::now().time_since_epoch();
+  rtc_.SaveState(std::span<u8, Rtc::kStateSize>(rtc_state_, Rtc::kStateSize), GetRtcTime(delay),
+                 std::chrono::duration_cast<std::chrono::seconds>(unix_time).count());
+  save_file_->MarkDirty(rtc_state_ - save_file_->GetData(), Rtc::kStateSize);
+}
 
+void Cartridge::Mbc3::WriteRegister(u16 adr, u8 data, const sc_time& delay) {
   assert(adr < 0x8000);
-  if (cmd == tlm::TLM_WRITE_COMMAND) {
-    if (adr <= 0x1FFF) {
-      ram_rtc_enabled_ = (*ptr & 0xA) == 0xA;
-    } else if (adr <= 0x3FFF) {
-      rom_ind_ = 0b01111111 & *ptr;
-    } else if (adr <= 0x5FFF) {
-      if (*ptr < 8) {
-        ram_ind_ = *ptr;
-        rtc_mapped_ = false;
-      } else if (*ptr < 13) {
-        rtc_reg_ = *ptr - 8;
-        rtc_mapped_ = true;
-      }
-    } else if (adr <= 0x7FFF) {
-      // TODO: latch thing.
+  if (adr <= 0x1FFF) {
+    const bool ram_rtc_enabled = (data & 0xA) == 0xA;
+    if (ram_rtc_enabled != ram_rtc_enabled_)
+      InvalidateRamDmi();
+    if (ram_rtc_enabled_ && !ram_rtc_enabled) {  // Games disable the RAM right after saving.
+      SaveRtc(delay);
+      save_file_->RequestFlush();
     }
-
-    rom_ind_ = (rom_ind_ == 0) ? 1 : rom_ind_;
-
-    assert(rom_ind_ < 128);
-    rom_high.DoBankSwitch(rom_ind_ - 1);
-    ext_ram.DoBankSwitch(ram_ind_);
-  }
-
-  if (cmd == tlm::TLM_READ_COMMAND) {
-    GbCommand* gbcmd;
-    trans.get_extension<GbCommand>(gbcmd);
-    if (adr <= 0x3FFF) {
-      if (gbcmd && symfile_tracer_)
-        if (gbcmd->cmd == GbCommand::kGbReadData)
-          symfile_tracer_->TraceAccess(0, adr);
-      rom_low_socket_out->b_transport(trans, delay);
-    } else if (adr <= 0x7FFF) {
-      if (gbcmd && symfile_tracer_)
-        if (gbcmd->cmd == GbCommand::kGbReadData)
-          symfile_tracer_->TraceAccess(rom_high.GetCurrentBankIndex(), adr);
-      trans.set_address(adr - 0x4000u);
-      rom_high_socket_out->b_transport(trans, delay);
+    ram_rtc_enabled_ = ram_rtc_enabled;
+  } else if (adr <= 0x3FFF) {
+    rom_ind_ = 0b01111111 & data;
+  } else if (adr <= 0x5FFF) {
+    const bool rtc_mapped = rtc_mapped_;
+    if (data < 8) {
+      ram_ind_ = data;
+      rtc_mapped_ = false;
+    } else if (data < 13) {
+      rtc_reg_ = data - 8;
+      rtc_mapped_ = true;
     }
+    if (rtc_mapped != rtc_mapped_)
+      InvalidateRamDmi();
+  } else {
+    if (rtc_latch_ == 0 && data == 1)
+      rtc_.Latch(GetRtcTime(delay));
+    rtc_latch_ = data;
   }
+
+  rom_ind_ = (rom_ind_ == 0) ? 1 : rom_ind_;
+
+  assert(rom_ind_ < 128);
+  rom_high.DoBankSwitch(rom_ind_);
+  ext_ram.DoBankSwitch(ram_ind_);
 }
 
-void Cartridge::Mbc3::b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) {
+void Cartridge::Mbc3::AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay) {
   assert(static_cast<u16>(trans.get_address()) <= 0x1FFFu);
   if (ram_rtc_enabled_) {
     if (rtc_mapped_) {
@@ -345,93 +405,59 @@ void Cartridge::Mbc3::b_transport_ram(tlm::tlm_generic_payload& trans, sc_time&
       trans.set_response_status(tlm::TLM_OK_RESPONSE);
 
       if (cmd == tlm::TLM_WRITE_COMMAND) {
-        // TODO: Implement.
+        rtc_.Write(rtc_reg_, *ptr, GetRtcTime(delay));
         return;
       }
-
-      const time_t t = std::time(nullptr);
-      const time_t secs = t % 60;
-      const time_t minutes = (t / 60) % 60;
-      const time_t hours = (t / (60 * 60)) % 60;
-      const time_t days = (t / (60 * 60 * 24)) % 512;
-      time_t val;
-
-      switch (rtc_reg_) {
-      case 0:
-        val = secs;
-        break;
-      case 1:
-        val = minutes;
-        break;
-      case 2:
-        val = hours;
-        break;
-      case 3:
-        val = days % 256;
-        break;
-      case 4:
-        val = (days >> 8) | ((uint)rtc_halted_ << 6);
-        break;
-      default:
-        val = 0;
-      }
-      *ptr = (u8)val;
+      std::memset(ptr, rtc_.Read(rtc_reg_), std::max<uint>(trans.get_data_length(), 1));  // RTC is mirrored.
     } else {
-      ram_socket_out->b_transport(trans, delay);
+      AccessExtRam(trans);
     }
   } else {
     std::cout << "[WARNING] Tried to write into disabled RAM/RTC!" << std::endl;
   }
 }
 
-Cartridge::Mbc5::Mbc5(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbol_file,
-                      bool quick_boot)
-    : MemoryBankCtrler(512, 16, symbol_file),
+// The RTC registers need the transport functions.
+bool Cartridge::Mbc3::get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+  return ram_rtc_enabled_ && !rtc_mapped_ && GetDirectMemPtrRam(trans, dmi_data);
+}
+
+Cartridge::Mbc5::Mbc5(std::filesystem::path game_path, std::filesystem::path boot_path, uint num_rom_banks,
+                      uint num_ram_banks, bool symbol_file, bool quick_boot)
+    : MemoryBankCtrler(game_path, num_rom_banks, num_ram_banks, symbol_file),
       ram_bits_(0),
-      rom_bank_low_bits_(0),
+      rom_bank_low_bits_(1),
       rom_bank_high_bits_(0),
       ram_enabled_(false) {
   game_path_ = game_path;
-  rom_low.LoadFromFile(game_path);
+  rom_ind_ = 1;  // Like rom_high, the bank register starts with bank 1.
   LoadBootRom(rom_low, boot_path, quick_boot);
-  rom_high.LoadFromFile(game_path, 0x4000);
 }
 
-void Cartridge::Mbc5::b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) {
-  tlm::tlm_command cmd = trans.get_command();
-  u16 adr = static_cast<u16>(trans.get_address());
-  u8* ptr = reinterpret_cast<u8*>(trans.get_data_ptr());
-
+void Cartridge::Mbc5::WriteRegister(u16 adr, u8 data, const sc_time& delay [[maybe_unused]]) {
   assert(adr < 0x8000);
-  if (cmd == tlm::TLM_WRITE_COMMAND) {
-    if (adr <= 0x1FFF) {
-      ram_enabled_ = (*ptr & 0xA) == 0xA;
-    } else if (adr <= 0x2FFF) {
-      rom_bank_low_bits_ = *ptr;
-    } else if (adr <= 0x3FFF) {
-      rom_bank_high_bits_ = *ptr & 1;
-    } else if (adr <= 0x5FFF) {
-      ram_bits_ = *ptr & 0x0F;
-    }
-    ram_ind_ = ram_enabled_ ? ram_bits_ : 0;
-    rom_ind_ = (rom_bank_high_bits_ << 8) | rom_bank_low_bits_;
-    rom_high.DoBankSwitch(rom_ind_);  // TODO(niko): Bank 0
-    ext_ram.DoBankSwitch(ram_ind_);
-  }
-  if (cmd == tlm::TLM_READ_COMMAND) {
-    if (adr <= 0x3FFF) {
-      rom_low_socket_out->b_transport(trans, delay);
-    } else if (adr <= 0x7FFF) {
-      trans.set_address(adr - 0x4000);
-      rom_high_socket_out->b_transport(trans, delay);
-    }
+  if (adr <= 0x1FFF) {
+    const bool ram_enabled = (data & 0xA) == 0xA;
+    if (ram_enabled != ram_enabled_)
+      InvalidateRamDmi();
+    ram_enabled_ = ram_enabled;
+  } else if (adr <= 0x2FFF) {
+    rom_bank_low_bits_ = data;
+  } else if (adr <= 0x3FFF) {
+    rom_bank_high_bits_ = data & 1;
+  } else if (adr <= 0x5FFF) {
+    ram_bits_ = data & 0x0F;
   }
+  ram_ind_ = ram_enabled_ ? ram_bits_ : 0;
+  rom_ind_ = (rom_bank_high_bits_ << 8) | rom_bank_low_bits_;
+  rom_high.DoBankSwitch(rom_ind_);
+  ext_ram.DoBankSwitch(ram_ind_);
 }
 
-void Cartridge::Mbc5::b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) {
+void Cartridge::Mbc5::AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
   assert(static_cast<u16>(trans.get_address()) <= 0x1FFF);
   if (ram_enabled_) {
-    ram_socket_out->b_transport(trans, delay);
+    AccessExtRam(trans);
   } else {
     assert(false);
   }
@@ -441,32 +467,37 @@ uint Cartridge::Mbc5::transport_dbg_ram(tlm::tlm_generic_payload& trans) {
   assert(static_cast<u16>(trans.get_address()) <= 0x1FFF);
   sc_time delay(0, SC_NS);
   ram_socket_out->b_transport(trans, delay);
-  return 1;
+  return std::max<uint>(trans.get_data_length(), 1);
+}
+
+bool Cartridge::Mbc5::get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+  return ram_enabled_ && ram_socket_out->get_direct_mem_ptr(trans, dmi_data);
 }
 
 Cartridge::Cartridge(sc_module_name name, std::filesystem::path game_path, std::filesystem::path boot_path,
-                     bool symbol_file, bool quick_boot)
-    : sc_module(name), sig_unmap_rom_in("sig_unmap_rom_in"), game_path_(game_path), boot_path_(boot_path) {
+                     bool symbol_file, bool quick_boot, std::chrono::milliseconds save_flush_interval,
+                     RtcSource rtc_source)
+    : sc_module(name), game_path_(game_path), boot_path_(boot_path) {
   game_info = std::make_unique<GameInfo>(game_path_);
   string cr_type = game_info->GetCartridgeType();
+  // The header says 0 banks for 32 KiB ROMs. RAM banks have 8 KiB. Smaller RAMs still occupy a bank.
+  const uint num_rom_banks = std::max(game_info->GetRomSize(), 2u);
+  const uint num_ram_banks = std::max((game_info->GetRamSize() + 7) / 8, 1u);
 
   if (cr_type == "ROM ONLY")
-    mbc = std::make_unique<Rom>(game_path, boot_path, symbol_file, quick_boot);
+    mbc = MakeMbc<Rom>(symbol_file, game_path, boot_path, symbol_file, quick_boot);
   else if (cr_type == "MBC1"  // TODO(niko): finer granularity and more MBC types
            || cr_type == "MBC1+RAM" || cr_type == "MBC1+BAT+RAM")
-    mbc = std::make_unique<Mbc1>(game_path, boot_path, symbol_file, quick_boot);
+    mbc = MakeMbc<Mbc1>(symbol_file, game_path, boot_path, num_rom_banks, num_ram_banks, symbol_file, quick_boot,
+                        save_flush_interval);
   else if (cr_type == "MBC3" || cr_type == "MBC3+RAM" || cr_type == "MBC3+BAT+RAM")
-    mbc = std::make_unique<Mbc3>(game_path, boot_path, symbol_file, quick_boot);
+    mbc = MakeMbc<Mbc3>(symbol_file, game_path, boot_path, num_rom_banks, num_ram_banks, false, symbol_file,
+                        quick_boot, save_flush_interval, rtc_source);
+  else if (cr_type == "MBC3+BAT+TIM" || cr_type == "MBC3+BAT+RAM+TIM")
+    mbc = MakeMbc<Mbc3>(symbol_file, game_path, boot_path, num_rom_banks, num_ram_banks, true, symbol_file,
+                        quick_boot, save_flush_interval, rtc_source);
   else if (cr_type == "MBC5" || cr_type == "MBC5+RAM" || cr_type == "MBC5+BAT+RAM")
-    mbc = std::make_unique<Mbc5>(game_path, boot_path, symbol_file, quick_boot);
+    mbc = MakeMbc<Mbc5>(symbol_file, game_path, boot_path, num_rom_banks, num_ram_banks, symbol_file, quick_boot);
   else
     throw std::runtime_error(std::format("Cartidge type {} not implemented", cr_type));
-
-  SC_METHOD(SigHandler);
-  dont_initialize();
-  sensitive << sig_unmap_rom_in;
-}
-
-void Cartridge::SigHandler() {
-  mbc->UnmapBootRom();
 }
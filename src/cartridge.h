@@ -6,24 +6,35 @@
  * Collection of classes that are all associated to the Game Boy's cartridge.
  * See: https://gbdev.gg8.se/wiki/articles/Memory_Bank_Controllers
  ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <memory>
+#include <utility>
 
 #include "common.h"
 #include "game_info.h"
 #include "generic_memory.h"
+#include "mapped_file.h"
+#include "rtc.h"
+#include "save_file.h"
 #include "symfile_tracer.h"
 
 class Cartridge : public sc_module {
-  SC_HAS_PROCESS(Cartridge);
-
   class BankSwitchedMem : public GenericMemory {
    public:
-    BankSwitchedMem(sc_module_name name, uint num_banks, uint bank_size);
-    void DoBankSwitch(u8 index);
-    u8 GetCurrentBankIndex();
+    BankSwitchedMem(sc_module_name name, uint num_banks, uint bank_size, u8* data = nullptr, uint bank_ind = 0);
+    // Like the hardware, bank numbers beyond the number of banks wrap around.
+    void DoBankSwitch(u16 index);
+    u16 GetCurrentBankIndex();
+    uint GetNumBanks() const { return num_banks_; }
+    u8* GetBankPtr() { return bank_data_; }
+    void SetDataPtr(u8* data) override;
     void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
     uint transport_dbg(tlm::tlm_generic_payload& trans);
+    // Grants the current bank. The grant is revoked on bank switches.
+    bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) override;
 
    protected:
     uint current_bank_ind_;
@@ -33,8 +44,17 @@ class Cartridge : public sc_module {
   };
 
   class MemoryBankCtrler {
+   protected:
+    // The ROM is mapped once. rom_low and rom_high are views into the mapping.
+    // rom_high's bank indices are the bank numbers in the file, so bank 0 can be switched in, too.
+    // Until the boot ROM is unmapped, rom_low views a second mapping of bank 0 that is overlaid by the boot ROM.
+    std::unique_ptr<MappedFile> rom_file_;
+    std::unique_ptr<MappedFile> boot_overlay_;
+
    public:
-    MemoryBankCtrler(uint num_rom_banks, uint num_ram_banks, bool symbol_file);
+    // The bank counts are the ones of the cartridge header. num_rom_banks includes the fixed bank 0.
+    MemoryBankCtrler(const std::filesystem::path& game_path, uint num_rom_banks, uint num_ram_banks,
+                     bool symbol_file);
     virtual ~MemoryBankCtrler();
 
     GenericMemory rom_low;
@@ -45,67 +65,130 @@ class Cartridge : public sc_module {
     tlm_utils::simple_initiator_socket<MemoryBankCtrler, gb_const::kBusDataWidth> rom_low_socket_out;
     tlm_utils::simple_initiator_socket<MemoryBankCtrler, gb_const::kBusDataWidth> rom_high_socket_out;
     tlm_utils::simple_initiator_socket<MemoryBankCtrler, gb_const::kBusDataWidth> ram_socket_out;
+    // Both handle bursts. The sockets are bound to the non-virtual functions of Mbc<Ctrler, kTrace>.
     virtual void b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) = 0;
     virtual void b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) = 0;
     virtual uint transport_dbg_ram(tlm::tlm_generic_payload& trans);
     virtual uint transport_dbg_rom(tlm::tlm_generic_payload& trans);
+    // ROM is granted read-only, so writes still reach the MBC registers.
     virtual bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data);
+    // External RAM is only granted while it is enabled.
+    virtual bool get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data);
+    // Forward DMI invalidations of the memories to the bus.
+    void invalidate_direct_mem_ptr_rom_low(sc_dt::uint64 start, sc_dt::uint64 end);
+    void invalidate_direct_mem_ptr_rom_high(sc_dt::uint64 start, sc_dt::uint64 end);
+    void invalidate_direct_mem_ptr_ram(sc_dt::uint64 start, sc_dt::uint64 end);
+    // Swaps the view of rom_low to the game and revokes the DMI grants. Doesn't touch the file. Later calls do nothing.
     virtual void UnmapBootRom();
-    u8 GetRomInd();
+    u16 GetRomInd();
     u8 GetRamInd();
 
    protected:
+    // Revokes the DMI grants of the external RAM. Needed whenever it gets enabled or disabled.
+    void InvalidateRamDmi();
+    // Maps <game>.save as the battery-backed external RAM. extra_size bytes behind the RAM are left to the MBC.
+    void LoadSaveFile(const std::filesystem::path& game_path, std::chrono::milliseconds flush_interval,
+                      size_t extra_size = 0);
+    // Reads straight from the memories. Reads may cross the fixed and the switchable bank.
+    void ReadRom(u16 adr, u8* data, size_t length) {
+      if (adr < 0x4000) {
+        const size_t low_length = std::min<size_t>(length, 0x4000 - adr);
+        std::memcpy(data, rom_low.GetDataPtr() + adr, low_length);
+        adr += low_length;
+        data += low_length;
+        length -= low_length;
+      }
+      std::memcpy(data, rom_high.GetBankPtr() + (adr - 0x4000), length);
+    }
+    // Accesses the current bank of the external RAM and tracks the written pages of the save file.
+    void AccessExtRam(tlm::tlm_generic_payload& trans) {
+      const u16 adr = static_cast<u16>(trans.get_address());
+      const size_t length = std::max<size_t>(trans.get_data_length(), 1);
+      assert(adr + length <= 0x2000);
+      u8* mem = ext_ram.GetBankPtr() + adr;
+      if (trans.is_read()) {
+        std::memcpy(trans.get_data_ptr(), mem, length);
+      } else if (trans.is_write()) {
+        std::memcpy(mem, trans.get_data_ptr(), length);
+        if (save_file_)
+          save_file_->MarkDirty(ext_ram.GetCurrentBankIndex() * 0x2000 + adr, length);
+      } else {
+        trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+        return;
+      }
+      trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+    bool GetDirectMemPtrRam(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data);
+
     std::filesystem::path game_path_;
     std::unique_ptr<SymfileTracer> symfile_tracer_;
+    std::unique_ptr<SaveFile> save_file_;
     u8 ram_ind_;
-    u8 rom_ind_;
+    u16 rom_ind_;
   };
 
   class Rom : public MemoryBankCtrler {
    public:
     Rom(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbole_file, bool quick_boot = false);
-    void b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) override;
-    void b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) override;
+    // There are no registers. Yet some games like Tetris try to write in the ROM...
+    void WriteRegister(u16 adr [[maybe_unused]], u8 data [[maybe_unused]], const sc_time& delay [[maybe_unused]]) {}
+    void AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay);
   };
 
   class Mbc1 : public MemoryBankCtrler {
    public:
-    Mbc1(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbol_file, bool quick_boot = false);
-    virtual ~Mbc1() override;
+    Mbc1(std::filesystem::path game_path, std::filesystem::path boot_path, uint num_rom_banks, uint num_ram_banks,
+         bool symbol_file, bool quick_boot = false,
+         std::chrono::milliseconds save_flush_interval = std::chrono::milliseconds(1000));
 
-    void b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) override;
-    void b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) override;
+    void WriteRegister(u16 adr, u8 data, const sc_time& delay);
+    void AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay);
+    bool get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) override;
 
    private:
     u8 rom_bank_low_bits;
     u8 the_two_bits_;
     bool more_ram_mode_;
     bool ram_enabled_;
-    std::filesystem::path save_file;
   };
 
   class Mbc3 : public MemoryBankCtrler {
    public:
-    Mbc3(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbol_file, bool quick_boot = false);
+    // With has_rtc (the TIM cartridges), the state of the RTC is kept behind the RAM in the save file.
+    Mbc3(std::filesystem::path game_path, std::filesystem::path boot_path, uint num_rom_banks, uint num_ram_banks,
+         bool has_rtc, bool symbol_file, bool quick_boot = false,
+         std::chrono::milliseconds save_flush_interval = std::chrono::milliseconds(1000),
+         RtcSource rtc_source = RtcSource::kEmulated);
     virtual ~Mbc3() override;
 
-    void b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) override;
-    void b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) override;
+    void WriteRegister(u16 adr, u8 data, const sc_time& delay);
+    void AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay);
+    bool get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) override;
 
    private:
+    // Current point of the RTC's time base in ns.
+    u64 GetRtcTime(const sc_time& delay) const;
+    // Writes the state of the RTC into the save file. Only done when the RAM gets disabled and on destruction,
+    // so latching and writing the RTC don't query the host's clock for it.
+    void SaveRtc(const sc_time& delay);
+
     uint rtc_reg_;
     bool ram_rtc_enabled_;
     bool rtc_mapped_;
-    bool rtc_halted_;
-    std::filesystem::path save_file;
+    u8 rtc_latch_;
+    RtcSource rtc_source_;
+    Rtc rtc_;
+    u8* rtc_state_;  // Behind the RAM in the save file. nullptr without an RTC.
   };
 
   class Mbc5 : public MemoryBankCtrler {
    public:
-    Mbc5(std::filesystem::path game_path, std::filesystem::path boot_path, bool symbol_file, bool quick_boot = false);
-    void b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) override;
-    void b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) override;
+    Mbc5(std::filesystem::path game_path, std::filesystem::path boot_path, uint num_rom_banks, uint num_ram_banks,
+         bool symbol_file, bool quick_boot = false);
+    void WriteRegister(u16 adr, u8 data, const sc_time& delay);
+    void AccessRam(tlm::tlm_generic_payload& trans, sc_time& delay);
     uint transport_dbg_ram(tlm::tlm_generic_payload& trans) override;
+    bool get_direct_mem_ptr_ram(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) override;
 
    private:
     u16 ram_bits_;
@@ -114,15 +197,77 @@ class Cartridge : public sc_module {
     bool ram_enabled_;
   };
 
+  // The controller that is instantiated for a cartridge. Ctrler is one of the MBC types above and is chosen once
+  // from the header. The sockets are bound to non-virtual functions that call Ctrler's WriteRegister and AccessRam,
+  // so the accesses don't go through virtual calls and the memories' sockets. With kTrace, the reads of data in
+  // the ROM are traced for the symbol file. Without it, the tracing costs nothing.
+  template <typename Ctrler, bool kTrace>
+  class Mbc final : public Ctrler {
+    using TransportFunc = void (MemoryBankCtrler::*)(tlm::tlm_generic_payload&, sc_time&);
+
+   public:
+    // The arguments are the ones of Ctrler. Its symbol_file has to match kTrace.
+    template <typename... Args>
+    explicit Mbc(Args&&... args) : Ctrler(std::forward<Args>(args)...) {
+      assert(kTrace == static_cast<bool>(this->symfile_tracer_));
+      this->rom_socket_in.register_b_transport(this, static_cast<TransportFunc>(&Mbc::TransportRom));
+      this->ram_socket_in.register_b_transport(this, static_cast<TransportFunc>(&Mbc::TransportRam));
+    }
+
+    void b_transport_rom(tlm::tlm_generic_payload& trans, sc_time& delay) override { TransportRom(trans, delay); }
+    void b_transport_ram(tlm::tlm_generic_payload& trans, sc_time& delay) override { TransportRam(trans, delay); }
+
+   private:
+    // Bursts that write the MBC registers are applied byte by byte.
+    void TransportRom(tlm::tlm_generic_payload& trans, sc_time& delay) {
+      const u16 adr = static_cast<u16>(trans.get_address());
+      u8* ptr = trans.get_data_ptr();
+      const size_t length = std::max<size_t>(trans.get_data_length(), 1);
+      assert(adr + length <= 0x8000);
+      if (trans.is_read()) [[likely]] {
+        if constexpr (kTrace) {
+          // Reads without a GbCommand come from other masters, e.g., the OAM DMA, and always read data.
+          GbCommand* gbcmd;
+          trans.get_extension<GbCommand>(gbcmd);
+          if (!gbcmd || gbcmd->cmd == GbCommand::kGbReadData) {
+            const u16 bank = this->rom_high.GetCurrentBankIndex();
+            for (size_t i = 0; i < length; ++i) {
+              const u16 cur_adr = static_cast<u16>(adr + i);
+              this->symfile_tracer_->TraceAccess((cur_adr < 0x4000) ? 0 : bank, cur_adr);
+            }
+          }
+        }
+        this->ReadRom(adr, ptr, length);
+      } else if (trans.is_write()) {
+        for (size_t i = 0; i < length; ++i)
+          Ctrler::WriteRegister(static_cast<u16>(adr + i), ptr[i], delay);
+      } else {
+        trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+        return;
+      }
+      trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+
+    void TransportRam(tlm::tlm_generic_payload& trans, sc_time& delay) { Ctrler::AccessRam(trans, delay); }
+  };
+
+  // Instantiates Mbc<Ctrler, symbol_file> with args.
+  template <typename Ctrler, typename... Args>
+  static std::unique_ptr<MemoryBankCtrler> MakeMbc(bool symbol_file, Args&&... args) {
+    if (symbol_file)
+      return std::make_unique<Mbc<Ctrler, true>>(std::forward<Args>(args)...);
+    return std::make_unique<Mbc<Ctrler, false>>(std::forward<Args>(args)...);
+  }
+
  public:
   std::unique_ptr<GameInfo> game_info;  // Needed for MBC selection.
   std::unique_ptr<MemoryBankCtrler> mbc;
-  sc_in<bool> sig_unmap_rom_in;
 
+  // The battery-backed RAM is written back to the save file every save_flush_interval.
   Cartridge(sc_module_name name, std::filesystem::path game_path, std::filesystem::path boot_path,
-            bool symbol_file = false, bool quick_boot = false);
-
-  void SigHandler();
+            bool symbol_file = false, bool quick_boot = false,
+            std::chrono::milliseconds save_flush_interval = std::chrono::milliseconds(1000),
+            RtcSource rtc_source = RtcSource::kEmulated);
 
  private:
   std::filesystem::path game_path_;
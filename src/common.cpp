@@ -14,4 +14,5 @@ tlm::tlm_extension_base* GbCommand::clone() const {
 
 void GbCommand::copy_from(tlm::tlm_extension_base const& ext) {
   this->cmd = static_cast<GbCommand const&>(ext).cmd;
+  this->rom_bank = static_cast<GbCommand const&>(ext).rom_bank;
 }
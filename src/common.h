@@ -32,6 +32,8 @@ struct GbCommand : public tlm::tlm_extension<GbCommand> {
     kGbReadData,
     kGbWriteData,
   } cmd;
+  // Set by the cartridge on reads from the switchable ROM bank.
+  u16 rom_bank = 0;
 
   virtual tlm::tlm_extension_base* clone() const override;
   virtual void copy_from(tlm::tlm_extension_base const& ext) override;
@@ -5,63 +5,235 @@
 
 #include "cpu.h"
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <bitset>
+#include <cstdio>
+#include <cstring>
 #include <format>
 #include <string>
 
+#include "io_registers.h"
+
 #include "cpu_jumptable.cpp"
 #include "cpu_ops.cpp"
 
-Cpu::Cpu(sc_module_name name, bool attach_gdb, bool single_step)
-    : sc_module(name), gdb_server(this), attach_gdb_(attach_gdb), single_step_(single_step), rom_bank_0_(nullptr) {
+Cpu::Cpu(sc_module_name name, bool attach_gdb, bool single_step, bool use_jit, u32 quantum_cycles)
+    : sc_module(name),
+      gdb_server(this),
+      attach_gdb_(attach_gdb),
+      single_step_(single_step),
+      use_quantum_(quantum_cycles != 0) {
+  init_socket.register_invalidate_direct_mem_ptr(this, &Cpu::invalidate_direct_mem_ptr);
+  if (use_quantum_)
+    tlm_utils::tlm_quantumkeeper::set_global_quantum(
+        sc_time::from_value(static_cast<u64>(quantum_cycles) * gb_const::kNsPerClkCycle));
+  // Breakpoints and single stepping need to see every instruction.
+  if (use_jit && !attach_gdb && !single_step && Jit::IsSupported()) {
+    jit_ = std::make_unique<Jit>();
+    jit_ctx_.regs = reg_file.GetDataPtr();
+    jit_ctx_.ime = &intr_master_enable;
+    jit_ctx_.read_pages = dmi_read_pages_.data();
+    jit_ctx_.write_pages = dmi_write_pages_.data();
+    jit_ctx_.code_pages = block_cache_.GetCodePages();
+    jit_ctx_.opaque = this;
+    jit_ctx_.read = &Cpu::JitRead;
+    jit_ctx_.write = &Cpu::JitWrite;
+    jit_ctx_.stop = false;
+  }
   SC_THREAD(DoMachineCycle);
 }
 
 Cpu::~Cpu() {
 }
 
+void Cpu::EnableProfiler() {
+  profiler = std::make_unique<Profiler>();
+  jit_.reset();
+}
+
+void Cpu::EnableCallStackSampler(u64 sample_cycles) {
+  call_stack_sampler = std::make_unique<CallStackSampler>(sample_cycles);
+  jit_.reset();
+}
+
+void Cpu::EnableTrace(const std::filesystem::path& path, bool mem_writes) {
+  trace_writer = std::make_unique<TraceWriter>(path);
+  trace_mem_writes_ = mem_writes;
+  jit_.reset();
+}
+
+void Cpu::EnableDmaBlocking(const IoRegisters* io_registers) {
+  dma_io_registers_ = io_registers;
+  jit_.reset();
+}
+
+bool Cpu::IsBlockedByDma(u16 addr) const {
+  if (dma_io_registers_ == nullptr || addr >= 0xFF00)
+    return false;
+  return dma_io_registers_->IsDmaActive(GetLocalTime() - sc_time_stamp());
+}
+
+void Cpu::TraceInstr() {
+  UpdateFlags();
+  std::array<u16, 6> regs;
+  for (size_t i = 0; i < regs.size(); ++i)
+    regs[i] = reg_file.Get(static_cast<Reg16>(i));
+  trace_writer->Record(GetLocalTime().value() / gb_const::kNsPerClkCycle, regs);
+}
+
+sc_time Cpu::GetLocalTime() const {
+  return use_quantum_ ? quantum_keeper_.get_current_time() : sc_time_stamp() + local_time_delta_;
+}
+
+// F is evaluated with the recorded state of the lazy flags. The CPU's state is restored afterwards.
+void Cpu::DumpFlightRecorder(int fd) {
+  const u8 cur_f = reg_file.F;
+  const std::array<u8, 5> cur_flag_data = {flag_op_, flag_lhs_, flag_rhs_, flag_carry_, flag_result_};
+  const auto set_flag_data = [this](const std::array<u8, 5>& data) {
+    flag_op_ = static_cast<FlagOp>(data[0]);
+    flag_lhs_ = data[1];
+    flag_rhs_ = data[2];
+    flag_carry_ = data[3];
+    flag_result_ = data[4];
+  };
+
+  char line[160];
+  const u64 num = std::min<u64>(flight_recorder.GetNumRecorded(), FlightRecorder::kNumEntries);
+  int len = std::snprintf(line, sizeof(line), "Flight recorder: last %llu instructions (oldest first):\n",
+                          static_cast<unsigned long long>(num));
+  [[maybe_unused]] ssize_t res = write(fd, line, len);
+  flight_recorder.ForEach([&](const FlightRecorder::Entry& entry) {
+    reg_file.F = static_cast<u8>(entry.regs[0]);
+    set_flag_data(entry.flag_data);
+    UpdateFlags();
+    char disassembly[kMaxDisassemblyLength];
+    const u8 length = Disassemble(entry.bytes.data(), entry.pc, disassembly, sizeof(disassembly));
+    char bytes[10] = "";
+    for (u8 i = 0; i < length; ++i)
+      std::snprintf(bytes + 3 * i, sizeof(bytes) - 3 * i, "%02x ", entry.bytes[i]);
+    len = std::snprintf(line, sizeof(line),
+                        "PC:0x%04x AF:0x%04x BC:0x%04x DE:0x%04x HL:0x%04x SP:0x%04x c:%llu  %-9s%s%s\n", entry.pc,
+                        (entry.regs[0] & 0xFF00) | reg_file.F, entry.regs[1], entry.regs[2], entry.regs[3],
+                        entry.regs[4], static_cast<unsigned long long>(entry.cycles), bytes, disassembly,
+                        entry.native ? " (JIT block)" : "");
+    res = write(fd, line, std::min<size_t>(len, sizeof(line) - 1));
+  });
+
+  reg_file.F = cur_f;
+  set_flag_data(cur_flag_data);
+}
+
 void Cpu::SetFlagC(bool val) {
+  UpdateFlags();
   reg_file.F = SetBit(reg_file.F, val, kIndCFlag);
 }
 
 void Cpu::SetFlagH(bool val) {
+  UpdateFlags();
   reg_file.F = SetBit(reg_file.F, val, kIndHFlag);
 }
 
 void Cpu::SetFlagN(bool val) {
+  UpdateFlags();
   reg_file.F = SetBit(reg_file.F, val, kIndNFlag);
 }
 
 void Cpu::SetFlagZ(bool val) {
+  UpdateFlags();
   reg_file.F = SetBit(reg_file.F, val, kIndZFlag);
 }
 
 bool Cpu::GetFlagC() const {
-  return static_cast<bool>(kMaskCFlag & reg_file.F);
+  switch (flag_op_) {
+  case kFlagOpNone:
+    return static_cast<bool>(kMaskCFlag & reg_file.F);
+  case kFlagOpAdd:
+    return flag_lhs_ + flag_rhs_ + flag_carry_ > 0xFF;
+  case kFlagOpSub:
+    return flag_lhs_ < flag_rhs_ + flag_carry_;
+  case kFlagOpInc:
+  case kFlagOpDec:
+    return flag_carry_;
+  default:
+    return false;
+  }
 }
 
 bool Cpu::GetFlagH() const {
-  return static_cast<bool>(kMaskHFlag & reg_file.F);
+  switch (flag_op_) {
+  case kFlagOpNone:
+    return static_cast<bool>(kMaskHFlag & reg_file.F);
+  case kFlagOpAdd:
+    return (flag_lhs_ & 0x0F) + (flag_rhs_ & 0x0F) + flag_carry_ > 0x0F;
+  case kFlagOpSub:
+    return (flag_lhs_ & 0x0F) < (flag_rhs_ & 0x0F) + flag_carry_;
+  case kFlagOpInc:
+    return (flag_result_ & 0x0F) == 0x00;
+  case kFlagOpDec:
+    return (flag_result_ & 0x0F) == 0x0F;
+  case kFlagOpAnd:
+    return true;
+  default:
+    return false;
+  }
 }
 
 bool Cpu::GetFlagN() const {
-  return static_cast<bool>(kMaskNFlag & reg_file.F);
+  if (flag_op_ == kFlagOpNone)
+    return static_cast<bool>(kMaskNFlag & reg_file.F);
+  return (flag_op_ == kFlagOpSub) || (flag_op_ == kFlagOpDec);
 }
 
 bool Cpu::GetFlagZ() const {
-  return static_cast<bool>(kMaskZFlag & reg_file.F);
+  if (flag_op_ == kFlagOpNone)
+    return static_cast<bool>(kMaskZFlag & reg_file.F);
+  return flag_result_ == 0;
+}
+
+void Cpu::UpdateFlags() {
+  if (flag_op_ == kFlagOpNone)
+    return;
+  reg_file.F = (GetFlagZ() << kIndZFlag) | (GetFlagN() << kIndNFlag) | (GetFlagH() << kIndHFlag) |
+               (GetFlagC() << kIndCFlag) | (reg_file.F & 0x0F);
+  flag_op_ = kFlagOpNone;
 }
 
-void Cpu::WriteBus(u16 addr, u8 data) {
+bool Cpu::WriteBus(u16 addr, u8 data) {
   static sc_time delay = SC_ZERO_TIME;  // Dummy delay.
 
+  if (trace_mem_writes_) [[unlikely]]
+    trace_writer->RecordWrite(addr, data);
+
+  if (IsBlockedByDma(addr)) [[unlikely]]
+    return false;
+  const bool invalidated = block_cache_.InvalidateWrite(addr);
+  if (invalidated)
+    cur_block_ = nullptr;
+
+  u8* page = dmi_write_pages_[addr >> 8];
+  if (page != nullptr || (page = RequestDmiPage(addr >> 8, true)) != nullptr) {
+    page[addr & 0xFF] = data;
+    return invalidated;
+  }
+
+  if (use_quantum_)
+    SyncOnMmio(addr);
+  if (addr == 0xFF46 && dma_io_registers_ != nullptr)
+    Sync(kSyncDma);  // The DMA starts at the current time, so IsBlockedByDma() sees the whole transfer.
   payload->set_command(tlm::TLM_WRITE_COMMAND);
   payload->set_address(addr);
   payload->set_data_ptr(reinterpret_cast<unsigned char*>(&data));
   init_socket->b_transport(*payload, delay);
+  return invalidated;
 }
 
 void Cpu::WriteBusDebug(u16 addr, u8 data) {
+  // GDB may also patch the ROM.
+  if (block_cache_.Invalidate(addr, addr))
+    cur_block_ = nullptr;
+
   payload->set_command(tlm::TLM_WRITE_COMMAND);
   payload->set_address(addr);
   payload->set_data_ptr(reinterpret_cast<unsigned char*>(&data));
@@ -72,11 +244,39 @@ void Cpu::WriteBusDebug(u16 addr, u8 data) {
   }
 }
 
-u8 Cpu::ReadBus(u16 addr, GbCommand::Cmd cmd) {
-  if ((addr <= 0x3FFF) && (rom_bank_0_ != nullptr)) {
-    return rom_bank_0_[addr];
+void Cpu::WriteBusDebug(u16 addr, std::span<const u8> data) {
+  size_t done = 0;
+  while (done < data.size()) {
+    const u16 adr = static_cast<u16>(addr + done);
+    const size_t length = std::min<size_t>(data.size() - done, 0x10000 - adr);
+    if (block_cache_.Invalidate(adr, static_cast<u16>(adr + length - 1)))
+      cur_block_ = nullptr;
+
+    payload->set_command(tlm::TLM_WRITE_COMMAND);
+    payload->set_address(adr);
+    payload->set_data_ptr(const_cast<unsigned char*>(&data[done]));
+    payload->set_data_length(length);
+    payload->set_streaming_width(length);
+    init_socket->transport_dbg(*payload);
+    payload->set_data_length(1);
+    payload->set_streaming_width(1);
+
+    if (payload->is_response_error()) {
+      SC_REPORT_ERROR("TLM-2", "Response error from b_transport");
+    }
+    done += length;
   }
+}
 
+u8 Cpu::ReadBus(u16 addr, GbCommand::Cmd cmd) {
+  if (IsBlockedByDma(addr)) [[unlikely]]
+    return 0xFF;
+  const u8* page = dmi_read_pages_[addr >> 8];
+  if (page != nullptr || (page = RequestDmiPage(addr >> 8, false)) != nullptr)
+    return page[addr & 0xFF];
+
+  if (use_quantum_)
+    SyncOnMmio(addr);
   this->gbcmd.cmd = cmd;
   static sc_time delay = SC_ZERO_TIME;  // Dummy delay.
   u8 data;
@@ -94,6 +294,31 @@ u8 Cpu::ReadBus(u16 addr, GbCommand::Cmd cmd) {
   return data;
 }
 
+// Requests the DMI pointers of the given page if they are unknown.
+// Returns the pointer for the respective access or nullptr if the page has to be accessed via TLM.
+u8* Cpu::RequestDmiPage(u8 page, bool write) {
+  if (!dmi_pages_unknown_[page])
+    return nullptr;
+  dmi_pages_unknown_[page] = false;
+
+  tlm::tlm_dmi dmi_data;
+  unsigned char dummy;
+  payload->set_command(tlm::TLM_READ_COMMAND);
+  payload->set_address(page << 8);
+  payload->set_data_ptr(&dummy);
+  if (init_socket->get_direct_mem_ptr(*payload, dmi_data)) {
+    // The targets return a pointer to the requested address. Since the bus forwards the address relative
+    // to the target, the payload now tells where the page starts within the target's range.
+    const sc_dt::uint64 page_start = payload->get_address();
+    if (dmi_data.get_start_address() <= page_start && page_start + 0xFF <= dmi_data.get_end_address()) {
+      u8* ptr = reinterpret_cast<u8*>(dmi_data.get_dmi_ptr());
+      dmi_read_pages_[page] = dmi_data.is_read_allowed() ? ptr : nullptr;
+      dmi_write_pages_[page] = dmi_data.is_write_allowed() ? ptr : nullptr;
+    }
+  }
+  return write ? dmi_write_pages_[page] : dmi_read_pages_[page];
+}
+
 u8 Cpu::ReadBusDebug(u16 addr) {
   u8 data;
   payload->set_command(tlm::TLM_READ_COMMAND);
@@ -107,21 +332,194 @@ u8 Cpu::ReadBusDebug(u16 addr) {
   return data;
 }
 
+// A burst stops at the first unmapped address, which is then read on its own.
+void Cpu::ReadBusDebug(u16 addr, std::span<u8> data) {
+  size_t done = 0;
+  while (done < data.size()) {
+    const u16 adr = static_cast<u16>(addr + done);
+    const size_t length = std::min<size_t>(data.size() - done, 0x10000 - adr);
+    payload->set_command(tlm::TLM_READ_COMMAND);
+    payload->set_address(adr);
+    payload->set_data_ptr(&data[done]);
+    payload->set_data_length(length);
+    payload->set_streaming_width(length);
+    payload->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+    done += init_socket->transport_dbg(*payload);
+    payload->set_data_length(1);
+    payload->set_streaming_width(1);
+
+    if (done < data.size() && payload->is_response_error()) {
+      data[done] = ReadBusDebug(static_cast<u16>(addr + done));
+      ++done;
+    }
+  }
+}
+
+// Fetches and decodes the instruction at PC and starts it (see StartInstr()). Returns the index of its handler.
+// If possible, the instruction is taken pre-decoded from the block cache. Otherwise, it's read from the bus.
+// In both cases, FetchNextInstrByte() serves the operands without accessing the bus.
+u16 Cpu::FetchOpcode() {
+  instr_pc_ = reg_file.PC;
+  instr_bytes_left_ = 0;
+  // While an OAM DMA blocks the bus, the fetch has to go through ReadBus(), which returns 0xFF.
+  const bool blocked = IsBlockedByDma(reg_file.PC);
+  if (blocked || cur_block_ == nullptr || next_instr_ind_ >= cur_block_->instrs.size() ||
+      cur_block_->instrs[next_instr_ind_].adr != reg_file.PC) {
+    cur_block_ = blocked ? nullptr : LookupBlock(reg_file.PC);
+    next_instr_ind_ = 0;
+    if (cur_block_ == nullptr) {
+      // Reading the operands ahead makes no difference, since no instruction accesses memory before its operands.
+      // This way, the flight recorder sees the whole instruction.
+      instr_bytes_[0] = ReadBus(reg_file.PC, GbCommand::kGbReadInst);
+      const u8 length = BlockCache::GetInstrLength(instr_bytes_[0]);
+      for (u8 i = 1; i < length; ++i)
+        instr_bytes_[i] = ReadBus(static_cast<u16>(reg_file.PC + i), GbCommand::kGbReadInst);
+      const OpcodeInfo& info = GetOpcodeInfo(instr_bytes_);
+      return StartDecodedInstr(info, GetOpcodeIndex(info), length);
+    }
+  }
+
+  const BlockCache::DecodedInstr& instr = cur_block_->instrs[next_instr_ind_++];
+  std::memcpy(instr_bytes_, instr.bytes, sizeof(instr_bytes_));  // The block may vanish during execution.
+  return StartDecodedInstr(*instr.info, instr.handler, instr.length);
+}
+
+// Starts the instruction in instr_bytes_. FetchNextInstrByte() serves its operands.
+u16 Cpu::StartDecodedInstr(const OpcodeInfo& info, u16 handler, u8 length) {
+  const u8 opcode_length = (handler >= 0x100) ? 2 : 1;  // Including the 0xCB prefix.
+  instr_byte_ind_ = opcode_length;
+  instr_bytes_left_ = length - opcode_length;
+  reg_file.PC += opcode_length;
+  StartInstr(info);
+  return handler;
+}
+
 u8 Cpu::FetchNextInstrByte() {
+  if (instr_bytes_left_ != 0) {
+    --instr_bytes_left_;
+    ++reg_file.PC;
+    return instr_bytes_[instr_byte_ind_++];
+  }
+
   u8 val = ReadBus(reg_file.PC, GbCommand::kGbReadInst);
   ++reg_file.PC;
   return val;
 }
 
 u16 Cpu::FetchNext2InstrBytes() {
-  gbcmd.cmd = GbCommand::kGbReadInst;
-  u16 lsb = static_cast<u16>(ReadBus(reg_file.PC, GbCommand::kGbReadInst));
-  ++reg_file.PC;
-  u16 msb = static_cast<u16>(ReadBus(reg_file.PC, GbCommand::kGbReadInst)) << 8;
-  ++reg_file.PC;
+  u16 lsb = static_cast<u16>(FetchNextInstrByte());
+  u16 msb = static_cast<u16>(FetchNextInstrByte()) << 8;
   return msb | lsb;
 }
 
+// Returns the cached block at the given address. Decodes a new block if there's none yet.
+// Returns nullptr for code that is not cacheable.
+BlockCache::Block* Cpu::LookupBlock(u16 adr) {
+  if (!BlockCache::IsCacheable(adr))
+    return nullptr;
+
+  const u16 bank = GetRomBank(adr);
+  BlockCache::Block* block = block_cache_.Find(adr, bank);
+  if (block == nullptr)
+    block = block_cache_.Build(adr, bank, [this](u16 a) { return ReadBusDebug(a); });
+  return block;
+}
+
+u16 Cpu::GetRomBank(u16 adr) {
+  if (!BlockCache::IsBankSwitched(adr))
+    return 0;
+  if (!rom_bank_valid_) {  // The cartridge tells us the current bank on non-DMI reads.
+    gbcmd.rom_bank = 0;
+    ReadBusDebug(adr);
+    rom_bank_ = gbcmd.rom_bank;
+    rom_bank_valid_ = true;
+  }
+  return rom_bank_;
+}
+
+// Executes the translated code of the block at PC. Blocks get translated after kJitThreshold executions.
+// Returns false if the interpreter has to execute the next instruction.
+bool Cpu::RunJit() {
+  if (cur_block_ != nullptr && next_instr_ind_ < cur_block_->instrs.size() &&
+      cur_block_->instrs[next_instr_ind_].adr == reg_file.PC) {
+    return false;  // The interpreter continues in the middle of a block.
+  }
+
+  BlockCache::Block* block = LookupBlock(reg_file.PC);
+  cur_block_ = block;
+  next_instr_ind_ = 0;
+  if (block == nullptr || block->translation_failed)
+    return false;
+
+  if (block->native_code == nullptr) {
+    if (++block->exec_count < kJitThreshold)
+      return false;
+    try {
+      block->native_code = jit_->Compile(*block, &block->native_max_cycles);
+    } catch (const std::runtime_error& e) {
+      std::cerr << "Warning: " << e.what() << ". Falling back to the interpreter." << std::endl;
+      jit_.reset();
+      cur_block_ = nullptr;
+      return false;
+    }
+    if (block->native_code == nullptr) {
+      if (jit_->IsFull()) {  // Start all over again.
+        block_cache_.Clear();
+        jit_->Reset();
+        cur_block_ = nullptr;
+      } else {
+        block->translation_failed = true;
+      }
+      return false;
+    }
+  }
+
+  // The translated code must not run past the next pending activity of the other modules (or the end of the
+  // quantum). This way, they observe the same timing as with the interpreter.
+  const sc_time run_time = sc_time::from_value(block->native_max_cycles * gb_const::kNsPerClkCycle);
+  if (use_quantum_) {
+    const sc_time time_limit = tlm::tlm_global_quantum::instance().compute_local_quantum();
+    if (quantum_keeper_.get_local_time() + run_time > time_limit)
+      return false;
+  } else {
+    const sc_time time_limit = sc_time_to_pending_activity();
+    if ((time_limit == sc_max_time() - sc_time_stamp()) || (local_time_delta_ + run_time > time_limit))
+      return false;
+  }
+
+  UpdateFlags();  // Translated code works on register F.
+  RecordInstr(reg_file.PC, block->instrs[0].handler, block->instrs[0].bytes, true);
+  const u32 cycles = block->native_code(&jit_ctx_);
+  if (cycles == 0)
+    return false;
+  wait_ns_ = cycles * gb_const::kNsPerClkCycle;
+
+  // If the translated code returned in the middle of the block, the interpreter continues there.
+  // A stop means that the block may be gone already.
+  cur_block_ = nullptr;
+  if (!jit_ctx_.stop && block->idle_loop_cycles != 0 && reg_file.PC == block->start_adr) {
+    cur_block_ = block;  // Completed an iteration of an idle loop, see SkipIdleLoop().
+    next_instr_ind_ = block->instrs.size();
+  } else if (!jit_ctx_.stop && block->start_adr < reg_file.PC && reg_file.PC <= block->end_adr) {
+    for (size_t i = 1; i < block->instrs.size(); ++i) {
+      if (block->instrs[i].adr == reg_file.PC) {
+        cur_block_ = block;
+        next_instr_ind_ = i;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+u8 Cpu::JitRead(void* cpu, u16 addr) {
+  return static_cast<Cpu*>(cpu)->ReadBus(addr, GbCommand::kGbReadData);
+}
+
+bool Cpu::JitWrite(void* cpu, u16 addr, u8 data) {
+  return static_cast<Cpu*>(cpu)->WriteBus(addr, data);
+}
+
 // Halts the CPU SystemC thread. Use Continue() to ...continue.
 // Don't confuse this with the halt instruction!
 // Is used by the GDB server to wait for a connection.
@@ -141,25 +539,136 @@ void Cpu::start_of_simulation() {
   InterruptModule::start_of_simulation();
   payload = new tlm::tlm_generic_payload;
 
-  tlm::tlm_dmi dmi_data;
-  unsigned char dummy;
-  payload->set_command(tlm::TLM_READ_COMMAND);
-  payload->set_address(0x0);
-  payload->set_data_ptr(&dummy);
-  payload->set_address(0x0);
-  if (init_socket->get_direct_mem_ptr(*payload, dmi_data)) {
-    assert(dmi_data.get_start_address() == 0);
-    assert(dmi_data.get_end_address() >= 0x3FFF);
-    rom_bank_0_ = reinterpret_cast<u8*>(dmi_data.get_dmi_ptr());
-  }
-  // May not get a DMI pointer if tracing is enabled.
+  // DMI pointers are requested on the first access of a page.
+  dmi_pages_unknown_.set();
+  quantum_keeper_.reset();
 
   payload->set_command(tlm::TLM_IGNORE_COMMAND);
   payload->set_address(0);
   payload->set_data_ptr(nullptr);
+  payload->set_data_length(1);
+  payload->set_streaming_width(1);
   payload->set_extension(&gbcmd);
 }
 
+// Called if the memory behind [start, end] changed in a way that isn't visible to the CPU's write accesses.
+// For example, when the cartridge switches the ROM bank or unmaps the boot ROM.
+void Cpu::invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end) {
+  end = std::min<sc_dt::uint64>(end, 0xFFFF);
+  for (sc_dt::uint64 page = start >> 8; page <= (end >> 8); ++page) {
+    dmi_read_pages_[page] = nullptr;
+    dmi_write_pages_[page] = nullptr;
+    dmi_pages_unknown_[page] = true;
+  }
+
+  if (start <= 0x7FFF && end >= 0x4000)
+    rom_bank_valid_ = false;  // Blocks are kept per bank.
+  if (start < 0x4000 || end > 0x7FFF)
+    block_cache_.Invalidate(static_cast<u16>(start), static_cast<u16>(end));
+  cur_block_ = nullptr;
+}
+
+// Advances the local time by the duration of the last instruction(s).
+// Synchronizes with the SystemC kernel once the next pending activity is reached or the quantum expired.
+void Cpu::AdvanceTime() {
+  executed_cycles_ += wait_ns_ / gb_const::kNsPerClkCycle;
+  if (profiler != nullptr) [[unlikely]]
+    profiler->Count(GetInstrBank(), instr_pc_, *cur_opcode_, wait_ns_ / gb_const::kNsPerClkCycle);
+  if (call_stack_sampler != nullptr) [[unlikely]]
+    call_stack_sampler->AddCycles(wait_ns_ / gb_const::kNsPerClkCycle);
+
+  if (use_quantum_) {
+    quantum_keeper_.inc(sc_time::from_value(wait_ns_));
+    if (quantum_keeper_.need_sync() || single_step_)
+      Sync(kSyncQuantum);
+    return;
+  }
+
+  local_time_delta_ += sc_time::from_value(wait_ns_);
+  auto time_limit = sc_time_to_pending_activity();
+  auto max_time = sc_max_time() - sc_time_stamp();
+  if (time_limit != max_time)
+    SkipIdleLoop(time_limit);
+  if ((time_limit <= local_time_delta_) || (time_limit == max_time) || single_step_)
+    Sync(kSyncPendingActivity);
+}
+
+void Cpu::Sync(SyncReason reason) {
+  ++sync_counts_[reason];
+  if (use_quantum_) {
+    quantum_keeper_.sync();
+  } else {
+    wait(local_time_delta_);
+    local_time_delta_ = SC_ZERO_TIME;
+  }
+}
+
+// The other modules lag behind the CPU by up to a quantum. Before accessing a register that changes with time,
+// the CPU lets them catch up, so that it reads (or overwrites) the register's current value.
+void Cpu::SyncOnMmio(u16 addr) {
+  SyncReason reason;
+  switch (addr) {
+  case 0xFF04:
+    reason = kSyncDiv;
+    break;
+  case 0xFF05:
+    reason = kSyncTima;
+    break;
+  case 0xFF0F:
+    reason = kSyncIf;
+    break;
+  case 0xFF41:
+    reason = kSyncStat;
+    break;
+  case 0xFF44:
+    reason = kSyncLy;
+    break;
+  default:
+    return;
+  }
+  if (quantum_keeper_.get_local_time() != SC_ZERO_TIME)
+    Sync(reason);
+}
+
+string Cpu::GetSyncReport() const {
+  string report = "CPU synchronizations:\n";
+  for (size_t i = 0; i < kNumSyncReasons; ++i)
+    report += std::format("  {:<16} {}\n", kSyncReasonNames[i], sync_counts_[i]);
+  return report;
+}
+
+// Fast-forwards an idle loop (see BlockCache::Block::idle_loop_cycles) if the CPU just jumped back to its start.
+// Skips all iterations that end before the next pending activity, since they can't observe any change.
+// A remaining partial iteration is executed as usual, so the loop notices changes at the same time as before.
+void Cpu::SkipIdleLoop(const sc_time& time_limit) {
+  if (cur_block_ == nullptr || cur_block_->idle_loop_cycles == 0 || next_instr_ind_ != cur_block_->instrs.size() ||
+      reg_file.PC != cur_block_->start_adr || attach_gdb_ || single_step_ || time_limit <= local_time_delta_) {
+    return;
+  }
+  if (intr_master_enable && (*reg_intr_enable_dmi & *reg_intr_pending_dmi))
+    return;  // The interrupt is handled before the next iteration.
+
+  // The last iteration must not have been interrupted by a synchronization. Otherwise, it may have read
+  // values that were changed by other modules in the meantime.
+  const u64 iteration_ns = static_cast<u64>(cur_block_->idle_loop_cycles) * gb_const::kNsPerClkCycle;
+  if (local_time_delta_.value() < iteration_ns)
+    return;
+  const u64 iterations = (time_limit - local_time_delta_).value() / iteration_ns;
+  local_time_delta_ += sc_time::from_value(iterations * iteration_ns);
+  idle_skipped_cycles_ += iterations * cur_block_->idle_loop_cycles;
+  executed_cycles_ += iterations * cur_block_->idle_loop_cycles;
+
+  if (profiler != nullptr) {
+    for (const BlockCache::DecodedInstr& instr : cur_block_->instrs) {
+      const OpcodeInfo& info = *instr.info;
+      const u64 cycles = (&instr == &cur_block_->instrs.back()) ? info.cycles_taken : info.cycles;
+      profiler->Count(cur_block_->bank, instr.adr, info, iterations * cycles, iterations);
+    }
+  }
+  if (call_stack_sampler != nullptr)
+    call_stack_sampler->AddCycles(iterations * cur_block_->idle_loop_cycles);
+}
+
 // TODO(niko): What happens if there are multiple interrupts???
 // source: http://imrannazar.com/gameboy-emulation-in-javascript:-interrupts
 // This has to be after the execute cycle
@@ -179,36 +688,29 @@ void Cpu::HandleInterrupts() {
   u8 intr = *reg_intr_enable_dmi & *reg_intr_pending_dmi;
   if (intr) {
     intr_master_enable = false;  // Disable IME.
-    InstrPush(reg_file.PC);
+    InstrPush<Reg16::kPC>();
     if (intr & gb_const::kVBlankIf) {
       DBG_LOG_CPU("Executing vblank ISR");
       reg_file.PC = 0x40;
       *reg_intr_pending_dmi &= ~gb_const::kVBlankIf;
-      return;
-    }
-    if (intr & gb_const::kLCDCIf) {
+    } else if (intr & gb_const::kLCDCIf) {
       DBG_LOG_CPU("Executing LCDC status ISR");
       reg_file.PC = 0x48;
       *reg_intr_pending_dmi &= ~gb_const::kLCDCIf;
-      return;
-    }
-    if (intr & gb_const::kTimerOfIf) {
+    } else if (intr & gb_const::kTimerOfIf) {
       DBG_LOG_CPU("Executing timer ISR");
       reg_file.PC = 0x50;
       *reg_intr_pending_dmi &= ~gb_const::kTimerOfIf;
-      return;
-    }
-    if (intr & gb_const::kSerialIOIf) {
+    } else if (intr & gb_const::kSerialIOIf) {
       DBG_LOG_CPU("Executing serial transfer ISR");
       reg_file.PC = 0x58;
       *reg_intr_pending_dmi &= ~gb_const::kSerialIOIf;
-      return;
-    }
-    if (intr & gb_const::kJoypadIf) {
+    } else if (intr & gb_const::kJoypadIf) {
       DBG_LOG_CPU("Executing joypad ISR");
       reg_file.PC = 0x60;
       *reg_intr_pending_dmi &= ~gb_const::kJoypadIf;
-      return;
     }
+    if (call_stack_sampler != nullptr) [[unlikely]]
+      call_stack_sampler->Interrupt(reg_file.PC, reg_file.SP);
   }
 }
@@ -8,15 +8,29 @@
 
 #include <stdlib.h>
 
+#include <array>
+#include <bitset>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <string>
 
+#include "block_cache.h"
+#include "call_stack_sampler.h"
 #include "common.h"
+#include "flight_recorder.h"
 #include "gb_const.h"
 #include "gdb_server.h"
 #include "interrupt_module.h"
+#include "jit.h"
+#include "opcodes.h"
+#include "profiler.h"
 #include "reg_file.h"
+#include "trace.h"
+#include "tlm_utils/tlm_quantumkeeper.h"
+
+struct IoRegisters;
 
 class Cpu : public InterruptModule<Cpu>, public sc_module {
  public:
@@ -24,7 +38,7 @@ class Cpu : public InterruptModule<Cpu>, public sc_module {
   friend GdbServer;
 
   // The Game Boy's register file.
-  RegFile reg_file;
+  RegFile reg_file{};
 
   // The states are a semihosting feature intended to communicate failure or success of tests.
   enum CpuState {
@@ -33,11 +47,45 @@ class Cpu : public InterruptModule<Cpu>, public sc_module {
     kTestFailed,
   } cpu_state = kNominal;
 
-  explicit Cpu(sc_module_name name, bool attach_gdb = false, bool singel_step = false);
+  explicit Cpu(sc_module_name name, bool attach_gdb = false, bool singel_step = false, bool use_jit = false,
+               u32 quantum_cycles = 0);
   ~Cpu();
 
+  // Notified by the interrupt sources (PPU, timer, serial, joypad) when they set a bit in IF.
+  // A halted CPU sleeps on this event.
+  sc_event intr_event;
+
+  // Returns the number of clock cycles the CPU fast-forwarded in idle loops instead of executing them.
+  u64 GetIdleSkippedCycles() const { return idle_skipped_cycles_; }
+  // Returns how often the CPU synchronized with the SystemC kernel for each reason.
+  string GetSyncReport() const;
+
+  // Counts the executed instructions and cycles per address and opcode. Disables the JIT, since it
+  // executes whole blocks at once.
+  void EnableProfiler();
+  // Is nullptr if the profiler is not enabled.
+  std::unique_ptr<Profiler> profiler;
+  // Keeps a shadow call stack and samples it every sample_cycles clock cycles. Disables the JIT.
+  void EnableCallStackSampler(u64 sample_cycles);
+  // Is nullptr if the call stack sampler is not enabled.
+  std::unique_ptr<CallStackSampler> call_stack_sampler;
+  // Records the register file and cycle count before each instruction (and optionally the memory writes)
+  // in a binary trace file. Disables the JIT.
+  void EnableTrace(const std::filesystem::path& path, bool mem_writes);
+  // Is nullptr if tracing is not enabled.
+  std::unique_ptr<TraceWriter> trace_writer;
+  // While an OAM DMA of io_registers is running, only 0xFF00-0xFFFF (registers and HRAM) are accessible.
+  // Other reads return 0xFF and other writes are dropped. Disables the JIT.
+  void EnableDmaBlocking(const IoRegisters* io_registers);
+  // Keeps the last executed instructions for a post-mortem. Always on.
+  FlightRecorder flight_recorder;
+  // Writes the instructions of the flight recorder from the oldest to the newest to the file descriptor.
+  // Apart from snprintf, only uses async-signal-safe functions, so it can be called by the crash handler.
+  void DumpFlightRecorder(int fd);
+
  private:
   void start_of_simulation() override;
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end);
 
   // Interrupt master enable.
   bool intr_master_enable = false;
@@ -52,20 +100,77 @@ class Cpu : public InterruptModule<Cpu>, public sc_module {
   bool GetFlagN() const;
   bool GetFlagZ() const;
 
-  // Write to bus/memory.
-  void WriteBus(u16 addr, u8 data);
+  // Lazy flag evaluation: Most ALU instructions only record the kind of operation, its operands, and its
+  // result. The flags are derived from these when they are read (see GetFlag*() and UpdateFlags()).
+  enum FlagOp : u8 {
+    kFlagOpNone,  // Register F is up to date.
+    kFlagOpAdd,   // ADD, ADC
+    kFlagOpSub,   // SUB, SBC, CP
+    kFlagOpInc,
+    kFlagOpDec,
+    kFlagOpAnd,
+    kFlagOpOr,  // OR, XOR
+  };
+  FlagOp flag_op_ = kFlagOpNone;
+  u8 flag_lhs_ = 0;
+  u8 flag_rhs_ = 0;
+  u8 flag_carry_ = 0;  // Carry of ADC/SBC or the unchanged C flag of INC/DEC.
+  u8 flag_result_ = 0;
+  void SetFlagsLazy(FlagOp op, u8 lhs, u8 rhs, u8 carry, u8 result) {
+    flag_op_ = op;
+    flag_lhs_ = lhs;
+    flag_rhs_ = rhs;
+    flag_carry_ = carry;
+    flag_result_ = result;
+  }
+  // Writes pending flags into register F. Has to be called before accessing F directly.
+  void UpdateFlags();
+
+  // Write to bus/memory. Returns true if the write changed cached code.
+  bool WriteBus(u16 addr, u8 data);
   // Write to bus/memory in debug mode. Also used by GDB.
   void WriteBusDebug(u16 addr, u8 data);
+  // Writes data to addr in debug mode using bursts. Addresses wrap around after 0xFFFF.
+  void WriteBusDebug(u16 addr, std::span<const u8> data);
   // Read from bus/memory.
   u8 ReadBus(u16 addr, GbCommand::Cmd cmd);
   // Read from bus/memory in debug mode. Also used by GDB.
   u8 ReadBusDebug(u16 addr);
+  // Fills data from addr in debug mode using bursts. Unmapped addresses read as 0.
+  // Addresses wrap around after 0xFFFF.
+  void ReadBusDebug(u16 addr, std::span<u8> data);
   tlm::tlm_generic_payload* payload;
   GbCommand gbcmd;
 
   // Executes on machine cycle (interrupts, fetch, decode, execute)
   void DoMachineCycle();
+  void AdvanceTime();
+  void SkipIdleLoop(const sc_time& time_limit);
+  // Reasons for synchronizing with the SystemC kernel.
+  enum SyncReason : u8 {
+    kSyncPendingActivity,  // Another module has pending activity (default mode).
+    kSyncQuantum,          // The quantum expired (--quantum-cycles).
+    kSyncHalt,
+    kSyncLy,
+    kSyncStat,
+    kSyncDiv,
+    kSyncTima,
+    kSyncIf,
+    kSyncDma,              // A write to 0xFF46 (--dma-hram-only).
+    kNumSyncReasons,
+  };
+  static constexpr std::array<const char*, kNumSyncReasons> kSyncReasonNames{
+      "pending activity", "quantum", "HALT", "LY", "STAT", "DIV", "TIMA", "IF", "OAM DMA"};
+  std::array<u64, kNumSyncReasons> sync_counts_{};
+  void Sync(SyncReason reason);
+  void SyncOnMmio(u16 addr);
+  // Clock cycles that were skipped in idle loops.
+  u64 idle_skipped_cycles_ = 0;
+  // Clock cycles executed so far, including HALT and skipped idle loops. Cheaper than asking the kernel for the time.
+  u64 executed_cycles_ = 0;
   void HandleInterrupts();
+  u16 FetchOpcode();
+  u16 StartDecodedInstr(const OpcodeInfo& info, u16 handler, u8 length);
   u8 FetchNextInstrByte();
   u16 FetchNext2InstrBytes();
 
@@ -82,114 +187,256 @@ class Cpu : public InterruptModule<Cpu>, public sc_module {
   bool halted_ = false;
   // In single step mode the CPU state is printed after each instruction.
   bool single_step_ = false;
+  // If true, the memory writes are recorded in the trace.
+  bool trace_mem_writes_ = false;
+  // Records the state before the current instruction in the trace.
+  void TraceInstr();
+  // Returns the local time of the CPU, which may be ahead of the SystemC kernel.
+  sc_time GetLocalTime() const;
+  // Records the state before the instruction at pc in the flight recorder.
+  void RecordInstr(u16 pc, u16 handler, const u8* bytes, bool native = false) {
+    FlightRecorder::Entry& entry = flight_recorder.Next();
+    entry.cycles = executed_cycles_;
+    std::memcpy(entry.regs.data(), reg_file.GetDataPtr(), sizeof(entry.regs));
+    entry.pc = pc;
+    entry.handler = handler;
+    std::memcpy(entry.bytes.data(), bytes, sizeof(entry.bytes));
+    entry.native = native;
+    entry.flag_data = {flag_op_, flag_lhs_, flag_rhs_, flag_carry_, flag_result_};
+  }
   // TCP port for the GDB stub.
   const int gdb_port_ = 1337;
   // Instruction wait time in nanoseconds.
   int wait_ns_;
+  // Static information about the instruction that is executed. Its cycles are the default wait time.
+  const OpcodeInfo* cur_opcode_ = &kOpcodes[0];
+  void StartInstr(const OpcodeInfo& info) {
+    cur_opcode_ = &info;
+    wait_ns_ = info.cycles * gb_const::kNsPerClkCycle;
+  }
+  // Conditional instructions call this if they branch.
+  void TakeBranch() { wait_ns_ = cur_opcode_->cycles_taken * gb_const::kNsPerClkCycle; }
   // The time the local SC_THREAD advanced without calling sc_wait.
   sc_time local_time_delta_;
-  // DMI pointer to lower ROM bank.
-  u8* rom_bank_0_;
+  // With a quantum, the CPU only synchronizes when the quantum expires or when it accesses a register that
+  // changes with time (see SyncOnMmio()). The quantum keeper tracks the local time instead of local_time_delta_.
+  bool use_quantum_;
+  tlm_utils::tlm_quantumkeeper quantum_keeper_;
+
+  // Host pointers to the 256 byte pages of the address space, separately for reads and writes.
+  // A nullptr means that the page has to be accessed via TLM (I/O registers, cartridge RAM, ...).
+  std::array<u8*, 256> dmi_read_pages_{};
+  std::array<u8*, 256> dmi_write_pages_{};
+  // Pages for which a DMI pointer has to be requested. Set initially and after invalidations.
+  std::bitset<256> dmi_pages_unknown_;
+  u8* RequestDmiPage(u8 page, bool write);
+  // Set by EnableDmaBlocking().
+  const IoRegisters* dma_io_registers_ = nullptr;
+  bool IsBlockedByDma(u16 addr) const;
+
+  // Pre-decoded blocks of instructions. Saves fetching the same code via the bus over and over again.
+  BlockCache block_cache_;
+  BlockCache::Block* LookupBlock(u16 adr);
+  // The block the current instruction is taken from and the index of the next instruction in it.
+  const BlockCache::Block* cur_block_ = nullptr;
+  size_t next_instr_ind_ = 0;
+  // Bytes of the current instruction. Operands not taken from a block are read ahead from the bus.
+  u8 instr_bytes_[3];
+  uint instr_byte_ind_ = 0;
+  uint instr_bytes_left_ = 0;
+  // The ROM bank at 0x4000-0x7FFF. Gets unknown when the cartridge switches the bank.
+  u16 rom_bank_ = 0;
+  bool rom_bank_valid_ = false;
+  // Address of the current instruction's opcode.
+  u16 instr_pc_ = 0;
+  // ROM bank of the current instruction. Only valid for code that is taken from the block cache.
+  u16 GetInstrBank() const { return BlockCache::IsBankSwitched(instr_pc_) ? rom_bank_ : 0; }
+  // Returns the ROM bank of the given address. Asks the cartridge if the bank is unknown.
+  u16 GetRomBank(u16 adr);
+
+  // Report calls and returns to the call stack sampler. Have to be called after the return address
+  // was pushed and before it is popped, respectively.
+  void TrackCall() {
+    if (call_stack_sampler != nullptr) [[unlikely]]
+      call_stack_sampler->Call(GetRomBank(reg_file.PC), reg_file.PC, reg_file.SP);
+  }
+  void TrackReturn() {
+    if (call_stack_sampler != nullptr) [[unlikely]]
+      call_stack_sampler->Return(reg_file.SP);
+  }
+
+  // Translates frequently executed blocks into native code. Is nullptr if the interpreter is used.
+  std::unique_ptr<Jit> jit_;
+  JitContext jit_ctx_;
+  // Number of executions after which a block gets translated.
+  static constexpr u32 kJitThreshold = 8;
+  bool RunJit();
+  static u8 JitRead(void* cpu, u16 addr);
+  static bool JitWrite(void* cpu, u16 addr, u8 data);
 
   // All of the SM83's instructions.
-  void InstrAddA(Reg<u8>& reg);
-  void InstrAddA(Reg<u16>& addr_reg);
-  void InstrAddACarry(Reg<u8>& reg);
-  void InstrAddACarry(Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrAddA();
+  template <Reg16 kAddrReg>
+  void InstrAddA();
+  template <Reg8 kReg>
+  void InstrAddACarry();
+  template <Reg16 kAddrReg>
+  void InstrAddACarry();
   void InstrAddACarryImm();
   void InstrAddAImm();
-  void InstrAddHl(Reg<u16>& reg);
+  template <Reg16 kReg>
+  void InstrAddHl();
   void InstrAddSp();
-  void InstrAnd(Reg<u8>& reg);
-  void InstrAnd(Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrAnd();
+  template <Reg16 kAddrReg>
+  void InstrAnd();
   void InstrAndImm();
-  void InstrBitN(uint bit_index, Reg<u8>& reg);
-  void InstrBitN(uint bit_index, Reg<u16>& addr);
+  template <Reg8 kReg>
+  void InstrBitN(uint bit_index);
+  template <Reg16 kAddr>
+  void InstrBitN(uint bit_index);
   void InstrCall();
   void InstrCallIf(bool cond);
   void InstrCCF();
-  void InstrComp(Reg<u8>& reg);
-  void InstrComp(Reg<u16>& reg);
+  template <Reg8 kReg>
+  void InstrComp();
+  template <Reg16 kReg>
+  void InstrComp();
   void InstrCompImm();
   void InstrComplement();
   void InstrDAA();
-  void InstrDec(Reg<u8>& reg);
-  void InstrDec(Reg<u16>& reg);
-  void InstrDecAddr(Reg<u16>& addr);
+  template <Reg8 kReg>
+  void InstrDec();
+  template <Reg16 kReg>
+  void InstrDec();
+  template <Reg16 kAddr>
+  void InstrDecAddr();
   void InstrDI();
   void InstrEI();
   void InstrHalt();
-  void InstrInc(Reg<u8>& reg);
-  void InstrInc(Reg<u16>& reg);
-  void InstrIncAddr(Reg<u16>& addr);
+  template <Reg8 kReg>
+  void InstrInc();
+  template <Reg16 kReg>
+  void InstrInc();
+  template <Reg16 kAddr>
+  void InstrIncAddr();
+  void InstrJump();
+  template <Reg16 kAddrReg>
   void InstrJump();
-  void InstrJump(Reg<u16>& addr_reg);
   void InstrJumpIf(bool cond);
   void InstrJumpAddr();
   void InstrJumpAddrIf(bool cond);
-  void InstrLoad(Reg<u8>& reg, Reg<u16>& addr_reg);
-  void InstrLoad(Reg<u8>& reg, const u16& addr_val);
+  template <Reg8 kReg, Reg16 kAddrReg>
+  void InstrLoad();
+  template <Reg8 kReg>
+  void InstrLoad(const u16& addr_val);
   void InstrLoadC();
-  void InstrLoadImm(Reg<u8>& reg);
-  void InstrLoadImm(Reg<u16>& reg);
-  void InstrLoadInc(Reg<u8>& reg, Reg<u16>& addr_reg);
-  void InstrLoadDec(Reg<u16>& addr_reg, Reg<u8>& reg);
-  void InstrLoadH(Reg<u8>& reg);
+  template <Reg8 kReg>
+  void InstrLoadImm();
+  template <Reg16 kReg>
+  void InstrLoadImm();
+  template <Reg8 kReg, Reg16 kAddrReg>
+  void InstrLoadInc();
+  template <Reg16 kAddrReg, Reg8 kReg>
+  void InstrLoadDec();
+  template <Reg8 kReg>
+  void InstrLoadH();
   void InstrLoadHlSpRel();
   void InstrLoadSpHl();
-  void InstrMov(Reg<u8>& reg_to, Reg<u8>& reg_from);
+  template <Reg8 kRegTo, Reg8 kRegFrom>
+  void InstrMov();
   void InstrNop();
-  void InstrOr(Reg<u8>& reg);
-  void InstrOr(Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrOr();
+  template <Reg16 kAddrReg>
+  void InstrOr();
   void InstrOrImm();
-  void InstrPop(Reg<u16>& reg);
+  template <Reg16 kReg>
+  void InstrPop();
   void InstrPopAF();
-  void InstrPush(Reg<u16>& reg);
-  void InstrResetBit(const uint bit, Reg<u8>& reg);
-  void InstrResetBit(const uint bit, Reg<u16>& addr_reg);
+  void InstrPushAF();
+  template <Reg16 kReg>
+  void InstrPush();
+  template <Reg8 kReg>
+  void InstrResetBit(const uint bit);
+  template <Reg16 kAddrReg>
+  void InstrResetBit(const uint bit);
   void InstrRet();
   void InstrRetI();
   void InstrRetIf(bool cond);
-  void InstrRotLeft(Reg<u8>& reg);
-  void InstrRotLeft(Reg<u16>& reg);
+  template <Reg8 kReg>
+  void InstrRotLeft();
+  template <Reg16 kReg>
+  void InstrRotLeft();
   void InstrRotLeftA();
-  void InstrRotRight(Reg<u8>& reg);
-  void InstrRotRight(Reg<u16>& reg);
+  template <Reg8 kReg>
+  void InstrRotRight();
+  template <Reg16 kReg>
+  void InstrRotRight();
   void InstrRlca();
-  void InstrRlc(Reg<u8>& reg);
-  void InstrRlc(const Reg<u16>& addr_reg);
-  void InstrRrc(Reg<u8>& reg);
-  void InstrRrc(const Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrRlc();
+  template <Reg16 kAddrReg>
+  void InstrRlc();
+  template <Reg8 kReg>
+  void InstrRrc();
+  template <Reg16 kAddrReg>
+  void InstrRrc();
   void InstrRra();
   void InstrRrca();
   void InstrRST(const u8 addr);
   void InstrSCF();
-  void InstrSetBitN(uint bit_index, Reg<u8>& reg);
-  void InstrSetBitN(uint bit_index, Reg<u16>& addr_reg);
-  void InstrShiftRight(Reg<u8>& reg);
-  void InstrShiftRight(Reg<u16>& addr_reg);
-  void InstrSLA(Reg<u8>& reg);
-  void InstrSLA(Reg<u16>& addr_reg);
-  void InstrStore(const Reg<u16>& addr_reg, const Reg<u8>& reg);
-  void InstrStore(const u8& addr_reg, const Reg<u8>& reg);
-  void InstrStore(const Reg<u8>& reg);
-  void InstrStoreInc(Reg<u16>& addr_reg, const u8 val);
-  void InstrStoreImm(Reg<u16>& addr);
-  void InstrStoreDec(Reg<u16>& addr_reg, const u8 val);
-  void InstrStoreH(Reg<u8>& reg);
+  template <Reg8 kReg>
+  void InstrSetBitN(uint bit_index);
+  template <Reg16 kAddrReg>
+  void InstrSetBitN(uint bit_index);
+  template <Reg8 kReg>
+  void InstrShiftRight();
+  template <Reg16 kAddrReg>
+  void InstrShiftRight();
+  template <Reg8 kReg>
+  void InstrSLA();
+  template <Reg16 kAddrReg>
+  void InstrSLA();
+  template <Reg16 kAddrReg, Reg8 kReg>
+  void InstrStore();
+  template <Reg8 kReg>
+  void InstrStore(const u8& addr_reg);
+  template <Reg8 kReg>
+  void InstrStore();
+  template <Reg16 kAddrReg>
+  void InstrStoreInc(const u8 val);
+  template <Reg16 kAddr>
+  void InstrStoreImm();
+  template <Reg16 kAddrReg>
+  void InstrStoreDec(const u8 val);
+  template <Reg8 kReg>
+  void InstrStoreH();
   void InstrSubImm();
-  void InstrSub(Reg<u8>& reg);
-  void InstrSub(Reg<u16>& addr_reg);
-  void InstrSubCarry(Reg<u8>& reg);
-  void InstrSubCarry(Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrSub();
+  template <Reg16 kAddrReg>
+  void InstrSub();
+  template <Reg8 kReg>
+  void InstrSubCarry();
+  template <Reg16 kAddrReg>
+  void InstrSubCarry();
   void InstrSubCarryImm();
-  void InstrSRA(Reg<u8>& reg);
-  void InstrSRA(Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrSRA();
+  template <Reg16 kAddrReg>
+  void InstrSRA();
   void InstrStoreSp();
-  void InstrSwap(Reg<u8>& reg);
-  void InstrSwap(Reg<u16>& addr_reg);
-  void InstrXor(Reg<u8>& reg);
-  void InstrXor(Reg<u16>& addr_reg);
+  template <Reg8 kReg>
+  void InstrSwap();
+  template <Reg16 kAddrReg>
+  void InstrSwap();
+  template <Reg8 kReg>
+  void InstrXor();
+  template <Reg16 kAddrReg>
+  void InstrXor();
   void InstrXorImm();
 
   // Not part of the original SM83 ISA. Used for semihosting.
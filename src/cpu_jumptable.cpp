@@ -8,7 +8,108 @@
 
 #include "cpu.h"
 
+// FetchOpcode() returns the index of the handler, which is the index of the opcode in kOpcodeTable:
+// 0x00-0xFF for the base opcodes and 0x100-0x1FF for the CB-prefixed ones. Hence, a single dispatch
+// selects the handler of every instruction, and pre-decoded instructions of the block cache skip decoding.
+// The dispatch is a switch statement by default. If CPU_THREADED_DISPATCH is defined, it uses threaded code
+// instead: Each opcode jumps to its handler via a table of label addresses (GCC's computed goto) and each
+// handler directly dispatches the next opcode. Hence, every handler has its own indirect jump, which is
+// easier to predict than the single jump of the switch statement.
+#ifdef CPU_THREADED_DISPATCH
+#define DISPATCH(handler) goto* kDispatchTable[handler];
+#define OPCODE(opcode) op_##opcode
+#define OPCODE_CB(opcode) op_cb_##opcode
+#define OPCODE_UNDEFINED op_undefined
+// Without debugging, tracing, and JIT, the next opcode can be dispatched without going through the main loop.
+#define NEXT_INSTR()                             \
+  AdvanceTime();                                 \
+  if (!threaded_dispatch)                        \
+    continue;                                    \
+  wait_ns_ = 0;                                  \
+  HandleInterrupts();                            \
+  handler = FetchOpcode();                       \
+  RecordInstr(instr_pc_, handler, instr_bytes_); \
+  goto* kDispatchTable[handler]
+#else
+#define DISPATCH(handler) switch (handler)
+#define OPCODE(opcode) case opcode
+#define OPCODE_CB(opcode) case 0x100 | opcode
+#define OPCODE_UNDEFINED default
+#define NEXT_INSTR() break
+#endif
+
 void Cpu::DoMachineCycle() {
+#ifdef CPU_THREADED_DISPATCH
+  static void* const kDispatchTable[512] = {
+      &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+      &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+      &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+      &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+      &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+      &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+      &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+      &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+      &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+      &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+      &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+      &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+      &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+      &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+      &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+      &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+      &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+      &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+      &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+      &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+      &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+      &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+      &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+      &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+      &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+      &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_undefined, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+      &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+      &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_undefined, &&op_0xDC, &&op_undefined, &&op_0xDE, &&op_0xDF,
+      &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_undefined, &&op_undefined, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+      &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_undefined, &&op_undefined, &&op_undefined, &&op_0xEE, &&op_0xEF,
+      &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_undefined, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+      &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_undefined, &&op_undefined, &&op_0xFE, &&op_0xFF,
+      // CB-prefixed opcodes.
+      &&op_cb_0x00, &&op_cb_0x01, &&op_cb_0x02, &&op_cb_0x03, &&op_cb_0x04, &&op_cb_0x05, &&op_cb_0x06, &&op_cb_0x07,
+      &&op_cb_0x08, &&op_cb_0x09, &&op_cb_0x0A, &&op_cb_0x0B, &&op_cb_0x0C, &&op_cb_0x0D, &&op_cb_0x0E, &&op_cb_0x0F,
+      &&op_cb_0x10, &&op_cb_0x11, &&op_cb_0x12, &&op_cb_0x13, &&op_cb_0x14, &&op_cb_0x15, &&op_cb_0x16, &&op_cb_0x17,
+      &&op_cb_0x18, &&op_cb_0x19, &&op_cb_0x1A, &&op_cb_0x1B, &&op_cb_0x1C, &&op_cb_0x1D, &&op_cb_0x1E, &&op_cb_0x1F,
+      &&op_cb_0x20, &&op_cb_0x21, &&op_cb_0x22, &&op_cb_0x23, &&op_cb_0x24, &&op_cb_0x25, &&op_cb_0x26, &&op_cb_0x27,
+      &&op_cb_0x28, &&op_cb_0x29, &&op_cb_0x2A, &&op_cb_0x2B, &&op_cb_0x2C, &&op_cb_0x2D, &&op_cb_0x2E, &&op_cb_0x2F,
+      &&op_cb_0x30, &&op_cb_0x31, &&op_cb_0x32, &&op_cb_0x33, &&op_cb_0x34, &&op_cb_0x35, &&op_cb_0x36, &&op_cb_0x37,
+      &&op_cb_0x38, &&op_cb_0x39, &&op_cb_0x3A, &&op_cb_0x3B, &&op_cb_0x3C, &&op_cb_0x3D, &&op_cb_0x3E, &&op_cb_0x3F,
+      &&op_cb_0x40, &&op_cb_0x41, &&op_cb_0x42, &&op_cb_0x43, &&op_cb_0x44, &&op_cb_0x45, &&op_cb_0x46, &&op_cb_0x47,
+      &&op_cb_0x48, &&op_cb_0x49, &&op_cb_0x4A, &&op_cb_0x4B, &&op_cb_0x4C, &&op_cb_0x4D, &&op_cb_0x4E, &&op_cb_0x4F,
+      &&op_cb_0x50, &&op_cb_0x51, &&op_cb_0x52, &&op_cb_0x53, &&op_cb_0x54, &&op_cb_0x55, &&op_cb_0x56, &&op_cb_0x57,
+      &&op_cb_0x58, &&op_cb_0x59, &&op_cb_0x5A, &&op_cb_0x5B, &&op_cb_0x5C, &&op_cb_0x5D, &&op_cb_0x5E, &&op_cb_0x5F,
+      &&op_cb_0x60, &&op_cb_0x61, &&op_cb_0x62, &&op_cb_0x63, &&op_cb_0x64, &&op_cb_0x65, &&op_cb_0x66, &&op_cb_0x67,
+      &&op_cb_0x68, &&op_cb_0x69, &&op_cb_0x6A, &&op_cb_0x6B, &&op_cb_0x6C, &&op_cb_0x6D, &&op_cb_0x6E, &&op_cb_0x6F,
+      &&op_cb_0x70, &&op_cb_0x71, &&op_cb_0x72, &&op_cb_0x73, &&op_cb_0x74, &&op_cb_0x75, &&op_cb_0x76, &&op_cb_0x77,
+      &&op_cb_0x78, &&op_cb_0x79, &&op_cb_0x7A, &&op_cb_0x7B, &&op_cb_0x7C, &&op_cb_0x7D, &&op_cb_0x7E, &&op_cb_0x7F,
+      &&op_cb_0x80, &&op_cb_0x81, &&op_cb_0x82, &&op_cb_0x83, &&op_cb_0x84, &&op_cb_0x85, &&op_cb_0x86, &&op_cb_0x87,
+      &&op_cb_0x88, &&op_cb_0x89, &&op_cb_0x8A, &&op_cb_0x8B, &&op_cb_0x8C, &&op_cb_0x8D, &&op_cb_0x8E, &&op_cb_0x8F,
+      &&op_cb_0x90, &&op_cb_0x91, &&op_cb_0x92, &&op_cb_0x93, &&op_cb_0x94, &&op_cb_0x95, &&op_cb_0x96, &&op_cb_0x97,
+      &&op_cb_0x98, &&op_cb_0x99, &&op_cb_0x9A, &&op_cb_0x9B, &&op_cb_0x9C, &&op_cb_0x9D, &&op_cb_0x9E, &&op_cb_0x9F,
+      &&op_cb_0xA0, &&op_cb_0xA1, &&op_cb_0xA2, &&op_cb_0xA3, &&op_cb_0xA4, &&op_cb_0xA5, &&op_cb_0xA6, &&op_cb_0xA7,
+      &&op_cb_0xA8, &&op_cb_0xA9, &&op_cb_0xAA, &&op_cb_0xAB, &&op_cb_0xAC, &&op_cb_0xAD, &&op_cb_0xAE, &&op_cb_0xAF,
+      &&op_cb_0xB0, &&op_cb_0xB1, &&op_cb_0xB2, &&op_cb_0xB3, &&op_cb_0xB4, &&op_cb_0xB5, &&op_cb_0xB6, &&op_cb_0xB7,
+      &&op_cb_0xB8, &&op_cb_0xB9, &&op_cb_0xBA, &&op_cb_0xBB, &&op_cb_0xBC, &&op_cb_0xBD, &&op_cb_0xBE, &&op_cb_0xBF,
+      &&op_cb_0xC0, &&op_cb_0xC1, &&op_cb_0xC2, &&op_cb_0xC3, &&op_cb_0xC4, &&op_cb_0xC5, &&op_cb_0xC6, &&op_cb_0xC7,
+      &&op_cb_0xC8, &&op_cb_0xC9, &&op_cb_0xCA, &&op_cb_0xCB, &&op_cb_0xCC, &&op_cb_0xCD, &&op_cb_0xCE, &&op_cb_0xCF,
+      &&op_cb_0xD0, &&op_cb_0xD1, &&op_cb_0xD2, &&op_cb_0xD3, &&op_cb_0xD4, &&op_cb_0xD5, &&op_cb_0xD6, &&op_cb_0xD7,
+      &&op_cb_0xD8, &&op_cb_0xD9, &&op_cb_0xDA, &&op_cb_0xDB, &&op_cb_0xDC, &&op_cb_0xDD, &&op_cb_0xDE, &&op_cb_0xDF,
+      &&op_cb_0xE0, &&op_cb_0xE1, &&op_cb_0xE2, &&op_cb_0xE3, &&op_cb_0xE4, &&op_cb_0xE5, &&op_cb_0xE6, &&op_cb_0xE7,
+      &&op_cb_0xE8, &&op_cb_0xE9, &&op_cb_0xEA, &&op_cb_0xEB, &&op_cb_0xEC, &&op_cb_0xED, &&op_cb_0xEE, &&op_cb_0xEF,
+      &&op_cb_0xF0, &&op_cb_0xF1, &&op_cb_0xF2, &&op_cb_0xF3, &&op_cb_0xF4, &&op_cb_0xF5, &&op_cb_0xF6, &&op_cb_0xF7,
+      &&op_cb_0xF8, &&op_cb_0xF9, &&op_cb_0xFA, &&op_cb_0xFB, &&op_cb_0xFC, &&op_cb_0xFD, &&op_cb_0xFE, &&op_cb_0xFF,
+  };
+  const bool threaded_dispatch = !attach_gdb_ && !single_step_ && (jit_ == nullptr) && (trace_writer == nullptr);
+#endif
+
   if (attach_gdb_) {
     std::cout << "waiting for gdb to attach on port " << gdb_port_ << "..." << std::endl;
     gdb_server.InitBlocking(gdb_port_);
@@ -38,2056 +139,2051 @@ void Cpu::DoMachineCycle() {
     HandleInterrupts();  // This disables IME and sets the PC in case of an interrupt.
 
     if (single_step_) {
+      UpdateFlags();
       const u64 cycles = (u64)(sc_core::sc_time_stamp().to_default_time_units() / gb_const::kNsPerMachineCycle);
-      for (const auto reg : reg_file) {
-        std::cout << std::format("{}:0x{:04x},", reg->name, reg->val());
+      for (size_t i = 0; i < kReg16Names.size(); ++i) {
+        std::cout << std::format("{}:0x{:04x},", kReg16Names[i], reg_file.Get(static_cast<Reg16>(i)));
       }
       std::cout << "c:" << cycles << std::endl;
     }
+    if (trace_writer != nullptr) [[unlikely]]
+      TraceInstr();
 
-    // Fetch.
-    u8 instr_byte = FetchNextInstrByte();
+    if (jit_ != nullptr && RunJit()) {
+      AdvanceTime();
+      continue;
+    }
 
-    // Decode & execute.
-    switch (instr_byte) {
-    case 0x00:
+    // Fetch & decode.
+    u16 handler = FetchOpcode();
+    RecordInstr(instr_pc_, handler, instr_bytes_);
+
+    // Execute.
+    DISPATCH(handler) {
+    OPCODE(0x00):
       DBG_LOG_INST("NOP");
       InstrNop();
-      break;
-    case 0x01:
+      NEXT_INSTR();
+    OPCODE(0x01):
       DBG_LOG_INST("LD BC,u16");
-      InstrLoadImm(reg_file.BC);
-      break;
-    case 0x02:
+      InstrLoadImm<Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0x02):
       DBG_LOG_INST("LD (BC),A");
-      InstrStore(reg_file.BC, reg_file.A);
-      break;
-    case 0x03:
+      InstrStore<Reg16::kBC, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x03):
       DBG_LOG_INST("INC BC");
-      InstrInc(reg_file.BC);
-      break;
-    case 0x04:
+      InstrInc<Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0x04):
       DBG_LOG_INST("INC B");
-      InstrInc(reg_file.B);
-      break;
-    case 0x05:
+      InstrInc<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x05):
       DBG_LOG_INST("DEC B");
-      InstrDec(reg_file.B);
-      break;
-    case 0x06:
+      InstrDec<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x06):
       DBG_LOG_INST("LD B,u8");
-      InstrLoadImm(reg_file.B);
-      break;
-    case 0x07:
+      InstrLoadImm<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x07):
       DBG_LOG_INST("RLCA");
       InstrRlca();
-      break;
-    case 0x08:
+      NEXT_INSTR();
+    OPCODE(0x08):
       DBG_LOG_INST("LD (a16),SP");
       InstrStoreSp();
-      break;
-    case 0x09:
+      NEXT_INSTR();
+    OPCODE(0x09):
       DBG_LOG_INST("ADD HL,BC");
-      InstrAddHl(reg_file.BC);
-      break;
-    case 0x0A:
+      InstrAddHl<Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0x0A):
       DBG_LOG_INST("LD A,(BC)");
-      InstrLoad(reg_file.A, reg_file.BC);
-      break;
-    case 0x0B:
+      InstrLoad<Reg8::kA, Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0x0B):
       DBG_LOG_INST("DEC BC");
-      InstrDec(reg_file.BC);
-      break;
-    case 0x0C:
+      InstrDec<Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0x0C):
       DBG_LOG_INST("INC C");
-      InstrInc(reg_file.C);
-      break;
-    case 0x0D:
+      InstrInc<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x0D):
       DBG_LOG_INST("DEC C");
-      InstrDec(reg_file.C);
-      break;
-    case 0x0E:
+      InstrDec<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x0E):
       DBG_LOG_INST("LD C,d8");
-      InstrLoadImm(reg_file.C);
-      break;
-    case 0x0F:
+      InstrLoadImm<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x0F):
       DBG_LOG_INST("RRCA");
       InstrRrca();
-      break;
-    case 0x10:
+      NEXT_INSTR();
+    OPCODE(0x10):
       DBG_LOG_INST("STOP 0");               // Halt CPU & LCD display until button pressed.
       DBG_LOG_INST("NOT IMPLEMENTED YET");  // TODO(niko): this is a special function
       throw std::runtime_error("Instruction 0x10 not implemented");
-      break;
-    case 0x11:
+      NEXT_INSTR();
+    OPCODE(0x11):
       DBG_LOG_INST("LD DE,d16");
-      InstrLoadImm(reg_file.DE);
-      break;
-    case 0x12:
+      InstrLoadImm<Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0x12):
       DBG_LOG_INST("LD (DE),A");
-      InstrStore(reg_file.DE, reg_file.A);
-      break;
-    case 0x13:
+      InstrStore<Reg16::kDE, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x13):
       DBG_LOG_INST("INC DE");
-      InstrInc(reg_file.DE);
-      break;
-    case 0x14:
+      InstrInc<Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0x14):
       DBG_LOG_INST("INC D");
-      InstrInc(reg_file.D);
-      break;
-    case 0x15:
+      InstrInc<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x15):
       DBG_LOG_INST("DEC D");
-      InstrDec(reg_file.D);
-      break;
-    case 0x16:
+      InstrDec<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x16):
       DBG_LOG_INST("LD D,d8");
-      InstrLoadImm(reg_file.D);
-      break;
-    case 0x17:
+      InstrLoadImm<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x17):
       DBG_LOG_INST("RLA");
       InstrRotLeftA();
-      break;
-    case 0x18:
+      NEXT_INSTR();
+    OPCODE(0x18):
       DBG_LOG_INST("JR r8");
       InstrJump();
-      break;
-    case 0x19:
+      NEXT_INSTR();
+    OPCODE(0x19):
       DBG_LOG_INST("ADD HL,DE");
-      InstrAddHl(reg_file.DE);
-      break;
-    case 0x1A:
+      InstrAddHl<Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0x1A):
       DBG_LOG_INST("LD A,(DE)");
-      InstrLoad(reg_file.A, reg_file.DE);
-      break;
-    case 0x1B:
+      InstrLoad<Reg8::kA, Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0x1B):
       DBG_LOG_INST("DEC DE");
-      InstrDec(reg_file.DE);
-      break;
-    case 0x1C:
+      InstrDec<Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0x1C):
       DBG_LOG_INST("INC E");
-      InstrInc(reg_file.E);
-      break;
-    case 0x1D:
+      InstrInc<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x1D):
       DBG_LOG_INST("DEC E");
-      InstrDec(reg_file.E);
-      break;
-    case 0x1E:
+      InstrDec<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x1E):
       DBG_LOG_INST("LD E,d8");
-      InstrLoadImm(reg_file.E);
-      break;
-    case 0x1F:
+      InstrLoadImm<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x1F):
       DBG_LOG_INST("RRA");
       InstrRra();
-      break;
-    case 0x20:
+      NEXT_INSTR();
+    OPCODE(0x20):
       DBG_LOG_INST("JR NZ, r8");
       InstrJumpIf(!GetFlagZ());
-      break;
-    case 0x21:
+      NEXT_INSTR();
+    OPCODE(0x21):
       DBG_LOG_INST("LD HL, d16");
-      InstrLoadImm(reg_file.HL);
-      break;
-    case 0x22:
+      InstrLoadImm<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x22):
       DBG_LOG_INST("LD (HL+), A");
-      InstrStoreInc(reg_file.HL, reg_file.A);
-      break;
-    case 0x23:
+      InstrStoreInc<Reg16::kHL>(reg_file.A);
+      NEXT_INSTR();
+    OPCODE(0x23):
       DBG_LOG_INST("INC HL");
-      InstrInc(reg_file.HL);
-      break;
-    case 0x24:
+      InstrInc<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x24):
       DBG_LOG_INST("INC H");
-      InstrInc(reg_file.H);
-      break;
-    case 0x25:
+      InstrInc<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x25):
       DBG_LOG_INST("DEC H");
-      InstrDec(reg_file.H);
-      break;
-    case 0x26:
+      InstrDec<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x26):
       DBG_LOG_INST("LD H,d8");
-      InstrLoadImm(reg_file.H);
-      break;
-    case 0x27:
+      InstrLoadImm<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x27):
       DBG_LOG_INST("DAA");
       InstrDAA();
-      break;
-    case 0x28:
+      NEXT_INSTR();
+    OPCODE(0x28):
       DBG_LOG_INST("JR Z,r8");
       InstrJumpIf(GetFlagZ());
-      break;
-    case 0x29:
+      NEXT_INSTR();
+    OPCODE(0x29):
       DBG_LOG_INST("ADD HL,HL");
-      InstrAddHl(reg_file.HL);
-      break;
-    case 0x2A:
+      InstrAddHl<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x2A):
       DBG_LOG_INST("LD A,(HL+)");
-      InstrLoadInc(reg_file.A, reg_file.HL);
-      break;
-    case 0x2B:
+      InstrLoadInc<Reg8::kA, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x2B):
       DBG_LOG_INST("DEC HL");
-      InstrDec(reg_file.HL);
-      break;
-    case 0x2C:
+      InstrDec<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x2C):
       DBG_LOG_INST("INC L");
-      InstrInc(reg_file.L);
-      break;
-    case 0x2D:
+      InstrInc<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x2D):
       DBG_LOG_INST("DEC L");
-      InstrDec(reg_file.L);
-      break;
-    case 0x2E:
+      InstrDec<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x2E):
       DBG_LOG_INST("LD L,D8");
-      InstrLoadImm(reg_file.L);
-      break;
-    case 0x2F:
+      InstrLoadImm<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x2F):
       DBG_LOG_INST("CPL");
       InstrComplement();
-      break;
-    case 0x30:
+      NEXT_INSTR();
+    OPCODE(0x30):
       DBG_LOG_INST("JR NC,r8");
       InstrJumpIf(!GetFlagC());
-      break;
-    case 0x31:
+      NEXT_INSTR();
+    OPCODE(0x31):
       DBG_LOG_INST("LD SP,d16");
-      InstrLoadImm(reg_file.SP);
-      break;
-    case 0x32:
+      InstrLoadImm<Reg16::kSP>();
+      NEXT_INSTR();
+    OPCODE(0x32):
       DBG_LOG_INST("LD (HL-), A");
-      InstrStoreDec(reg_file.HL, reg_file.A);
-      break;
-    case 0x33:
+      InstrStoreDec<Reg16::kHL>(reg_file.A);
+      NEXT_INSTR();
+    OPCODE(0x33):
       DBG_LOG_INST("INC SP");
-      InstrInc(reg_file.SP);
-      break;
-    case 0x34:
+      InstrInc<Reg16::kSP>();
+      NEXT_INSTR();
+    OPCODE(0x34):
       DBG_LOG_INST("INC (HL)");
-      InstrIncAddr(reg_file.HL);
-      break;
-    case 0x35:
+      InstrIncAddr<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x35):
       DBG_LOG_INST("INC (HL)");
-      InstrDecAddr(reg_file.HL);
-      break;
-    case 0x36:
+      InstrDecAddr<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x36):
       DBG_LOG_INST("LD (HL),d8");
-      InstrStoreImm(reg_file.HL);
-      break;
-    case 0x37:
+      InstrStoreImm<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x37):
       DBG_LOG_INST("SCF");
       InstrSCF();
-      break;
-    case 0x38:
+      NEXT_INSTR();
+    OPCODE(0x38):
       DBG_LOG_INST("JR C,r8");
       InstrJumpIf(GetFlagC());
-      break;
-    case 0x39:
+      NEXT_INSTR();
+    OPCODE(0x39):
       DBG_LOG_INST("ADD HL,SO");
-      InstrAddHl(reg_file.SP);
-      break;
-    case 0x3A:
+      InstrAddHl<Reg16::kSP>();
+      NEXT_INSTR();
+    OPCODE(0x3A):
       DBG_LOG_INST("LD A,(HL-)");
-      InstrLoadDec(reg_file.HL, reg_file.A);
-      break;
-    case 0x3B:
+      InstrLoadDec<Reg16::kHL, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x3B):
       DBG_LOG_INST("DEC SP");
-      InstrDec(reg_file.SP);
-      break;
-    case 0x3C:
+      InstrDec<Reg16::kSP>();
+      NEXT_INSTR();
+    OPCODE(0x3C):
       DBG_LOG_INST("INC A");
-      InstrInc(reg_file.A);
-      break;
-    case 0x3D:
+      InstrInc<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x3D):
       DBG_LOG_INST("DEC A");
-      InstrDec(reg_file.A);
-      break;
-    case 0x3E:
+      InstrDec<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x3E):
       DBG_LOG_INST("LD A,d8");
-      InstrLoadImm(reg_file.A);
-      break;
-    case 0x3F:
+      InstrLoadImm<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x3F):
       DBG_LOG_INST("CCF");
       InstrCCF();
-      break;
-    case 0x40:
+      NEXT_INSTR();
+    OPCODE(0x40):
       DBG_LOG_INST("LD B,B");
-      InstrMov(reg_file.B, reg_file.B);
-      break;
-    case 0x41:
+      InstrMov<Reg8::kB, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x41):
       DBG_LOG_INST("LD B,C");
-      InstrMov(reg_file.B, reg_file.C);
-      break;
-    case 0x42:
+      InstrMov<Reg8::kB, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x42):
       DBG_LOG_INST("LD B,D");
-      InstrMov(reg_file.B, reg_file.D);
-      break;
-    case 0x43:
+      InstrMov<Reg8::kB, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x43):
       DBG_LOG_INST("LD B,E");
-      InstrMov(reg_file.B, reg_file.E);
-      break;
-    case 0x44:
+      InstrMov<Reg8::kB, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x44):
       DBG_LOG_INST("LD B,H");
-      InstrMov(reg_file.B, reg_file.H);
-      break;
-    case 0x45:
+      InstrMov<Reg8::kB, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x45):
       DBG_LOG_INST("LD B,L");
-      InstrMov(reg_file.B, reg_file.L);
-      break;
-    case 0x46:
+      InstrMov<Reg8::kB, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x46):
       DBG_LOG_INST("LD B,(HL)");
-      InstrLoad(reg_file.B, reg_file.HL);
-      break;
-    case 0x47:
+      InstrLoad<Reg8::kB, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x47):
       DBG_LOG_INST("LD B,L");
-      InstrMov(reg_file.B, reg_file.A);
-      break;
-    case 0x48:
+      InstrMov<Reg8::kB, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x48):
       DBG_LOG_INST("LD C,B");
-      InstrMov(reg_file.C, reg_file.B);
-      break;
-    case 0x49:
+      InstrMov<Reg8::kC, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x49):
       DBG_LOG_INST("LD C,C");
-      InstrMov(reg_file.C, reg_file.C);
-      break;
-    case 0x4A:
+      InstrMov<Reg8::kC, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x4A):
       DBG_LOG_INST("LD C,D");
-      InstrMov(reg_file.C, reg_file.D);
-      break;
-    case 0x4B:
+      InstrMov<Reg8::kC, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x4B):
       DBG_LOG_INST("LD C,E");
-      InstrMov(reg_file.C, reg_file.E);
-      break;
-    case 0x4C:
+      InstrMov<Reg8::kC, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x4C):
       DBG_LOG_INST("LD C,H");
-      InstrMov(reg_file.C, reg_file.H);
-      break;
-    case 0x4D:
+      InstrMov<Reg8::kC, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x4D):
       DBG_LOG_INST("LD C,L");
-      InstrMov(reg_file.C, reg_file.L);
-      break;
-    case 0x4E:
+      InstrMov<Reg8::kC, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x4E):
       DBG_LOG_INST("LD C,(HL)");
-      InstrLoad(reg_file.C, reg_file.HL);
-      break;
-    case 0x4F:
+      InstrLoad<Reg8::kC, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x4F):
       DBG_LOG_INST("LD C,A");
-      InstrMov(reg_file.C, reg_file.A);
-      break;
-    case 0x50:
+      InstrMov<Reg8::kC, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x50):
       DBG_LOG_INST("LD D,B");
-      InstrMov(reg_file.D, reg_file.B);
-      break;
-    case 0x51:
+      InstrMov<Reg8::kD, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x51):
       DBG_LOG_INST("LD D,C");
-      InstrMov(reg_file.D, reg_file.C);
-      break;
-    case 0x52:
+      InstrMov<Reg8::kD, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x52):
       DBG_LOG_INST("LD D,D");
-      InstrMov(reg_file.D, reg_file.D);
-      break;
-    case 0x53:
+      InstrMov<Reg8::kD, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x53):
       DBG_LOG_INST("LD D,E");
-      InstrMov(reg_file.D, reg_file.E);
-      break;
-    case 0x54:
+      InstrMov<Reg8::kD, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x54):
       DBG_LOG_INST("LD D,H");
-      InstrMov(reg_file.D, reg_file.H);
-      break;
-    case 0x55:
+      InstrMov<Reg8::kD, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x55):
       DBG_LOG_INST("LD D,L");
-      InstrMov(reg_file.D, reg_file.L);
-      break;
-    case 0x56:
+      InstrMov<Reg8::kD, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x56):
       DBG_LOG_INST("LD D,(HL)");
-      InstrLoad(reg_file.D, reg_file.HL);
-      break;
-    case 0x57:
+      InstrLoad<Reg8::kD, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x57):
       DBG_LOG_INST("LD D,A");
-      InstrMov(reg_file.D, reg_file.A);
-      break;
-    case 0x58:
+      InstrMov<Reg8::kD, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x58):
       DBG_LOG_INST("LD E,B");
-      InstrMov(reg_file.E, reg_file.B);
-      break;
-    case 0x59:
+      InstrMov<Reg8::kE, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x59):
       DBG_LOG_INST("LD E,C");
-      InstrMov(reg_file.E, reg_file.C);
-      break;
-    case 0x5A:
+      InstrMov<Reg8::kE, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x5A):
       DBG_LOG_INST("LD E,D");
-      InstrMov(reg_file.E, reg_file.D);
-      break;
-    case 0x5B:
+      InstrMov<Reg8::kE, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x5B):
       DBG_LOG_INST("LD E,E");
-      InstrMov(reg_file.E, reg_file.E);
-      break;
-    case 0x5C:
+      InstrMov<Reg8::kE, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x5C):
       DBG_LOG_INST("LD E,H");
-      InstrMov(reg_file.E, reg_file.H);
-      break;
-    case 0x5D:
+      InstrMov<Reg8::kE, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x5D):
       DBG_LOG_INST("LD E,L");
-      InstrMov(reg_file.E, reg_file.L);
-      break;
-    case 0x5E:
+      InstrMov<Reg8::kE, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x5E):
       DBG_LOG_INST("LD E,(HL)");
-      InstrLoad(reg_file.E, reg_file.HL);
-      break;
-    case 0x5F:
+      InstrLoad<Reg8::kE, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x5F):
       DBG_LOG_INST("LD E,A");
-      InstrMov(reg_file.E, reg_file.A);
-      break;
-    case 0x60:
+      InstrMov<Reg8::kE, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x60):
       DBG_LOG_INST("LD H,B");
-      InstrMov(reg_file.H, reg_file.B);
-      break;
-    case 0x61:
+      InstrMov<Reg8::kH, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x61):
       DBG_LOG_INST("LD H,C");
-      InstrMov(reg_file.H, reg_file.C);
-      break;
-    case 0x62:
+      InstrMov<Reg8::kH, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x62):
       DBG_LOG_INST("LD H,D");
-      InstrMov(reg_file.H, reg_file.D);
-      break;
-    case 0x63:
+      InstrMov<Reg8::kH, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x63):
       DBG_LOG_INST("LD H,E");
-      InstrMov(reg_file.H, reg_file.E);
-      break;
-    case 0x64:
+      InstrMov<Reg8::kH, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x64):
       DBG_LOG_INST("LD H,H");
-      InstrMov(reg_file.H, reg_file.H);
-      break;
-    case 0x65:
+      InstrMov<Reg8::kH, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x65):
       DBG_LOG_INST("LD H,L");
-      InstrMov(reg_file.H, reg_file.L);
-      break;
-    case 0x66:
+      InstrMov<Reg8::kH, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x66):
       DBG_LOG_INST("LD H,(HL)");
-      InstrLoad(reg_file.H, reg_file.HL);
-      break;
-    case 0x67:
+      InstrLoad<Reg8::kH, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x67):
       DBG_LOG_INST("LD H,A");
-      InstrMov(reg_file.H, reg_file.A);
-      break;
-    case 0x68:
+      InstrMov<Reg8::kH, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x68):
       DBG_LOG_INST("LD L,B");
-      InstrMov(reg_file.L, reg_file.B);
-      break;
-    case 0x69:
+      InstrMov<Reg8::kL, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x69):
       DBG_LOG_INST("LD L,C");
-      InstrMov(reg_file.L, reg_file.C);
-      break;
-    case 0x6A:
+      InstrMov<Reg8::kL, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x6A):
       DBG_LOG_INST("LD L,D");
-      InstrMov(reg_file.L, reg_file.D);
-      break;
-    case 0x6B:
+      InstrMov<Reg8::kL, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x6B):
       DBG_LOG_INST("LD L,E");
-      InstrMov(reg_file.L, reg_file.E);
-      break;
-    case 0x6C:
+      InstrMov<Reg8::kL, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x6C):
       DBG_LOG_INST("LD L,H");
-      InstrMov(reg_file.L, reg_file.H);
-      break;
-    case 0x6D:
+      InstrMov<Reg8::kL, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x6D):
       DBG_LOG_INST("LD L,L");
-      InstrMov(reg_file.L, reg_file.L);
-      break;
-    case 0x6E:
+      InstrMov<Reg8::kL, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x6E):
       DBG_LOG_INST("LD L,(HL)");
-      InstrLoad(reg_file.L, reg_file.HL);
-      break;
-    case 0x6F:
+      InstrLoad<Reg8::kL, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x6F):
       DBG_LOG_INST("LD L,A");
-      InstrMov(reg_file.L, reg_file.A);
-      break;
-    case 0x70:
+      InstrMov<Reg8::kL, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x70):
       DBG_LOG_INST("LD (HL),B");
-      InstrStore(reg_file.HL, reg_file.B);
-      break;
-    case 0x71:
+      InstrStore<Reg16::kHL, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x71):
       DBG_LOG_INST("LD (HL),C");
-      InstrStore(reg_file.HL, reg_file.C);
-      break;
-    case 0x72:
+      InstrStore<Reg16::kHL, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x72):
       DBG_LOG_INST("LD (HL),D");
-      InstrStore(reg_file.HL, reg_file.D);
-      break;
-    case 0x73:
+      InstrStore<Reg16::kHL, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x73):
       DBG_LOG_INST("LD (HL),E");
-      InstrStore(reg_file.HL, reg_file.E);
-      break;
-    case 0x74:
+      InstrStore<Reg16::kHL, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x74):
       DBG_LOG_INST("LD (HL),H");
-      InstrStore(reg_file.HL, reg_file.H);
-      break;
-    case 0x75:
+      InstrStore<Reg16::kHL, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x75):
       DBG_LOG_INST("LD (HL),L");
-      InstrStore(reg_file.HL, reg_file.L);
-      break;
-    case 0x76:
+      InstrStore<Reg16::kHL, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x76):
       DBG_LOG_INST("HALT");
       InstrHalt();
-      break;
-    case 0x77:
+      NEXT_INSTR();
+    OPCODE(0x77):
       DBG_LOG_INST("LD (HL),A");
-      InstrStore(reg_file.HL, reg_file.A);
-      break;
-    case 0x78:
+      InstrStore<Reg16::kHL, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x78):
       DBG_LOG_INST("LD A,B");
-      InstrMov(reg_file.A, reg_file.B);
-      break;
-    case 0x79:
+      InstrMov<Reg8::kA, Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x79):
       DBG_LOG_INST("LD A,C");
-      InstrMov(reg_file.A, reg_file.C);
-      break;
-    case 0x7A:
+      InstrMov<Reg8::kA, Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x7A):
       DBG_LOG_INST("LD A,D");
-      InstrMov(reg_file.A, reg_file.D);
-      break;
-    case 0x7B:
+      InstrMov<Reg8::kA, Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x7B):
       DBG_LOG_INST("LD A,E");
-      InstrMov(reg_file.A, reg_file.E);
-      break;
-    case 0x7C:
+      InstrMov<Reg8::kA, Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x7C):
       DBG_LOG_INST("LD A,H");
-      InstrMov(reg_file.A, reg_file.H);
-      break;
-    case 0x7D:
+      InstrMov<Reg8::kA, Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x7D):
       DBG_LOG_INST("LD A,L");
-      InstrMov(reg_file.A, reg_file.L);
-      break;
-    case 0x7E:
+      InstrMov<Reg8::kA, Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x7E):
       DBG_LOG_INST("LD A,(HL)");
-      InstrLoad(reg_file.A, reg_file.HL);
-      break;
-    case 0x7F:
+      InstrLoad<Reg8::kA, Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x7F):
       DBG_LOG_INST("LD A,A");
-      InstrMov(reg_file.A, reg_file.A);
-      break;
-    case 0x80:
+      InstrMov<Reg8::kA, Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x80):
       DBG_LOG_INST("ADD A,B");
-      InstrAddA(reg_file.B);
-      break;
-    case 0x81:
+      InstrAddA<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x81):
       DBG_LOG_INST("ADD A,C");
-      InstrAddA(reg_file.C);
-      break;
-    case 0x82:
+      InstrAddA<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x82):
       DBG_LOG_INST("ADD A,D");
-      InstrAddA(reg_file.D);
-      break;
-    case 0x83:
+      InstrAddA<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x83):
       DBG_LOG_INST("ADD A,E");
-      InstrAddA(reg_file.E);
-      break;
-    case 0x84:
+      InstrAddA<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x84):
       DBG_LOG_INST("ADD A,H");
-      InstrAddA(reg_file.H);
-      break;
-    case 0x85:
+      InstrAddA<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x85):
       DBG_LOG_INST("ADD A,L");
-      InstrAddA(reg_file.L);
-      break;
-    case 0x86:
+      InstrAddA<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x86):
       DBG_LOG_INST("ADD A,(HL)");
-      InstrAddA(reg_file.HL);
-      break;
-    case 0x87:
+      InstrAddA<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x87):
       DBG_LOG_INST("ADD A,A");
-      InstrAddA(reg_file.A);
-      break;
-    case 0x88:
+      InstrAddA<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x88):
       DBG_LOG_INST("ADC A,B");
-      InstrAddACarry(reg_file.B);
-      break;
-    case 0x89:
+      InstrAddACarry<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x89):
       DBG_LOG_INST("ADC A,C");
-      InstrAddACarry(reg_file.C);
-      break;
-    case 0x8A:
+      InstrAddACarry<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x8A):
       DBG_LOG_INST("ADC A,D");
-      InstrAddACarry(reg_file.D);
-      break;
-    case 0x8B:
+      InstrAddACarry<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x8B):
       DBG_LOG_INST("ADC A,E");
-      InstrAddACarry(reg_file.E);
-      break;
-    case 0x8C:
+      InstrAddACarry<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x8C):
       DBG_LOG_INST("ADC A,H");
-      InstrAddACarry(reg_file.H);
-      break;
-    case 0x8D:
+      InstrAddACarry<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x8D):
       DBG_LOG_INST("ADC A,L");
-      InstrAddACarry(reg_file.L);
-      break;
-    case 0x8E:
+      InstrAddACarry<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x8E):
       DBG_LOG_INST("ADC A,(HL)");
-      InstrAddACarry(reg_file.HL);
-      break;
-    case 0x8F:
+      InstrAddACarry<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x8F):
       DBG_LOG_INST("ADC A,A");
-      InstrAddACarry(reg_file.A);
-      break;
-    case 0x90:
+      InstrAddACarry<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x90):
       DBG_LOG_INST("SUB B");
-      InstrSub(reg_file.B);
-      break;
-    case 0x91:
+      InstrSub<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x91):
       DBG_LOG_INST("SUB C");
-      InstrSub(reg_file.C);
-      break;
-    case 0x92:
+      InstrSub<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x92):
       DBG_LOG_INST("SUB D");
-      InstrSub(reg_file.D);
-      break;
-    case 0x93:
+      InstrSub<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x93):
       DBG_LOG_INST("SUB E");
-      InstrSub(reg_file.E);
-      break;
-    case 0x94:
+      InstrSub<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x94):
       DBG_LOG_INST("SUB H");
-      InstrSub(reg_file.H);
-      break;
-    case 0x95:
+      InstrSub<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x95):
       DBG_LOG_INST("SUB L");
-      InstrSub(reg_file.L);
-      break;
-    case 0x96:
+      InstrSub<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x96):
       DBG_LOG_INST("SUB (HL)");
-      InstrSub(reg_file.HL);
-      break;
-    case 0x97:
+      InstrSub<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x97):
       DBG_LOG_INST("SUB A");
-      InstrSub(reg_file.A);
-      break;
-    case 0x98:
+      InstrSub<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0x98):
       DBG_LOG_INST("SBC A,B");
-      InstrSubCarry(reg_file.B);
-      break;
-    case 0x99:
+      InstrSubCarry<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0x99):
       DBG_LOG_INST("SBC A,C");
-      InstrSubCarry(reg_file.C);
-      break;
-    case 0x9A:
+      InstrSubCarry<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0x9A):
       DBG_LOG_INST("SBC A,D");
-      InstrSubCarry(reg_file.D);
-      break;
-    case 0x9B:
+      InstrSubCarry<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0x9B):
       DBG_LOG_INST("SBC A,E");
-      InstrSubCarry(reg_file.E);
-      break;
-    case 0x9C:
+      InstrSubCarry<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0x9C):
       DBG_LOG_INST("SBC A,H");
-      InstrSubCarry(reg_file.H);
-      break;
-    case 0x9D:
+      InstrSubCarry<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0x9D):
       DBG_LOG_INST("SBC A,L");
-      InstrSubCarry(reg_file.L);
-      break;
-    case 0x9E:
+      InstrSubCarry<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0x9E):
       DBG_LOG_INST("SBC A,(HL)");
-      InstrSubCarry(reg_file.HL);
-      break;
-    case 0x9F:
+      InstrSubCarry<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0x9F):
       DBG_LOG_INST("SBC A,A");
-      InstrSubCarry(reg_file.A);
-      break;
-    case 0xA0:
+      InstrSubCarry<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xA0):
       DBG_LOG_INST("AND B");
-      InstrAnd(reg_file.B);
-      break;
-    case 0xA1:
+      InstrAnd<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0xA1):
       DBG_LOG_INST("AND C");
-      InstrAnd(reg_file.C);
-      break;
-    case 0xA2:
+      InstrAnd<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0xA2):
       DBG_LOG_INST("AND D");
-      InstrAnd(reg_file.D);
-      break;
-    case 0xA3:
+      InstrAnd<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0xA3):
       DBG_LOG_INST("AND E");
-      InstrAnd(reg_file.E);
-      break;
-    case 0xA4:
+      InstrAnd<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0xA4):
       DBG_LOG_INST("AND H");
-      InstrAnd(reg_file.H);
-      break;
-    case 0xA5:
+      InstrAnd<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0xA5):
       DBG_LOG_INST("AND L");
-      InstrAnd(reg_file.L);
-      break;
-    case 0xA6:
+      InstrAnd<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0xA6):
       DBG_LOG_INST("AND (HL)");
-      InstrAnd(reg_file.HL);
-      break;
-    case 0xA7:
+      InstrAnd<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xA7):
       DBG_LOG_INST("AND A");
-      InstrAnd(reg_file.A);
-      break;
-    case 0xA8:
+      InstrAnd<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xA8):
       DBG_LOG_INST("XOR B");
-      InstrXor(reg_file.B);
-      break;
-    case 0xA9:
+      InstrXor<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0xA9):
       DBG_LOG_INST("XOR C");
-      InstrXor(reg_file.C);
-      break;
-    case 0xAA:
+      InstrXor<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0xAA):
       DBG_LOG_INST("XOR D");
-      InstrXor(reg_file.D);
-      break;
-    case 0xAB:
+      InstrXor<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0xAB):
       DBG_LOG_INST("XOR E");
-      InstrXor(reg_file.E);
-      break;
-    case 0xAC:
+      InstrXor<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0xAC):
       DBG_LOG_INST("XOR H");
-      InstrXor(reg_file.H);
-      break;
-    case 0xAD:
+      InstrXor<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0xAD):
       DBG_LOG_INST("XOR L");
-      InstrXor(reg_file.L);
-      break;
-    case 0xAE:
+      InstrXor<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0xAE):
       DBG_LOG_INST("XOR (HL)");
-      InstrXor(reg_file.HL);
-      break;
-    case 0xAF:
+      InstrXor<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xAF):
       DBG_LOG_INST("XOR A");
-      InstrXor(reg_file.A);
-      break;
-    case 0xB0:
+      InstrXor<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xB0):
       DBG_LOG_INST("OR B");
-      InstrOr(reg_file.B);
-      break;
-    case 0xB1:
+      InstrOr<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0xB1):
       DBG_LOG_INST("OR C");
-      InstrOr(reg_file.C);
-      break;
-    case 0xB2:
+      InstrOr<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0xB2):
       DBG_LOG_INST("OR D");
-      InstrOr(reg_file.D);
-      break;
-    case 0xB3:
+      InstrOr<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0xB3):
       DBG_LOG_INST("OR E");
-      InstrOr(reg_file.E);
-      break;
-    case 0xB4:
+      InstrOr<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0xB4):
       DBG_LOG_INST("OR H");
-      InstrOr(reg_file.H);
-      break;
-    case 0xB5:
+      InstrOr<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0xB5):
       DBG_LOG_INST("OR L");
-      InstrOr(reg_file.L);
-      break;
-    case 0xB6:
+      InstrOr<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0xB6):
       DBG_LOG_INST("OR (HL)");
-      InstrOr(reg_file.HL);
-      break;
-    case 0xB7:
+      InstrOr<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xB7):
       DBG_LOG_INST("OR A");
-      InstrOr(reg_file.A);
-      break;
-    case 0xB8:
+      InstrOr<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xB8):
       DBG_LOG_INST("CP B");
-      InstrComp(reg_file.B);
-      break;
-    case 0xB9:
+      InstrComp<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE(0xB9):
       DBG_LOG_INST("CP C");
-      InstrComp(reg_file.C);
-      break;
-    case 0xBA:
+      InstrComp<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE(0xBA):
       DBG_LOG_INST("CP D");
-      InstrComp(reg_file.D);
-      break;
-    case 0xBB:
+      InstrComp<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE(0xBB):
       DBG_LOG_INST("CP E");
-      InstrComp(reg_file.E);
-      break;
-    case 0xBC:
+      InstrComp<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE(0xBC):
       DBG_LOG_INST("CP H");
-      InstrComp(reg_file.H);
-      break;
-    case 0xBD:
+      InstrComp<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE(0xBD):
       DBG_LOG_INST("CP L");
-      InstrComp(reg_file.L);
-      break;
-    case 0xBE:
+      InstrComp<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE(0xBE):
       DBG_LOG_INST("CP (HL)");
-      InstrComp(reg_file.HL);
-      break;
-    case 0xBF:
+      InstrComp<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xBF):
       DBG_LOG_INST("CP A");
-      InstrComp(reg_file.A);
-      break;
-    case 0xC0:
+      InstrComp<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xC0):
       DBG_LOG_INST("RET NZ");
       InstrRetIf(!GetFlagZ());
-      break;
-    case 0xC1:
+      NEXT_INSTR();
+    OPCODE(0xC1):
       DBG_LOG_INST("POP BC");
-      InstrPop(reg_file.BC);
-      break;
-    case 0xC2:
+      InstrPop<Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0xC2):
       DBG_LOG_INST("JP NZ,a16");
       InstrJumpAddrIf(!GetFlagZ());
-      break;
-    case 0xC3:
+      NEXT_INSTR();
+    OPCODE(0xC3):
       DBG_LOG_INST("JP a16");
       InstrJumpAddr();
-      break;
-    case 0xC4:
+      NEXT_INSTR();
+    OPCODE(0xC4):
       DBG_LOG_INST("Call NZ,a16");
       InstrCallIf(!GetFlagZ());
-      break;
-    case 0xC5:
+      NEXT_INSTR();
+    OPCODE(0xC5):
       DBG_LOG_INST("PUSH BC");
-      InstrPush(reg_file.BC);
-      break;
-    case 0xC6:
+      InstrPush<Reg16::kBC>();
+      NEXT_INSTR();
+    OPCODE(0xC6):
       DBG_LOG_INST("ADD A, d8");
       InstrAddAImm();
-      break;
-    case 0xC7:
+      NEXT_INSTR();
+    OPCODE(0xC7):
       DBG_LOG_INST("RST 00H");
       InstrRST(0x00);
-      break;
-    case 0xC8:
+      NEXT_INSTR();
+    OPCODE(0xC8):
       DBG_LOG_INST("RET Z");
       InstrRetIf(GetFlagZ());
-      break;
-    case 0xC9:
+      NEXT_INSTR();
+    OPCODE(0xC9):
       DBG_LOG_INST("RET");
       InstrRet();
-      break;
-    case 0xCA:
+      NEXT_INSTR();
+    OPCODE(0xCA):
       DBG_LOG_INST("JP Z,a16");
       InstrJumpAddrIf(GetFlagZ());
-      break;
-    case 0xCC:
+      NEXT_INSTR();
+    OPCODE(0xCC):
       DBG_LOG_INST("Call z,a16");
       InstrCallIf(GetFlagZ());
-      break;
-    case 0xCD:
+      NEXT_INSTR();
+    OPCODE(0xCD):
       DBG_LOG_INST("Call a16");
       InstrCall();
-      break;
-    case 0xCE:
+      NEXT_INSTR();
+    OPCODE(0xCE):
       DBG_LOG_INST("ADC A,d8");
       InstrAddACarryImm();
-      break;
-    case 0xCF:
+      NEXT_INSTR();
+    OPCODE(0xCF):
       DBG_LOG_INST("RST 08H");
       InstrRST(0x08);
-      break;
-    case 0xD0:
+      NEXT_INSTR();
+    OPCODE(0xD0):
       DBG_LOG_INST("RET NC");
       InstrRetIf(!GetFlagC());
-      break;
-    case 0xD1:
+      NEXT_INSTR();
+    OPCODE(0xD1):
       DBG_LOG_INST("POP DE");
-      InstrPop(reg_file.DE);
-      break;
-    case 0xD2:
+      InstrPop<Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0xD2):
       DBG_LOG_INST("JP NC, a16");
       InstrJumpAddrIf(!GetFlagC());
-      break;
-    case 0xD3:
+      NEXT_INSTR();
+    OPCODE(0xD3):
       DBG_LOG_INST("STOP SIM");  // Special instruction.
       InstrEmu();
-      break;
-    case 0xD4:
+      NEXT_INSTR();
+    OPCODE(0xD4):
       DBG_LOG_INST("CALL NC,a16");
       InstrCallIf(!GetFlagC());
-      break;
-    case 0xD5:
+      NEXT_INSTR();
+    OPCODE(0xD5):
       DBG_LOG_INST("PUSH DE");
-      InstrPush(reg_file.DE);
-      break;
-    case 0xD6:
+      InstrPush<Reg16::kDE>();
+      NEXT_INSTR();
+    OPCODE(0xD6):
       DBG_LOG_INST("SUB (d8)");
       InstrSubImm();
-      break;
-    case 0xD7:
+      NEXT_INSTR();
+    OPCODE(0xD7):
       DBG_LOG_INST("RST 10H");
       InstrRST(0x10);
-      break;
-    case 0xD8:
+      NEXT_INSTR();
+    OPCODE(0xD8):
       DBG_LOG_INST("RET C");
       InstrRetIf(GetFlagC());
-      break;
-    case 0xD9:
+      NEXT_INSTR();
+    OPCODE(0xD9):
       DBG_LOG_INST("RETI");
       InstrRetI();
-      break;
-    case 0xDA:
+      NEXT_INSTR();
+    OPCODE(0xDA):
       DBG_LOG_INST("JP C,a16");
       InstrJumpAddrIf(GetFlagC());
-      break;
+      NEXT_INSTR();
     // case 0xDB: Not implemented!
-    case 0xDC:
+    OPCODE(0xDC):
       DBG_LOG_INST("CALL C,a16");
       InstrCallIf(GetFlagC());
-      break;
+      NEXT_INSTR();
     // case 0xDD: Not implemented!
-    case 0xDE:
+    OPCODE(0xDE):
       DBG_LOG_INST("SBC A, d8");
       InstrSubCarryImm();
-      break;
-    case 0xDF:
+      NEXT_INSTR();
+    OPCODE(0xDF):
       DBG_LOG_INST("RST 18H");
       InstrRST(0x18);
-      break;
-    case 0xE0:
+      NEXT_INSTR();
+    OPCODE(0xE0):
       DBG_LOG_INST("LDH (a8), A");
-      InstrStoreH(reg_file.A);
-      break;
-    case 0xE1:
+      InstrStoreH<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xE1):
       DBG_LOG_INST("POP HL");
-      InstrPop(reg_file.HL);
-      break;
-    case 0xE2:
+      InstrPop<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xE2):
       DBG_LOG_INST("LD (C), A");
-      InstrStore(reg_file.C.val(), reg_file.A);
-      break;
+      InstrStore<Reg8::kA>(reg_file.C);
+      NEXT_INSTR();
     // case 0xE3: This one is not implemented!
     // case 0xE4: This one is not implemented!
-    case 0xE5:
+    OPCODE(0xE5):
       DBG_LOG_INST("PUSH HL");
-      InstrPush(reg_file.HL);
-      break;
-    case 0xE6:
+      InstrPush<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xE6):
       DBG_LOG_INST("AND d8");
       InstrAndImm();
-      break;
-    case 0xE7:
+      NEXT_INSTR();
+    OPCODE(0xE7):
       DBG_LOG_INST("RST 20H");
       InstrRST(0x20);
-      break;
-    case 0xE8:
+      NEXT_INSTR();
+    OPCODE(0xE8):
       DBG_LOG_INST("ADD SP, r8");
       InstrAddSp();
-      break;
-    case 0xE9:
+      NEXT_INSTR();
+    OPCODE(0xE9):
       DBG_LOG_INST("JP (HL)");
-      InstrJump(reg_file.HL);
-      break;
-    case 0xEA:
+      InstrJump<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE(0xEA):
       DBG_LOG_INST("LD (a16), A");
-      InstrStore(reg_file.A);
-      break;
+      InstrStore<Reg8::kA>();
+      NEXT_INSTR();
     // case 0xEB: Not implemented!
     // case 0xEC: Not implemented!
     // case 0xED: Not implemented!
-    case 0xEE:
+    OPCODE(0xEE):
       DBG_LOG_INST("XOR d8");
       InstrXorImm();
-      break;
-    case 0xEF:
+      NEXT_INSTR();
+    OPCODE(0xEF):
       DBG_LOG_INST("RST 28H");
       InstrRST(0x28);
-      break;
-    case 0xF0:
+      NEXT_INSTR();
+    OPCODE(0xF0):
       DBG_LOG_INST("LDH A,(a8)");
-      InstrLoadH(reg_file.A);
-      break;
-    case 0xF1:
+      InstrLoadH<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE(0xF1):
       DBG_LOG_INST("POP AF");
-      InstrPop(reg_file.AF);
-      break;
-    case 0xF2:
+      InstrPopAF();
+      NEXT_INSTR();
+    OPCODE(0xF2):
       DBG_LOG_INST("LD A,(C)");
       InstrLoadC();
-      break;
-    case 0xF3:
+      NEXT_INSTR();
+    OPCODE(0xF3):
       DBG_LOG_INST("DI");
       InstrDI();
-      break;
+      NEXT_INSTR();
     // case 0xF4: This one is not implemented!
-    case 0xF5:
+    OPCODE(0xF5):
       DBG_LOG_INST("PUSH AF");  // Note: AF is not writable!
-      InstrPush(reg_file.AF);
-      break;
-    case 0xF6:
+      InstrPushAF();
+      NEXT_INSTR();
+    OPCODE(0xF6):
       DBG_LOG_INST("OR d8");
       InstrOrImm();
-      break;
-    case 0xF7:
+      NEXT_INSTR();
+    OPCODE(0xF7):
       DBG_LOG_INST("RST 30H");
       InstrRST(0x30);
-      break;
-    case 0xF8:
+      NEXT_INSTR();
+    OPCODE(0xF8):
       DBG_LOG_INST("LDHL SP,n");
       InstrLoadHlSpRel();
-      break;
-    case 0xF9:
+      NEXT_INSTR();
+    OPCODE(0xF9):
       DBG_LOG_INST("LD SP,HL");
       InstrLoadSpHl();
-      break;
-    case 0xFA:
+      NEXT_INSTR();
+    OPCODE(0xFA):
       DBG_LOG_INST("LD A, (a16)");
-      InstrLoad(reg_file.A, FetchNext2InstrBytes());
-      break;
-    case 0xFB:
+      InstrLoad<Reg8::kA>(FetchNext2InstrBytes());
+      NEXT_INSTR();
+    OPCODE(0xFB):
       DBG_LOG_INST("EI");
       InstrEI();
-      break;
+      NEXT_INSTR();
     // case 0xFC: This one is not implemented!
     // case 0xFD: This one is not implemented!
-    case 0xFE:
+    OPCODE(0xFE):
       DBG_LOG_INST("CP d8");
       InstrCompImm();
-      break;
-    case 0xFF:
+      NEXT_INSTR();
+    OPCODE(0xFF):
       DBG_LOG_INST("RST 38H");
       InstrRST(0x38);
-      break;
-    case 0xCB:  // special bit instruction is called
-      instr_byte = FetchNextInstrByte();
-      switch (instr_byte) {
-      case 0x00:
-        DBG_LOG_INST("RLC B");
-        InstrRlc(reg_file.B);
-        break;
-      case 0x01:
-        DBG_LOG_INST("RLC C");
-        InstrRlc(reg_file.C);
-        break;
-      case 0x02:
-        DBG_LOG_INST("RLC D");
-        InstrRlc(reg_file.D);
-        break;
-      case 0x03:
-        DBG_LOG_INST("RLC E");
-        InstrRlc(reg_file.E);
-        break;
-      case 0x04:
-        DBG_LOG_INST("RLC H");
-        InstrRlc(reg_file.H);
-        break;
-      case 0x05:
-        DBG_LOG_INST("RLC L");
-        InstrRlc(reg_file.L);
-        break;
-      case 0x06:
-        DBG_LOG_INST("RLC (HL)");
-        InstrRlc(reg_file.HL);
-        break;
-      case 0x07:
-        DBG_LOG_INST("RLC A");
-        InstrRlc(reg_file.A);
-        break;
-      case 0x08:
-        DBG_LOG_INST("RRC B");
-        InstrRrc(reg_file.B);
-        break;
-      case 0x09:
-        DBG_LOG_INST("RRC C");
-        InstrRrc(reg_file.C);
-        break;
-      case 0x0A:
-        DBG_LOG_INST("RRC D");
-        InstrRrc(reg_file.D);
-        break;
-      case 0x0B:
-        DBG_LOG_INST("RRC E");
-        InstrRrc(reg_file.E);
-        break;
-      case 0x0C:
-        DBG_LOG_INST("RRC H");
-        InstrRrc(reg_file.H);
-        break;
-      case 0x0D:
-        DBG_LOG_INST("RRC L");
-        InstrRrc(reg_file.L);
-        break;
-      case 0x0E:
-        DBG_LOG_INST("RRC (HL)");
-        InstrRrc(reg_file.HL);
-        break;
-      case 0x0F:
-        DBG_LOG_INST("RRC A");
-        InstrRrc(reg_file.A);
-        break;
-      case 0x10:
-        DBG_LOG_INST("RL B");
-        InstrRotLeft(reg_file.B);
-        break;
-      case 0x11:
-        DBG_LOG_INST("RL C");
-        InstrRotLeft(reg_file.C);
-        break;
-      case 0x12:
-        DBG_LOG_INST("RL D");
-        InstrRotLeft(reg_file.D);
-        break;
-      case 0x13:
-        DBG_LOG_INST("RL E");
-        InstrRotLeft(reg_file.E);
-        break;
-      case 0x14:
-        DBG_LOG_INST("RL H");
-        InstrRotLeft(reg_file.H);
-        break;
-      case 0x15:
-        DBG_LOG_INST("RL L");
-        InstrRotLeft(reg_file.L);
-        break;
-      case 0x16:
-        DBG_LOG_INST("RL (HL)");
-        InstrRotLeft(reg_file.HL);
-        break;
-      case 0x17:
-        DBG_LOG_INST("RL A");
-        InstrRotLeft(reg_file.A);
-        break;
-      case 0x18:
-        DBG_LOG_INST("RR B");
-        InstrRotRight(reg_file.B);
-        break;
-      case 0x19:
-        DBG_LOG_INST("RR C");
-        InstrRotRight(reg_file.C);
-        break;
-      case 0x1A:
-        DBG_LOG_INST("RR D");
-        InstrRotRight(reg_file.D);
-        break;
-      case 0x1B:
-        DBG_LOG_INST("RR E");
-        InstrRotRight(reg_file.E);
-        break;
-      case 0x1C:
-        DBG_LOG_INST("RR H");
-        InstrRotRight(reg_file.H);
-        break;
-      case 0x1D:
-        DBG_LOG_INST("RR L");
-        InstrRotRight(reg_file.L);
-        break;
-      case 0x1E:
-        DBG_LOG_INST("RR (HL");
-        InstrRotRight(reg_file.HL);
-        break;
-      case 0x1F:
-        DBG_LOG_INST("RR A");
-        InstrRotRight(reg_file.A);
-        break;
-      case 0x20:
-        DBG_LOG_INST("SLA B");
-        InstrSLA(reg_file.B);
-        break;
-      case 0x21:
-        DBG_LOG_INST("SLA C");
-        InstrSLA(reg_file.C);
-        break;
-      case 0x22:
-        DBG_LOG_INST("SLA D");
-        InstrSLA(reg_file.D);
-        break;
-      case 0x23:
-        DBG_LOG_INST("SLA E");
-        InstrSLA(reg_file.E);
-        break;
-      case 0x24:
-        DBG_LOG_INST("SLA H");
-        InstrSLA(reg_file.H);
-        break;
-      case 0x25:
-        DBG_LOG_INST("SLA L");
-        InstrSLA(reg_file.L);
-        break;
-      case 0x26:
-        DBG_LOG_INST("SLA (HL)");
-        InstrSLA(reg_file.HL);
-        break;
-      case 0x27:
-        DBG_LOG_INST("SLA A");
-        InstrSLA(reg_file.A);
-        break;
-      case 0x28:
-        DBG_LOG_INST("SRA B");
-        InstrSRA(reg_file.B);
-        break;
-      case 0x29:
-        DBG_LOG_INST("SRA C");
-        InstrSRA(reg_file.C);
-        break;
-      case 0x2A:
-        DBG_LOG_INST("SRA D");
-        InstrSRA(reg_file.D);
-        break;
-      case 0x2B:
-        DBG_LOG_INST("SRA E");
-        InstrSRA(reg_file.E);
-        break;
-      case 0x2C:
-        DBG_LOG_INST("SRA H");
-        InstrSRA(reg_file.H);
-        break;
-      case 0x2D:
-        DBG_LOG_INST("SRA L");
-        InstrSRA(reg_file.L);
-        break;
-      case 0x2E:
-        DBG_LOG_INST("SRA (HL)");
-        InstrSRA(reg_file.HL);
-        break;
-      case 0x2F:
-        DBG_LOG_INST("SRA A");
-        InstrSRA(reg_file.A);
-        break;
-      case 0x30:
-        DBG_LOG_INST("SWAP B");
-        InstrSwap(reg_file.B);
-        break;
-      case 0x31:
-        DBG_LOG_INST("SWAP C");
-        InstrSwap(reg_file.C);
-        break;
-      case 0x32:
-        DBG_LOG_INST("SWAP D");
-        InstrSwap(reg_file.D);
-        break;
-      case 0x33:
-        DBG_LOG_INST("SWAP E");
-        InstrSwap(reg_file.E);
-        break;
-      case 0x34:
-        DBG_LOG_INST("SWAP H");
-        InstrSwap(reg_file.H);
-        break;
-      case 0x35:
-        DBG_LOG_INST("SWAP L");
-        InstrSwap(reg_file.L);
-        break;
-      case 0x36:
-        DBG_LOG_INST("SWAP (HL)");
-        InstrSwap(reg_file.HL);
-        break;
-      case 0x37:
-        DBG_LOG_INST("SWAP A");
-        InstrSwap(reg_file.A);
-        break;
-      case 0x38:
-        DBG_LOG_INST("SRL B");
-        InstrShiftRight(reg_file.B);
-        break;
-      case 0x39:
-        DBG_LOG_INST("SRL C");
-        InstrShiftRight(reg_file.C);
-        break;
-      case 0x3A:
-        DBG_LOG_INST("SRL D");
-        InstrShiftRight(reg_file.D);
-        break;
-      case 0x3B:
-        DBG_LOG_INST("SRL E");
-        InstrShiftRight(reg_file.E);
-        break;
-      case 0x3C:
-        DBG_LOG_INST("SRL H");
-        InstrShiftRight(reg_file.H);
-        break;
-      case 0x3D:
-        DBG_LOG_INST("SRL L");
-        InstrShiftRight(reg_file.L);
-        break;
-      case 0x3E:
-        DBG_LOG_INST("SRL (HL)");
-        InstrShiftRight(reg_file.HL);
-        break;
-      case 0x3F:
-        DBG_LOG_INST("SRL A");
-        InstrShiftRight(reg_file.A);
-        break;
-      case 0x40:
-        DBG_LOG_INST("BIT 0,B");
-        InstrBitN(0, reg_file.B);
-        break;
-      case 0x41:
-        DBG_LOG_INST("BIT 0,C");
-        InstrBitN(0, reg_file.C);
-        break;
-      case 0x42:
-        DBG_LOG_INST("BIT 0,D");
-        InstrBitN(0, reg_file.D);
-        break;
-      case 0x43:
-        DBG_LOG_INST("BIT 0,E");
-        InstrBitN(0, reg_file.E);
-        break;
-      case 0x44:
-        DBG_LOG_INST("BIT 0,H");
-        InstrBitN(0, reg_file.H);
-        break;
-      case 0x45:
-        DBG_LOG_INST("BIT 0,L");
-        InstrBitN(0, reg_file.L);
-        break;
-      case 0x46:
-        DBG_LOG_INST("BIT 0,(HL)");
-        InstrBitN(0, reg_file.HL);
-        break;
-      case 0x47:
-        DBG_LOG_INST("BIT 0,A");
-        InstrBitN(0, reg_file.A);
-        break;
-      case 0x48:
-        DBG_LOG_INST("BIT 1,B");
-        InstrBitN(1, reg_file.B);
-        break;
-      case 0x49:
-        DBG_LOG_INST("BIT 1,C");
-        InstrBitN(1, reg_file.C);
-        break;
-      case 0x4A:
-        DBG_LOG_INST("BIT 1,D");
-        InstrBitN(1, reg_file.D);
-        break;
-      case 0x4B:
-        DBG_LOG_INST("BIT 1,E");
-        InstrBitN(1, reg_file.E);
-        break;
-      case 0x4C:
-        DBG_LOG_INST("BIT 1,H");
-        InstrBitN(1, reg_file.H);
-        break;
-      case 0x4D:
-        DBG_LOG_INST("BIT 1,L");
-        InstrBitN(1, reg_file.L);
-        break;
-      case 0x4E:
-        DBG_LOG_INST("BIT 1,(HL)");
-        InstrBitN(1, reg_file.HL);
-        break;
-      case 0x4F:
-        DBG_LOG_INST("BIT 1,A");
-        InstrBitN(1, reg_file.A);
-        break;
-      case 0x50:
-        DBG_LOG_INST("BIT 2,B");
-        InstrBitN(2, reg_file.B);
-        break;
-      case 0x51:
-        DBG_LOG_INST("BIT 2,C");
-        InstrBitN(2, reg_file.C);
-        break;
-      case 0x52:
-        DBG_LOG_INST("BIT 2,D");
-        InstrBitN(2, reg_file.D);
-        break;
-      case 0x53:
-        DBG_LOG_INST("BIT 2,E");
-        InstrBitN(2, reg_file.E);
-        break;
-      case 0x54:
-        DBG_LOG_INST("BIT 2,H");
-        InstrBitN(2, reg_file.H);
-        break;
-      case 0x55:
-        DBG_LOG_INST("BIT 2,L");
-        InstrBitN(2, reg_file.L);
-        break;
-      case 0x56:
-        DBG_LOG_INST("BIT 2,(HL)");
-        InstrBitN(2, reg_file.HL);
-        break;
-      case 0x57:
-        DBG_LOG_INST("BIT 2,A");
-        InstrBitN(2, reg_file.A);
-        break;
-      case 0x58:
-        DBG_LOG_INST("BIT 3,B");
-        InstrBitN(3, reg_file.B);
-        break;
-      case 0x59:
-        DBG_LOG_INST("BIT 3,C");
-        InstrBitN(3, reg_file.C);
-        break;
-      case 0x5A:
-        DBG_LOG_INST("BIT 3,D");
-        InstrBitN(3, reg_file.D);
-        break;
-      case 0x5B:
-        DBG_LOG_INST("BIT 3,E");
-        InstrBitN(3, reg_file.E);
-        break;
-      case 0x5C:
-        DBG_LOG_INST("BIT 3,H");
-        InstrBitN(3, reg_file.H);
-        break;
-      case 0x5D:
-        DBG_LOG_INST("BIT 3,L");
-        InstrBitN(3, reg_file.L);
-        break;
-      case 0x5E:
-        DBG_LOG_INST("BIT 3,(HL)");
-        InstrBitN(3, reg_file.HL);
-        break;
-      case 0x5F:
-        DBG_LOG_INST("BIT 3,A");
-        InstrBitN(3, reg_file.A);
-        break;
-      case 0x60:
-        DBG_LOG_INST("BIT 4,B");
-        InstrBitN(4, reg_file.B);
-        break;
-      case 0x61:
-        DBG_LOG_INST("BIT 4,C");
-        InstrBitN(4, reg_file.C);
-        break;
-      case 0x62:
-        DBG_LOG_INST("BIT 4,D");
-        InstrBitN(4, reg_file.D);
-        break;
-      case 0x63:
-        DBG_LOG_INST("BIT 4,E");
-        InstrBitN(4, reg_file.E);
-        break;
-      case 0x64:
-        DBG_LOG_INST("BIT 4,H");
-        InstrBitN(4, reg_file.H);
-        break;
-      case 0x65:
-        DBG_LOG_INST("BIT 4,L");
-        InstrBitN(4, reg_file.L);
-        break;
-      case 0x66:
-        DBG_LOG_INST("BIT 4,(HL)");
-        InstrBitN(4, reg_file.HL);
-        break;
-      case 0x67:
-        DBG_LOG_INST("BIT 4,A");
-        InstrBitN(4, reg_file.A);
-        break;
-      case 0x68:
-        DBG_LOG_INST("BIT 5,B");
-        InstrBitN(5, reg_file.B);
-        break;
-      case 0x69:
-        DBG_LOG_INST("BIT 5,C");
-        InstrBitN(5, reg_file.C);
-        break;
-      case 0x6A:
-        DBG_LOG_INST("BIT 5,D");
-        InstrBitN(5, reg_file.D);
-        break;
-      case 0x6B:
-        DBG_LOG_INST("BIT 5,E");
-        InstrBitN(5, reg_file.E);
-        break;
-      case 0x6C:
-        DBG_LOG_INST("BIT 5,H");
-        InstrBitN(5, reg_file.H);
-        break;
-      case 0x6D:
-        DBG_LOG_INST("BIT 5,L");
-        InstrBitN(5, reg_file.L);
-        break;
-      case 0x6E:
-        DBG_LOG_INST("BIT 5,(HL)");
-        InstrBitN(5, reg_file.HL);
-        break;
-      case 0x6F:
-        DBG_LOG_INST("BIT 5,A");
-        InstrBitN(5, reg_file.A);
-        break;
-      case 0x70:
-        DBG_LOG_INST("BIT 6,B");
-        InstrBitN(6, reg_file.B);
-        break;
-      case 0x71:
-        DBG_LOG_INST("BIT 6,C");
-        InstrBitN(6, reg_file.C);
-        break;
-      case 0x72:
-        DBG_LOG_INST("BIT 6,D");
-        InstrBitN(6, reg_file.D);
-        break;
-      case 0x73:
-        DBG_LOG_INST("BIT 6,E");
-        InstrBitN(6, reg_file.E);
-        break;
-      case 0x74:
-        DBG_LOG_INST("BIT 6,H");
-        InstrBitN(6, reg_file.H);
-        break;
-      case 0x75:
-        DBG_LOG_INST("BIT 6,L");
-        InstrBitN(6, reg_file.L);
-        break;
-      case 0x76:
-        DBG_LOG_INST("BIT 6,(HL)");
-        InstrBitN(6, reg_file.HL);
-        break;
-      case 0x77:
-        DBG_LOG_INST("BIT 6,A");
-        InstrBitN(6, reg_file.A);
-        break;
-      case 0x78:
-        DBG_LOG_INST("BIT 7,B");
-        InstrBitN(7, reg_file.B);
-        break;
-      case 0x79:
-        DBG_LOG_INST("BIT 7,C");
-        InstrBitN(7, reg_file.C);
-        break;
-      case 0x7A:
-        DBG_LOG_INST("BIT 7,D");
-        InstrBitN(7, reg_file.D);
-        break;
-      case 0x7B:
-        DBG_LOG_INST("BIT 7,E");
-        InstrBitN(7, reg_file.E);
-        break;
-      case 0x7C:
-        DBG_LOG_INST("BIT 7,H");
-        InstrBitN(7, reg_file.H);
-        break;
-      case 0x7D:
-        DBG_LOG_INST("BIT 7,L");
-        InstrBitN(7, reg_file.L);
-        break;
-      case 0x7E:
-        DBG_LOG_INST("BIT 7,(HL)");
-        InstrBitN(7, reg_file.HL);
-        break;
-      case 0x7F:
-        DBG_LOG_INST("BIT 7, A");
-        InstrBitN(7, reg_file.A);
-        break;
-      case 0x80:
-        DBG_LOG_INST("RES 0, B");
-        InstrResetBit(0, reg_file.B);
-        break;
-      case 0x81:
-        DBG_LOG_INST("RES 0, C");
-        InstrResetBit(0, reg_file.C);
-        break;
-      case 0x82:
-        DBG_LOG_INST("RES 0, D");
-        InstrResetBit(0, reg_file.D);
-        break;
-      case 0x83:
-        DBG_LOG_INST("RES 0, E");
-        InstrResetBit(0, reg_file.E);
-        break;
-      case 0x84:
-        DBG_LOG_INST("RES 0, H");
-        InstrResetBit(0, reg_file.H);
-        break;
-      case 0x85:
-        DBG_LOG_INST("RES 0, L");
-        InstrResetBit(0, reg_file.L);
-        break;
-      case 0x86:
-        DBG_LOG_INST("RES 0, (HL)");
-        InstrResetBit(0, reg_file.HL);
-        break;
-      case 0x87:
-        DBG_LOG_INST("RES 0, A");
-        InstrResetBit(0, reg_file.A);
-        break;
-      case 0x88:
-        DBG_LOG_INST("RES 1, B");
-        InstrResetBit(1, reg_file.B);
-        break;
-      case 0x89:
-        DBG_LOG_INST("RES 1, C");
-        InstrResetBit(1, reg_file.C);
-        break;
-      case 0x8A:
-        DBG_LOG_INST("RES 1, D");
-        InstrResetBit(1, reg_file.D);
-        break;
-      case 0x8B:
-        DBG_LOG_INST("RES 1, E");
-        InstrResetBit(1, reg_file.E);
-        break;
-      case 0x8C:
-        DBG_LOG_INST("RES 1, H");
-        InstrResetBit(1, reg_file.H);
-        break;
-      case 0x8D:
-        DBG_LOG_INST("RES 1, L");
-        InstrResetBit(1, reg_file.L);
-        break;
-      case 0x8E:
-        DBG_LOG_INST("RES 1, (HL)");
-        InstrResetBit(1, reg_file.HL);
-        break;
-      case 0x8F:
-        DBG_LOG_INST("RES 1, A");
-        InstrResetBit(1, reg_file.A);
-        break;
-      case 0x90:
-        DBG_LOG_INST("RES 2, B");
-        InstrResetBit(2, reg_file.B);
-        break;
-      case 0x91:
-        DBG_LOG_INST("RES 2, C");
-        InstrResetBit(2, reg_file.C);
-        break;
-      case 0x92:
-        DBG_LOG_INST("RES 2, D");
-        InstrResetBit(2, reg_file.D);
-        break;
-      case 0x93:
-        DBG_LOG_INST("RES 2, E");
-        InstrResetBit(2, reg_file.E);
-        break;
-      case 0x94:
-        DBG_LOG_INST("RES 2, H");
-        InstrResetBit(2, reg_file.H);
-        break;
-      case 0x95:
-        DBG_LOG_INST("RES 2, L");
-        InstrResetBit(2, reg_file.L);
-        break;
-      case 0x96:
-        DBG_LOG_INST("RES 2, HL");
-        InstrResetBit(2, reg_file.HL);
-        break;
-      case 0x97:
-        DBG_LOG_INST("RES 2, A");
-        InstrResetBit(2, reg_file.A);
-        break;
-      case 0x98:
-        DBG_LOG_INST("RES 3, B");
-        InstrResetBit(3, reg_file.B);
-        break;
-      case 0x99:
-        DBG_LOG_INST("RES 3, C");
-        InstrResetBit(3, reg_file.C);
-        break;
-      case 0x9A:
-        DBG_LOG_INST("RES 3, D");
-        InstrResetBit(3, reg_file.D);
-        break;
-      case 0x9B:
-        DBG_LOG_INST("RES 3, E");
-        InstrResetBit(3, reg_file.E);
-        break;
-      case 0x9C:
-        DBG_LOG_INST("RES 3, H");
-        InstrResetBit(3, reg_file.H);
-        break;
-      case 0x9D:
-        DBG_LOG_INST("RES 3, L");
-        InstrResetBit(3, reg_file.L);
-        break;
-      case 0x9E:
-        DBG_LOG_INST("RES 3, (HL)");
-        InstrResetBit(3, reg_file.HL);
-        break;
-      case 0x9F:
-        DBG_LOG_INST("RES 3, A");
-        InstrResetBit(3, reg_file.A);
-        break;
-      case 0xA0:
-        DBG_LOG_INST("RES 4, B");
-        InstrResetBit(4, reg_file.B);
-        break;
-      case 0xA1:
-        DBG_LOG_INST("RES 4, C");
-        InstrResetBit(4, reg_file.C);
-        break;
-      case 0xA2:
-        DBG_LOG_INST("RES 4, D");
-        InstrResetBit(4, reg_file.D);
-        break;
-      case 0xA3:
-        DBG_LOG_INST("RES 4, E");
-        InstrResetBit(4, reg_file.E);
-        break;
-      case 0xA4:
-        DBG_LOG_INST("RES 4, H");
-        InstrResetBit(4, reg_file.H);
-        break;
-      case 0xA5:
-        DBG_LOG_INST("RES 4, L");
-        InstrResetBit(4, reg_file.L);
-        break;
-      case 0xA6:
-        DBG_LOG_INST("RES 4, (HL)");
-        InstrResetBit(4, reg_file.HL);
-        break;
-      case 0xA7:
-        DBG_LOG_INST("RES 4, A");
-        InstrResetBit(4, reg_file.A);
-        break;
-      case 0xA8:
-        DBG_LOG_INST("RES 5, B");
-        InstrResetBit(5, reg_file.B);
-        break;
-      case 0xA9:
-        DBG_LOG_INST("RES 5, C");
-        InstrResetBit(5, reg_file.C);
-        break;
-      case 0xAA:
-        DBG_LOG_INST("RES 5, D");
-        InstrResetBit(5, reg_file.D);
-        break;
-      case 0xAB:
-        DBG_LOG_INST("RES 5, E");
-        InstrResetBit(5, reg_file.E);
-        break;
-      case 0xAC:
-        DBG_LOG_INST("RES 5, H");
-        InstrResetBit(5, reg_file.H);
-        break;
-      case 0xAD:
-        DBG_LOG_INST("RES 5, L");
-        InstrResetBit(5, reg_file.L);
-        break;
-      case 0xAE:
-        DBG_LOG_INST("RES 5, (HL)");
-        InstrResetBit(5, reg_file.HL);
-        break;
-      case 0xAF:
-        DBG_LOG_INST("RES 5, A");
-        InstrResetBit(5, reg_file.A);
-        break;
-      case 0xB0:
-        DBG_LOG_INST("RES 6, B");
-        InstrResetBit(6, reg_file.B);
-        break;
-      case 0xB1:
-        DBG_LOG_INST("RES 6, C");
-        InstrResetBit(6, reg_file.C);
-        break;
-      case 0xB2:
-        DBG_LOG_INST("RES 6, D");
-        InstrResetBit(6, reg_file.D);
-        break;
-      case 0xB3:
-        DBG_LOG_INST("RES 6, E");
-        InstrResetBit(6, reg_file.E);
-        break;
-      case 0xB4:
-        DBG_LOG_INST("RES 6, H");
-        InstrResetBit(6, reg_file.H);
-        break;
-      case 0xB5:
-        DBG_LOG_INST("RES 6, L");
-        InstrResetBit(6, reg_file.L);
-        break;
-      case 0xB6:
-        DBG_LOG_INST("RES 6, (HL)");
-        InstrResetBit(6, reg_file.HL);
-        break;
-      case 0xB7:
-        DBG_LOG_INST("RES 6, A");
-        InstrResetBit(6, reg_file.A);
-        break;
-      case 0xB8:
-        DBG_LOG_INST("RES 7, B");
-        InstrResetBit(7, reg_file.B);
-        break;
-      case 0xB9:
-        DBG_LOG_INST("RES 7, C");
-        InstrResetBit(7, reg_file.C);
-        break;
-      case 0xBA:
-        DBG_LOG_INST("RES 7, D");
-        InstrResetBit(7, reg_file.D);
-        break;
-      case 0xBB:
-        DBG_LOG_INST("RES 7, E");
-        InstrResetBit(7, reg_file.E);
-        break;
-      case 0xBC:
-        DBG_LOG_INST("RES 7, H");
-        InstrResetBit(7, reg_file.H);
-        break;
-      case 0xBD:
-        DBG_LOG_INST("RES 7, L");
-        InstrResetBit(7, reg_file.L);
-        break;
-      case 0xBE:
-        DBG_LOG_INST("RES 7, (HL)");
-        InstrResetBit(7, reg_file.HL);
-        break;
-      case 0xBF:
-        DBG_LOG_INST("RES 7, A");
-        InstrResetBit(7, reg_file.A);
-        break;
-      case 0xC0:
-        DBG_LOG_INST("SET 0, B");
-        InstrSetBitN(0, reg_file.B);
-        break;
-      case 0xC1:
-        DBG_LOG_INST("SET 0, C");
-        InstrSetBitN(0, reg_file.C);
-        break;
-      case 0xC2:
-        DBG_LOG_INST("SET 0, D");
-        InstrSetBitN(0, reg_file.D);
-        break;
-      case 0xC3:
-        DBG_LOG_INST("SET 0, E");
-        InstrSetBitN(0, reg_file.E);
-        break;
-      case 0xC4:
-        DBG_LOG_INST("SET 0, H");
-        InstrSetBitN(0, reg_file.H);
-        break;
-      case 0xC5:
-        DBG_LOG_INST("SET 0, L");
-        InstrSetBitN(0, reg_file.L);
-        break;
-      case 0xC6:
-        DBG_LOG_INST("SET 0, (HL)");
-        InstrSetBitN(0, reg_file.HL);
-        break;
-      case 0xC7:
-        DBG_LOG_INST("SET 0, A");
-        InstrSetBitN(0, reg_file.A);
-        break;
-      case 0xC8:
-        DBG_LOG_INST("SET 1, B");
-        InstrSetBitN(1, reg_file.B);
-        break;
-      case 0xC9:
-        DBG_LOG_INST("SET 1, C");
-        InstrSetBitN(1, reg_file.C);
-        break;
-      case 0xCA:
-        DBG_LOG_INST("SET 1, D");
-        InstrSetBitN(1, reg_file.D);
-        break;
-      case 0xCB:
-        DBG_LOG_INST("SET 1, E");
-        InstrSetBitN(1, reg_file.E);
-        break;
-      case 0xCC:
-        DBG_LOG_INST("SET 1, H");
-        InstrSetBitN(1, reg_file.H);
-        break;
-      case 0xCD:
-        DBG_LOG_INST("SET 1, L");
-        InstrSetBitN(1, reg_file.L);
-        break;
-      case 0xCE:
-        DBG_LOG_INST("SET 1, (HL)");
-        InstrSetBitN(1, reg_file.HL);
-        break;
-      case 0xCF:
-        DBG_LOG_INST("SET 1, A");
-        InstrSetBitN(1, reg_file.A);
-        break;
-      case 0xD0:
-        DBG_LOG_INST("SET 2, B");
-        InstrSetBitN(2, reg_file.B);
-        break;
-      case 0xD1:
-        DBG_LOG_INST("SET 2, C");
-        InstrSetBitN(2, reg_file.C);
-        break;
-      case 0xD2:
-        DBG_LOG_INST("SET 2, D");
-        InstrSetBitN(2, reg_file.D);
-        break;
-      case 0xD3:
-        DBG_LOG_INST("SET 2, E");
-        InstrSetBitN(2, reg_file.E);
-        break;
-      case 0xD4:
-        DBG_LOG_INST("SET 2, H");
-        InstrSetBitN(2, reg_file.H);
-        break;
-      case 0xD5:
-        DBG_LOG_INST("SET 2, L");
-        InstrSetBitN(2, reg_file.L);
-        break;
-      case 0xD6:
-        DBG_LOG_INST("SET 2, (HL)");
-        InstrSetBitN(2, reg_file.HL);
-        break;
-      case 0xD7:
-        DBG_LOG_INST("SET 2, A");
-        InstrSetBitN(2, reg_file.A);
-        break;
-      case 0xD8:
-        DBG_LOG_INST("SET 3, B");
-        InstrSetBitN(3, reg_file.B);
-        break;
-      case 0xD9:
-        DBG_LOG_INST("SET 3, C");
-        InstrSetBitN(3, reg_file.C);
-        break;
-      case 0xDA:
-        DBG_LOG_INST("SET 3, D");
-        InstrSetBitN(3, reg_file.D);
-        break;
-      case 0xDB:
-        DBG_LOG_INST("SET 3, E");
-        InstrSetBitN(3, reg_file.E);
-        break;
-      case 0xDC:
-        DBG_LOG_INST("SET 3, H");
-        InstrSetBitN(3, reg_file.H);
-        break;
-      case 0xDD:
-        DBG_LOG_INST("SET 3, L");
-        InstrSetBitN(3, reg_file.L);
-        break;
-      case 0xDE:
-        DBG_LOG_INST("SET 3, (HL)");
-        InstrSetBitN(3, reg_file.HL);
-        break;
-      case 0xDF:
-        DBG_LOG_INST("SET 3, A");
-        InstrSetBitN(3, reg_file.A);
-        break;
-      case 0xE0:
-        DBG_LOG_INST("SET 4, B");
-        InstrSetBitN(4, reg_file.B);
-        break;
-      case 0xE1:
-        DBG_LOG_INST("SET 4, C");
-        InstrSetBitN(4, reg_file.C);
-        break;
-      case 0xE2:
-        DBG_LOG_INST("SET 4, D");
-        InstrSetBitN(4, reg_file.D);
-        break;
-      case 0xE3:
-        DBG_LOG_INST("SET 4, E");
-        InstrSetBitN(4, reg_file.E);
-        break;
-      case 0xE4:
-        DBG_LOG_INST("SET 4, H");
-        InstrSetBitN(4, reg_file.H);
-        break;
-      case 0xE5:
-        DBG_LOG_INST("SET 4, L");
-        InstrSetBitN(4, reg_file.L);
-        break;
-      case 0xE6:
-        DBG_LOG_INST("SET 4, (HL)");
-        InstrSetBitN(4, reg_file.HL);
-        break;
-      case 0xE7:
-        DBG_LOG_INST("SET 4, A");
-        InstrSetBitN(4, reg_file.A);
-        break;
-      case 0xE8:
-        DBG_LOG_INST("SET 5, B");
-        InstrSetBitN(5, reg_file.B);
-        break;
-      case 0xE9:
-        DBG_LOG_INST("SET 5, C");
-        InstrSetBitN(5, reg_file.C);
-        break;
-      case 0xEA:
-        DBG_LOG_INST("SET 5, D");
-        InstrSetBitN(5, reg_file.D);
-        break;
-      case 0xEB:
-        DBG_LOG_INST("SET 5, E");
-        InstrSetBitN(5, reg_file.E);
-        break;
-      case 0xEC:
-        DBG_LOG_INST("SET 5, H");
-        InstrSetBitN(5, reg_file.H);
-        break;
-      case 0xED:
-        DBG_LOG_INST("SET 5, L");
-        InstrSetBitN(5, reg_file.L);
-        break;
-      case 0xEE:
-        DBG_LOG_INST("SET 5, (HL)");
-        InstrSetBitN(5, reg_file.HL);
-        break;
-      case 0xEF:
-        DBG_LOG_INST("SET 5, A");
-        InstrSetBitN(5, reg_file.A);
-        break;
-      case 0xF0:
-        DBG_LOG_INST("SET 6, B");
-        InstrSetBitN(6, reg_file.B);
-        break;
-      case 0xF1:
-        DBG_LOG_INST("SET 6, C");
-        InstrSetBitN(6, reg_file.C);
-        break;
-      case 0xF2:
-        DBG_LOG_INST("SET 6, D");
-        InstrSetBitN(6, reg_file.D);
-        break;
-      case 0xF3:
-        DBG_LOG_INST("SET 6, E");
-        InstrSetBitN(6, reg_file.E);
-        break;
-      case 0xF4:
-        DBG_LOG_INST("SET 6, H");
-        InstrSetBitN(6, reg_file.H);
-        break;
-      case 0xF5:
-        DBG_LOG_INST("SET 6, L");
-        InstrSetBitN(6, reg_file.L);
-        break;
-      case 0xF6:
-        DBG_LOG_INST("SET 6, (HL)");
-        InstrSetBitN(6, reg_file.HL);
-        break;
-      case 0xF7:
-        DBG_LOG_INST("SET 6, A");
-        InstrSetBitN(6, reg_file.A);
-        break;
-      case 0xF8:
-        DBG_LOG_INST("SET 7, B");
-        InstrSetBitN(7, reg_file.B);
-        break;
-      case 0xF9:
-        DBG_LOG_INST("SET 7, C");
-        InstrSetBitN(7, reg_file.C);
-        break;
-      case 0xFA:
-        DBG_LOG_INST("SET 7, D");
-        InstrSetBitN(7, reg_file.D);
-        break;
-      case 0xFB:
-        DBG_LOG_INST("SET 7, E");
-        InstrSetBitN(7, reg_file.E);
-        break;
-      case 0xFC:
-        DBG_LOG_INST("SET 7, H");
-        InstrSetBitN(7, reg_file.H);
-        break;
-      case 0xFD:
-        DBG_LOG_INST("SET 7, L");
-        InstrSetBitN(7, reg_file.L);
-        break;
-      case 0xFE:
-        DBG_LOG_INST("SET 7, (HL)");
-        InstrSetBitN(7, reg_file.HL);
-        break;
-      case 0xFF:
-        DBG_LOG_INST("SET 7, A");
-        InstrSetBitN(7, reg_file.A);
-        break;
-      default:
-        std::cout << "UNKNOWN INSTRUCTION: CB 0x" << std::hex << static_cast<int>(instr_byte) << " at PC=0x" << std::hex
-                  << static_cast<int>(reg_file.PC) << std::endl;
-        exit(EXIT_FAILURE);
-        break;
-      }
-      break;
-    default:
-      std::cout << "UNKNOWN INSTRUCTION: 0x" << std::hex << static_cast<int>(instr_byte) << " at PC=0x" << std::hex
+      NEXT_INSTR();
+    // CB-prefixed opcodes. FetchOpcode() already consumed the prefix.
+    OPCODE_CB(0x00):
+      DBG_LOG_INST("RLC B");
+      InstrRlc<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x01):
+      DBG_LOG_INST("RLC C");
+      InstrRlc<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x02):
+      DBG_LOG_INST("RLC D");
+      InstrRlc<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x03):
+      DBG_LOG_INST("RLC E");
+      InstrRlc<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x04):
+      DBG_LOG_INST("RLC H");
+      InstrRlc<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x05):
+      DBG_LOG_INST("RLC L");
+      InstrRlc<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x06):
+      DBG_LOG_INST("RLC (HL)");
+      InstrRlc<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x07):
+      DBG_LOG_INST("RLC A");
+      InstrRlc<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x08):
+      DBG_LOG_INST("RRC B");
+      InstrRrc<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x09):
+      DBG_LOG_INST("RRC C");
+      InstrRrc<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x0A):
+      DBG_LOG_INST("RRC D");
+      InstrRrc<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x0B):
+      DBG_LOG_INST("RRC E");
+      InstrRrc<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x0C):
+      DBG_LOG_INST("RRC H");
+      InstrRrc<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x0D):
+      DBG_LOG_INST("RRC L");
+      InstrRrc<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x0E):
+      DBG_LOG_INST("RRC (HL)");
+      InstrRrc<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x0F):
+      DBG_LOG_INST("RRC A");
+      InstrRrc<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x10):
+      DBG_LOG_INST("RL B");
+      InstrRotLeft<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x11):
+      DBG_LOG_INST("RL C");
+      InstrRotLeft<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x12):
+      DBG_LOG_INST("RL D");
+      InstrRotLeft<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x13):
+      DBG_LOG_INST("RL E");
+      InstrRotLeft<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x14):
+      DBG_LOG_INST("RL H");
+      InstrRotLeft<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x15):
+      DBG_LOG_INST("RL L");
+      InstrRotLeft<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x16):
+      DBG_LOG_INST("RL (HL)");
+      InstrRotLeft<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x17):
+      DBG_LOG_INST("RL A");
+      InstrRotLeft<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x18):
+      DBG_LOG_INST("RR B");
+      InstrRotRight<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x19):
+      DBG_LOG_INST("RR C");
+      InstrRotRight<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x1A):
+      DBG_LOG_INST("RR D");
+      InstrRotRight<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x1B):
+      DBG_LOG_INST("RR E");
+      InstrRotRight<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x1C):
+      DBG_LOG_INST("RR H");
+      InstrRotRight<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x1D):
+      DBG_LOG_INST("RR L");
+      InstrRotRight<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x1E):
+      DBG_LOG_INST("RR (HL");
+      InstrRotRight<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x1F):
+      DBG_LOG_INST("RR A");
+      InstrRotRight<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x20):
+      DBG_LOG_INST("SLA B");
+      InstrSLA<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x21):
+      DBG_LOG_INST("SLA C");
+      InstrSLA<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x22):
+      DBG_LOG_INST("SLA D");
+      InstrSLA<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x23):
+      DBG_LOG_INST("SLA E");
+      InstrSLA<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x24):
+      DBG_LOG_INST("SLA H");
+      InstrSLA<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x25):
+      DBG_LOG_INST("SLA L");
+      InstrSLA<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x26):
+      DBG_LOG_INST("SLA (HL)");
+      InstrSLA<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x27):
+      DBG_LOG_INST("SLA A");
+      InstrSLA<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x28):
+      DBG_LOG_INST("SRA B");
+      InstrSRA<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x29):
+      DBG_LOG_INST("SRA C");
+      InstrSRA<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x2A):
+      DBG_LOG_INST("SRA D");
+      InstrSRA<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x2B):
+      DBG_LOG_INST("SRA E");
+      InstrSRA<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x2C):
+      DBG_LOG_INST("SRA H");
+      InstrSRA<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x2D):
+      DBG_LOG_INST("SRA L");
+      InstrSRA<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x2E):
+      DBG_LOG_INST("SRA (HL)");
+      InstrSRA<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x2F):
+      DBG_LOG_INST("SRA A");
+      InstrSRA<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x30):
+      DBG_LOG_INST("SWAP B");
+      InstrSwap<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x31):
+      DBG_LOG_INST("SWAP C");
+      InstrSwap<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x32):
+      DBG_LOG_INST("SWAP D");
+      InstrSwap<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x33):
+      DBG_LOG_INST("SWAP E");
+      InstrSwap<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x34):
+      DBG_LOG_INST("SWAP H");
+      InstrSwap<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x35):
+      DBG_LOG_INST("SWAP L");
+      InstrSwap<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x36):
+      DBG_LOG_INST("SWAP (HL)");
+      InstrSwap<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x37):
+      DBG_LOG_INST("SWAP A");
+      InstrSwap<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x38):
+      DBG_LOG_INST("SRL B");
+      InstrShiftRight<Reg8::kB>();
+      NEXT_INSTR();
+    OPCODE_CB(0x39):
+      DBG_LOG_INST("SRL C");
+      InstrShiftRight<Reg8::kC>();
+      NEXT_INSTR();
+    OPCODE_CB(0x3A):
+      DBG_LOG_INST("SRL D");
+      InstrShiftRight<Reg8::kD>();
+      NEXT_INSTR();
+    OPCODE_CB(0x3B):
+      DBG_LOG_INST("SRL E");
+      InstrShiftRight<Reg8::kE>();
+      NEXT_INSTR();
+    OPCODE_CB(0x3C):
+      DBG_LOG_INST("SRL H");
+      InstrShiftRight<Reg8::kH>();
+      NEXT_INSTR();
+    OPCODE_CB(0x3D):
+      DBG_LOG_INST("SRL L");
+      InstrShiftRight<Reg8::kL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x3E):
+      DBG_LOG_INST("SRL (HL)");
+      InstrShiftRight<Reg16::kHL>();
+      NEXT_INSTR();
+    OPCODE_CB(0x3F):
+      DBG_LOG_INST("SRL A");
+      InstrShiftRight<Reg8::kA>();
+      NEXT_INSTR();
+    OPCODE_CB(0x40):
+      DBG_LOG_INST("BIT 0,B");
+      InstrBitN<Reg8::kB>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x41):
+      DBG_LOG_INST("BIT 0,C");
+      InstrBitN<Reg8::kC>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x42):
+      DBG_LOG_INST("BIT 0,D");
+      InstrBitN<Reg8::kD>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x43):
+      DBG_LOG_INST("BIT 0,E");
+      InstrBitN<Reg8::kE>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x44):
+      DBG_LOG_INST("BIT 0,H");
+      InstrBitN<Reg8::kH>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x45):
+      DBG_LOG_INST("BIT 0,L");
+      InstrBitN<Reg8::kL>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x46):
+      DBG_LOG_INST("BIT 0,(HL)");
+      InstrBitN<Reg16::kHL>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x47):
+      DBG_LOG_INST("BIT 0,A");
+      InstrBitN<Reg8::kA>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x48):
+      DBG_LOG_INST("BIT 1,B");
+      InstrBitN<Reg8::kB>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x49):
+      DBG_LOG_INST("BIT 1,C");
+      InstrBitN<Reg8::kC>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x4A):
+      DBG_LOG_INST("BIT 1,D");
+      InstrBitN<Reg8::kD>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x4B):
+      DBG_LOG_INST("BIT 1,E");
+      InstrBitN<Reg8::kE>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x4C):
+      DBG_LOG_INST("BIT 1,H");
+      InstrBitN<Reg8::kH>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x4D):
+      DBG_LOG_INST("BIT 1,L");
+      InstrBitN<Reg8::kL>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x4E):
+      DBG_LOG_INST("BIT 1,(HL)");
+      InstrBitN<Reg16::kHL>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x4F):
+      DBG_LOG_INST("BIT 1,A");
+      InstrBitN<Reg8::kA>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x50):
+      DBG_LOG_INST("BIT 2,B");
+      InstrBitN<Reg8::kB>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x51):
+      DBG_LOG_INST("BIT 2,C");
+      InstrBitN<Reg8::kC>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x52):
+      DBG_LOG_INST("BIT 2,D");
+      InstrBitN<Reg8::kD>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x53):
+      DBG_LOG_INST("BIT 2,E");
+      InstrBitN<Reg8::kE>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x54):
+      DBG_LOG_INST("BIT 2,H");
+      InstrBitN<Reg8::kH>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x55):
+      DBG_LOG_INST("BIT 2,L");
+      InstrBitN<Reg8::kL>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x56):
+      DBG_LOG_INST("BIT 2,(HL)");
+      InstrBitN<Reg16::kHL>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x57):
+      DBG_LOG_INST("BIT 2,A");
+      InstrBitN<Reg8::kA>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x58):
+      DBG_LOG_INST("BIT 3,B");
+      InstrBitN<Reg8::kB>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x59):
+      DBG_LOG_INST("BIT 3,C");
+      InstrBitN<Reg8::kC>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x5A):
+      DBG_LOG_INST("BIT 3,D");
+      InstrBitN<Reg8::kD>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x5B):
+      DBG_LOG_INST("BIT 3,E");
+      InstrBitN<Reg8::kE>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x5C):
+      DBG_LOG_INST("BIT 3,H");
+      InstrBitN<Reg8::kH>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x5D):
+      DBG_LOG_INST("BIT 3,L");
+      InstrBitN<Reg8::kL>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x5E):
+      DBG_LOG_INST("BIT 3,(HL)");
+      InstrBitN<Reg16::kHL>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x5F):
+      DBG_LOG_INST("BIT 3,A");
+      InstrBitN<Reg8::kA>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x60):
+      DBG_LOG_INST("BIT 4,B");
+      InstrBitN<Reg8::kB>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x61):
+      DBG_LOG_INST("BIT 4,C");
+      InstrBitN<Reg8::kC>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x62):
+      DBG_LOG_INST("BIT 4,D");
+      InstrBitN<Reg8::kD>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x63):
+      DBG_LOG_INST("BIT 4,E");
+      InstrBitN<Reg8::kE>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x64):
+      DBG_LOG_INST("BIT 4,H");
+      InstrBitN<Reg8::kH>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x65):
+      DBG_LOG_INST("BIT 4,L");
+      InstrBitN<Reg8::kL>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x66):
+      DBG_LOG_INST("BIT 4,(HL)");
+      InstrBitN<Reg16::kHL>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x67):
+      DBG_LOG_INST("BIT 4,A");
+      InstrBitN<Reg8::kA>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0x68):
+      DBG_LOG_INST("BIT 5,B");
+      InstrBitN<Reg8::kB>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x69):
+      DBG_LOG_INST("BIT 5,C");
+      InstrBitN<Reg8::kC>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x6A):
+      DBG_LOG_INST("BIT 5,D");
+      InstrBitN<Reg8::kD>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x6B):
+      DBG_LOG_INST("BIT 5,E");
+      InstrBitN<Reg8::kE>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x6C):
+      DBG_LOG_INST("BIT 5,H");
+      InstrBitN<Reg8::kH>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x6D):
+      DBG_LOG_INST("BIT 5,L");
+      InstrBitN<Reg8::kL>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x6E):
+      DBG_LOG_INST("BIT 5,(HL)");
+      InstrBitN<Reg16::kHL>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x6F):
+      DBG_LOG_INST("BIT 5,A");
+      InstrBitN<Reg8::kA>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0x70):
+      DBG_LOG_INST("BIT 6,B");
+      InstrBitN<Reg8::kB>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x71):
+      DBG_LOG_INST("BIT 6,C");
+      InstrBitN<Reg8::kC>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x72):
+      DBG_LOG_INST("BIT 6,D");
+      InstrBitN<Reg8::kD>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x73):
+      DBG_LOG_INST("BIT 6,E");
+      InstrBitN<Reg8::kE>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x74):
+      DBG_LOG_INST("BIT 6,H");
+      InstrBitN<Reg8::kH>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x75):
+      DBG_LOG_INST("BIT 6,L");
+      InstrBitN<Reg8::kL>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x76):
+      DBG_LOG_INST("BIT 6,(HL)");
+      InstrBitN<Reg16::kHL>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x77):
+      DBG_LOG_INST("BIT 6,A");
+      InstrBitN<Reg8::kA>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0x78):
+      DBG_LOG_INST("BIT 7,B");
+      InstrBitN<Reg8::kB>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x79):
+      DBG_LOG_INST("BIT 7,C");
+      InstrBitN<Reg8::kC>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x7A):
+      DBG_LOG_INST("BIT 7,D");
+      InstrBitN<Reg8::kD>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x7B):
+      DBG_LOG_INST("BIT 7,E");
+      InstrBitN<Reg8::kE>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x7C):
+      DBG_LOG_INST("BIT 7,H");
+      InstrBitN<Reg8::kH>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x7D):
+      DBG_LOG_INST("BIT 7,L");
+      InstrBitN<Reg8::kL>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x7E):
+      DBG_LOG_INST("BIT 7,(HL)");
+      InstrBitN<Reg16::kHL>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x7F):
+      DBG_LOG_INST("BIT 7, A");
+      InstrBitN<Reg8::kA>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0x80):
+      DBG_LOG_INST("RES 0, B");
+      InstrResetBit<Reg8::kB>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x81):
+      DBG_LOG_INST("RES 0, C");
+      InstrResetBit<Reg8::kC>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x82):
+      DBG_LOG_INST("RES 0, D");
+      InstrResetBit<Reg8::kD>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x83):
+      DBG_LOG_INST("RES 0, E");
+      InstrResetBit<Reg8::kE>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x84):
+      DBG_LOG_INST("RES 0, H");
+      InstrResetBit<Reg8::kH>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x85):
+      DBG_LOG_INST("RES 0, L");
+      InstrResetBit<Reg8::kL>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x86):
+      DBG_LOG_INST("RES 0, (HL)");
+      InstrResetBit<Reg16::kHL>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x87):
+      DBG_LOG_INST("RES 0, A");
+      InstrResetBit<Reg8::kA>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0x88):
+      DBG_LOG_INST("RES 1, B");
+      InstrResetBit<Reg8::kB>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x89):
+      DBG_LOG_INST("RES 1, C");
+      InstrResetBit<Reg8::kC>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x8A):
+      DBG_LOG_INST("RES 1, D");
+      InstrResetBit<Reg8::kD>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x8B):
+      DBG_LOG_INST("RES 1, E");
+      InstrResetBit<Reg8::kE>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x8C):
+      DBG_LOG_INST("RES 1, H");
+      InstrResetBit<Reg8::kH>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x8D):
+      DBG_LOG_INST("RES 1, L");
+      InstrResetBit<Reg8::kL>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x8E):
+      DBG_LOG_INST("RES 1, (HL)");
+      InstrResetBit<Reg16::kHL>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x8F):
+      DBG_LOG_INST("RES 1, A");
+      InstrResetBit<Reg8::kA>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0x90):
+      DBG_LOG_INST("RES 2, B");
+      InstrResetBit<Reg8::kB>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x91):
+      DBG_LOG_INST("RES 2, C");
+      InstrResetBit<Reg8::kC>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x92):
+      DBG_LOG_INST("RES 2, D");
+      InstrResetBit<Reg8::kD>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x93):
+      DBG_LOG_INST("RES 2, E");
+      InstrResetBit<Reg8::kE>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x94):
+      DBG_LOG_INST("RES 2, H");
+      InstrResetBit<Reg8::kH>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x95):
+      DBG_LOG_INST("RES 2, L");
+      InstrResetBit<Reg8::kL>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x96):
+      DBG_LOG_INST("RES 2, HL");
+      InstrResetBit<Reg16::kHL>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x97):
+      DBG_LOG_INST("RES 2, A");
+      InstrResetBit<Reg8::kA>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0x98):
+      DBG_LOG_INST("RES 3, B");
+      InstrResetBit<Reg8::kB>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x99):
+      DBG_LOG_INST("RES 3, C");
+      InstrResetBit<Reg8::kC>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x9A):
+      DBG_LOG_INST("RES 3, D");
+      InstrResetBit<Reg8::kD>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x9B):
+      DBG_LOG_INST("RES 3, E");
+      InstrResetBit<Reg8::kE>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x9C):
+      DBG_LOG_INST("RES 3, H");
+      InstrResetBit<Reg8::kH>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x9D):
+      DBG_LOG_INST("RES 3, L");
+      InstrResetBit<Reg8::kL>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x9E):
+      DBG_LOG_INST("RES 3, (HL)");
+      InstrResetBit<Reg16::kHL>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0x9F):
+      DBG_LOG_INST("RES 3, A");
+      InstrResetBit<Reg8::kA>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xA0):
+      DBG_LOG_INST("RES 4, B");
+      InstrResetBit<Reg8::kB>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA1):
+      DBG_LOG_INST("RES 4, C");
+      InstrResetBit<Reg8::kC>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA2):
+      DBG_LOG_INST("RES 4, D");
+      InstrResetBit<Reg8::kD>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA3):
+      DBG_LOG_INST("RES 4, E");
+      InstrResetBit<Reg8::kE>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA4):
+      DBG_LOG_INST("RES 4, H");
+      InstrResetBit<Reg8::kH>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA5):
+      DBG_LOG_INST("RES 4, L");
+      InstrResetBit<Reg8::kL>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA6):
+      DBG_LOG_INST("RES 4, (HL)");
+      InstrResetBit<Reg16::kHL>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA7):
+      DBG_LOG_INST("RES 4, A");
+      InstrResetBit<Reg8::kA>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xA8):
+      DBG_LOG_INST("RES 5, B");
+      InstrResetBit<Reg8::kB>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xA9):
+      DBG_LOG_INST("RES 5, C");
+      InstrResetBit<Reg8::kC>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xAA):
+      DBG_LOG_INST("RES 5, D");
+      InstrResetBit<Reg8::kD>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xAB):
+      DBG_LOG_INST("RES 5, E");
+      InstrResetBit<Reg8::kE>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xAC):
+      DBG_LOG_INST("RES 5, H");
+      InstrResetBit<Reg8::kH>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xAD):
+      DBG_LOG_INST("RES 5, L");
+      InstrResetBit<Reg8::kL>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xAE):
+      DBG_LOG_INST("RES 5, (HL)");
+      InstrResetBit<Reg16::kHL>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xAF):
+      DBG_LOG_INST("RES 5, A");
+      InstrResetBit<Reg8::kA>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xB0):
+      DBG_LOG_INST("RES 6, B");
+      InstrResetBit<Reg8::kB>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB1):
+      DBG_LOG_INST("RES 6, C");
+      InstrResetBit<Reg8::kC>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB2):
+      DBG_LOG_INST("RES 6, D");
+      InstrResetBit<Reg8::kD>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB3):
+      DBG_LOG_INST("RES 6, E");
+      InstrResetBit<Reg8::kE>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB4):
+      DBG_LOG_INST("RES 6, H");
+      InstrResetBit<Reg8::kH>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB5):
+      DBG_LOG_INST("RES 6, L");
+      InstrResetBit<Reg8::kL>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB6):
+      DBG_LOG_INST("RES 6, (HL)");
+      InstrResetBit<Reg16::kHL>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB7):
+      DBG_LOG_INST("RES 6, A");
+      InstrResetBit<Reg8::kA>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xB8):
+      DBG_LOG_INST("RES 7, B");
+      InstrResetBit<Reg8::kB>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xB9):
+      DBG_LOG_INST("RES 7, C");
+      InstrResetBit<Reg8::kC>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xBA):
+      DBG_LOG_INST("RES 7, D");
+      InstrResetBit<Reg8::kD>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xBB):
+      DBG_LOG_INST("RES 7, E");
+      InstrResetBit<Reg8::kE>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xBC):
+      DBG_LOG_INST("RES 7, H");
+      InstrResetBit<Reg8::kH>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xBD):
+      DBG_LOG_INST("RES 7, L");
+      InstrResetBit<Reg8::kL>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xBE):
+      DBG_LOG_INST("RES 7, (HL)");
+      InstrResetBit<Reg16::kHL>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xBF):
+      DBG_LOG_INST("RES 7, A");
+      InstrResetBit<Reg8::kA>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xC0):
+      DBG_LOG_INST("SET 0, B");
+      InstrSetBitN<Reg8::kB>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC1):
+      DBG_LOG_INST("SET 0, C");
+      InstrSetBitN<Reg8::kC>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC2):
+      DBG_LOG_INST("SET 0, D");
+      InstrSetBitN<Reg8::kD>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC3):
+      DBG_LOG_INST("SET 0, E");
+      InstrSetBitN<Reg8::kE>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC4):
+      DBG_LOG_INST("SET 0, H");
+      InstrSetBitN<Reg8::kH>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC5):
+      DBG_LOG_INST("SET 0, L");
+      InstrSetBitN<Reg8::kL>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC6):
+      DBG_LOG_INST("SET 0, (HL)");
+      InstrSetBitN<Reg16::kHL>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC7):
+      DBG_LOG_INST("SET 0, A");
+      InstrSetBitN<Reg8::kA>(0);
+      NEXT_INSTR();
+    OPCODE_CB(0xC8):
+      DBG_LOG_INST("SET 1, B");
+      InstrSetBitN<Reg8::kB>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xC9):
+      DBG_LOG_INST("SET 1, C");
+      InstrSetBitN<Reg8::kC>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xCA):
+      DBG_LOG_INST("SET 1, D");
+      InstrSetBitN<Reg8::kD>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xCB):
+      DBG_LOG_INST("SET 1, E");
+      InstrSetBitN<Reg8::kE>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xCC):
+      DBG_LOG_INST("SET 1, H");
+      InstrSetBitN<Reg8::kH>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xCD):
+      DBG_LOG_INST("SET 1, L");
+      InstrSetBitN<Reg8::kL>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xCE):
+      DBG_LOG_INST("SET 1, (HL)");
+      InstrSetBitN<Reg16::kHL>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xCF):
+      DBG_LOG_INST("SET 1, A");
+      InstrSetBitN<Reg8::kA>(1);
+      NEXT_INSTR();
+    OPCODE_CB(0xD0):
+      DBG_LOG_INST("SET 2, B");
+      InstrSetBitN<Reg8::kB>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD1):
+      DBG_LOG_INST("SET 2, C");
+      InstrSetBitN<Reg8::kC>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD2):
+      DBG_LOG_INST("SET 2, D");
+      InstrSetBitN<Reg8::kD>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD3):
+      DBG_LOG_INST("SET 2, E");
+      InstrSetBitN<Reg8::kE>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD4):
+      DBG_LOG_INST("SET 2, H");
+      InstrSetBitN<Reg8::kH>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD5):
+      DBG_LOG_INST("SET 2, L");
+      InstrSetBitN<Reg8::kL>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD6):
+      DBG_LOG_INST("SET 2, (HL)");
+      InstrSetBitN<Reg16::kHL>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD7):
+      DBG_LOG_INST("SET 2, A");
+      InstrSetBitN<Reg8::kA>(2);
+      NEXT_INSTR();
+    OPCODE_CB(0xD8):
+      DBG_LOG_INST("SET 3, B");
+      InstrSetBitN<Reg8::kB>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xD9):
+      DBG_LOG_INST("SET 3, C");
+      InstrSetBitN<Reg8::kC>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xDA):
+      DBG_LOG_INST("SET 3, D");
+      InstrSetBitN<Reg8::kD>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xDB):
+      DBG_LOG_INST("SET 3, E");
+      InstrSetBitN<Reg8::kE>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xDC):
+      DBG_LOG_INST("SET 3, H");
+      InstrSetBitN<Reg8::kH>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xDD):
+      DBG_LOG_INST("SET 3, L");
+      InstrSetBitN<Reg8::kL>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xDE):
+      DBG_LOG_INST("SET 3, (HL)");
+      InstrSetBitN<Reg16::kHL>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xDF):
+      DBG_LOG_INST("SET 3, A");
+      InstrSetBitN<Reg8::kA>(3);
+      NEXT_INSTR();
+    OPCODE_CB(0xE0):
+      DBG_LOG_INST("SET 4, B");
+      InstrSetBitN<Reg8::kB>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE1):
+      DBG_LOG_INST("SET 4, C");
+      InstrSetBitN<Reg8::kC>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE2):
+      DBG_LOG_INST("SET 4, D");
+      InstrSetBitN<Reg8::kD>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE3):
+      DBG_LOG_INST("SET 4, E");
+      InstrSetBitN<Reg8::kE>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE4):
+      DBG_LOG_INST("SET 4, H");
+      InstrSetBitN<Reg8::kH>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE5):
+      DBG_LOG_INST("SET 4, L");
+      InstrSetBitN<Reg8::kL>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE6):
+      DBG_LOG_INST("SET 4, (HL)");
+      InstrSetBitN<Reg16::kHL>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE7):
+      DBG_LOG_INST("SET 4, A");
+      InstrSetBitN<Reg8::kA>(4);
+      NEXT_INSTR();
+    OPCODE_CB(0xE8):
+      DBG_LOG_INST("SET 5, B");
+      InstrSetBitN<Reg8::kB>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xE9):
+      DBG_LOG_INST("SET 5, C");
+      InstrSetBitN<Reg8::kC>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xEA):
+      DBG_LOG_INST("SET 5, D");
+      InstrSetBitN<Reg8::kD>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xEB):
+      DBG_LOG_INST("SET 5, E");
+      InstrSetBitN<Reg8::kE>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xEC):
+      DBG_LOG_INST("SET 5, H");
+      InstrSetBitN<Reg8::kH>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xED):
+      DBG_LOG_INST("SET 5, L");
+      InstrSetBitN<Reg8::kL>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xEE):
+      DBG_LOG_INST("SET 5, (HL)");
+      InstrSetBitN<Reg16::kHL>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xEF):
+      DBG_LOG_INST("SET 5, A");
+      InstrSetBitN<Reg8::kA>(5);
+      NEXT_INSTR();
+    OPCODE_CB(0xF0):
+      DBG_LOG_INST("SET 6, B");
+      InstrSetBitN<Reg8::kB>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF1):
+      DBG_LOG_INST("SET 6, C");
+      InstrSetBitN<Reg8::kC>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF2):
+      DBG_LOG_INST("SET 6, D");
+      InstrSetBitN<Reg8::kD>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF3):
+      DBG_LOG_INST("SET 6, E");
+      InstrSetBitN<Reg8::kE>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF4):
+      DBG_LOG_INST("SET 6, H");
+      InstrSetBitN<Reg8::kH>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF5):
+      DBG_LOG_INST("SET 6, L");
+      InstrSetBitN<Reg8::kL>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF6):
+      DBG_LOG_INST("SET 6, (HL)");
+      InstrSetBitN<Reg16::kHL>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF7):
+      DBG_LOG_INST("SET 6, A");
+      InstrSetBitN<Reg8::kA>(6);
+      NEXT_INSTR();
+    OPCODE_CB(0xF8):
+      DBG_LOG_INST("SET 7, B");
+      InstrSetBitN<Reg8::kB>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xF9):
+      DBG_LOG_INST("SET 7, C");
+      InstrSetBitN<Reg8::kC>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xFA):
+      DBG_LOG_INST("SET 7, D");
+      InstrSetBitN<Reg8::kD>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xFB):
+      DBG_LOG_INST("SET 7, E");
+      InstrSetBitN<Reg8::kE>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xFC):
+      DBG_LOG_INST("SET 7, H");
+      InstrSetBitN<Reg8::kH>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xFD):
+      DBG_LOG_INST("SET 7, L");
+      InstrSetBitN<Reg8::kL>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xFE):
+      DBG_LOG_INST("SET 7, (HL)");
+      InstrSetBitN<Reg16::kHL>(7);
+      NEXT_INSTR();
+    OPCODE_CB(0xFF):
+      DBG_LOG_INST("SET 7, A");
+      InstrSetBitN<Reg8::kA>(7);
+      NEXT_INSTR();
+    OPCODE_UNDEFINED:
+      std::cout << "UNKNOWN INSTRUCTION: 0x" << std::hex << static_cast<int>(handler) << " at PC=0x" << std::hex
                 << static_cast<int>(reg_file.PC) << std::endl;
+      DumpFlightRecorder(STDOUT_FILENO);
       exit(EXIT_FAILURE);
-      break;
+      NEXT_INSTR();
     }
 
-    local_time_delta_ += sc_time::from_value(wait_ns_);
-    auto time_limit = sc_time_to_pending_activity();
-    auto max_time = sc_max_time() - sc_time_stamp();
-    if ((time_limit <= local_time_delta_) || (time_limit == max_time) || single_step_) {
-      wait(local_time_delta_);
-      local_time_delta_ = SC_ZERO_TIME;
-    }
+    AdvanceTime();
   }
 }  // NOLINT(readability/fn_size)
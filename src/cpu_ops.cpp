@@ -7,105 +7,140 @@
 #include "utils.h"
 
 // Halts the Game Boy until an interrupt is triggered.
+// Sleeps until an interrupt source notifies intr_event. The CPU still wakes up on the 4-cycle grid
+// that starts with the HALT, just like it did when busy waiting.
 void Cpu::InstrHalt() {
-  do {
-    wait(4 * gb_const::kNsPerClkCycle, sc_core::SC_NS);  // Busy waiting.
-  } while ((*reg_intr_enable_dmi & *reg_intr_pending_dmi) == 0);
+  if (use_quantum_ && quantum_keeper_.get_local_time() != SC_ZERO_TIME)
+    Sync(kSyncHalt);  // Waiting below requires the CPU to be in sync.
+  const sc_time cycle_time(4 * gb_const::kNsPerClkCycle, sc_core::SC_NS);
+  const sc_time start = sc_time_stamp();
+  wait(cycle_time);
+  while ((*reg_intr_enable_dmi & *reg_intr_pending_dmi) == 0) {
+    wait(intr_event);
+    const sc_dt::uint64 rest = (sc_time_stamp() - start).value() % cycle_time.value();
+    if (rest != 0)
+      wait(sc_time::from_value(cycle_time.value() - rest));
+  }
+  if (use_quantum_)
+    quantum_keeper_.reset();  // The quantum keeper didn't notice the waiting.
+  wait_ns_ = 0;  // The waiting above already covers the time of HALT.
+  const u64 halted_cycles = (sc_time_stamp() - start).value() / gb_const::kNsPerClkCycle;
+  executed_cycles_ += halted_cycles;
+  if (profiler != nullptr)
+    profiler->AddCycles(GetInstrBank(), instr_pc_, *cur_opcode_, halted_cycles);
+  if (call_stack_sampler != nullptr)
+    call_stack_sampler->AddCycles(halted_cycles);
 }
 
 // NOP, does nothing.
-void Cpu::InstrNop() {
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
-}
+void Cpu::InstrNop() {}
 
 // LD reg,(u16)
-void Cpu::InstrLoad(Reg<u8>& reg, const u16& addr_val) {
+template <Reg8 kReg>
+void Cpu::InstrLoad(const u16& addr_val) {
+  u8& reg = reg_file.Get<kReg>();
   reg = ReadBus(addr_val, GbCommand::kGbReadData);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // LD reg8,(reg16)
-void Cpu::InstrLoad(Reg<u8>& reg, Reg<u16>& addr_reg) {
+template <Reg8 kReg, Reg16 kAddrReg>
+void Cpu::InstrLoad() {
+  u8& reg = reg_file.Get<kReg>();
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   reg = ReadBus(addr_reg, GbCommand::kGbReadData);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD reg16,u16
-void Cpu::InstrLoadImm(Reg<u16>& reg) {
+template <Reg16 kReg>
+void Cpu::InstrLoadImm() {
+  u16& reg = reg_file.Get<kReg>();
   reg = FetchNext2InstrBytes();
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // LD reg8,u8
-void Cpu::InstrLoadImm(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrLoadImm() {
+  u8& reg = reg_file.Get<kReg>();
   reg = FetchNextInstrByte();
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // "LD reg8,(reg16+)
-void Cpu::InstrLoadInc(Reg<u8>& reg, Reg<u16>& addr_reg) {
+template <Reg8 kReg, Reg16 kAddrReg>
+void Cpu::InstrLoadInc() {
+  u8& reg = reg_file.Get<kReg>();
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   reg = ReadBus(addr_reg, GbCommand::kGbReadData);
   ++addr_reg;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD reg8,(reg16-)
-void Cpu::InstrLoadDec(Reg<u16>& addr_reg, Reg<u8>& reg) {
+template <Reg16 kAddrReg, Reg8 kReg>
+void Cpu::InstrLoadDec() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
+  u8& reg = reg_file.Get<kReg>();
   reg = ReadBus(addr_reg, GbCommand::kGbReadData);
   --addr_reg;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD (reg16+),reg8
-void Cpu::InstrStoreInc(Reg<u16>& addr_reg, const u8 val) {
+template <Reg16 kAddrReg>
+void Cpu::InstrStoreInc(const u8 val) {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   WriteBus(addr_reg, val);
   ++addr_reg;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD (reg16-),reg8
-void Cpu::InstrStoreDec(Reg<u16>& addr_reg, const u8 val) {
+template <Reg16 kAddrReg>
+void Cpu::InstrStoreDec(const u8 val) {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   WriteBus(addr_reg, val);
   --addr_reg;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD (reg16),reg8
-void Cpu::InstrStore(const Reg<u16>& addr_reg, const Reg<u8>& reg) {
+template <Reg16 kAddrReg, Reg8 kReg>
+void Cpu::InstrStore() {
+  const u16& addr_reg = reg_file.Get<kAddrReg>();
+  const u8& reg = reg_file.Get<kReg>();
   WriteBus(addr_reg, reg);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD (reg8+0xFF),reg8
-void Cpu::InstrStore(const u8& addr_reg, const Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrStore(const u8& addr_reg) {
+  const u8& reg = reg_file.Get<kReg>();
   WriteBus(static_cast<u16>(addr_reg) + 0xFF00, reg);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // LD (u16),reg8
-void Cpu::InstrStore(const Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrStore() {
+  const u8& reg = reg_file.Get<kReg>();
   WriteBus(FetchNext2InstrBytes(), reg);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // LD (reg16), u8
-void Cpu::InstrStoreImm(Reg<u16>& addr) {
+template <Reg16 kAddr>
+void Cpu::InstrStoreImm() {
+  u16& addr = reg_file.Get<kAddr>();
   WriteBus(addr, FetchNextInstrByte());
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // LDH (u8+0xFF00), reg8
-void Cpu::InstrStoreH(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrStoreH() {
+  u8& reg = reg_file.Get<kReg>();
   WriteBus(static_cast<u16>(FetchNextInstrByte()) + 0xFF00, reg);
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // LDH reg8,(u8+0xFF00)
-void Cpu::InstrLoadH(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrLoadH() {
+  u8& reg = reg_file.Get<kReg>();
   u16 addr = static_cast<u16>(FetchNextInstrByte()) + 0xFF00;
   reg = ReadBus(addr, GbCommand::kGbReadData);
   assert(addr >= 0xFF00);
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // LDHL SP,n
@@ -118,50 +153,49 @@ void Cpu::InstrLoadHlSpRel() {
   SetFlagH(((reg ^ imm ^ (result & 0xFFFF)) & 0x10) == 0x10);
   SetFlagN(false);
   SetFlagZ(false);
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // LD SP,HL
 void Cpu::InstrLoadSpHl() {
   reg_file.SP = reg_file.HL;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // INC reg8
-void Cpu::InstrInc(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrInc() {
+  u8& reg = reg_file.Get<kReg>();
+  const bool carry = GetFlagC();
   ++reg;
-  SetFlagZ((reg == 0));
-  SetFlagN(false);
-  SetFlagH((reg & 0x0F) == 0);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpInc, 0, 0, carry, reg);
 }
 
 // INC reg16
-void Cpu::InstrInc(Reg<u16>& reg) {
+template <Reg16 kReg>
+void Cpu::InstrInc() {
+  u16& reg = reg_file.Get<kReg>();
   ++reg;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // INC (reg16)
-void Cpu::InstrIncAddr(Reg<u16>& addr) {
+template <Reg16 kAddr>
+void Cpu::InstrIncAddr() {
+  u16& addr = reg_file.Get<kAddr>();
+  const bool carry = GetFlagC();
   u8 val = ReadBus(addr, GbCommand::kGbReadData);
   ++val;
   WriteBus(addr, val);
-  SetFlagZ((val == 0));
-  SetFlagN(false);
-  SetFlagH((val & 0x0F) == 0);
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpInc, 0, 0, carry, val);
 }
 
 // DEC (reg16)
-void Cpu::InstrDecAddr(Reg<u16>& addr) {
+template <Reg16 kAddr>
+void Cpu::InstrDecAddr() {
+  u16& addr = reg_file.Get<kAddr>();
+  const bool carry = GetFlagC();
   u8 val = ReadBus(addr, GbCommand::kGbReadData);
   --val;
   WriteBus(addr, val);
-  SetFlagH((val & 0x0F) == 0x0F);
-  SetFlagN(true);
-  SetFlagZ((val == 0));
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpDec, 0, 0, carry, val);
 }
 
 // Rotate A left. Old bit 7 to carry.
@@ -171,7 +205,6 @@ void Cpu::InstrRlca() {
   SetFlagZ(false);
   SetFlagN(false);
   SetFlagC((reg_file.A & 0x01));
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // Rotate A right. Old bit 0 to carry.
@@ -182,7 +215,6 @@ void Cpu::InstrRrca() {
   SetFlagH(false);
   SetFlagN(false);
   SetFlagZ(false);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // Rotate A right. Old bit 0 to carry.
@@ -194,21 +226,23 @@ void Cpu::InstrRra() {
   SetFlagH(false);
   SetFlagN(false);
   SetFlagZ(false);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // Rotate reg8 left. Old bit 7 to Carry flag.
-void Cpu::InstrRlc(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrRlc() {
+  u8& reg = reg_file.Get<kReg>();
   reg = reg << 1 | reg >> 7;
   SetFlagH(false);
   SetFlagZ(reg == 0);
   SetFlagN(false);
   SetFlagC((reg & 0x01));
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // Rotate (reg16) left. Old bit 7 to Carry flag.
-void Cpu::InstrRlc(const Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrRlc() {
+  const u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   dat = dat << 1 | dat >> 7;
   WriteBus(addr_reg, dat);
@@ -216,21 +250,23 @@ void Cpu::InstrRlc(const Reg<u16>& addr_reg) {
   SetFlagZ(dat == 0);
   SetFlagN(false);
   SetFlagC((dat & 0x01));
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // Rotate reg8 right. Old bit 0 to carry.
-void Cpu::InstrRrc(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrRrc() {
+  u8& reg = reg_file.Get<kReg>();
   reg = reg >> 1 | reg << 7;
   SetFlagH(false);
   SetFlagZ(reg == 0);
   SetFlagN(false);
   SetFlagC((reg & 0x80));
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // Rotate (reg16) right. Old bit 0 to carry.
-void Cpu::InstrRrc(const Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrRrc() {
+  const u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   dat = dat >> 1 | dat << 7;
   WriteBus(addr_reg, dat);
@@ -238,7 +274,6 @@ void Cpu::InstrRrc(const Reg<u16>& addr_reg) {
   SetFlagZ(dat == 0);
   SetFlagN(false);
   SetFlagC((dat & 0x80));
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // LD (u16),SP
@@ -246,17 +281,17 @@ void Cpu::InstrStoreSp() {
   u16 addr = FetchNext2InstrBytes();
   WriteBus(addr, reg_file.SPlsb);
   WriteBus(addr + 1, reg_file.SPmsb);
-  wait_ns_ = 20 * gb_const::kNsPerClkCycle;
 }
 
 // ADD HL,reg16
-void Cpu::InstrAddHl(Reg<u16>& reg) {
+template <Reg16 kReg>
+void Cpu::InstrAddHl() {
+  u16& reg = reg_file.Get<kReg>();
   SetFlagH((reg_file.HL & 0x0fff) + (reg & 0x0fff) > 0x0fff);
   u16 old_val = reg_file.HL;
   reg_file.HL += reg;
   SetFlagN(false);
   SetFlagC(reg_file.HL < old_val);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // ADD SP,i8
@@ -269,296 +304,232 @@ void Cpu::InstrAddSp() {
   SetFlagN(false);
   SetFlagC(((reg ^ data ^ (result & 0xFFFF)) & 0x100) == 0x100);
   SetFlagZ(false);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // ADD A,reg8
-void Cpu::InstrAddA(Reg<u8>& reg) {
-  SetFlagH((reg_file.A & 0x0f) + (reg & 0x0f) > 0x0f);
-  u8 old_val = reg;
-  reg_file.A += reg;
-  SetFlagN(false);
-  SetFlagC(reg_file.A < old_val);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+template <Reg8 kReg>
+void Cpu::InstrAddA() {
+  u8& reg = reg_file.Get<kReg>();
+  const u8 lhs = reg_file.A;
+  const u8 rhs = reg;
+  reg_file.A += rhs;
+  SetFlagsLazy(kFlagOpAdd, lhs, rhs, 0, reg_file.A);
 }
 
 // ADD A,(reg16)
-void Cpu::InstrAddA(Reg<u16>& addr_reg) {
-  u8 reg = ReadBus(addr_reg, GbCommand::kGbReadData);
-  SetFlagH((reg_file.A & 0x0f) + (reg & 0x0f) > 0x0f);
-  reg_file.A += reg;
-  SetFlagN(false);
-  SetFlagC(reg_file.A < reg);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+template <Reg16 kAddrReg>
+void Cpu::InstrAddA() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
+  const u8 lhs = reg_file.A;
+  const u8 rhs = ReadBus(addr_reg, GbCommand::kGbReadData);
+  reg_file.A += rhs;
+  SetFlagsLazy(kFlagOpAdd, lhs, rhs, 0, reg_file.A);
 }
 
 // ADD A,u8
 void Cpu::InstrAddAImm() {
-  u8 imm = FetchNextInstrByte();
-  SetFlagH((reg_file.A & 0x0f) + (imm & 0x0f) > 0x0f);
-  reg_file.A += imm;
-  SetFlagN(false);
-  SetFlagC(reg_file.A < imm);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  const u8 lhs = reg_file.A;
+  const u8 rhs = FetchNextInstrByte();
+  reg_file.A += rhs;
+  SetFlagsLazy(kFlagOpAdd, lhs, rhs, 0, reg_file.A);
 }
 
 // ADC A,reg8: Add reg8 + carry flag to A.
-void Cpu::InstrAddACarry(Reg<u8>& reg) {
-  u8 carry_add = GetFlagC() ? 1 : 0;
-  u8 old_val = reg_file.A;
-  SetFlagH((reg_file.A & 0x0f) + (reg & 0x0f) + carry_add > 0x0f);
-  reg_file.A += reg + carry_add;
-  SetFlagN(false);
-  SetFlagC((reg_file.A < old_val) || (reg_file.A == old_val && carry_add == 1));
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+template <Reg8 kReg>
+void Cpu::InstrAddACarry() {
+  u8& reg = reg_file.Get<kReg>();
+  const u8 carry = GetFlagC() ? 1 : 0;
+  const u8 lhs = reg_file.A;
+  const u8 rhs = reg;
+  reg_file.A += rhs + carry;
+  SetFlagsLazy(kFlagOpAdd, lhs, rhs, carry, reg_file.A);
 }
 
 // ADC A,(reg16): Add (reg16) + carry flag to A.
-void Cpu::InstrAddACarry(Reg<u16>& addr_reg) {
-  u8 reg = ReadBus(addr_reg, GbCommand::kGbReadData);
-  u8 carry_add = GetFlagC() ? 1 : 0;
-  u8 old_val = reg_file.A;
-  SetFlagH((reg_file.A & 0x0f) + (reg & 0x0f) + carry_add > 0x0f);
-  reg_file.A += reg + carry_add;
-  SetFlagN(false);
-  SetFlagC(reg_file.A < old_val || (reg_file.A == old_val && carry_add == 1));
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+template <Reg16 kAddrReg>
+void Cpu::InstrAddACarry() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
+  const u8 rhs = ReadBus(addr_reg, GbCommand::kGbReadData);
+  const u8 carry = GetFlagC() ? 1 : 0;
+  const u8 lhs = reg_file.A;
+  reg_file.A += rhs + carry;
+  SetFlagsLazy(kFlagOpAdd, lhs, rhs, carry, reg_file.A);
 }
 
 // ADC A,u8: Add u8 + carry flag to A.
 void Cpu::InstrAddACarryImm() {
-  u8 reg = FetchNextInstrByte();
-  u8 old_val = reg_file.A;
-  u8 carry_add = GetFlagC() ? 1 : 0;
-  SetFlagH((reg_file.A & 0x0f) + (reg & 0x0f) + carry_add > 0x0f);
-  reg_file.A += reg + carry_add;
-  SetFlagN(false);
-  SetFlagC(reg_file.A < old_val || (reg_file.A == old_val && carry_add == 1));
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  const u8 rhs = FetchNextInstrByte();
+  const u8 carry = GetFlagC() ? 1 : 0;
+  const u8 lhs = reg_file.A;
+  reg_file.A += rhs + carry;
+  SetFlagsLazy(kFlagOpAdd, lhs, rhs, carry, reg_file.A);
 }
 
 // SUB (d8): subtract immediate from register A.
 void Cpu::InstrSubImm() {
-  u8 pre_val = reg_file.A;
-  int8_t imm = FetchNextInstrByte();
-  reg_file.A -= imm;
-  SetFlagC(reg_file.A > pre_val);
-  SetFlagH(((pre_val & 0xf) - (imm & 0xf)) < 0);
-  SetFlagZ(reg_file.A == 0);
-  SetFlagN(true);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  const u8 lhs = reg_file.A;
+  const u8 rhs = FetchNextInstrByte();
+  reg_file.A -= rhs;
+  SetFlagsLazy(kFlagOpSub, lhs, rhs, 0, reg_file.A);
 }
 
 // SUB reg8: Subtract reg8 from register A.
-void Cpu::InstrSub(Reg<u8>& reg) {
-  u8 pre_val = reg_file.A;
-  u8 old_reg_val = reg;
-  reg_file.A -= reg;
-  SetFlagC(reg_file.A > pre_val);
-  SetFlagH(((pre_val & 0xf) - (old_reg_val & 0xf)) < 0);
-  SetFlagZ(reg_file.A == 0);
-  SetFlagN(true);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+template <Reg8 kReg>
+void Cpu::InstrSub() {
+  u8& reg = reg_file.Get<kReg>();
+  const u8 lhs = reg_file.A;
+  const u8 rhs = reg;
+  reg_file.A -= rhs;
+  SetFlagsLazy(kFlagOpSub, lhs, rhs, 0, reg_file.A);
 }
 
 // SUB (reg16): Subtract (reg16) from register A.
-void Cpu::InstrSub(Reg<u16>& addr_reg) {
-  u8 reg = ReadBus(addr_reg, GbCommand::kGbReadData);
-  u8 pre_val = reg_file.A;
-  reg_file.A -= reg;
-  SetFlagC(reg_file.A > pre_val);
-  SetFlagH(((pre_val & 0xf) - (reg & 0xf)) < 0);
-  SetFlagZ(reg_file.A == 0);
-  SetFlagN(true);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+template <Reg16 kAddrReg>
+void Cpu::InstrSub() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
+  const u8 rhs = ReadBus(addr_reg, GbCommand::kGbReadData);
+  const u8 lhs = reg_file.A;
+  reg_file.A -= rhs;
+  SetFlagsLazy(kFlagOpSub, lhs, rhs, 0, reg_file.A);
 }
 
 // SBC A,reg8: Subtract reg8 and carry from register A.
-void Cpu::InstrSubCarry(Reg<u8>& reg) {
-  u8 carry_sub = GetFlagC() ? 1 : 0;
-  u8 old_val = reg_file.A;
-  reg_file.A -= (reg + carry_sub);
-  SetFlagC(reg_file.A > old_val || (reg_file.A == old_val && carry_sub == 1));
-  SetFlagH(((old_val & 0xf) - (reg & 0xf) - carry_sub) < 0);
-  SetFlagZ(reg_file.A == 0);
-  SetFlagN(true);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+template <Reg8 kReg>
+void Cpu::InstrSubCarry() {
+  u8& reg = reg_file.Get<kReg>();
+  const u8 carry = GetFlagC() ? 1 : 0;
+  const u8 lhs = reg_file.A;
+  const u8 rhs = reg;
+  reg_file.A -= rhs + carry;
+  SetFlagsLazy(kFlagOpSub, lhs, rhs, carry, reg_file.A);
 }
 
 // SBC A,(reg16): Subtract (reg16) and carry from register A.
-void Cpu::InstrSubCarry(Reg<u16>& addr_reg) {
-  u8 reg = ReadBus(addr_reg, GbCommand::kGbReadData);
-  u8 carry_sub = GetFlagC() ? 1 : 0;
-  u8 old_val = reg_file.A;
-  reg_file.A -= (reg + carry_sub);
-  SetFlagC(reg_file.A > old_val || (reg_file.A == old_val && carry_sub == 1));
-  SetFlagH(((old_val & 0xf) - (reg & 0xf) - carry_sub) < 0);
-  SetFlagZ(reg_file.A == 0);
-  SetFlagN(true);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+template <Reg16 kAddrReg>
+void Cpu::InstrSubCarry() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
+  const u8 rhs = ReadBus(addr_reg, GbCommand::kGbReadData);
+  const u8 carry = GetFlagC() ? 1 : 0;
+  const u8 lhs = reg_file.A;
+  reg_file.A -= rhs + carry;
+  SetFlagsLazy(kFlagOpSub, lhs, rhs, carry, reg_file.A);
 }
 
 // SBC A, u8: Subtract immediate and carry form register A.
 void Cpu::InstrSubCarryImm() {
-  u8 dat = FetchNextInstrByte();
-  u8 carry_sub = GetFlagC() ? 1 : 0;
-  u8 old_val = reg_file.A;
-  reg_file.A -= (dat + carry_sub);
-  SetFlagC(reg_file.A > old_val || (reg_file.A == old_val && carry_sub == 1));
-  SetFlagH(((old_val & 0xf) - (dat & 0xf) - carry_sub) < 0);
-  SetFlagZ(reg_file.A == 0);
-  SetFlagN(true);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  const u8 rhs = FetchNextInstrByte();
+  const u8 carry = GetFlagC() ? 1 : 0;
+  const u8 lhs = reg_file.A;
+  reg_file.A -= rhs + carry;
+  SetFlagsLazy(kFlagOpSub, lhs, rhs, carry, reg_file.A);
 }
 
 // CP A,reg8: Compare A with reg8.
 // Basically an A-reg8  subtraction instruction but the results are thrown away.
-void Cpu::InstrComp(Reg<u8>& reg) {
-  u8 pre_val = reg_file.A;
-  u8 result = reg_file.A - reg;
-  SetFlagC(result > pre_val);
-  SetFlagH(((pre_val & 0xf) - (reg & 0xf)) < 0);
-  SetFlagZ(result == 0);
-  SetFlagN(true);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+template <Reg8 kReg>
+void Cpu::InstrComp() {
+  u8& reg = reg_file.Get<kReg>();
+  const u8 rhs = reg;
+  SetFlagsLazy(kFlagOpSub, reg_file.A, rhs, 0, reg_file.A - rhs);
 }
 
 // CP A,(reg16): Compare A with (reg16).
 // Basically an A-(reg16) subtraction instruction but the results are thrown away.
-void Cpu::InstrComp(Reg<u16>& reg) {
-  u8 pre_val = reg_file.A;
-  u8 read_reg = ReadBus(reg, GbCommand::kGbReadData);
-  u8 result = reg_file.A - read_reg;
-  SetFlagC(result > pre_val);
-  SetFlagH(((pre_val & 0xf) - (read_reg & 0xf)) < 0);
-  SetFlagZ(result == 0);
-  SetFlagN(true);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+template <Reg16 kReg>
+void Cpu::InstrComp() {
+  u16& reg = reg_file.Get<kReg>();
+  const u8 rhs = ReadBus(reg, GbCommand::kGbReadData);
+  SetFlagsLazy(kFlagOpSub, reg_file.A, rhs, 0, reg_file.A - rhs);
 }
 
 // CP A,u8: Compare A with u8.
 // Basically an A-u8 subtraction instruction but the results are thrown  away.
 void Cpu::InstrCompImm() {
-  u8 imm = FetchNextInstrByte();
-  u8 pre_val = reg_file.A;
-  u8 result = reg_file.A - imm;
+  const u8 imm = FetchNextInstrByte();
   DBG_LOG_INST("d8 = 0x" << std::hex << static_cast<uint>(imm));
-  SetFlagC(result > pre_val);
-  SetFlagH(((pre_val & 0xf) - (imm & 0xf)) < 0);
-  SetFlagZ(result == 0);
-  SetFlagN(true);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpSub, reg_file.A, imm, 0, reg_file.A - imm);
 }
 
 // DEC reg16
-void Cpu::InstrDec(Reg<u16>& reg) {
+template <Reg16 kReg>
+void Cpu::InstrDec() {
+  u16& reg = reg_file.Get<kReg>();
   --reg;
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // DEC reg8
-void Cpu::InstrDec(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrDec() {
+  u8& reg = reg_file.Get<kReg>();
+  const bool carry = GetFlagC();
   --reg;
-  SetFlagH((reg & 0x0F) == 0x0F);
-  SetFlagN(true);
-  SetFlagZ((reg == 0));
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpDec, 0, 0, carry, reg);
 }
 
 // XOR A,reg8
-void Cpu::InstrXor(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrXor() {
+  u8& reg = reg_file.Get<kReg>();
   reg_file.A ^= reg;
-  SetFlagC(false);
-  SetFlagH(false);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpOr, 0, 0, 0, reg_file.A);
 }
 
 // XOR A,(reg16)
-void Cpu::InstrXor(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrXor() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   reg_file.A ^= ReadBus(addr_reg, GbCommand::kGbReadData);
-  SetFlagC(false);
-  SetFlagH(false);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpOr, 0, 0, 0, reg_file.A);
 }
 
 // XOR A,u8
 void Cpu::InstrXorImm() {
   reg_file.A ^= FetchNextInstrByte();
-  SetFlagC(false);
-  SetFlagH(false);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpOr, 0, 0, 0, reg_file.A);
 }
 
 // AND A,reg8
-void Cpu::InstrAnd(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrAnd() {
+  u8& reg = reg_file.Get<kReg>();
   reg_file.A &= reg;
-  SetFlagC(false);
-  SetFlagH(true);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpAnd, 0, 0, 0, reg_file.A);
 }
 
 // AND A,reg16
-void Cpu::InstrAnd(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrAnd() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   reg_file.A &= ReadBus(addr_reg, GbCommand::kGbReadData);
-  SetFlagC(false);
-  SetFlagH(true);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpAnd, 0, 0, 0, reg_file.A);
 }
 
 // AND A,u8
 void Cpu::InstrAndImm() {
   reg_file.A &= FetchNextInstrByte();
-  SetFlagC(false);
-  SetFlagH(true);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpAnd, 0, 0, 0, reg_file.A);
 }
 
 // OR A,reg8
-void Cpu::InstrOr(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrOr() {
+  u8& reg = reg_file.Get<kReg>();
   reg_file.A |= reg;
-  SetFlagC(false);
-  SetFlagH(false);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpOr, 0, 0, 0, reg_file.A);
 }
 
 // OR A,reg16
-void Cpu::InstrOr(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrOr() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   reg_file.A |= ReadBus(addr_reg, GbCommand::kGbReadData);
-  SetFlagC(false);
-  SetFlagH(false);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpOr, 0, 0, 0, reg_file.A);
 }
 
 // OR A,u8
 void Cpu::InstrOrImm() {
   reg_file.A |= FetchNextInstrByte();
-  SetFlagC(false);
-  SetFlagH(false);
-  SetFlagN(false);
-  SetFlagZ(reg_file.A == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+  SetFlagsLazy(kFlagOpOr, 0, 0, 0, reg_file.A);
 }
 
 // JR PC+1+i8
@@ -566,19 +537,18 @@ void Cpu::InstrJump() {
   int tmp_pc = static_cast<int>(reg_file.PC);
   int tmp_instr = static_cast<int>(static_cast<int8_t>(FetchNextInstrByte()));
   reg_file.PC = static_cast<u16>(tmp_pc + 1 + tmp_instr);
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // JR reg16: Jump to address in reg16.
-void Cpu::InstrJump(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrJump() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   reg_file.PC = addr_reg;
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // JR u16: Jump to u16.
 void Cpu::InstrJumpAddr() {
   reg_file.PC = FetchNext2InstrBytes();
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // JP cond,reg: Jump to reg8+PC+1 if cond is true.
@@ -587,10 +557,9 @@ void Cpu::InstrJumpIf(bool cond) {
     int tmp_pc = static_cast<int>(reg_file.PC);
     int tmp_instr = static_cast<int>(static_cast<int8_t>(FetchNextInstrByte()));
     reg_file.PC = static_cast<u16>(tmp_pc + tmp_instr + 1);
-    wait_ns_ = 12 * gb_const::kNsPerClkCycle;
+    TakeBranch();
   } else {
     FetchNextInstrByte();
-    wait_ns_ = 8 * gb_const::kNsPerClkCycle;
   }
 }
 
@@ -599,42 +568,44 @@ void Cpu::InstrJumpAddrIf(bool cond) {
   u16 jmp_addr = FetchNext2InstrBytes();
   if (cond) {
     reg_file.PC = jmp_addr;
-    wait_ns_ = 16 * gb_const::kNsPerClkCycle;
-  } else {
-    wait_ns_ = 12 * gb_const::kNsPerClkCycle;
+    TakeBranch();
   }
 }
 
 // BIT ind,reg8: set z flag if bit ind of register reg8 is 0.
 // Note, this is a little counter-intuitive as the Z flag is set when the bit is 0.
-void Cpu::InstrBitN(uint bit_index, Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrBitN(uint bit_index) {
+  u8& reg = reg_file.Get<kReg>();
   SetFlagH(true);
   SetFlagN(false);
   SetFlagZ(!IsBitSet(reg, bit_index));
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // BIT ind,(reg16): set z flag bit b of address (reg16)
 // Note, this is a little counter-intuitive as the Z flag is set when the bit is 0
-void Cpu::InstrBitN(uint bit_index, Reg<u16>& addr) {
+template <Reg16 kAddr>
+void Cpu::InstrBitN(uint bit_index) {
+  u16& addr = reg_file.Get<kAddr>();
   SetFlagH(true);
   SetFlagN(false);
   SetFlagZ(!IsBitSet(ReadBus(addr, GbCommand::kGbReadData), bit_index));
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
 }
 
 // SET ind,reg8
-void Cpu::InstrSetBitN(uint bit_index, Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrSetBitN(uint bit_index) {
+  u8& reg = reg_file.Get<kReg>();
   reg = SetBit(reg, true, bit_index);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // SET ind,(reg16)
-void Cpu::InstrSetBitN(uint bit_index, Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrSetBitN(uint bit_index) {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 tmp = ReadBus(addr_reg, GbCommand::kGbReadData);
   tmp = SetBit(tmp, true, bit_index);
   WriteBus(addr_reg, tmp);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // CALL u16: Push address of next instruction onto stack and then jump to u16.
@@ -644,7 +615,7 @@ void Cpu::InstrCall() {
   WriteBus(--reg_file.SP, reg_file.PCmsb);
   WriteBus(--reg_file.SP, reg_file.PClsb);
   reg_file.PC = jmp_addr;
-  wait_ns_ = 24 * gb_const::kNsPerClkCycle;
+  TrackCall();
 }
 
 // CALL cond,u16: Push address of next instruction onto stack and then jump to u16 if cond is true.
@@ -657,25 +628,25 @@ void Cpu::InstrCallIf(bool cond) {
     --reg_file.SP;
     WriteBus(reg_file.SP, reg_file.PClsb);
     reg_file.PC = jmp_addr;
-    wait_ns_ = 24 * gb_const::kNsPerClkCycle;
-  } else {
-    wait_ns_ = 12 * gb_const::kNsPerClkCycle;
+    TakeBranch();
+    TrackCall();
   }
 }
 
 // RET: Pop two bytes from stack & jump to that address.
 void Cpu::InstrRet() {
+  TrackReturn();
   u16 lsb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
   ++reg_file.SP;
   u16 msb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
   msb <<= 8;
   ++reg_file.SP;
   reg_file.PC = msb | lsb;
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // RETI: Pop two bytes from stack and jump to that address and enable interrupts.
 void Cpu::InstrRetI() {
+  TrackReturn();
   u16 lsb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
   ++reg_file.SP;
   u16 msb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
@@ -683,20 +654,22 @@ void Cpu::InstrRetI() {
   ++reg_file.SP;
   reg_file.PC = msb | lsb;
   intr_master_enable = true;
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // PUSH reg16: Push register reg16 onto stack. Decrement Stack Pointer (SP) by two.
-void Cpu::InstrPush(Reg<u16>& reg) {
+template <Reg16 kReg>
+void Cpu::InstrPush() {
+  u16& reg = reg_file.Get<kReg>();
   --reg_file.SP;
   WriteBus(reg_file.SP, static_cast<u8>(reg >> 8));  // msb
   --reg_file.SP;
   WriteBus(reg_file.SP, static_cast<u8>(reg & 0x00FF));  // lsb
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // POP reg16: Pop two bytes off stack into register pair nn. Increment Stack Pointer (SP) by two.
-void Cpu::InstrPop(Reg<u16>& reg) {
+template <Reg16 kReg>
+void Cpu::InstrPop() {
+  u16& reg = reg_file.Get<kReg>();
   u8 f_tmp = reg_file.F & 0x0F;  // The lower four registers always read as zero!
   u16 lsb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
   ++reg_file.SP;
@@ -705,17 +678,32 @@ void Cpu::InstrPop(Reg<u16>& reg) {
   msb <<= 8;
   reg = msb | lsb;
   reg_file.F = (reg_file.F & 0xF0) | f_tmp;
-  wait_ns_ = 12 * gb_const::kNsPerClkCycle;
+}
+
+// POP AF: Like POP reg16 but replaces all flags.
+void Cpu::InstrPopAF() {
+  flag_op_ = kFlagOpNone;  // Pending flags are overwritten anyway.
+  InstrPop<Reg16::kAF>();
+}
+
+// PUSH AF: Like PUSH reg16 but the flags have to be up to date.
+void Cpu::InstrPushAF() {
+  UpdateFlags();
+  InstrPush<Reg16::kAF>();
 }
 
 // LD reg8,reg8: Register to register transfer.
-void Cpu::InstrMov(Reg<u8>& reg_to, Reg<u8>& reg_from) {
+template <Reg8 kRegTo, Reg8 kRegFrom>
+void Cpu::InstrMov() {
+  u8& reg_to = reg_file.Get<kRegTo>();
+  u8& reg_from = reg_file.Get<kRegFrom>();
   reg_to = reg_from;
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // RL reg8
-void Cpu::InstrRotLeft(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrRotLeft() {
+  u8& reg = reg_file.Get<kReg>();
   bool old_carry = GetFlagC();
   SetFlagC(reg & 0b10000000);
   reg <<= 1;
@@ -723,11 +711,12 @@ void Cpu::InstrRotLeft(Reg<u8>& reg) {
   SetFlagZ(reg == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // RL (reg16)
-void Cpu::InstrRotLeft(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrRotLeft() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   bool old_carry = GetFlagC();
   SetFlagC(dat & 0b10000000);
@@ -737,11 +726,12 @@ void Cpu::InstrRotLeft(Reg<u16>& addr_reg) {
   SetFlagZ(dat == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // RR reg8
-void Cpu::InstrRotRight(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrRotRight() {
+  u8& reg = reg_file.Get<kReg>();
   bool old_carry = GetFlagC();
   SetFlagC(reg & 1);
   reg = reg >> 1;
@@ -749,11 +739,12 @@ void Cpu::InstrRotRight(Reg<u8>& reg) {
   SetFlagZ(reg == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // RR (reg16)
-void Cpu::InstrRotRight(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrRotRight() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   bool old_carry = GetFlagC();
   SetFlagC(dat & 1);
@@ -763,7 +754,6 @@ void Cpu::InstrRotRight(Reg<u16>& addr_reg) {
   SetFlagZ(dat == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // RLA: Note, GBCPUMan and opcode missmatch (zero flag)
@@ -775,22 +765,24 @@ void Cpu::InstrRotLeftA() {
   SetFlagZ(false);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // SRL reg8
-void Cpu::InstrShiftRight(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrShiftRight() {
+  u8& reg = reg_file.Get<kReg>();
   u8 tmp = reg;
   reg = reg >> 1;
   SetFlagC(tmp & gb_const::kMaskBit0);
   SetFlagZ(reg == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // SRL reg16
-void Cpu::InstrShiftRight(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrShiftRight() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   u8 tmp = dat;
   dat = dat >> 1;
@@ -799,38 +791,36 @@ void Cpu::InstrShiftRight(Reg<u16>& addr_reg) {
   SetFlagZ(dat == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // DI
 void Cpu::InstrDI() {
   intr_master_enable = false;
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // EI
 void Cpu::InstrEI() {
   intr_master_enable = true;
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // RET cond: Pop two bytes from stack & jump to that address if cond is true
 void Cpu::InstrRetIf(bool cond) {
   if (cond) {
+    TrackReturn();
     u16 lsb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
     ++reg_file.SP;
     u16 msb = static_cast<u16>(ReadBus(reg_file.SP, GbCommand::kGbReadData));
     msb <<= 8;
     ++reg_file.SP;
     reg_file.PC = msb | lsb;
-    wait_ns_ = 20 * gb_const::kNsPerClkCycle;
-  } else {
-    wait_ns_ = 8 * gb_const::kNsPerClkCycle;
+    TakeBranch();
   }
 }
 
 // SWAP reg8
-void Cpu::InstrSwap(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrSwap() {
+  u8& reg = reg_file.Get<kReg>();
   u8 old_upper_nib = reg >> 4;
   u8 old_lower_nib = reg << 4;
   reg = old_lower_nib | old_upper_nib;
@@ -838,11 +828,12 @@ void Cpu::InstrSwap(Reg<u8>& reg) {
   SetFlagZ(reg == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // SWAP reg16
-void Cpu::InstrSwap(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrSwap() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   u8 old_upper_nib = dat >> 4;
   u8 old_lower_nib = dat << 4;
@@ -852,7 +843,6 @@ void Cpu::InstrSwap(Reg<u16>& addr_reg) {
   SetFlagZ(dat == 0);
   SetFlagN(false);
   SetFlagH(false);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // RST u8
@@ -862,21 +852,23 @@ void Cpu::InstrRST(const u8 addr) {
   --reg_file.SP;
   WriteBus(reg_file.SP, reg_file.PClsb);
   reg_file.PC = addr;
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;  // TODO(niko): PDF and opcode table differ.
+  TrackCall();
 }
 
 // RES bit, reg8
-void Cpu::InstrResetBit(const uint bit, Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrResetBit(const uint bit) {
+  u8& reg = reg_file.Get<kReg>();
   reg = reg & ~(1 << bit);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // RES bit, (reg16)
-void Cpu::InstrResetBit(const uint bit, Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrResetBit(const uint bit) {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 res = ReadBus(addr_reg, GbCommand::kGbReadData);
   res = res & ~(1 << bit);
   WriteBus(addr_reg, res);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // CPL: Complement of register A.
@@ -884,22 +876,24 @@ void Cpu::InstrComplement() {
   reg_file.A = ~reg_file.A;
   SetFlagH(true);
   SetFlagN(true);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // SLA reg8: Shift left into carry.
-void Cpu::InstrSLA(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrSLA() {
+  u8& reg = reg_file.Get<kReg>();
   u8 carry_bit = reg & gb_const::kMaskBit7;
   reg = reg << 1;
   SetFlagC(carry_bit);
   SetFlagH(false);
   SetFlagN(false);
   SetFlagZ(reg == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // InstrSLA (reg16)
-void Cpu::InstrSLA(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrSLA() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   u8 carry_bit = dat & gb_const::kMaskBit7;
   dat = dat << 1;
@@ -908,13 +902,12 @@ void Cpu::InstrSLA(Reg<u16>& addr_reg) {
   SetFlagH(false);
   SetFlagN(false);
   SetFlagZ(dat == 0);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // Not part of the original ISA. Stops the simulation.
 // The value of register A determines the reason for stop.
 void Cpu::InstrEmu() {
-  switch (reg_file.B.val()) {
+  switch (reg_file.B) {
   case 0:
     cpu_state = kTestPassed;
     break;
@@ -951,7 +944,6 @@ void Cpu::InstrDAA() {
   SetFlagH(false);
   SetFlagZ(reg == 0);
   reg_file.A = reg;
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // SCF
@@ -959,7 +951,6 @@ void Cpu::InstrSCF() {
   SetFlagC(true);
   SetFlagH(false);
   SetFlagN(false);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // CCF
@@ -967,11 +958,12 @@ void Cpu::InstrCCF() {
   SetFlagC(!GetFlagC());
   SetFlagH(false);
   SetFlagN(false);
-  wait_ns_ = 4 * gb_const::kNsPerClkCycle;
 }
 
 // Shift n right into Carry. MSB doesn't change.
-void Cpu::InstrSRA(Reg<u8>& reg) {
+template <Reg8 kReg>
+void Cpu::InstrSRA() {
+  u8& reg = reg_file.Get<kReg>();
   u8 carry_bit = reg & 1;
   u8 top_bit = reg & gb_const::kMaskBit7;
   reg = reg >> 1 | top_bit;
@@ -979,11 +971,12 @@ void Cpu::InstrSRA(Reg<u8>& reg) {
   SetFlagH(false);
   SetFlagN(false);
   SetFlagZ(reg == 0);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
 
 // SRA reg8
-void Cpu::InstrSRA(Reg<u16>& addr_reg) {
+template <Reg16 kAddrReg>
+void Cpu::InstrSRA() {
+  u16& addr_reg = reg_file.Get<kAddrReg>();
   u8 dat = ReadBus(addr_reg, GbCommand::kGbReadData);
   u8 carry_bit = dat & 1;
   u8 top_bit = dat & gb_const::kMaskBit7;
@@ -993,11 +986,9 @@ void Cpu::InstrSRA(Reg<u16>& addr_reg) {
   SetFlagH(false);
   SetFlagN(false);
   SetFlagZ(result == 0);
-  wait_ns_ = 16 * gb_const::kNsPerClkCycle;
 }
 
 // LD A,(C).
 void Cpu::InstrLoadC() {
   reg_file.A = ReadBus(0xFF00 + reg_file.C, GbCommand::kGbReadData);
-  wait_ns_ = 8 * gb_const::kNsPerClkCycle;
 }
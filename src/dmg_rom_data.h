@@ -44,7 +44,7 @@ static constexpr u8 kQuickBoot[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x01, 0xe0, 0x50};
 
-unsigned int dmg_boot_bin_len = 256;
+static constexpr unsigned int dmg_boot_bin_len = 256;
 
 static constexpr std::span<const u8> kSpan{kOriginalBoot};
 static constexpr std::span<const u8> kQuickBootSpan{kQuickBoot};
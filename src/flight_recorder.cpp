@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "flight_recorder.h"
+
+#include <signal.h>
+
+#include <csignal>
+
+namespace {
+void (*crash_dump)(void* opaque) = nullptr;
+void* crash_dump_opaque = nullptr;
+
+void HandleCrash(int sig) {
+  // SA_RESETHAND restored the default action, so a crash inside the dump doesn't recurse.
+  if (crash_dump != nullptr)
+    crash_dump(crash_dump_opaque);
+  std::raise(sig);
+}
+}  // namespace
+
+void FlightRecorder::InstallCrashHandler(void (*dump)(void* opaque), void* opaque) {
+  crash_dump = dump;
+  crash_dump_opaque = opaque;
+
+  static std::array<char, 1 << 16> alt_stack;
+  stack_t stack = {};
+  stack.ss_sp = alt_stack.data();
+  stack.ss_size = alt_stack.size();
+  sigaltstack(&stack, nullptr);
+
+  struct sigaction action = {};
+  action.sa_handler = HandleCrash;
+  action.sa_flags = SA_ONSTACK | SA_RESETHAND | SA_NODEFER;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGSEGV, &action, nullptr);
+  sigaction(SIGABRT, &action, nullptr);
+}
@@ -0,0 +1,63 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * The FlightRecorder keeps the last kNumEntries executed instructions in a
+ * fixed-size ring buffer. It is always on and costs only a few stores per
+ * instruction. When the emulation crashes (or on --dump-on-exit), the entries
+ * are decoded into a human-readable post-mortem.
+ * There's a single writer (the CPU). Readers are the crash handler, which
+ * interrupts the writer on the same thread, and the end of the simulation.
+ * Hence, the ring buffer needs no locks. If a signal interrupts the recording,
+ * the newest entry may be incomplete.
+ ******************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "common.h"
+
+class FlightRecorder {
+ public:
+  constexpr static size_t kNumEntries = 4096;  // Has to be a power of two.
+
+  struct Entry {
+    u64 cycles;                   // Clock cycles the CPU executed before the instruction.
+    std::array<u16, 5> regs;      // AF, BC, DE, HL, SP before the instruction.
+    u16 pc;                       // Address of the opcode.
+    u16 handler;                  // Index in kOpcodeTable (0x100-0x1FF for CB-prefixed instructions).
+    std::array<u8, 3> bytes;      // The instruction, i.e., the opcode followed by its operands.
+    bool native;                  // A block of the JIT that starts with this instruction.
+    std::array<u8, 5> flag_data;  // State of the lazy flag evaluation. F may be stale without it.
+  };
+
+  FlightRecorder() : entries_(kNumEntries) {}
+
+  // Returns the entry for the next instruction, which overwrites the oldest entry.
+  Entry& Next() {
+    const u64 pos = pos_.load(std::memory_order_relaxed);
+    pos_.store(pos + 1, std::memory_order_relaxed);
+    return entries_[pos & (kNumEntries - 1)];
+  }
+
+  // Calls func(entry) for the recorded entries from the oldest to the newest.
+  template <typename Func>
+  void ForEach(Func func) const {
+    const u64 pos = pos_.load(std::memory_order_relaxed);
+    for (u64 i = (pos > kNumEntries) ? pos - kNumEntries : 0; i < pos; ++i)
+      func(entries_[i & (kNumEntries - 1)]);
+  }
+
+  // Number of instructions that have been recorded in total.
+  u64 GetNumRecorded() const { return pos_.load(std::memory_order_relaxed); }
+
+  // Calls dump(opaque) on SIGSEGV and SIGABRT. Afterwards, the default action of the signal takes place.
+  // The handler runs on an alternate stack, so it also works after a stack overflow.
+  static void InstallCrashHandler(void (*dump)(void* opaque), void* opaque);
+
+ private:
+  std::vector<Entry> entries_;
+  std::atomic<u64> pos_ = 0;
+};
@@ -6,21 +6,25 @@
 
 GbTop::GbTop(sc_module_name name, const Options& options)
     : sc_module(name),
-      cartridge("cartridge", options.rom_path, options.boot_rom_path, options.symbol_file, options.quick_boot),
+      memory_arena(std::make_unique<MemoryArena>()),
+      cartridge("cartridge", options.rom_path, options.boot_rom_path, options.symbol_file, options.quick_boot,
+                std::chrono::milliseconds(options.save_flush_ms),
+                options.rtc_source == "host" ? RtcSource::kHost : RtcSource::kEmulated),
       apu("apu"),
       bus("bus"),
-      cpu("cpu", options.wait_for_gdb, options.single_step),
+      cpu("cpu", options.wait_for_gdb, options.single_step, options.cpu_backend == "jit",
+          static_cast<u32>(options.quantum_cycles)),
       joy_pad("joy_pad"),
-      video_ram(8192, "video_ram"),
-      work_ram(4096, "work_ram"),
-      work_ram_n(4096, "work_ram_n"),
-      echo_ram(4096, "echo_work_ram_n", work_ram.GetDataPtr()),
-      echo_ram_n(4096, "echo_ram_n", work_ram_n.GetDataPtr()),
-      obj_attr_mem(160, "obj_attr_mem"),
-      high_ram(127, "high_ram"),
-      reg_if(1, "reg_if"),
-      intr_enable(1, "intr_enable"),
-      io_registers("io_registers"),
+      video_ram(8192, "video_ram", memory_arena->GetPtr(0x8000)),
+      work_ram(4096, "work_ram", memory_arena->GetPtr(0xC000)),
+      work_ram_n(4096, "work_ram_n", memory_arena->GetPtr(0xD000)),
+      echo_ram(4096, "echo_work_ram_n", memory_arena->GetPtr(0xC000)),
+      echo_ram_n(4096, "echo_ram_n", memory_arena->GetPtr(0xD000)),
+      obj_attr_mem(160, "obj_attr_mem", memory_arena->GetPtr(0xFE00)),
+      high_ram(127, "high_ram", memory_arena->GetPtr(0xFF80)),
+      reg_if(1, "reg_if", memory_arena->GetPtr(0xFF0F)),
+      intr_enable(1, "intr_enable", memory_arena->GetPtr(0xFFFF)),
+      io_registers("io_registers", memory_arena->GetPtr(IoRegisters::kAddress)),
       ppu("ppu", PpuArgs{options.headless, options.fps_cap, options.resolution_scaling, options.color_palette,
                          options.show_ext_game_wndw, options.show_window_wndw}),
       serial("serial", reg_if.GetDataPtr()),
@@ -30,7 +34,19 @@ GbTop::GbTop(sc_module_name name, const Options& options)
   bus.AddBusMaster(&ppu.init_socket);
   bus.AddBusMaster(&joy_pad.init_socket);
   bus.AddBusMaster(&io_registers.init_socket);
-  cartridge.sig_unmap_rom_in(sig_unmap_rom);
+  joy_pad.intr_event = &cpu.intr_event;
+  ppu.intr_event = &cpu.intr_event;
+  serial.intr_event = &cpu.intr_event;
+  timer.intr_event = &cpu.intr_event;
+  io_registers.unmap_boot_rom = [this] { cartridge.mbc->UnmapBootRom(); };
+  if (!options.profile_path.empty())
+    cpu.EnableProfiler();
+  if (!options.profile_stacks_path.empty())
+    cpu.EnableCallStackSampler(options.profile_stacks_cycles);
+  if (!options.trace_path.empty())
+    cpu.EnableTrace(options.trace_path, options.trace_mem_writes);
+  if (options.dma_hram_only)
+    cpu.EnableDmaBlocking(&io_registers);
   apu.sig_reload_length_square1_in(sig_reload_length_square1);
   apu.sig_reload_length_square2_in(sig_reload_length_square2);
   apu.sig_reload_length_noise_in(sig_reload_length_noise);
@@ -49,19 +65,19 @@ GbTop::GbTop(sc_module_name name, const Options& options)
   io_registers.sig_trigger_noise_out(sig_trigger_noise);
   io_registers.sig_trigger_wave_out(sig_trigger_wave);
 
-  bus.AddBusSlave(&cartridge.mbc->rom_socket_in, 0x0000, 0x7FFF);
-  bus.AddBusSlave(&video_ram.targ_socket, 0x8000, 0x9FFF);
-  bus.AddBusSlave(&cartridge.mbc->ram_socket_in, 0xA000, 0xBFFF);
-  bus.AddBusSlave(&work_ram.targ_socket, 0xC000, 0xCFFF);
-  bus.AddBusSlave(&work_ram_n.targ_socket, 0xD000, 0xDFFF);
-  bus.AddBusSlave(&echo_ram.targ_socket, 0xE000, 0xEFFF);
-  bus.AddBusSlave(&echo_ram_n.targ_socket, 0xF000, 0xFDFF);
-  bus.AddBusSlave(&obj_attr_mem.targ_socket, 0xFE00, 0xFE9F);
+  bus.AddBusSlave(&cartridge.mbc->rom_socket_in, 0x0000, 0x7FFF, true);
+  bus.AddBusSlave(&video_ram.targ_socket, 0x8000, 0x9FFF, true);
+  bus.AddBusSlave(&cartridge.mbc->ram_socket_in, 0xA000, 0xBFFF, true);
+  bus.AddBusSlave(&work_ram.targ_socket, 0xC000, 0xCFFF, true);
+  bus.AddBusSlave(&work_ram_n.targ_socket, 0xD000, 0xDFFF, true);
+  bus.AddBusSlave(&echo_ram.targ_socket, 0xE000, 0xEFFF, true);
+  bus.AddBusSlave(&echo_ram_n.targ_socket, 0xF000, 0xFDFF, true);
+  bus.AddBusSlave(&obj_attr_mem.targ_socket, 0xFE00, 0xFE9F, true);
   bus.AddBusSlave(&joy_pad.targ_socket, 0xFF00, 0xFF00);
   bus.AddBusSlave(&serial.targ_socket, 0xFF01, 0xFF03);
   bus.AddBusSlave(&timer.targ_socket, 0xFF04, 0xFF07);
-  bus.AddBusSlave(&reg_if.targ_socket, 0xFF0F, 0xFF0F);
-  bus.AddBusSlave(&io_registers.targ_socket, 0xFF10, 0xFF7F);
-  bus.AddBusSlave(&high_ram.targ_socket, 0xFF80, 0xFFFE);
-  bus.AddBusSlave(&intr_enable.targ_socket, 0xFFFF, 0xFFFF);
+  bus.AddBusSlave(&reg_if.targ_socket, 0xFF0F, 0xFF0F, true);
+  bus.AddBusSlave(&io_registers.targ_socket, IoRegisters::kAddress, IoRegisters::kAddress + IoRegisters::kSize - 1);
+  bus.AddBusSlave(&high_ram.targ_socket, 0xFF80, 0xFFFE, true);
+  bus.AddBusSlave(&intr_enable.targ_socket, 0xFFFF, 0xFFFF, true);
 }
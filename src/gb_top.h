@@ -6,6 +6,7 @@
  * This is the top level of the Game Boy.
  ******************************************************************************/
 #include <filesystem>
+#include <memory>
 
 #include "apu.h"
 #include "bus.h"
@@ -16,6 +17,7 @@
 #include "generic_memory.h"
 #include "io_registers.h"
 #include "joypad.h"
+#include "memory_arena.h"
 #include "options.h"
 #include "ppu.h"
 #include "serial.h"
@@ -24,6 +26,7 @@
 struct GbTop : public sc_module {
   SC_HAS_PROCESS(GbTop);
   u8 reg_ie;
+  std::unique_ptr<MemoryArena> memory_arena;  // Has to be constructed before the memories.
   Cartridge cartridge;
   Apu apu;
   Bus bus;
@@ -222,10 +222,11 @@ void GdbServer::CmdNotFound(const std::vector<string>& msg_split [[maybe_unused]
 // "g": Read general registers.
 void GdbServer::CmdReadReg(const std::vector<string>& msg_split [[maybe_unused]]) {
   string msg_resp;
-  msg_resp = std::format("{:04x}{:04x}{:04x}{:04x}{:04x}{:04x}{:x>{}}", std::rotl(cpu_->reg_file.AF.val(), 8),
-                         std::rotl(cpu_->reg_file.BC.val(), 8), std::rotl(cpu_->reg_file.DE.val(), 8),
-                         std::rotl(cpu_->reg_file.HL.val(), 8), std::rotl(cpu_->reg_file.SP.val(), 8),
-                         std::rotl(cpu_->reg_file.PC.val(), 8), "", 7 * 4);
+  cpu_->UpdateFlags();
+  msg_resp = std::format("{:04x}{:04x}{:04x}{:04x}{:04x}{:04x}{:x>{}}", std::rotl(cpu_->reg_file.AF, 8),
+                         std::rotl(cpu_->reg_file.BC, 8), std::rotl(cpu_->reg_file.DE, 8),
+                         std::rotl(cpu_->reg_file.HL, 8), std::rotl(cpu_->reg_file.SP, 8),
+                         std::rotl(cpu_->reg_file.PC, 8), "", 7 * 4);
   DBG_LOG_GDB("reading geeneral registers");
   msg_resp = Packetify(msg_resp);
   tcp_server_.SendMsg(msg_resp.c_str());
@@ -237,9 +238,10 @@ void GdbServer::CmdWriteReg(const std::vector<string>& msg_split) {
   string data_str = msg_split[1];
   assert(data_str.size() >= 24);
   int i = 0;
-  for (auto reg : cpu_->reg_file) {
+  cpu_->UpdateFlags();  // Otherwise, pending flags would overwrite the new value of F.
+  for (size_t reg = 0; reg < kReg16Names.size(); ++reg) {
     u16 data = std::stoi(data_str.substr(i, 4), nullptr, 16);
-    reg->val(std::rotl(data, 8));
+    cpu_->reg_file.Get(static_cast<Reg16>(reg)) = std::rotl(data, 8);
     i += 4;
   }
   DBG_LOG_GDB("writing into registers: " << data_str);
@@ -253,10 +255,11 @@ void GdbServer::CmdReadMem(const std::vector<string>& msg_split) {
   string length_str = msg_split[2];
   uint addr = std::stoi(addr_str, nullptr, 16);
   uint length = std::stoi(length_str, nullptr, 16);
-  for (uint i = 0; i < length; ++i) {
-    u8 data = cpu_->ReadBusDebug(addr + i);
-    msg_resp.append(std::format("{:02x}", data));
-  }
+  std::vector<u8> data(length);
+  cpu_->ReadBusDebug(addr, data);
+  msg_resp.reserve(2 * length);
+  for (u8 byte : data)
+    msg_resp.append(std::format("{:02x}", byte));
   DBG_LOG_GDB("reading 0x" << length_str << " bytes at address 0x" << addr_str);
   msg_resp = Packetify(msg_resp);
   tcp_server_.SendMsg(msg_resp.c_str());
@@ -269,10 +272,10 @@ void GdbServer::CmdWriteMem(const std::vector<string>& msg_split) {
   string data_str = msg_split[3];
   uint addr = std::stoi(addr_str, nullptr, 16);
   uint length = std::stoi(length_str, nullptr, 16);
-  for (uint i = 0; i < length; ++i) {
-    u8 data = std::stoi(data_str.substr(i * 2, 2), nullptr, 16);
-    cpu_->WriteBusDebug(addr + i, data);
-  }
+  std::vector<u8> data(length);
+  for (uint i = 0; i < length; ++i)
+    data[i] = std::stoi(data_str.substr(i * 2, 2), nullptr, 16);
+  cpu_->WriteBusDebug(addr, data);
   DBG_LOG_GDB("writing 0x" << length_str << " bytes at address 0x" << addr_str);
   DBG_LOG_GDB("data is:" << data_str);
   tcp_server_.SendMsg(kMsgOk);
@@ -5,6 +5,8 @@
 
 #include "generic_memory.h"
 
+#include <algorithm>
+#include <cstring>
 #include <format>
 
 GenericMemory::GenericMemory(size_t memory_size, sc_module_name name, u8* data)
@@ -33,8 +35,11 @@ void GenericMemory::SetMemData(u8* data, size_t size) {
   std::memcpy(data_, data, size);
 }
 
-u8* GenericMemory::GetDataPtr() {
-  return data_;
+void GenericMemory::SetDataPtr(u8* data) {
+  if (delete_data_)
+    delete[] data_;
+  data_ = data;
+  delete_data_ = false;
 }
 
 void GenericMemory::LoadFromFile(std::filesystem::path path, int offset) {
@@ -84,16 +89,19 @@ void GenericMemory::SaveToFile(const std::filesystem::path path) {
   file.close();
 }
 
+// Also handles bursts. A data length of 0 counts as a single byte.
 void GenericMemory::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
   tlm::tlm_command cmd = trans.get_command();
   u16 adr = static_cast<u16>(trans.get_address());
   unsigned char* ptr = trans.get_data_ptr();
+  const size_t length = std::max<size_t>(trans.get_data_length(), 1);
+  assert(adr + length <= memory_size_);
 
   if (cmd == tlm::TLM_READ_COMMAND) {
-    *ptr = data_[adr];
+    std::memcpy(ptr, &data_[adr], length);
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
   } else if (cmd == tlm::TLM_WRITE_COMMAND) {
-    data_[adr] = *ptr;
+    std::memcpy(&data_[adr], ptr, length);
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
   } else {
     trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
@@ -103,7 +111,7 @@ void GenericMemory::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay
 uint GenericMemory::transport_dbg(tlm::tlm_generic_payload& trans) {
   sc_time delay = SC_ZERO_TIME;
   b_transport(trans, delay);
-  return 1;
+  return std::max<uint>(trans.get_data_length(), 1);
 }
 
 bool GenericMemory::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
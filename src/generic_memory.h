@@ -24,7 +24,9 @@ struct GenericMemory : public sc_module {
   GenericMemory(GenericMemory const&) = delete;
   void operator=(GenericMemory const&) = delete;
 
-  u8* GetDataPtr();
+  u8* GetDataPtr() { return data_; }
+  // Lets the memory operate on external data from now on. Already owned data is freed.
+  virtual void SetDataPtr(u8* data);
   void SetMemData(u8* data, size_t size);
   virtual void LoadFromFile(std::filesystem::path path, int offset = 0);
   void LoadFromData(std::span<const u8> data);
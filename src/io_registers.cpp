@@ -5,35 +5,64 @@
 
 #include "io_registers.h"
 
-IoRegisters::IoRegisters(sc_module_name name)
-    : GenericMemory(0x80, name), sig_unmap_rom_out("sig_unmap_rom_out"), init_socket("init_socket") {
+#include <cstring>
+
+IoRegisters::IoRegisters(sc_module_name name, u8* data)
+    : GenericMemory(kSize, name, data), sig_unmap_rom_out("sig_unmap_rom_out"), init_socket("init_socket") {
+  dma_payload_.set_data_length(kOamSize);  // Bursts if DMI isn't possible.
+  dma_payload_.set_streaming_width(kOamSize);
 }
 
-// TODO(niko): 160µs.
 // In theory it skips 4 bits per entry as these aren't used.
-void IoRegisters::DmaTransfer(const u8 byte) {
-  u8 read_data;
-  u8 write_data;
-  sc_time delay = SC_ZERO_TIME;
-  auto read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0xFFFFF, &read_data);
-  auto write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0xFFFFF, &write_data);
-  const u16 start_address = byte * 0x100;
+void IoRegisters::DmaTransfer(const u8 byte, const sc_time& delay) {
+  const u16 src_adr = byte * 0x100;
+  std::array<u8, kOamSize> buffer;
+  sc_time tlm_delay = SC_ZERO_TIME;
+
+  const u8* src = GetDmiPtr(src_adr, kOamSize, false);
+  if (src == nullptr) {
+    dma_payload_.set_command(tlm::TLM_READ_COMMAND);
+    dma_payload_.set_address(src_adr);
+    dma_payload_.set_data_ptr(buffer.data());
+    init_socket->b_transport(dma_payload_, tlm_delay);
+    src = buffer.data();
+  }
 
-  for (u16 i = 0x0; i <= 0x9F; ++i) {
-    u16 from_address = start_address + i;
-    u16 to_address = 0xFE00 + i;
-    read_payload->set_address(from_address);
+  u8* dst = GetDmiPtr(kOamAddress, kOamSize, true);
+  if (dst != nullptr) {
+    std::memcpy(dst, src, kOamSize);
+  } else {
+    dma_payload_.set_command(tlm::TLM_WRITE_COMMAND);
+    dma_payload_.set_address(kOamAddress);
+    dma_payload_.set_data_ptr(const_cast<u8*>(src));
+    init_socket->b_transport(dma_payload_, tlm_delay);
+  }
 
-    init_socket->b_transport(*read_payload, delay);
+  const sc_time duration(kDmaMachineCycles * gb_const::kNsPerMachineCycle, SC_NS);
+  dma_end_ = sc_time_stamp() + delay + duration;
+  dma_done_event.notify(delay + duration);
+}
 
-    write_data = read_data;
-    write_payload->set_address(to_address);
+bool IoRegisters::IsDmaActive(const sc_time& delay) const {
+  return sc_time_stamp() + delay < dma_end_;
+}
 
-    init_socket->b_transport(*write_payload, delay);
-  }
+u8* IoRegisters::GetDmiPtr(u16 adr, size_t size, bool write) {
+  tlm::tlm_dmi dmi_data;
+  dma_payload_.set_command(tlm::TLM_READ_COMMAND);
+  dma_payload_.set_address(adr);
+  if (!init_socket->get_direct_mem_ptr(dma_payload_, dmi_data))
+    return nullptr;
+  // Targets return a pointer to the requested address. The payload holds the address relative to the target.
+  const sc_dt::uint64 rel_adr = dma_payload_.get_address();
+  if (rel_adr < dmi_data.get_start_address() || rel_adr + size - 1 > dmi_data.get_end_address())
+    return nullptr;
+  if (write ? !dmi_data.is_write_allowed() : !dmi_data.is_read_allowed())
+    return nullptr;
+  return reinterpret_cast<u8*>(dmi_data.get_dmi_ptr());
 }
 
-void IoRegisters::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) {
+void IoRegisters::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
   tlm::tlm_command cmd = trans.get_command();
   u16 adr = static_cast<u16>(trans.get_address());
   unsigned char ptr = *trans.get_data_ptr();
@@ -159,11 +188,14 @@ void IoRegisters::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay [[
       data_[adr] = (ptr & 0x78) | (data_[adr] & 0x07);
       break;
     case 0x36:  // 0xFF46
-      DmaTransfer(ptr);
+      DmaTransfer(ptr, delay);
       break;
     case 0x40:  // Writing "1" to 0xFF50 maps out the rom.
-      if (ptr == 1)
+      if (ptr == 1) {
+        if (unmap_boot_rom)
+          unmap_boot_rom();
         sig_unmap_rom_out.write(true);
+      }
       break;
     case 0x7F:
       // TODO(niko) warn!
@@ -5,19 +5,36 @@
  *
  * IO registers. Reside in 0xFF10-0xFF7F.
  ******************************************************************************/
+#include <array>
 #include <filesystem>
+#include <functional>
 
 #include "common.h"
 #include "generic_memory.h"
 #include "joypad.h"
 
 struct IoRegisters : public GenericMemory {
-  IoRegisters(sc_module_name name);
+  constexpr static u16 kAddress = 0xFF10;
+  constexpr static size_t kSize = 0x70;  // Up to 0xFF7F, where the high RAM begins.
+  constexpr static u16 kOamAddress = 0xFE00;
+  constexpr static size_t kOamSize = 0xA0;
+  constexpr static i32 kDmaMachineCycles = 160;  // Duration of an OAM DMA transfer.
 
-  void DmaTransfer(const u8 byte);
+  // data is the backing store of the registers. If it's nullptr, the registers allocate their own.
+  explicit IoRegisters(sc_module_name name, u8* data = nullptr);
+
+  // Copies kOamSize bytes from byte * 0x100 to the OAM. Source and destination are resolved via DMI and
+  // copied at once. Targets without DMI are accessed via TLM bursts. The transfer counts as active for
+  // kDmaMachineCycles after the write to 0xFF46 (happening at delay), after which dma_done_event fires.
+  void DmaTransfer(const u8 byte, const sc_time& delay = SC_ZERO_TIME);
+  // Whether the transfer is still running at delay after the current simulation time.
+  bool IsDmaActive(const sc_time& delay = SC_ZERO_TIME) const;
+  sc_event dma_done_event;
+  // Called by the write of 1 to 0xFF50, so the boot ROM is gone before the next instruction is fetched.
+  std::function<void()> unmap_boot_rom;
 
   // SystemC interfaces.
-  sc_out<bool> sig_unmap_rom_out;              // Unmaps the boot ROM.
+  sc_out<bool> sig_unmap_rom_out;              // Toggled after the boot ROM got unmapped.
   sc_out<bool> sig_reload_length_square1_out;  // Sound length register Square 1.
   sc_out<bool> sig_reload_length_square2_out;  // Sound length register Square 2.
   sc_out<bool> sig_reload_length_wave_out;     // Sound length register Wave.
@@ -28,5 +45,12 @@ struct IoRegisters : public GenericMemory {
   sc_out<bool> sig_trigger_noise_out;          // Trigger event Noise.
 
   tlm_utils::simple_initiator_socket<IoRegisters, gb_const::kBusDataWidth> init_socket;
-  void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay [[maybe_unused]]) override;
+  void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) override;
+
+ private:
+  // Returns a pointer to [adr, adr + size) or nullptr if the range isn't (fully) accessible via DMI.
+  u8* GetDmiPtr(u16 adr, size_t size, bool write);
+
+  tlm::tlm_generic_payload dma_payload_;
+  sc_time dma_end_ = SC_ZERO_TIME;
 };
@@ -0,0 +1,946 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "jit.h"
+
+#if defined(__x86_64__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "opcodes.h"
+
+namespace {
+
+// Offsets of the registers in the register file.
+constexpr u8 kOffF = 0;
+constexpr u8 kOffA = 1;
+constexpr u8 kOffC = 2;
+constexpr u8 kOffB = 3;
+constexpr u8 kOffE = 4;
+constexpr u8 kOffD = 5;
+constexpr u8 kOffL = 6;
+constexpr u8 kOffH = 7;
+constexpr u8 kOffAF = 0;
+constexpr u8 kOffBC = 2;
+constexpr u8 kOffDE = 4;
+constexpr u8 kOffHL = 6;
+constexpr u8 kOffSP = 8;
+constexpr u8 kOffPC = 10;
+
+// 8-bit operands as encoded in the opcodes: B, C, D, E, H, L, (HL), A.
+constexpr u8 kRegOffs[8] = {kOffB, kOffC, kOffD, kOffE, kOffH, kOffL, 0xFF, kOffA};
+// 16-bit operands as encoded in the opcodes: BC, DE, HL, SP. PUSH and POP use AF instead of SP.
+constexpr u8 kPairOffs[4] = {kOffBC, kOffDE, kOffHL, kOffSP};
+
+// Returned by the memory helpers if the interpreter has to do the access.
+constexpr u32 kBail = 0x10000;
+
+// Returns true if translated code may access the address.
+// The interpreter takes care of the cartridge (MBC registers, RAM, RTC), the I/O registers, and unmapped memory.
+bool IsAccessible(u16 adr, bool write) {
+  if (adr <= 0x7FFF)
+    return !write;
+  return (adr <= 0x9FFF) || (0xC000 <= adr && adr <= 0xFE9F) || (0xFF80 <= adr && adr <= 0xFFFE);
+}
+
+u16 GetPair(const JitContext* ctx, u8 off) {
+  u16 val;
+  std::memcpy(&val, ctx->regs + off, sizeof(val));
+  return val;
+}
+
+void SetPair(JitContext* ctx, u8 off, u16 val) {
+  std::memcpy(ctx->regs + off, &val, sizeof(val));
+}
+
+// Sets Z, N, H, and C. The lower nibble of F is kept as it is.
+void SetFlags(JitContext* ctx, bool z, bool n, bool h, bool c) {
+  u8& f = ctx->regs[kOffF];
+  f = (f & 0x0F) | (z << 7) | (n << 6) | (h << 5) | (c << 4);
+}
+
+bool GetFlagC(const JitContext* ctx) {
+  return ctx->regs[kOffF] & 0x10;
+}
+
+// The helpers below are called by the native code.
+// They mirror the respective implementations of the interpreter (see cpu_ops.cpp).
+
+u32 Read8(JitContext* ctx, u32 adr) {
+  if (const u8* page = ctx->read_pages[adr >> 8])
+    return page[adr & 0xFF];
+  if (!IsAccessible(adr, false))
+    return kBail;
+  return ctx->read(ctx->opaque, adr);
+}
+
+u32 Write8(JitContext* ctx, u32 adr, u32 data) {
+  if (u8* page = ctx->write_pages[adr >> 8]; page != nullptr && !ctx->code_pages[adr >> 8]) {
+    page[adr & 0xFF] = data;
+    return 0;
+  }
+  if (!IsAccessible(adr, true))
+    return kBail;
+  ctx->stop |= ctx->write(ctx->opaque, adr, data);
+  return 0;
+}
+
+u32 Push16(JitContext* ctx, u32 val) {
+  const u16 sp = GetPair(ctx, kOffSP);
+  const u16 msb_adr = sp - 1;
+  const u16 lsb_adr = sp - 2;
+  if (!IsAccessible(msb_adr, true) || !IsAccessible(lsb_adr, true))
+    return kBail;
+  SetPair(ctx, kOffSP, lsb_adr);
+  Write8(ctx, msb_adr, val >> 8);
+  Write8(ctx, lsb_adr, val & 0xFF);
+  return 0;
+}
+
+u32 Pop16(JitContext* ctx) {
+  const u16 sp = GetPair(ctx, kOffSP);
+  if (!IsAccessible(sp, false) || !IsAccessible(sp + 1, false))
+    return kBail;
+  const u32 lsb = Read8(ctx, sp);
+  const u32 msb = Read8(ctx, static_cast<u16>(sp + 1));
+  SetPair(ctx, kOffSP, sp + 2);
+  return (msb << 8) | lsb;
+}
+
+// CB-prefixed instructions with a register operand.
+void CbOp(JitContext* ctx, u32 op) {
+  u8& reg = ctx->regs[kRegOffs[op & 7]];
+  const uint bit = (op >> 3) & 7;
+  const bool old_carry = GetFlagC(ctx);
+  bool carry = false;
+  switch (op >> 6) {
+  case 0:
+    switch (bit) {
+    case 0:  // RLC
+      reg = reg << 1 | reg >> 7;
+      carry = reg & 0x01;
+      break;
+    case 1:  // RRC
+      reg = reg >> 1 | reg << 7;
+      carry = reg & 0x80;
+      break;
+    case 2:  // RL
+      carry = reg & 0x80;
+      reg = reg << 1 | old_carry;
+      break;
+    case 3:  // RR
+      carry = reg & 0x01;
+      reg = reg >> 1 | old_carry << 7;
+      break;
+    case 4:  // SLA
+      carry = reg & 0x80;
+      reg = reg << 1;
+      break;
+    case 5:  // SRA
+      carry = reg & 0x01;
+      reg = reg >> 1 | (reg & 0x80);
+      break;
+    case 6:  // SWAP
+      reg = reg << 4 | reg >> 4;
+      break;
+    case 7:  // SRL
+      carry = reg & 0x01;
+      reg = reg >> 1;
+      break;
+    }
+    SetFlags(ctx, reg == 0, false, false, carry);
+    break;
+  case 1:  // BIT
+    SetFlags(ctx, !(reg & (1 << bit)), false, true, old_carry);
+    break;
+  case 2:  // RES
+    reg &= ~(1 << bit);
+    break;
+  case 3:  // SET
+    reg |= 1 << bit;
+    break;
+  }
+}
+
+// RLCA, RRCA, RLA, RRA.
+void RotA(JitContext* ctx, u32 op) {
+  u8& a = ctx->regs[kOffA];
+  const bool old_carry = GetFlagC(ctx);
+  bool carry;
+  switch (op) {
+  case 0x07:
+    a = a << 1 | a >> 7;
+    carry = a & 0x01;
+    break;
+  case 0x0F:
+    carry = a & 0x01;
+    a = a >> 1 | a << 7;
+    break;
+  case 0x17:
+    carry = a & 0x80;
+    a = a << 1 | old_carry;
+    break;
+  default:
+    carry = a & 0x01;
+    a = a >> 1 | old_carry << 7;
+    break;
+  }
+  SetFlags(ctx, false, false, false, carry);
+}
+
+void Daa(JitContext* ctx) {
+  u8& f = ctx->regs[kOffF];
+  u8 reg = ctx->regs[kOffA];
+  const bool flag_n = f & 0x40;
+  u8 correction = (f & 0x10) ? 0x60 : 0x00;
+  if ((f & 0x20) || (!flag_n && ((reg & 0x0F) > 9)))
+    correction |= 0x06;
+  if ((f & 0x10) || (!flag_n && (reg > 0x99)))
+    correction |= 0x60;
+  reg = flag_n ? reg - correction : reg + correction;
+  const bool carry = (f & 0x10) || (correction & 0x40);
+  SetFlags(ctx, reg == 0, flag_n, false, carry);
+  ctx->regs[kOffA] = reg;
+}
+
+// ADD HL,rr
+void AddHl(JitContext* ctx, u32 pair_off) {
+  const u16 hl = GetPair(ctx, kOffHL);
+  const u16 val = GetPair(ctx, pair_off);
+  const u16 result = hl + val;
+  SetPair(ctx, kOffHL, result);
+  SetFlags(ctx, ctx->regs[kOffF] & 0x80, false, (hl & 0x0FFF) + (val & 0x0FFF) > 0x0FFF, result < hl);
+}
+
+// ADD SP,i8 and LD HL,SP+i8
+void AddSpRel(JitContext* ctx, u32 op, u32 imm) {
+  const i8 data = static_cast<i8>(imm);
+  const u16 sp = GetPair(ctx, kOffSP);
+  const int result = static_cast<int>(sp + data);
+  SetPair(ctx, (op == 0xE8) ? kOffSP : kOffHL, static_cast<u16>(result));
+  SetFlags(ctx, false, false, ((sp ^ data ^ (result & 0xFFFF)) & 0x10) == 0x10,
+           ((sp ^ data ^ (result & 0xFFFF)) & 0x100) == 0x100);
+}
+
+#if defined(__x86_64__)
+
+// Host registers as encoded in x86 instructions.
+enum HostReg : u8 {
+  kEax = 0,
+  kEcx = 1,
+  kEdx = 2,
+  kEsi = 6,
+};
+
+// Condition codes of the near jcc instructions.
+enum HostCond : u8 {
+  kCondEqual = 0x84,
+  kCondNotEqual = 0x85,
+  kCondAbove = 0x87,
+};
+
+// Minimal x86-64 assembler. The register file is addressed via rbx, the JitContext via r12.
+class Emitter {
+ public:
+  std::vector<u8> code;
+
+  void Emit(std::initializer_list<u8> bytes) { code.insert(code.end(), bytes); }
+
+  void Emit32(u32 val) {
+    for (int i = 0; i < 4; ++i)
+      code.push_back(static_cast<u8>(val >> (8 * i)));
+  }
+
+  void Emit64(u64 val) {
+    for (int i = 0; i < 8; ++i)
+      code.push_back(static_cast<u8>(val >> (8 * i)));
+  }
+
+  int NewLabel() {
+    labels_.push_back(-1);
+    return labels_.size() - 1;
+  }
+
+  void Bind(int label) { labels_[label] = code.size(); }
+
+  // jmp label
+  void Jump(int label) {
+    Emit({0xE9});
+    AddFixup(label);
+  }
+
+  // jcc label
+  void JumpIf(HostCond cond, int label) {
+    Emit({0x0F, cond});
+    AddFixup(label);
+  }
+
+  // Resolves all jumps. Call this after binding all labels.
+  void ResolveLabels() {
+    for (const auto& [pos, label] : fixups_) {
+      assert(labels_[label] >= 0);
+      const u32 rel = static_cast<u32>(labels_[label] - static_cast<int>(pos + 4));
+      std::memcpy(&code[pos], &rel, sizeof(rel));
+    }
+  }
+
+  // movzx reg, byte [rbx+off]
+  void LoadU8(HostReg reg, u8 off) { Emit({0x0F, 0xB6, ModRmRbx(reg), off}); }
+  // movzx reg, word [rbx+off]
+  void LoadU16(HostReg reg, u8 off) { Emit({0x0F, 0xB7, ModRmRbx(reg), off}); }
+  // mov byte [rbx+off], reg
+  void StoreU8(HostReg reg, u8 off) {
+    assert(reg != kEsi);  // Would need a REX prefix.
+    Emit({0x88, ModRmRbx(reg), off});
+  }
+  // mov word [rbx+off], reg
+  void StoreU16(HostReg reg, u8 off) { Emit({0x66, 0x89, ModRmRbx(reg), off}); }
+  // mov byte [rbx+off], imm
+  void StoreImm8(u8 off, u8 imm) { Emit({0xC6, 0x43, off, imm}); }
+  // mov word [rbx+off], imm
+  void StoreImm16(u8 off, u16 imm) { Emit({0x66, 0xC7, 0x43, off, static_cast<u8>(imm), static_cast<u8>(imm >> 8)}); }
+  // inc word [rbx+off]
+  void IncU16(u8 off) { Emit({0x66, 0xFF, 0x43, off}); }
+  // dec word [rbx+off]
+  void DecU16(u8 off) { Emit({0x66, 0xFF, 0x4B, off}); }
+  // mov reg, imm
+  void MovImm(HostReg reg, u32 imm) {
+    Emit({static_cast<u8>(0xB8 | reg)});
+    Emit32(imm);
+  }
+  // test byte [rbx+kOffF], mask
+  void TestF(u8 mask) { Emit({0xF6, 0x43, kOffF, mask}); }
+
+  // Calls fn(ctx, esi, edx). Clobbers all caller-saved registers.
+  template <typename Fn>
+  void CallHelper(Fn* fn) {
+    Emit({0x4C, 0x89, 0xE7});  // mov rdi, r12
+    Emit({0x48, 0xB8});        // mov rax, fn
+    Emit64(reinterpret_cast<u64>(fn));
+    Emit({0xFF, 0xD0});  // call rax
+  }
+
+ private:
+  static u8 ModRmRbx(HostReg reg) { return 0x40 | (reg << 3) | 3; }
+
+  void AddFixup(int label) {
+    fixups_.push_back({code.size(), label});
+    Emit32(0);
+  }
+
+  std::vector<int> labels_;
+  std::vector<std::pair<size_t, int>> fixups_;
+};
+
+// Translates one block into native code.
+class Translator {
+ public:
+  explicit Translator(const BlockCache::Block& block) : block_(block) {}
+
+  // Returns false if not even the first instruction could be translated.
+  bool Translate() {
+    epilogue_ = e_.NewLabel();
+
+    e_.Emit({0x53});                                               // push rbx
+    e_.Emit({0x41, 0x54});                                         // push r12
+    e_.Emit({0x41, 0x55});                                         // push r13 (keeps the stack aligned)
+    e_.Emit({0x49, 0x89, 0xFC});                                   // mov r12, rdi
+    e_.Emit({0x49, 0x8B, 0x5C, 0x24, offsetof(JitContext, regs)});  // mov rbx, [r12+regs]
+    e_.Emit({0x41, 0xC6, 0x44, 0x24, offsetof(JitContext, stop), 0x00});  // mov byte [r12+stop], 0
+
+    bool exited = false;
+    for (const BlockCache::DecodedInstr& instr : block_.instrs) {
+      instr_ = &instr;
+      bail_ = -1;
+      if (!TranslateInstr(exited)) {
+        if (&instr == &block_.instrs.front())
+          return false;
+        Exit(instr.adr, cycles_);
+        exited = true;
+      }
+      if (exited)
+        break;
+    }
+    if (!exited)
+      Exit(block_.end_adr + 1, cycles_);
+
+    for (const auto& [label, pc, cycles] : bails_) {
+      e_.Bind(label);
+      Exit(pc, cycles);
+    }
+
+    e_.Bind(epilogue_);
+    e_.Emit({0x41, 0x5D});  // pop r13
+    e_.Emit({0x41, 0x5C});  // pop r12
+    e_.Emit({0x5B});        // pop rbx
+    e_.Emit({0xC3});        // ret
+    e_.ResolveLabels();
+    return true;
+  }
+
+  const std::vector<u8>& GetCode() const { return e_.code; }
+  u32 GetMaxCycles() const { return max_cycles_; }
+
+ private:
+  // Stores the PC and returns the number of executed cycles.
+  void Exit(u16 pc, u32 cycles) {
+    e_.StoreImm16(kOffPC, pc);
+    e_.MovImm(kEax, cycles);
+    e_.Jump(epilogue_);
+  }
+
+  // Cycles of the current instruction and of the current branch if it is taken (see kOpcodes).
+  u32 Cycles() const { return instr_->info->cycles; }
+  u32 CyclesTaken() const { return instr_->info->cycles_taken; }
+
+  // Accounts for the cycles of a non-branching instruction.
+  void Step() {
+    cycles_ += Cycles();
+    max_cycles_ = cycles_;
+  }
+
+  // Accounts for the cycles of a branch that exits the block.
+  void Branch() { max_cycles_ = cycles_ + CyclesTaken(); }
+
+  u16 NextPc() const { return instr_->adr + instr_->length; }
+
+  // Returns the label to jump to if the current instruction has to be executed by the interpreter.
+  int Bail() {
+    if (bail_ < 0) {
+      bail_ = e_.NewLabel();
+      bails_.push_back({bail_, instr_->adr, cycles_});
+    }
+    return bail_;
+  }
+
+  // Loads the host pointer of esi's page into rcx and the page number into eax.
+  // Jumps to slow if the page has no host pointer.
+  void EmitPageLookup(u8 pages_off, int slow) {
+    e_.Emit({0x89, 0xF0});                         // mov eax, esi
+    e_.Emit({0xC1, 0xE8, 0x08});                   // shr eax, 8
+    e_.Emit({0x49, 0x8B, 0x4C, 0x24, pages_off});  // mov rcx, [r12+pages]
+    e_.Emit({0x48, 0x8B, 0x0C, 0xC1});             // mov rcx, [rcx+rax*8]
+    e_.Emit({0x48, 0x85, 0xC9});                   // test rcx, rcx
+    e_.JumpIf(kCondEqual, slow);
+  }
+
+  // Reads the byte at esi into eax.
+  void EmitRead() {
+    const int slow = e_.NewLabel();
+    const int done = e_.NewLabel();
+    EmitPageLookup(offsetof(JitContext, read_pages), slow);
+    e_.Emit({0x40, 0x0F, 0xB6, 0xC6});  // movzx eax, sil
+    e_.Emit({0x0F, 0xB6, 0x04, 0x01});  // movzx eax, byte [rcx+rax]
+    e_.Jump(done);
+    e_.Bind(slow);
+    e_.CallHelper(&Read8);
+    e_.Emit({0x3D, 0xFF, 0x00, 0x00, 0x00});  // cmp eax, 0xFF
+    e_.JumpIf(kCondAbove, Bail());
+    e_.Bind(done);
+  }
+
+  // Writes the byte in edx to esi.
+  void EmitWrite() {
+    const int slow = e_.NewLabel();
+    const int done = e_.NewLabel();
+    EmitPageLookup(offsetof(JitContext, write_pages), slow);
+    e_.Emit({0x4D, 0x8B, 0x44, 0x24, offsetof(JitContext, code_pages)});  // mov r8, [r12+code_pages]
+    e_.Emit({0x41, 0x80, 0x3C, 0x00, 0x00});                              // cmp byte [r8+rax], 0
+    e_.JumpIf(kCondNotEqual, slow);
+    e_.Emit({0x40, 0x0F, 0xB6, 0xC6});  // movzx eax, sil
+    e_.Emit({0x88, 0x14, 0x01});        // mov byte [rcx+rax], dl
+    e_.Jump(done);
+    e_.Bind(slow);
+    e_.CallHelper(&Write8);
+    e_.Emit({0x85, 0xC0});  // test eax, eax
+    e_.JumpIf(kCondNotEqual, Bail());
+    e_.Bind(done);
+  }
+
+  // Exits after the current instruction if a write changed cached code.
+  // Has to be called after Step().
+  void EmitStopCheck() {
+    const int cont = e_.NewLabel();
+    e_.Emit({0x41, 0x80, 0x7C, 0x24, offsetof(JitContext, stop), 0x00});  // cmp byte [r12+stop], 0
+    e_.JumpIf(kCondEqual, cont);
+    Exit(NextPc(), cycles_);
+    e_.Bind(cont);
+  }
+
+  // Merges the flags in ecx into F. Keeps the bits of F given by mask.
+  void EmitMergeFlags(u8 mask) {
+    e_.LoadU8(kEdx, kOffF);
+    e_.Emit({0x83, 0xE2, mask});  // and edx, mask
+    e_.Emit({0x09, 0xD1});        // or ecx, edx
+    e_.StoreU8(kEcx, kOffF);
+  }
+
+  // Converts the host flags (pushed into rcx) to Z, H, and C.
+  void EmitArithFlags(bool flag_n) {
+    e_.Emit({0x89, 0xCA});        // mov edx, ecx
+    e_.Emit({0x83, 0xE1, 0x50});  // and ecx, ZF|AF
+    e_.Emit({0x01, 0xC9});        // add ecx, ecx (ZF -> Z, AF -> H)
+    e_.Emit({0x83, 0xE2, 0x01});  // and edx, CF
+    e_.Emit({0xC1, 0xE2, 0x04});  // shl edx, 4 (CF -> C)
+    e_.Emit({0x09, 0xD1});        // or ecx, edx
+    if (flag_n)
+      e_.Emit({0x83, 0xC9, 0x40});  // or ecx, N
+  }
+
+  // ALU operation (ADD, ADC, SUB, SBC, AND, XOR, OR, CP) of A and ecx.
+  // The carry and half-carry flags of x86 have the same semantics as the SM83 ones.
+  void EmitAlu(uint alu_op) {
+    static constexpr u8 kHostOps[8] = {0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38};
+    e_.LoadU8(kEax, kOffA);
+    if (alu_op == 1 || alu_op == 3) {
+      e_.LoadU8(kEdx, kOffF);
+      e_.Emit({0xC0, 0xEA, 0x05});  // shr dl, 5 (C -> CF)
+    }
+    e_.Emit({kHostOps[alu_op], 0xC8});  // op al, cl
+    e_.Emit({0x9C, 0x59});              // pushfq; pop rcx
+    if (alu_op != 7)
+      e_.StoreU8(kEax, kOffA);
+    if (4 <= alu_op && alu_op <= 6) {
+      e_.Emit({0x83, 0xE1, 0x40});  // and ecx, ZF
+      e_.Emit({0x01, 0xC9});        // add ecx, ecx (ZF -> Z)
+      if (alu_op == 4)
+        e_.Emit({0x83, 0xC9, 0x20});  // or ecx, H
+    } else {
+      EmitArithFlags(alu_op == 2 || alu_op == 3 || alu_op == 7);
+    }
+    EmitMergeFlags(0x0F);
+  }
+
+  // INC reg8 and DEC reg8. Keep the C flag.
+  void EmitIncDec(u8 off, bool dec) {
+    e_.LoadU8(kEax, off);
+    e_.Emit({0xFE, static_cast<u8>(dec ? 0xC8 : 0xC0)});  // inc/dec al
+    e_.Emit({0x9C, 0x59});                                // pushfq; pop rcx
+    e_.StoreU8(kEax, off);
+    e_.Emit({0x83, 0xE1, 0x50});  // and ecx, ZF|AF
+    e_.Emit({0x01, 0xC9});        // add ecx, ecx
+    if (dec)
+      e_.Emit({0x83, 0xC9, 0x40});  // or ecx, N
+    EmitMergeFlags(0x1F);
+  }
+
+  // Jumps to the label if the condition (NZ, Z, NC, C) of the opcode holds.
+  void EmitCond(u8 op, int label) {
+    const uint cond = (op >> 3) & 3;
+    e_.TestF(cond < 2 ? 0x80 : 0x10);
+    e_.JumpIf((cond & 1) ? kCondNotEqual : kCondEqual, label);
+  }
+
+  // Pushes esi onto the stack.
+  void EmitPush() {
+    e_.CallHelper(&Push16);
+    e_.Emit({0x85, 0xC0});  // test eax, eax
+    e_.JumpIf(kCondNotEqual, Bail());
+  }
+
+  // Pops the stack into eax.
+  void EmitPop() {
+    e_.CallHelper(&Pop16);
+    e_.Emit({0x3D, 0xFF, 0xFF, 0x00, 0x00});  // cmp eax, 0xFFFF
+    e_.JumpIf(kCondAbove, Bail());
+  }
+
+  // Translates the current instruction. Returns false if there's no native implementation.
+  // Sets exited if the instruction leaves the block.
+  bool TranslateInstr(bool& exited) {
+    const u8 op = instr_->bytes[0];
+    const u8 imm8 = instr_->bytes[1];
+    const u16 imm16 = instr_->bytes[1] | (instr_->bytes[2] << 8);
+
+    // LD r,r
+    if (0x40 <= op && op <= 0x7F) {
+      const uint dst = (op >> 3) & 7;
+      const uint src = op & 7;
+      if (op == 0x76) {  // HALT
+        return false;
+      } else if (src == 6) {
+        e_.LoadU16(kEsi, kOffHL);
+        EmitRead();
+        e_.StoreU8(kEax, kRegOffs[dst]);
+        Step();
+      } else if (dst == 6) {
+        e_.LoadU16(kEsi, kOffHL);
+        e_.LoadU8(kEdx, kRegOffs[src]);
+        EmitWrite();
+        Step();
+        EmitStopCheck();
+      } else {
+        if (src != dst) {
+          e_.LoadU8(kEax, kRegOffs[src]);
+          e_.StoreU8(kEax, kRegOffs[dst]);
+        }
+        Step();
+      }
+      return true;
+    }
+
+    // ALU A,r
+    if (0x80 <= op && op <= 0xBF) {
+      const uint src = op & 7;
+      if (src == 6) {
+        e_.LoadU16(kEsi, kOffHL);
+        EmitRead();
+        e_.Emit({0x89, 0xC1});  // mov ecx, eax
+      } else {
+        e_.LoadU8(kEcx, kRegOffs[src]);
+      }
+      EmitAlu((op >> 3) & 7);
+      Step();
+      return true;
+    }
+
+    switch (op & 0xC7) {
+    case 0x04:  // INC r
+    case 0x05:  // DEC r
+      if (((op >> 3) & 7) == 6)
+        return false;
+      EmitIncDec(kRegOffs[(op >> 3) & 7], op & 1);
+      Step();
+      return true;
+    case 0x06:  // LD r,u8
+      if (op == 0x36) {
+        e_.LoadU16(kEsi, kOffHL);
+        e_.MovImm(kEdx, imm8);
+        EmitWrite();
+        Step();
+        EmitStopCheck();
+      } else {
+        e_.StoreImm8(kRegOffs[(op >> 3) & 7], imm8);
+        Step();
+      }
+      return true;
+    case 0xC6:  // ALU A,u8
+      e_.MovImm(kEcx, imm8);
+      EmitAlu((op >> 3) & 7);
+      Step();
+      return true;
+    case 0xC7:  // RST
+      e_.MovImm(kEsi, NextPc());
+      EmitPush();
+      Branch();
+      Exit(op & 0x38, cycles_ + CyclesTaken());
+      exited = true;
+      return true;
+    }
+
+    switch (op & 0xCF) {
+    case 0x01:  // LD rr,u16
+      e_.StoreImm16(kPairOffs[op >> 4], imm16);
+      Step();
+      return true;
+    case 0x03:  // INC rr
+      e_.IncU16(kPairOffs[op >> 4]);
+      Step();
+      return true;
+    case 0x0B:  // DEC rr
+      e_.DecU16(kPairOffs[op >> 4]);
+      Step();
+      return true;
+    case 0x09:  // ADD HL,rr
+      e_.MovImm(kEsi, kPairOffs[op >> 4]);
+      e_.CallHelper(&AddHl);
+      Step();
+      return true;
+    case 0xC1:  // POP rr
+      EmitPop();
+      if (op == 0xF1) {  // The lower nibble of F doesn't change.
+        e_.LoadU8(kEdx, kOffF);
+        e_.Emit({0x83, 0xE2, 0x0F});                    // and edx, 0x0F
+        e_.Emit({0x25, 0xF0, 0xFF, 0x00, 0x00});        // and eax, 0xFFF0
+        e_.Emit({0x09, 0xD0});                          // or eax, edx
+        e_.StoreU16(kEax, kOffAF);
+      } else {
+        e_.StoreU16(kEax, kPairOffs[(op >> 4) & 3]);
+      }
+      Step();
+      return true;
+    case 0xC5:  // PUSH rr
+      e_.LoadU16(kEsi, op == 0xF5 ? kOffAF : kPairOffs[(op >> 4) & 3]);
+      EmitPush();
+      Step();
+      EmitStopCheck();
+      return true;
+    }
+
+    switch (op) {
+    case 0x00:  // NOP
+      Step();
+      return true;
+    case 0x02:  // LD (BC),A
+    case 0x12:  // LD (DE),A
+    case 0x22:  // LD (HL+),A
+    case 0x32:  // LD (HL-),A
+      e_.LoadU16(kEsi, (op < 0x20) ? kPairOffs[op >> 4] : kOffHL);
+      e_.LoadU8(kEdx, kOffA);
+      EmitWrite();
+      if (op == 0x22)
+        e_.IncU16(kOffHL);
+      else if (op == 0x32)
+        e_.DecU16(kOffHL);
+      Step();
+      EmitStopCheck();
+      return true;
+    case 0x0A:  // LD A,(BC)
+    case 0x1A:  // LD A,(DE)
+    case 0x2A:  // LD A,(HL+)
+    case 0x3A:  // LD A,(HL-)
+      e_.LoadU16(kEsi, (op < 0x20) ? kPairOffs[op >> 4] : kOffHL);
+      EmitRead();
+      e_.StoreU8(kEax, kOffA);
+      if (op == 0x2A)
+        e_.IncU16(kOffHL);
+      else if (op == 0x3A)
+        e_.DecU16(kOffHL);
+      Step();
+      return true;
+    case 0x07:  // RLCA
+    case 0x0F:  // RRCA
+    case 0x17:  // RLA
+    case 0x1F:  // RRA
+      e_.MovImm(kEsi, op);
+      e_.CallHelper(&RotA);
+      Step();
+      return true;
+    case 0x27:  // DAA
+      e_.CallHelper(&Daa);
+      Step();
+      return true;
+    case 0x2F:  // CPL
+      e_.Emit({0x80, 0x73, kOffA, 0xFF});  // xor byte [rbx+A], 0xFF
+      e_.Emit({0x80, 0x4B, kOffF, 0x60});  // or byte [rbx+F], N|H
+      Step();
+      return true;
+    case 0x37:  // SCF
+      e_.Emit({0x80, 0x63, kOffF, 0x8F});  // and byte [rbx+F], ~(N|H|C)
+      e_.Emit({0x80, 0x4B, kOffF, 0x10});  // or byte [rbx+F], C
+      Step();
+      return true;
+    case 0x3F:  // CCF
+      e_.Emit({0x80, 0x63, kOffF, 0x9F});  // and byte [rbx+F], ~(N|H)
+      e_.Emit({0x80, 0x73, kOffF, 0x10});  // xor byte [rbx+F], C
+      Step();
+      return true;
+    case 0x18:  // JR i8
+      Branch();
+      Exit(NextPc() + static_cast<i8>(imm8), cycles_ + CyclesTaken());
+      exited = true;
+      return true;
+    case 0x20:  // JR NZ,i8
+    case 0x28:  // JR Z,i8
+    case 0x30:  // JR NC,i8
+    case 0x38:  // JR C,i8
+    case 0xC2:  // JP NZ,u16
+    case 0xCA:  // JP Z,u16
+    case 0xD2:  // JP NC,u16
+    case 0xDA: {  // JP C,u16
+      const bool is_jr = op < 0x40;
+      const int taken = e_.NewLabel();
+      Branch();
+      EmitCond(op, taken);
+      Exit(NextPc(), cycles_ + Cycles());
+      e_.Bind(taken);
+      Exit(is_jr ? NextPc() + static_cast<i8>(imm8) : imm16, cycles_ + CyclesTaken());
+      exited = true;
+      return true;
+    }
+    case 0xC3:  // JP u16
+      Branch();
+      Exit(imm16, cycles_ + CyclesTaken());
+      exited = true;
+      return true;
+    case 0xE9:  // JP HL
+      Branch();
+      e_.LoadU16(kEax, kOffHL);
+      e_.StoreU16(kEax, kOffPC);
+      e_.MovImm(kEax, cycles_ + CyclesTaken());
+      e_.Jump(epilogue_);
+      exited = true;
+      return true;
+    case 0xCD:  // CALL u16
+    case 0xC4:  // CALL NZ,u16
+    case 0xCC:  // CALL Z,u16
+    case 0xD4:  // CALL NC,u16
+    case 0xDC: {  // CALL C,u16
+      Branch();
+      if (op != 0xCD) {
+        const int taken = e_.NewLabel();
+        EmitCond(op, taken);
+        Exit(NextPc(), cycles_ + Cycles());
+        e_.Bind(taken);
+      }
+      e_.MovImm(kEsi, NextPc());
+      EmitPush();
+      Exit(imm16, cycles_ + CyclesTaken());
+      exited = true;
+      return true;
+    }
+    case 0xC9:  // RET
+    case 0xC0:  // RET NZ
+    case 0xC8:  // RET Z
+    case 0xD0:  // RET NC
+    case 0xD8: {  // RET C
+      Branch();
+      if (op != 0xC9) {
+        const int taken = e_.NewLabel();
+        EmitCond(op, taken);
+        Exit(NextPc(), cycles_ + Cycles());
+        e_.Bind(taken);
+      }
+      EmitPop();
+      e_.StoreU16(kEax, kOffPC);
+      e_.MovImm(kEax, cycles_ + CyclesTaken());
+      e_.Jump(epilogue_);
+      exited = true;
+      return true;
+    }
+    case 0xE0:  // LDH (u8),A
+    case 0xEA:  // LD (u16),A
+      // Accesses of the I/O registers are left to the interpreter right away.
+      if (!IsAccessible(op == 0xE0 ? 0xFF00 + imm8 : imm16, true))
+        return false;
+      e_.MovImm(kEsi, op == 0xE0 ? 0xFF00 + imm8 : imm16);
+      e_.LoadU8(kEdx, kOffA);
+      EmitWrite();
+      Step();
+      EmitStopCheck();
+      return true;
+    case 0xF0:  // LDH A,(u8)
+    case 0xFA:  // LD A,(u16)
+      if (!IsAccessible(op == 0xF0 ? 0xFF00 + imm8 : imm16, false))
+        return false;
+      e_.MovImm(kEsi, op == 0xF0 ? 0xFF00 + imm8 : imm16);
+      EmitRead();
+      e_.StoreU8(kEax, kOffA);
+      Step();
+      return true;
+    case 0xE8:  // ADD SP,i8
+    case 0xF8:  // LD HL,SP+i8
+      e_.MovImm(kEsi, op);
+      e_.MovImm(kEdx, imm8);
+      e_.CallHelper(&AddSpRel);
+      Step();
+      return true;
+    case 0xF9:  // LD SP,HL
+      e_.LoadU16(kEax, kOffHL);
+      e_.StoreU16(kEax, kOffSP);
+      Step();
+      return true;
+    case 0xF3:  // DI
+      e_.Emit({0x49, 0x8B, 0x44, 0x24, offsetof(JitContext, ime)});  // mov rax, [r12+ime]
+      e_.Emit({0xC6, 0x00, 0x00});                                    // mov byte [rax], 0
+      Step();
+      return true;
+    case 0xCB:  // Prefix
+      if ((imm8 & 7) == 6)
+        return false;
+      e_.MovImm(kEsi, imm8);
+      e_.CallHelper(&CbOp);
+      Step();
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  const BlockCache::Block& block_;
+  const BlockCache::DecodedInstr* instr_ = nullptr;
+  Emitter e_;
+  int epilogue_ = -1;
+  // Label of the current instruction's exit to the interpreter.
+  int bail_ = -1;
+  struct BailExit {
+    int label;
+    u16 pc;
+    u32 cycles;
+  };
+  std::vector<BailExit> bails_;
+  // Cycles of all instructions before the current one.
+  u32 cycles_ = 0;
+  u32 max_cycles_ = 0;
+};
+
+#endif  // defined(__x86_64__)
+
+}  // namespace
+
+Jit::Jit() {
+}
+
+Jit::~Jit() {
+#if defined(__x86_64__)
+  if (code_buf_ != nullptr)
+    munmap(code_buf_, kCodeBufSize);
+#endif
+}
+
+bool Jit::IsSupported() {
+#if defined(__x86_64__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+Jit::NativeBlock Jit::Compile(const BlockCache::Block& block, u32* max_cycles) {
+#if defined(__x86_64__)
+  if (code_buf_ == nullptr) {
+    void* buf = mmap(nullptr, kCodeBufSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED)
+      throw std::runtime_error("JIT: Could not allocate the code buffer");
+    code_buf_ = static_cast<u8*>(buf);
+  }
+
+  if (IsFull())
+    return nullptr;
+
+  Translator translator(block);
+  if (!translator.Translate())
+    return nullptr;
+  const std::vector<u8>& code = translator.GetCode();
+  assert(code.size() <= kMaxNativeBlockSize);
+
+  // The code buffer is never writable and executable at the same time. Only the pages of the new code change.
+  u8* native_code = code_buf_ + code_buf_used_;
+  const uintptr_t page_mask = ~(static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1);
+  const uintptr_t first_page = reinterpret_cast<uintptr_t>(native_code) & page_mask;
+  const uintptr_t end_page = (reinterpret_cast<uintptr_t>(native_code + code.size()) + ~page_mask) & page_mask;
+  void* pages = reinterpret_cast<void*>(first_page);
+  if (mprotect(pages, end_page - first_page, PROT_READ | PROT_WRITE) != 0)
+    throw std::runtime_error(std::format("JIT: Could not make the code buffer writable: {}", std::strerror(errno)));
+  std::memcpy(native_code, code.data(), code.size());
+  if (mprotect(pages, end_page - first_page, PROT_READ | PROT_EXEC) != 0)
+    throw std::runtime_error(std::format("JIT: Could not make the code buffer executable: {}", std::strerror(errno)));
+  code_buf_used_ += (code.size() + 15) & ~static_cast<size_t>(15);
+
+  *max_cycles = translator.GetMaxCycles();
+  return reinterpret_cast<NativeBlock>(native_code);
+#else
+  (void)block;
+  (void)max_cycles;
+  return nullptr;
+#endif
+}
+
+bool Jit::IsFull() const {
+  return code_buf_used_ + kMaxNativeBlockSize > kCodeBufSize;
+}
+
+void Jit::Reset() {
+  code_buf_used_ = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Dynamic binary translator for the SM83 CPU (x86-64 hosts only).
+ * Translates the blocks of the block cache into native code.
+ * A translated block works directly on the CPU's register file and accesses the
+ * memory via the DMI pages of the JitContext. Only pages without a host pointer
+ * (and writes into pages with cached code) go through the callbacks.
+ * Translation stops at the first instruction that has no native implementation
+ * (HALT, EI, RETI, (HL) read-modify-write, ...). Moreover, native code returns
+ * before accessing the I/O registers or the cartridge's control registers,
+ * so that the interpreter can execute these with correct timing.
+ ******************************************************************************/
+
+#include <cstddef>
+
+#include "block_cache.h"
+#include "common.h"
+
+// Everything a translated block needs at run time.
+struct JitContext {
+  u8* regs;      // Data of the register file (see RegFile::GetDataPtr()).
+  bool* ime;     // Interrupt master enable.
+  void* opaque;  // Is handed over to the callbacks.
+  // Host pointers of the 256 byte pages (see Cpu::dmi_read_pages_). A nullptr means that the callback is called.
+  u8* const* read_pages;
+  u8* const* write_pages;
+  // Writes into pages with cached code go through the callback (see BlockCache::GetCodePages()).
+  const u8* code_pages;
+  u8 (*read)(void* opaque, u16 adr);
+  // Has to return true if the write changed cached code.
+  bool (*write)(void* opaque, u16 adr, u8 data);
+  // Set by the native code if a write changed cached code. Execution stops after the respective instruction.
+  bool stop;
+};
+
+class Jit {
+ public:
+  // Executes a translated block and returns the number of executed clock cycles.
+  // Returns 0 if not even the first instruction was executed.
+  using NativeBlock = u32 (*)(JitContext* ctx);
+
+  Jit();
+  ~Jit();
+
+  // Returns true if the host can execute translated code.
+  static bool IsSupported();
+
+  // Translates the given block. Returns nullptr if not even the first instruction can be translated or
+  // if the code buffer is full (see IsFull()).
+  // max_cycles returns the maximum number of clock cycles the translated code may take.
+  // Throws std::runtime_error if the code buffer can't be allocated or protected. All NativeBlocks get invalid then.
+  NativeBlock Compile(const BlockCache::Block& block, u32* max_cycles);
+  // Returns true if the code buffer has no more space for another block.
+  bool IsFull() const;
+  // Discards all translated code. All NativeBlocks returned so far get invalid!
+  void Reset();
+
+ private:
+  u8* code_buf_ = nullptr;
+  size_t code_buf_used_ = 0;
+
+  static constexpr size_t kCodeBufSize = 8 * 1024 * 1024;
+  // Upper bound of the native code size of one block.
+  static constexpr size_t kMaxNativeBlockSize = 64 * 1024;
+};
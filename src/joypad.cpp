@@ -120,7 +120,7 @@ void JoyPad::SetButton(SDL_Keycode sym, bool pressed) {
   }
 
   if (pressed) {
-    *reg_intr_pending_dmi |= gb_const::kJoypadIf;
+    RequestInterrupt(reg_intr_pending_dmi, gb_const::kJoypadIf, intr_event);
   }
 }
 
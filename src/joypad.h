@@ -48,6 +48,7 @@ struct JoyPad : public InterruptModule<JoyPad>, public sc_module {
 
   // SystemC interfaces.
   tlm_utils::simple_target_socket<JoyPad, gb_const::kBusDataWidth> targ_socket;
+  sc_event* intr_event = nullptr;  // Notified on a joypad interrupt.
   void start_of_simulation() override;
   void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
   uint transport_dbg(tlm::tlm_generic_payload& trans);
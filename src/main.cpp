@@ -7,8 +7,13 @@
  * Here resides the top module which connects all submodule from CPU to PPU.
  ******************************************************************************/
 
+#include <unistd.h>
+
+#include <format>
+
 #include "gb_top.h"
 #include "options.h"
+#include "symbol_table.h"
 
 int sc_main(int argc, char* argv[]) {
   Options options;
@@ -32,11 +37,43 @@ int sc_main(int argc, char* argv[]) {
 
   std::cout << static_cast<string>(*gb_top.cartridge.game_info);
 
-  if (options.max_cycles < 0) {
-    sc_start();
-  } else {
-    sc_start(sc_time(gb_const::kNsPerClkCycle * options.max_cycles, SC_NS));
+  // The flight recorder tells what the CPU did before a crash.
+  FlightRecorder::InstallCrashHandler([](void* cpu) { static_cast<Cpu*>(cpu)->DumpFlightRecorder(STDERR_FILENO); },
+                                      &gb_top.cpu);
+  try {
+    if (options.max_cycles < 0) {
+      sc_start();
+    } else {
+      sc_start(sc_time(gb_const::kNsPerClkCycle * options.max_cycles, SC_NS));
+    }
+  } catch (...) {
+    gb_top.cpu.DumpFlightRecorder(STDERR_FILENO);
+    throw;
+  }
+
+  if (options.dump_on_exit) {
+    std::cout.flush();
+    gb_top.cpu.DumpFlightRecorder(STDOUT_FILENO);
   }
 
+  if (options.stats)
+    std::cerr << "Clock cycles skipped in idle loops: " << gb_top.cpu.GetIdleSkippedCycles() << std::endl;
+  if (options.stats && options.quantum_cycles > 0)
+    std::cerr << gb_top.cpu.GetSyncReport();  // Only meaningful with a quantum.
+
+  if (gb_top.cpu.trace_writer != nullptr) {
+    gb_top.cpu.trace_writer->Close();
+    std::cout << std::format("Wrote {} instructions to trace '{}'\n", gb_top.cpu.trace_writer->GetNumRecords(),
+                             options.trace_path.string());
+  }
+
+  SymbolTable symbols;
+  if (!options.profile_symbols_path.empty())
+    symbols.LoadFile(options.profile_symbols_path);
+  if (gb_top.cpu.profiler != nullptr)
+    gb_top.cpu.profiler->WriteFiles(options.profile_path, symbols);
+  if (gb_top.cpu.call_stack_sampler != nullptr)
+    gb_top.cpu.call_stack_sampler->WriteFile(options.profile_stacks_path, symbols);
+
   return 0;
 }
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace {
+size_t RoundUp(size_t num) {
+  const size_t page_size = MappedFile::GetPageSize();
+  return (num + page_size - 1) / page_size * page_size;
+}
+}  // namespace
+
+// The anonymous mapping provides the zeroed tail. The file is then mapped over its beginning.
+MappedFile::MappedFile(const std::filesystem::path& path, size_t size, bool shared) : size_(size) {
+  const int fd = shared ? open(path.c_str(), O_RDWR | O_CREAT, 0644) : open(path.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0 ||
+      (shared && static_cast<size_t>(file_stat.st_size) < size && ftruncate(fd, size) != 0)) {
+    if (fd >= 0)
+      close(fd);
+    throw std::runtime_error(std::format("Could not read file '{}'!", path.string()));
+  }
+  file_size_ = shared ? size : std::min<size_t>(file_stat.st_size, size);
+
+  map_size_ = std::max(RoundUp(size), GetPageSize());
+  void* data = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  const int flags = (shared ? MAP_SHARED : MAP_PRIVATE) | MAP_FIXED;
+  if (data != MAP_FAILED && file_size_ > 0 &&
+      mmap(data, RoundUp(file_size_), PROT_READ | PROT_WRITE, flags, fd, 0) == MAP_FAILED) {
+    munmap(data, map_size_);
+    data = MAP_FAILED;
+  }
+  close(fd);
+  if (data == MAP_FAILED)
+    throw std::runtime_error(std::format("Could not read file '{}'!", path.string()));
+  data_ = static_cast<u8*>(data);
+}
+
+MappedFile::~MappedFile() {
+  munmap(data_, map_size_);
+}
+
+void MappedFile::Sync(size_t offset, size_t size, bool wait) {
+  const size_t start = offset / GetPageSize() * GetPageSize();
+  const size_t end = std::min(RoundUp(offset + size), RoundUp(file_size_));
+  if (start < end)
+    msync(data_ + start, end - start, wait ? MS_SYNC : MS_ASYNC);
+}
+
+size_t MappedFile::GetPageSize() {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
@@ -0,0 +1,43 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * A MappedFile maps a file into memory instead of reading it. Pages are only
+ * loaded from disk when touched and are shared via the page cache with every
+ * other process that maps the same file.
+ * A private mapping never writes back: writes (e.g. a boot ROM overlay or a
+ * GDB patch) trigger a copy-on-write of the affected page. Such a mapping may
+ * be larger than the file. Bytes behind the end of the file read as zero.
+ * A shared mapping writes back to the file, which is created or grown to the
+ * mapped size if needed. Sync() forces the write-back of a range.
+ ******************************************************************************/
+
+#include <filesystem>
+
+#include "common.h"
+
+class MappedFile {
+ public:
+  // Maps the first size bytes of the file. Throws a std::runtime_error if the file can't be mapped.
+  MappedFile(const std::filesystem::path& path, size_t size, bool shared = false);
+  ~MappedFile();
+  MappedFile(MappedFile const&) = delete;
+  void operator=(MappedFile const&) = delete;
+
+  u8* GetData() { return data_; }
+  size_t GetSize() const { return size_; }
+  // Number of mapped bytes that stem from the file.
+  size_t GetFileSize() const { return file_size_; }
+  // Writes the pages that overlap [offset, offset + size) back to the file of a shared mapping.
+  // With wait == false, the write-back is only scheduled.
+  void Sync(size_t offset, size_t size, bool wait = true);
+
+  static size_t GetPageSize();
+
+ private:
+  u8* data_ = nullptr;
+  size_t size_;
+  size_t file_size_ = 0;
+  size_t map_size_ = 0;  // Size rounded up to full pages.
+};
@@ -0,0 +1,32 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Backing store of all memories inside the Game Boy (everything except the cartridge).
+ * The arena mirrors the address map: each memory is a view at the offset of its
+ * address. For example, the work RAM starts at GetPtr(0xC000). The areas of the
+ * cartridge (0x0000-0x7FFF and 0xA000-0xBFFF) stay unused.
+ * Keeping everything in one page-aligned block improves cache locality, and a
+ * snapshot of the internal memories is a single copy.
+ ******************************************************************************/
+
+#include <array>
+#include <cstring>
+#include <span>
+
+#include "common.h"
+
+class MemoryArena {
+ public:
+  constexpr static size_t kSize = 0x10000;
+  constexpr static size_t kAlignment = 4096;
+
+  u8* GetPtr(u16 adr) { return &data_[adr]; }
+
+  void SaveSnapshot(std::span<u8, kSize> snapshot) const { std::memcpy(snapshot.data(), data_.data(), kSize); }
+  void LoadSnapshot(std::span<const u8, kSize> snapshot) { std::memcpy(data_.data(), snapshot.data(), kSize); }
+
+ private:
+  alignas(kAlignment) std::array<u8, kSize> data_{};
+};
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "opcodes.h"
+
+namespace {
+
+// Appends characters to a fixed-size buffer and always keeps it null-terminated.
+class OutBuffer {
+ public:
+  OutBuffer(char* out, size_t size) : out_(out), size_(size) {
+    if (size_ != 0)
+      out_[0] = '\0';
+  }
+
+  void Put(char c) {
+    if (pos_ + 1 >= size_)
+      return;
+    out_[pos_++] = c;
+    out_[pos_] = '\0';
+  }
+
+  void PutHex(uint val, uint num_digits) {
+    constexpr char kDigits[] = "0123456789abcdef";
+    Put('0');
+    Put('x');
+    for (int i = static_cast<int>(num_digits) - 1; i >= 0; --i)
+      Put(kDigits[(val >> (4 * i)) & 0xF]);
+  }
+
+  void PutDec(uint val) {
+    if (val >= 10)
+      PutDec(val / 10);
+    Put(static_cast<char>('0' + val % 10));
+  }
+
+  // Replaces the last character. Used for "SP+i8" with a negative offset.
+  void ReplaceLast(char c) {
+    if (pos_ != 0)
+      out_[pos_ - 1] = c;
+  }
+
+  char Last() const { return (pos_ != 0) ? out_[pos_ - 1] : '\0'; }
+
+ private:
+  char* out_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+u8 Disassemble(const u8* bytes, u16 adr, char* out, size_t out_size) {
+  const OpcodeInfo& info = GetOpcodeInfo(bytes);
+  OutBuffer buf(out, out_size);
+
+  if (info.mnemonic == nullptr) {
+    for (char c : {'D', 'B', ' '})
+      buf.Put(c);
+    buf.PutHex(bytes[0], 2);
+    return info.length;
+  }
+
+  for (const char* c = info.mnemonic; *c != '\0'; ++c) {
+    if (c[0] == 'u' && c[1] == '1' && c[2] == '6') {
+      buf.PutHex(bytes[1] | (bytes[2] << 8), 4);
+      c += 2;
+    } else if (c[0] == 'u' && c[1] == '8') {
+      buf.PutHex(bytes[1], 2);
+      c += 1;
+    } else if (c[0] == 'i' && c[1] == '8') {
+      const i8 offset = static_cast<i8>(bytes[1]);
+      if (info.mnemonic[0] == 'J') {  // JR prints the target address.
+        buf.PutHex(static_cast<u16>(adr + info.length + offset), 4);
+      } else {  // ADD SP,i8 and LD HL,SP+i8
+        if (offset < 0 && buf.Last() == '+')
+          buf.ReplaceLast('-');
+        else if (offset < 0)
+          buf.Put('-');
+        buf.PutDec(static_cast<uint>(offset < 0 ? -offset : offset));
+      }
+      c += 1;
+    } else {
+      buf.Put(*c);
+    }
+  }
+  return info.length;
+}
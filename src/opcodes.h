@@ -0,0 +1,572 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Static information about all opcodes: mnemonic, length, timing, and memory accesses.
+ * Used by the interpreter and JIT for the timing, by the block cache for decoding,
+ * and by everything that prints instructions (see Disassemble()).
+ ******************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "common.h"
+
+// How an instruction accesses memory besides fetching its operands.
+// Stack operations (PUSH, POP, CALL, RET, RST) count as well.
+enum class MemAccess : u8 { kNone, kRead, kWrite, kReadWrite };
+
+struct OpcodeInfo {
+  // Operands are written as u8, u16 (immediates), or i8 (signed offset). nullptr for undefined opcodes.
+  const char* mnemonic;
+  u8 length;        // In bytes, including the 0xCB prefix.
+  u8 cycles;        // Clock cycles. For conditional branches: cycles if the branch is not taken.
+  u8 cycles_taken;  // Clock cycles if a conditional branch is taken. Equals cycles for all other opcodes.
+  MemAccess mem_access;
+};
+
+// Notes on a few special opcodes:
+// 0x10 STOP: Not implemented by the CPU yet.
+// 0x76 HALT: The CPU waits for an interrupt on its own, see Cpu::InstrHalt().
+// 0xCB PREFIX CB: The cycles of the prefix are included in kOpcodesCb.
+// 0xD3 EMU: Undefined on a real Game Boy; the TLMBoy uses it for semihosting.
+// All opcodes: 0x00-0xFF are the base opcodes, 0x100-0x1FF the ones prefixed by 0xCB.
+inline constexpr std::array<OpcodeInfo, 512> kOpcodeTable{{
+    // Base opcodes.
+    {"NOP", 1, 4, 4, MemAccess::kNone},  // 0x00
+    {"LD BC,u16", 3, 12, 12, MemAccess::kNone},  // 0x01
+    {"LD (BC),A", 1, 8, 8, MemAccess::kWrite},  // 0x02
+    {"INC BC", 1, 8, 8, MemAccess::kNone},  // 0x03
+    {"INC B", 1, 4, 4, MemAccess::kNone},  // 0x04
+    {"DEC B", 1, 4, 4, MemAccess::kNone},  // 0x05
+    {"LD B,u8", 2, 8, 8, MemAccess::kNone},  // 0x06
+    {"RLCA", 1, 4, 4, MemAccess::kNone},  // 0x07
+    {"LD (u16),SP", 3, 20, 20, MemAccess::kWrite},  // 0x08
+    {"ADD HL,BC", 1, 8, 8, MemAccess::kNone},  // 0x09
+    {"LD A,(BC)", 1, 8, 8, MemAccess::kRead},  // 0x0A
+    {"DEC BC", 1, 8, 8, MemAccess::kNone},  // 0x0B
+    {"INC C", 1, 4, 4, MemAccess::kNone},  // 0x0C
+    {"DEC C", 1, 4, 4, MemAccess::kNone},  // 0x0D
+    {"LD C,u8", 2, 8, 8, MemAccess::kNone},  // 0x0E
+    {"RRCA", 1, 4, 4, MemAccess::kNone},  // 0x0F
+    {"STOP", 2, 4, 4, MemAccess::kNone},  // 0x10
+    {"LD DE,u16", 3, 12, 12, MemAccess::kNone},  // 0x11
+    {"LD (DE),A", 1, 8, 8, MemAccess::kWrite},  // 0x12
+    {"INC DE", 1, 8, 8, MemAccess::kNone},  // 0x13
+    {"INC D", 1, 4, 4, MemAccess::kNone},  // 0x14
+    {"DEC D", 1, 4, 4, MemAccess::kNone},  // 0x15
+    {"LD D,u8", 2, 8, 8, MemAccess::kNone},  // 0x16
+    {"RLA", 1, 4, 4, MemAccess::kNone},  // 0x17
+    {"JR i8", 2, 12, 12, MemAccess::kNone},  // 0x18
+    {"ADD HL,DE", 1, 8, 8, MemAccess::kNone},  // 0x19
+    {"LD A,(DE)", 1, 8, 8, MemAccess::kRead},  // 0x1A
+    {"DEC DE", 1, 8, 8, MemAccess::kNone},  // 0x1B
+    {"INC E", 1, 4, 4, MemAccess::kNone},  // 0x1C
+    {"DEC E", 1, 4, 4, MemAccess::kNone},  // 0x1D
+    {"LD E,u8", 2, 8, 8, MemAccess::kNone},  // 0x1E
+    {"RRA", 1, 4, 4, MemAccess::kNone},  // 0x1F
+    {"JR NZ,i8", 2, 8, 12, MemAccess::kNone},  // 0x20
+    {"LD HL,u16", 3, 12, 12, MemAccess::kNone},  // 0x21
+    {"LD (HL+),A", 1, 8, 8, MemAccess::kWrite},  // 0x22
+    {"INC HL", 1, 8, 8, MemAccess::kNone},  // 0x23
+    {"INC H", 1, 4, 4, MemAccess::kNone},  // 0x24
+    {"DEC H", 1, 4, 4, MemAccess::kNone},  // 0x25
+    {"LD H,u8", 2, 8, 8, MemAccess::kNone},  // 0x26
+    {"DAA", 1, 4, 4, MemAccess::kNone},  // 0x27
+    {"JR Z,i8", 2, 8, 12, MemAccess::kNone},  // 0x28
+    {"ADD HL,HL", 1, 8, 8, MemAccess::kNone},  // 0x29
+    {"LD A,(HL+)", 1, 8, 8, MemAccess::kRead},  // 0x2A
+    {"DEC HL", 1, 8, 8, MemAccess::kNone},  // 0x2B
+    {"INC L", 1, 4, 4, MemAccess::kNone},  // 0x2C
+    {"DEC L", 1, 4, 4, MemAccess::kNone},  // 0x2D
+    {"LD L,u8", 2, 8, 8, MemAccess::kNone},  // 0x2E
+    {"CPL", 1, 4, 4, MemAccess::kNone},  // 0x2F
+    {"JR NC,i8", 2, 8, 12, MemAccess::kNone},  // 0x30
+    {"LD SP,u16", 3, 12, 12, MemAccess::kNone},  // 0x31
+    {"LD (HL-),A", 1, 8, 8, MemAccess::kWrite},  // 0x32
+    {"INC SP", 1, 8, 8, MemAccess::kNone},  // 0x33
+    {"INC (HL)", 1, 12, 12, MemAccess::kReadWrite},  // 0x34
+    {"DEC (HL)", 1, 12, 12, MemAccess::kReadWrite},  // 0x35
+    {"LD (HL),u8", 2, 12, 12, MemAccess::kWrite},  // 0x36
+    {"SCF", 1, 4, 4, MemAccess::kNone},  // 0x37
+    {"JR C,i8", 2, 8, 12, MemAccess::kNone},  // 0x38
+    {"ADD HL,SP", 1, 8, 8, MemAccess::kNone},  // 0x39
+    {"LD A,(HL-)", 1, 8, 8, MemAccess::kRead},  // 0x3A
+    {"DEC SP", 1, 8, 8, MemAccess::kNone},  // 0x3B
+    {"INC A", 1, 4, 4, MemAccess::kNone},  // 0x3C
+    {"DEC A", 1, 4, 4, MemAccess::kNone},  // 0x3D
+    {"LD A,u8", 2, 8, 8, MemAccess::kNone},  // 0x3E
+    {"CCF", 1, 4, 4, MemAccess::kNone},  // 0x3F
+    {"LD B,B", 1, 4, 4, MemAccess::kNone},  // 0x40
+    {"LD B,C", 1, 4, 4, MemAccess::kNone},  // 0x41
+    {"LD B,D", 1, 4, 4, MemAccess::kNone},  // 0x42
+    {"LD B,E", 1, 4, 4, MemAccess::kNone},  // 0x43
+    {"LD B,H", 1, 4, 4, MemAccess::kNone},  // 0x44
+    {"LD B,L", 1, 4, 4, MemAccess::kNone},  // 0x45
+    {"LD B,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x46
+    {"LD B,A", 1, 4, 4, MemAccess::kNone},  // 0x47
+    {"LD C,B", 1, 4, 4, MemAccess::kNone},  // 0x48
+    {"LD C,C", 1, 4, 4, MemAccess::kNone},  // 0x49
+    {"LD C,D", 1, 4, 4, MemAccess::kNone},  // 0x4A
+    {"LD C,E", 1, 4, 4, MemAccess::kNone},  // 0x4B
+    {"LD C,H", 1, 4, 4, MemAccess::kNone},  // 0x4C
+    {"LD C,L", 1, 4, 4, MemAccess::kNone},  // 0x4D
+    {"LD C,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x4E
+    {"LD C,A", 1, 4, 4, MemAccess::kNone},  // 0x4F
+    {"LD D,B", 1, 4, 4, MemAccess::kNone},  // 0x50
+    {"LD D,C", 1, 4, 4, MemAccess::kNone},  // 0x51
+    {"LD D,D", 1, 4, 4, MemAccess::kNone},  // 0x52
+    {"LD D,E", 1, 4, 4, MemAccess::kNone},  // 0x53
+    {"LD D,H", 1, 4, 4, MemAccess::kNone},  // 0x54
+    {"LD D,L", 1, 4, 4, MemAccess::kNone},  // 0x55
+    {"LD D,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x56
+    {"LD D,A", 1, 4, 4, MemAccess::kNone},  // 0x57
+    {"LD E,B", 1, 4, 4, MemAccess::kNone},  // 0x58
+    {"LD E,C", 1, 4, 4, MemAccess::kNone},  // 0x59
+    {"LD E,D", 1, 4, 4, MemAccess::kNone},  // 0x5A
+    {"LD E,E", 1, 4, 4, MemAccess::kNone},  // 0x5B
+    {"LD E,H", 1, 4, 4, MemAccess::kNone},  // 0x5C
+    {"LD E,L", 1, 4, 4, MemAccess::kNone},  // 0x5D
+    {"LD E,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x5E
+    {"LD E,A", 1, 4, 4, MemAccess::kNone},  // 0x5F
+    {"LD H,B", 1, 4, 4, MemAccess::kNone},  // 0x60
+    {"LD H,C", 1, 4, 4, MemAccess::kNone},  // 0x61
+    {"LD H,D", 1, 4, 4, MemAccess::kNone},  // 0x62
+    {"LD H,E", 1, 4, 4, MemAccess::kNone},  // 0x63
+    {"LD H,H", 1, 4, 4, MemAccess::kNone},  // 0x64
+    {"LD H,L", 1, 4, 4, MemAccess::kNone},  // 0x65
+    {"LD H,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x66
+    {"LD H,A", 1, 4, 4, MemAccess::kNone},  // 0x67
+    {"LD L,B", 1, 4, 4, MemAccess::kNone},  // 0x68
+    {"LD L,C", 1, 4, 4, MemAccess::kNone},  // 0x69
+    {"LD L,D", 1, 4, 4, MemAccess::kNone},  // 0x6A
+    {"LD L,E", 1, 4, 4, MemAccess::kNone},  // 0x6B
+    {"LD L,H", 1, 4, 4, MemAccess::kNone},  // 0x6C
+    {"LD L,L", 1, 4, 4, MemAccess::kNone},  // 0x6D
+    {"LD L,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x6E
+    {"LD L,A", 1, 4, 4, MemAccess::kNone},  // 0x6F
+    {"LD (HL),B", 1, 8, 8, MemAccess::kWrite},  // 0x70
+    {"LD (HL),C", 1, 8, 8, MemAccess::kWrite},  // 0x71
+    {"LD (HL),D", 1, 8, 8, MemAccess::kWrite},  // 0x72
+    {"LD (HL),E", 1, 8, 8, MemAccess::kWrite},  // 0x73
+    {"LD (HL),H", 1, 8, 8, MemAccess::kWrite},  // 0x74
+    {"LD (HL),L", 1, 8, 8, MemAccess::kWrite},  // 0x75
+    {"HALT", 1, 4, 4, MemAccess::kNone},  // 0x76
+    {"LD (HL),A", 1, 8, 8, MemAccess::kWrite},  // 0x77
+    {"LD A,B", 1, 4, 4, MemAccess::kNone},  // 0x78
+    {"LD A,C", 1, 4, 4, MemAccess::kNone},  // 0x79
+    {"LD A,D", 1, 4, 4, MemAccess::kNone},  // 0x7A
+    {"LD A,E", 1, 4, 4, MemAccess::kNone},  // 0x7B
+    {"LD A,H", 1, 4, 4, MemAccess::kNone},  // 0x7C
+    {"LD A,L", 1, 4, 4, MemAccess::kNone},  // 0x7D
+    {"LD A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x7E
+    {"LD A,A", 1, 4, 4, MemAccess::kNone},  // 0x7F
+    {"ADD A,B", 1, 4, 4, MemAccess::kNone},  // 0x80
+    {"ADD A,C", 1, 4, 4, MemAccess::kNone},  // 0x81
+    {"ADD A,D", 1, 4, 4, MemAccess::kNone},  // 0x82
+    {"ADD A,E", 1, 4, 4, MemAccess::kNone},  // 0x83
+    {"ADD A,H", 1, 4, 4, MemAccess::kNone},  // 0x84
+    {"ADD A,L", 1, 4, 4, MemAccess::kNone},  // 0x85
+    {"ADD A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x86
+    {"ADD A,A", 1, 4, 4, MemAccess::kNone},  // 0x87
+    {"ADC A,B", 1, 4, 4, MemAccess::kNone},  // 0x88
+    {"ADC A,C", 1, 4, 4, MemAccess::kNone},  // 0x89
+    {"ADC A,D", 1, 4, 4, MemAccess::kNone},  // 0x8A
+    {"ADC A,E", 1, 4, 4, MemAccess::kNone},  // 0x8B
+    {"ADC A,H", 1, 4, 4, MemAccess::kNone},  // 0x8C
+    {"ADC A,L", 1, 4, 4, MemAccess::kNone},  // 0x8D
+    {"ADC A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x8E
+    {"ADC A,A", 1, 4, 4, MemAccess::kNone},  // 0x8F
+    {"SUB A,B", 1, 4, 4, MemAccess::kNone},  // 0x90
+    {"SUB A,C", 1, 4, 4, MemAccess::kNone},  // 0x91
+    {"SUB A,D", 1, 4, 4, MemAccess::kNone},  // 0x92
+    {"SUB A,E", 1, 4, 4, MemAccess::kNone},  // 0x93
+    {"SUB A,H", 1, 4, 4, MemAccess::kNone},  // 0x94
+    {"SUB A,L", 1, 4, 4, MemAccess::kNone},  // 0x95
+    {"SUB A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x96
+    {"SUB A,A", 1, 4, 4, MemAccess::kNone},  // 0x97
+    {"SBC A,B", 1, 4, 4, MemAccess::kNone},  // 0x98
+    {"SBC A,C", 1, 4, 4, MemAccess::kNone},  // 0x99
+    {"SBC A,D", 1, 4, 4, MemAccess::kNone},  // 0x9A
+    {"SBC A,E", 1, 4, 4, MemAccess::kNone},  // 0x9B
+    {"SBC A,H", 1, 4, 4, MemAccess::kNone},  // 0x9C
+    {"SBC A,L", 1, 4, 4, MemAccess::kNone},  // 0x9D
+    {"SBC A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0x9E
+    {"SBC A,A", 1, 4, 4, MemAccess::kNone},  // 0x9F
+    {"AND A,B", 1, 4, 4, MemAccess::kNone},  // 0xA0
+    {"AND A,C", 1, 4, 4, MemAccess::kNone},  // 0xA1
+    {"AND A,D", 1, 4, 4, MemAccess::kNone},  // 0xA2
+    {"AND A,E", 1, 4, 4, MemAccess::kNone},  // 0xA3
+    {"AND A,H", 1, 4, 4, MemAccess::kNone},  // 0xA4
+    {"AND A,L", 1, 4, 4, MemAccess::kNone},  // 0xA5
+    {"AND A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0xA6
+    {"AND A,A", 1, 4, 4, MemAccess::kNone},  // 0xA7
+    {"XOR A,B", 1, 4, 4, MemAccess::kNone},  // 0xA8
+    {"XOR A,C", 1, 4, 4, MemAccess::kNone},  // 0xA9
+    {"XOR A,D", 1, 4, 4, MemAccess::kNone},  // 0xAA
+    {"XOR A,E", 1, 4, 4, MemAccess::kNone},  // 0xAB
+    {"XOR A,H", 1, 4, 4, MemAccess::kNone},  // 0xAC
+    {"XOR A,L", 1, 4, 4, MemAccess::kNone},  // 0xAD
+    {"XOR A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0xAE
+    {"XOR A,A", 1, 4, 4, MemAccess::kNone},  // 0xAF
+    {"OR A,B", 1, 4, 4, MemAccess::kNone},  // 0xB0
+    {"OR A,C", 1, 4, 4, MemAccess::kNone},  // 0xB1
+    {"OR A,D", 1, 4, 4, MemAccess::kNone},  // 0xB2
+    {"OR A,E", 1, 4, 4, MemAccess::kNone},  // 0xB3
+    {"OR A,H", 1, 4, 4, MemAccess::kNone},  // 0xB4
+    {"OR A,L", 1, 4, 4, MemAccess::kNone},  // 0xB5
+    {"OR A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0xB6
+    {"OR A,A", 1, 4, 4, MemAccess::kNone},  // 0xB7
+    {"CP A,B", 1, 4, 4, MemAccess::kNone},  // 0xB8
+    {"CP A,C", 1, 4, 4, MemAccess::kNone},  // 0xB9
+    {"CP A,D", 1, 4, 4, MemAccess::kNone},  // 0xBA
+    {"CP A,E", 1, 4, 4, MemAccess::kNone},  // 0xBB
+    {"CP A,H", 1, 4, 4, MemAccess::kNone},  // 0xBC
+    {"CP A,L", 1, 4, 4, MemAccess::kNone},  // 0xBD
+    {"CP A,(HL)", 1, 8, 8, MemAccess::kRead},  // 0xBE
+    {"CP A,A", 1, 4, 4, MemAccess::kNone},  // 0xBF
+    {"RET NZ", 1, 8, 20, MemAccess::kRead},  // 0xC0
+    {"POP BC", 1, 12, 12, MemAccess::kRead},  // 0xC1
+    {"JP NZ,u16", 3, 12, 16, MemAccess::kNone},  // 0xC2
+    {"JP u16", 3, 16, 16, MemAccess::kNone},  // 0xC3
+    {"CALL NZ,u16", 3, 12, 24, MemAccess::kWrite},  // 0xC4
+    {"PUSH BC", 1, 16, 16, MemAccess::kWrite},  // 0xC5
+    {"ADD A,u8", 2, 8, 8, MemAccess::kNone},  // 0xC6
+    {"RST 00h", 1, 16, 16, MemAccess::kWrite},  // 0xC7
+    {"RET Z", 1, 8, 20, MemAccess::kRead},  // 0xC8
+    {"RET", 1, 16, 16, MemAccess::kRead},  // 0xC9
+    {"JP Z,u16", 3, 12, 16, MemAccess::kNone},  // 0xCA
+    {"PREFIX CB", 2, 4, 4, MemAccess::kNone},  // 0xCB
+    {"CALL Z,u16", 3, 12, 24, MemAccess::kWrite},  // 0xCC
+    {"CALL u16", 3, 24, 24, MemAccess::kWrite},  // 0xCD
+    {"ADC A,u8", 2, 8, 8, MemAccess::kNone},  // 0xCE
+    {"RST 08h", 1, 16, 16, MemAccess::kWrite},  // 0xCF
+    {"RET NC", 1, 8, 20, MemAccess::kRead},  // 0xD0
+    {"POP DE", 1, 12, 12, MemAccess::kRead},  // 0xD1
+    {"JP NC,u16", 3, 12, 16, MemAccess::kNone},  // 0xD2
+    {"EMU", 1, 0, 0, MemAccess::kNone},  // 0xD3
+    {"CALL NC,u16", 3, 12, 24, MemAccess::kWrite},  // 0xD4
+    {"PUSH DE", 1, 16, 16, MemAccess::kWrite},  // 0xD5
+    {"SUB A,u8", 2, 8, 8, MemAccess::kNone},  // 0xD6
+    {"RST 10h", 1, 16, 16, MemAccess::kWrite},  // 0xD7
+    {"RET C", 1, 8, 20, MemAccess::kRead},  // 0xD8
+    {"RETI", 1, 16, 16, MemAccess::kRead},  // 0xD9
+    {"JP C,u16", 3, 12, 16, MemAccess::kNone},  // 0xDA
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xDB
+    {"CALL C,u16", 3, 12, 24, MemAccess::kWrite},  // 0xDC
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xDD
+    {"SBC A,u8", 2, 8, 8, MemAccess::kNone},  // 0xDE
+    {"RST 18h", 1, 16, 16, MemAccess::kWrite},  // 0xDF
+    {"LDH (u8),A", 2, 12, 12, MemAccess::kWrite},  // 0xE0
+    {"POP HL", 1, 12, 12, MemAccess::kRead},  // 0xE1
+    {"LD (C),A", 1, 8, 8, MemAccess::kWrite},  // 0xE2
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xE3
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xE4
+    {"PUSH HL", 1, 16, 16, MemAccess::kWrite},  // 0xE5
+    {"AND A,u8", 2, 8, 8, MemAccess::kNone},  // 0xE6
+    {"RST 20h", 1, 16, 16, MemAccess::kWrite},  // 0xE7
+    {"ADD SP,i8", 2, 16, 16, MemAccess::kNone},  // 0xE8
+    {"JP HL", 1, 4, 4, MemAccess::kNone},  // 0xE9
+    {"LD (u16),A", 3, 16, 16, MemAccess::kWrite},  // 0xEA
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xEB
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xEC
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xED
+    {"XOR A,u8", 2, 8, 8, MemAccess::kNone},  // 0xEE
+    {"RST 28h", 1, 16, 16, MemAccess::kWrite},  // 0xEF
+    {"LDH A,(u8)", 2, 12, 12, MemAccess::kRead},  // 0xF0
+    {"POP AF", 1, 12, 12, MemAccess::kRead},  // 0xF1
+    {"LD A,(C)", 1, 8, 8, MemAccess::kRead},  // 0xF2
+    {"DI", 1, 4, 4, MemAccess::kNone},  // 0xF3
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xF4
+    {"PUSH AF", 1, 16, 16, MemAccess::kWrite},  // 0xF5
+    {"OR A,u8", 2, 8, 8, MemAccess::kNone},  // 0xF6
+    {"RST 30h", 1, 16, 16, MemAccess::kWrite},  // 0xF7
+    {"LD HL,SP+i8", 2, 12, 12, MemAccess::kNone},  // 0xF8
+    {"LD SP,HL", 1, 8, 8, MemAccess::kNone},  // 0xF9
+    {"LD A,(u16)", 3, 16, 16, MemAccess::kRead},  // 0xFA
+    {"EI", 1, 4, 4, MemAccess::kNone},  // 0xFB
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xFC
+    {nullptr, 1, 0, 0, MemAccess::kNone},  // 0xFD
+    {"CP A,u8", 2, 8, 8, MemAccess::kNone},  // 0xFE
+    {"RST 38h", 1, 16, 16, MemAccess::kWrite},  // 0xFF
+    // CB prefixed opcodes.
+    {"RLC B", 2, 8, 8, MemAccess::kNone},  // CB 0x00
+    {"RLC C", 2, 8, 8, MemAccess::kNone},  // CB 0x01
+    {"RLC D", 2, 8, 8, MemAccess::kNone},  // CB 0x02
+    {"RLC E", 2, 8, 8, MemAccess::kNone},  // CB 0x03
+    {"RLC H", 2, 8, 8, MemAccess::kNone},  // CB 0x04
+    {"RLC L", 2, 8, 8, MemAccess::kNone},  // CB 0x05
+    {"RLC (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x06
+    {"RLC A", 2, 8, 8, MemAccess::kNone},  // CB 0x07
+    {"RRC B", 2, 8, 8, MemAccess::kNone},  // CB 0x08
+    {"RRC C", 2, 8, 8, MemAccess::kNone},  // CB 0x09
+    {"RRC D", 2, 8, 8, MemAccess::kNone},  // CB 0x0A
+    {"RRC E", 2, 8, 8, MemAccess::kNone},  // CB 0x0B
+    {"RRC H", 2, 8, 8, MemAccess::kNone},  // CB 0x0C
+    {"RRC L", 2, 8, 8, MemAccess::kNone},  // CB 0x0D
+    {"RRC (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x0E
+    {"RRC A", 2, 8, 8, MemAccess::kNone},  // CB 0x0F
+    {"RL B", 2, 8, 8, MemAccess::kNone},  // CB 0x10
+    {"RL C", 2, 8, 8, MemAccess::kNone},  // CB 0x11
+    {"RL D", 2, 8, 8, MemAccess::kNone},  // CB 0x12
+    {"RL E", 2, 8, 8, MemAccess::kNone},  // CB 0x13
+    {"RL H", 2, 8, 8, MemAccess::kNone},  // CB 0x14
+    {"RL L", 2, 8, 8, MemAccess::kNone},  // CB 0x15
+    {"RL (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x16
+    {"RL A", 2, 8, 8, MemAccess::kNone},  // CB 0x17
+    {"RR B", 2, 8, 8, MemAccess::kNone},  // CB 0x18
+    {"RR C", 2, 8, 8, MemAccess::kNone},  // CB 0x19
+    {"RR D", 2, 8, 8, MemAccess::kNone},  // CB 0x1A
+    {"RR E", 2, 8, 8, MemAccess::kNone},  // CB 0x1B
+    {"RR H", 2, 8, 8, MemAccess::kNone},  // CB 0x1C
+    {"RR L", 2, 8, 8, MemAccess::kNone},  // CB 0x1D
+    {"RR (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x1E
+    {"RR A", 2, 8, 8, MemAccess::kNone},  // CB 0x1F
+    {"SLA B", 2, 8, 8, MemAccess::kNone},  // CB 0x20
+    {"SLA C", 2, 8, 8, MemAccess::kNone},  // CB 0x21
+    {"SLA D", 2, 8, 8, MemAccess::kNone},  // CB 0x22
+    {"SLA E", 2, 8, 8, MemAccess::kNone},  // CB 0x23
+    {"SLA H", 2, 8, 8, MemAccess::kNone},  // CB 0x24
+    {"SLA L", 2, 8, 8, MemAccess::kNone},  // CB 0x25
+    {"SLA (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x26
+    {"SLA A", 2, 8, 8, MemAccess::kNone},  // CB 0x27
+    {"SRA B", 2, 8, 8, MemAccess::kNone},  // CB 0x28
+    {"SRA C", 2, 8, 8, MemAccess::kNone},  // CB 0x29
+    {"SRA D", 2, 8, 8, MemAccess::kNone},  // CB 0x2A
+    {"SRA E", 2, 8, 8, MemAccess::kNone},  // CB 0x2B
+    {"SRA H", 2, 8, 8, MemAccess::kNone},  // CB 0x2C
+    {"SRA L", 2, 8, 8, MemAccess::kNone},  // CB 0x2D
+    {"SRA (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x2E
+    {"SRA A", 2, 8, 8, MemAccess::kNone},  // CB 0x2F
+    {"SWAP B", 2, 8, 8, MemAccess::kNone},  // CB 0x30
+    {"SWAP C", 2, 8, 8, MemAccess::kNone},  // CB 0x31
+    {"SWAP D", 2, 8, 8, MemAccess::kNone},  // CB 0x32
+    {"SWAP E", 2, 8, 8, MemAccess::kNone},  // CB 0x33
+    {"SWAP H", 2, 8, 8, MemAccess::kNone},  // CB 0x34
+    {"SWAP L", 2, 8, 8, MemAccess::kNone},  // CB 0x35
+    {"SWAP (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x36
+    {"SWAP A", 2, 8, 8, MemAccess::kNone},  // CB 0x37
+    {"SRL B", 2, 8, 8, MemAccess::kNone},  // CB 0x38
+    {"SRL C", 2, 8, 8, MemAccess::kNone},  // CB 0x39
+    {"SRL D", 2, 8, 8, MemAccess::kNone},  // CB 0x3A
+    {"SRL E", 2, 8, 8, MemAccess::kNone},  // CB 0x3B
+    {"SRL H", 2, 8, 8, MemAccess::kNone},  // CB 0x3C
+    {"SRL L", 2, 8, 8, MemAccess::kNone},  // CB 0x3D
+    {"SRL (HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x3E
+    {"SRL A", 2, 8, 8, MemAccess::kNone},  // CB 0x3F
+    {"BIT 0,B", 2, 8, 8, MemAccess::kNone},  // CB 0x40
+    {"BIT 0,C", 2, 8, 8, MemAccess::kNone},  // CB 0x41
+    {"BIT 0,D", 2, 8, 8, MemAccess::kNone},  // CB 0x42
+    {"BIT 0,E", 2, 8, 8, MemAccess::kNone},  // CB 0x43
+    {"BIT 0,H", 2, 8, 8, MemAccess::kNone},  // CB 0x44
+    {"BIT 0,L", 2, 8, 8, MemAccess::kNone},  // CB 0x45
+    {"BIT 0,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x46
+    {"BIT 0,A", 2, 8, 8, MemAccess::kNone},  // CB 0x47
+    {"BIT 1,B", 2, 8, 8, MemAccess::kNone},  // CB 0x48
+    {"BIT 1,C", 2, 8, 8, MemAccess::kNone},  // CB 0x49
+    {"BIT 1,D", 2, 8, 8, MemAccess::kNone},  // CB 0x4A
+    {"BIT 1,E", 2, 8, 8, MemAccess::kNone},  // CB 0x4B
+    {"BIT 1,H", 2, 8, 8, MemAccess::kNone},  // CB 0x4C
+    {"BIT 1,L", 2, 8, 8, MemAccess::kNone},  // CB 0x4D
+    {"BIT 1,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x4E
+    {"BIT 1,A", 2, 8, 8, MemAccess::kNone},  // CB 0x4F
+    {"BIT 2,B", 2, 8, 8, MemAccess::kNone},  // CB 0x50
+    {"BIT 2,C", 2, 8, 8, MemAccess::kNone},  // CB 0x51
+    {"BIT 2,D", 2, 8, 8, MemAccess::kNone},  // CB 0x52
+    {"BIT 2,E", 2, 8, 8, MemAccess::kNone},  // CB 0x53
+    {"BIT 2,H", 2, 8, 8, MemAccess::kNone},  // CB 0x54
+    {"BIT 2,L", 2, 8, 8, MemAccess::kNone},  // CB 0x55
+    {"BIT 2,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x56
+    {"BIT 2,A", 2, 8, 8, MemAccess::kNone},  // CB 0x57
+    {"BIT 3,B", 2, 8, 8, MemAccess::kNone},  // CB 0x58
+    {"BIT 3,C", 2, 8, 8, MemAccess::kNone},  // CB 0x59
+    {"BIT 3,D", 2, 8, 8, MemAccess::kNone},  // CB 0x5A
+    {"BIT 3,E", 2, 8, 8, MemAccess::kNone},  // CB 0x5B
+    {"BIT 3,H", 2, 8, 8, MemAccess::kNone},  // CB 0x5C
+    {"BIT 3,L", 2, 8, 8, MemAccess::kNone},  // CB 0x5D
+    {"BIT 3,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x5E
+    {"BIT 3,A", 2, 8, 8, MemAccess::kNone},  // CB 0x5F
+    {"BIT 4,B", 2, 8, 8, MemAccess::kNone},  // CB 0x60
+    {"BIT 4,C", 2, 8, 8, MemAccess::kNone},  // CB 0x61
+    {"BIT 4,D", 2, 8, 8, MemAccess::kNone},  // CB 0x62
+    {"BIT 4,E", 2, 8, 8, MemAccess::kNone},  // CB 0x63
+    {"BIT 4,H", 2, 8, 8, MemAccess::kNone},  // CB 0x64
+    {"BIT 4,L", 2, 8, 8, MemAccess::kNone},  // CB 0x65
+    {"BIT 4,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x66
+    {"BIT 4,A", 2, 8, 8, MemAccess::kNone},  // CB 0x67
+    {"BIT 5,B", 2, 8, 8, MemAccess::kNone},  // CB 0x68
+    {"BIT 5,C", 2, 8, 8, MemAccess::kNone},  // CB 0x69
+    {"BIT 5,D", 2, 8, 8, MemAccess::kNone},  // CB 0x6A
+    {"BIT 5,E", 2, 8, 8, MemAccess::kNone},  // CB 0x6B
+    {"BIT 5,H", 2, 8, 8, MemAccess::kNone},  // CB 0x6C
+    {"BIT 5,L", 2, 8, 8, MemAccess::kNone},  // CB 0x6D
+    {"BIT 5,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x6E
+    {"BIT 5,A", 2, 8, 8, MemAccess::kNone},  // CB 0x6F
+    {"BIT 6,B", 2, 8, 8, MemAccess::kNone},  // CB 0x70
+    {"BIT 6,C", 2, 8, 8, MemAccess::kNone},  // CB 0x71
+    {"BIT 6,D", 2, 8, 8, MemAccess::kNone},  // CB 0x72
+    {"BIT 6,E", 2, 8, 8, MemAccess::kNone},  // CB 0x73
+    {"BIT 6,H", 2, 8, 8, MemAccess::kNone},  // CB 0x74
+    {"BIT 6,L", 2, 8, 8, MemAccess::kNone},  // CB 0x75
+    {"BIT 6,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x76
+    {"BIT 6,A", 2, 8, 8, MemAccess::kNone},  // CB 0x77
+    {"BIT 7,B", 2, 8, 8, MemAccess::kNone},  // CB 0x78
+    {"BIT 7,C", 2, 8, 8, MemAccess::kNone},  // CB 0x79
+    {"BIT 7,D", 2, 8, 8, MemAccess::kNone},  // CB 0x7A
+    {"BIT 7,E", 2, 8, 8, MemAccess::kNone},  // CB 0x7B
+    {"BIT 7,H", 2, 8, 8, MemAccess::kNone},  // CB 0x7C
+    {"BIT 7,L", 2, 8, 8, MemAccess::kNone},  // CB 0x7D
+    {"BIT 7,(HL)", 2, 12, 12, MemAccess::kRead},  // CB 0x7E
+    {"BIT 7,A", 2, 8, 8, MemAccess::kNone},  // CB 0x7F
+    {"RES 0,B", 2, 8, 8, MemAccess::kNone},  // CB 0x80
+    {"RES 0,C", 2, 8, 8, MemAccess::kNone},  // CB 0x81
+    {"RES 0,D", 2, 8, 8, MemAccess::kNone},  // CB 0x82
+    {"RES 0,E", 2, 8, 8, MemAccess::kNone},  // CB 0x83
+    {"RES 0,H", 2, 8, 8, MemAccess::kNone},  // CB 0x84
+    {"RES 0,L", 2, 8, 8, MemAccess::kNone},  // CB 0x85
+    {"RES 0,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x86
+    {"RES 0,A", 2, 8, 8, MemAccess::kNone},  // CB 0x87
+    {"RES 1,B", 2, 8, 8, MemAccess::kNone},  // CB 0x88
+    {"RES 1,C", 2, 8, 8, MemAccess::kNone},  // CB 0x89
+    {"RES 1,D", 2, 8, 8, MemAccess::kNone},  // CB 0x8A
+    {"RES 1,E", 2, 8, 8, MemAccess::kNone},  // CB 0x8B
+    {"RES 1,H", 2, 8, 8, MemAccess::kNone},  // CB 0x8C
+    {"RES 1,L", 2, 8, 8, MemAccess::kNone},  // CB 0x8D
+    {"RES 1,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x8E
+    {"RES 1,A", 2, 8, 8, MemAccess::kNone},  // CB 0x8F
+    {"RES 2,B", 2, 8, 8, MemAccess::kNone},  // CB 0x90
+    {"RES 2,C", 2, 8, 8, MemAccess::kNone},  // CB 0x91
+    {"RES 2,D", 2, 8, 8, MemAccess::kNone},  // CB 0x92
+    {"RES 2,E", 2, 8, 8, MemAccess::kNone},  // CB 0x93
+    {"RES 2,H", 2, 8, 8, MemAccess::kNone},  // CB 0x94
+    {"RES 2,L", 2, 8, 8, MemAccess::kNone},  // CB 0x95
+    {"RES 2,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x96
+    {"RES 2,A", 2, 8, 8, MemAccess::kNone},  // CB 0x97
+    {"RES 3,B", 2, 8, 8, MemAccess::kNone},  // CB 0x98
+    {"RES 3,C", 2, 8, 8, MemAccess::kNone},  // CB 0x99
+    {"RES 3,D", 2, 8, 8, MemAccess::kNone},  // CB 0x9A
+    {"RES 3,E", 2, 8, 8, MemAccess::kNone},  // CB 0x9B
+    {"RES 3,H", 2, 8, 8, MemAccess::kNone},  // CB 0x9C
+    {"RES 3,L", 2, 8, 8, MemAccess::kNone},  // CB 0x9D
+    {"RES 3,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0x9E
+    {"RES 3,A", 2, 8, 8, MemAccess::kNone},  // CB 0x9F
+    {"RES 4,B", 2, 8, 8, MemAccess::kNone},  // CB 0xA0
+    {"RES 4,C", 2, 8, 8, MemAccess::kNone},  // CB 0xA1
+    {"RES 4,D", 2, 8, 8, MemAccess::kNone},  // CB 0xA2
+    {"RES 4,E", 2, 8, 8, MemAccess::kNone},  // CB 0xA3
+    {"RES 4,H", 2, 8, 8, MemAccess::kNone},  // CB 0xA4
+    {"RES 4,L", 2, 8, 8, MemAccess::kNone},  // CB 0xA5
+    {"RES 4,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xA6
+    {"RES 4,A", 2, 8, 8, MemAccess::kNone},  // CB 0xA7
+    {"RES 5,B", 2, 8, 8, MemAccess::kNone},  // CB 0xA8
+    {"RES 5,C", 2, 8, 8, MemAccess::kNone},  // CB 0xA9
+    {"RES 5,D", 2, 8, 8, MemAccess::kNone},  // CB 0xAA
+    {"RES 5,E", 2, 8, 8, MemAccess::kNone},  // CB 0xAB
+    {"RES 5,H", 2, 8, 8, MemAccess::kNone},  // CB 0xAC
+    {"RES 5,L", 2, 8, 8, MemAccess::kNone},  // CB 0xAD
+    {"RES 5,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xAE
+    {"RES 5,A", 2, 8, 8, MemAccess::kNone},  // CB 0xAF
+    {"RES 6,B", 2, 8, 8, MemAccess::kNone},  // CB 0xB0
+    {"RES 6,C", 2, 8, 8, MemAccess::kNone},  // CB 0xB1
+    {"RES 6,D", 2, 8, 8, MemAccess::kNone},  // CB 0xB2
+    {"RES 6,E", 2, 8, 8, MemAccess::kNone},  // CB 0xB3
+    {"RES 6,H", 2, 8, 8, MemAccess::kNone},  // CB 0xB4
+    {"RES 6,L", 2, 8, 8, MemAccess::kNone},  // CB 0xB5
+    {"RES 6,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xB6
+    {"RES 6,A", 2, 8, 8, MemAccess::kNone},  // CB 0xB7
+    {"RES 7,B", 2, 8, 8, MemAccess::kNone},  // CB 0xB8
+    {"RES 7,C", 2, 8, 8, MemAccess::kNone},  // CB 0xB9
+    {"RES 7,D", 2, 8, 8, MemAccess::kNone},  // CB 0xBA
+    {"RES 7,E", 2, 8, 8, MemAccess::kNone},  // CB 0xBB
+    {"RES 7,H", 2, 8, 8, MemAccess::kNone},  // CB 0xBC
+    {"RES 7,L", 2, 8, 8, MemAccess::kNone},  // CB 0xBD
+    {"RES 7,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xBE
+    {"RES 7,A", 2, 8, 8, MemAccess::kNone},  // CB 0xBF
+    {"SET 0,B", 2, 8, 8, MemAccess::kNone},  // CB 0xC0
+    {"SET 0,C", 2, 8, 8, MemAccess::kNone},  // CB 0xC1
+    {"SET 0,D", 2, 8, 8, MemAccess::kNone},  // CB 0xC2
+    {"SET 0,E", 2, 8, 8, MemAccess::kNone},  // CB 0xC3
+    {"SET 0,H", 2, 8, 8, MemAccess::kNone},  // CB 0xC4
+    {"SET 0,L", 2, 8, 8, MemAccess::kNone},  // CB 0xC5
+    {"SET 0,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xC6
+    {"SET 0,A", 2, 8, 8, MemAccess::kNone},  // CB 0xC7
+    {"SET 1,B", 2, 8, 8, MemAccess::kNone},  // CB 0xC8
+    {"SET 1,C", 2, 8, 8, MemAccess::kNone},  // CB 0xC9
+    {"SET 1,D", 2, 8, 8, MemAccess::kNone},  // CB 0xCA
+    {"SET 1,E", 2, 8, 8, MemAccess::kNone},  // CB 0xCB
+    {"SET 1,H", 2, 8, 8, MemAccess::kNone},  // CB 0xCC
+    {"SET 1,L", 2, 8, 8, MemAccess::kNone},  // CB 0xCD
+    {"SET 1,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xCE
+    {"SET 1,A", 2, 8, 8, MemAccess::kNone},  // CB 0xCF
+    {"SET 2,B", 2, 8, 8, MemAccess::kNone},  // CB 0xD0
+    {"SET 2,C", 2, 8, 8, MemAccess::kNone},  // CB 0xD1
+    {"SET 2,D", 2, 8, 8, MemAccess::kNone},  // CB 0xD2
+    {"SET 2,E", 2, 8, 8, MemAccess::kNone},  // CB 0xD3
+    {"SET 2,H", 2, 8, 8, MemAccess::kNone},  // CB 0xD4
+    {"SET 2,L", 2, 8, 8, MemAccess::kNone},  // CB 0xD5
+    {"SET 2,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xD6
+    {"SET 2,A", 2, 8, 8, MemAccess::kNone},  // CB 0xD7
+    {"SET 3,B", 2, 8, 8, MemAccess::kNone},  // CB 0xD8
+    {"SET 3,C", 2, 8, 8, MemAccess::kNone},  // CB 0xD9
+    {"SET 3,D", 2, 8, 8, MemAccess::kNone},  // CB 0xDA
+    {"SET 3,E", 2, 8, 8, MemAccess::kNone},  // CB 0xDB
+    {"SET 3,H", 2, 8, 8, MemAccess::kNone},  // CB 0xDC
+    {"SET 3,L", 2, 8, 8, MemAccess::kNone},  // CB 0xDD
+    {"SET 3,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xDE
+    {"SET 3,A", 2, 8, 8, MemAccess::kNone},  // CB 0xDF
+    {"SET 4,B", 2, 8, 8, MemAccess::kNone},  // CB 0xE0
+    {"SET 4,C", 2, 8, 8, MemAccess::kNone},  // CB 0xE1
+    {"SET 4,D", 2, 8, 8, MemAccess::kNone},  // CB 0xE2
+    {"SET 4,E", 2, 8, 8, MemAccess::kNone},  // CB 0xE3
+    {"SET 4,H", 2, 8, 8, MemAccess::kNone},  // CB 0xE4
+    {"SET 4,L", 2, 8, 8, MemAccess::kNone},  // CB 0xE5
+    {"SET 4,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xE6
+    {"SET 4,A", 2, 8, 8, MemAccess::kNone},  // CB 0xE7
+    {"SET 5,B", 2, 8, 8, MemAccess::kNone},  // CB 0xE8
+    {"SET 5,C", 2, 8, 8, MemAccess::kNone},  // CB 0xE9
+    {"SET 5,D", 2, 8, 8, MemAccess::kNone},  // CB 0xEA
+    {"SET 5,E", 2, 8, 8, MemAccess::kNone},  // CB 0xEB
+    {"SET 5,H", 2, 8, 8, MemAccess::kNone},  // CB 0xEC
+    {"SET 5,L", 2, 8, 8, MemAccess::kNone},  // CB 0xED
+    {"SET 5,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xEE
+    {"SET 5,A", 2, 8, 8, MemAccess::kNone},  // CB 0xEF
+    {"SET 6,B", 2, 8, 8, MemAccess::kNone},  // CB 0xF0
+    {"SET 6,C", 2, 8, 8, MemAccess::kNone},  // CB 0xF1
+    {"SET 6,D", 2, 8, 8, MemAccess::kNone},  // CB 0xF2
+    {"SET 6,E", 2, 8, 8, MemAccess::kNone},  // CB 0xF3
+    {"SET 6,H", 2, 8, 8, MemAccess::kNone},  // CB 0xF4
+    {"SET 6,L", 2, 8, 8, MemAccess::kNone},  // CB 0xF5
+    {"SET 6,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xF6
+    {"SET 6,A", 2, 8, 8, MemAccess::kNone},  // CB 0xF7
+    {"SET 7,B", 2, 8, 8, MemAccess::kNone},  // CB 0xF8
+    {"SET 7,C", 2, 8, 8, MemAccess::kNone},  // CB 0xF9
+    {"SET 7,D", 2, 8, 8, MemAccess::kNone},  // CB 0xFA
+    {"SET 7,E", 2, 8, 8, MemAccess::kNone},  // CB 0xFB
+    {"SET 7,H", 2, 8, 8, MemAccess::kNone},  // CB 0xFC
+    {"SET 7,L", 2, 8, 8, MemAccess::kNone},  // CB 0xFD
+    {"SET 7,(HL)", 2, 16, 16, MemAccess::kReadWrite},  // CB 0xFE
+    {"SET 7,A", 2, 8, 8, MemAccess::kNone},  // CB 0xFF
+}};
+inline constexpr std::span<const OpcodeInfo, 256> kOpcodes{kOpcodeTable.data(), 256};
+inline constexpr std::span<const OpcodeInfo, 256> kOpcodesCb{kOpcodeTable.data() + 256, 256};
+
+// Returns the information about the instruction starting with the given bytes.
+constexpr const OpcodeInfo& GetOpcodeInfo(const u8* bytes) {
+  return (bytes[0] == 0xCB) ? kOpcodesCb[bytes[1]] : kOpcodes[bytes[0]];
+}
+
+// Returns the index of an entry of kOpcodeTable.
+inline u16 GetOpcodeIndex(const OpcodeInfo& info) {
+  return static_cast<u16>(&info - kOpcodeTable.data());
+}
+
+// Writes the assembly of the instruction at address adr (bytes point to its opcode) into out as a
+// null-terminated string. Immediates are printed as hex numbers, relative jumps with their target address.
+// Doesn't allocate any memory, so it can be called for every executed instruction.
+// Returns the length of the instruction in bytes.
+u8 Disassemble(const u8* bytes, u16 adr, char* out, size_t out_size);
+
+// Maximum length of a disassembled instruction including the terminating null (e.g., "CALL NZ,0x1234").
+inline constexpr size_t kMaxDisassemblyLength = 24;
@@ -9,17 +9,32 @@
 
 #include <algorithm>
 
+#include "jit.h"
+
 void Options::InitOpts(int argc, char* argv[]) {
   const struct option long_opts[] = {{"boot-rom-path", required_argument, 0, 'b'},
                                      {"color-palette", required_argument, 0, 'c'},
+                                     {"cpu-backend", required_argument, 0, 'u'},
+                                     {"dma-hram-only", no_argument, 0, 'D'},
+                                     {"dump-on-exit", no_argument, 0, 'd'},
                                      {"fps-cap", required_argument, 0, 'f'},
                                      {"headless", no_argument, 0, 'l'},
                                      {"help", no_argument, 0, 'h'},
                                      {"max-cycles", required_argument, 0, 'm'},
+                                     {"profile", required_argument, 0, 'p'},
+                                     {"profile-symbols", required_argument, 0, 'o'},
+                                     {"profile-stacks", required_argument, 0, 'g'},
+                                     {"profile-stacks-cycles", required_argument, 0, 'i'},
+                                     {"quantum-cycles", required_argument, 0, 'k'},
                                      {"rom-path", required_argument, 0, 'r'},
+                                     {"rtc-source", required_argument, 0, 'z'},
                                      {"resolution-scaling", required_argument, 0, 'e'},
+                                     {"save-flush-ms", required_argument, 0, 'a'},
                                      {"single-step", no_argument, 0, 's'},
+                                     {"stats", no_argument, 0, 'j'},
                                      {"symbol-file", no_argument, 0, 'y'},
+                                     {"trace", required_argument, 0, 't'},
+                                     {"trace-mem-writes", no_argument, 0, 'v'},
                                      {"wait-for-gdb", no_argument, 0, 'w'},
                                      {"show-ext-game-window", no_argument, 0, 'x'},
                                      {"show-window-window", no_argument, 0, 'n'},
@@ -28,16 +43,28 @@ void Options::InitOpts(int argc, char* argv[]) {
 
   int index;
   while (true) {
-    switch (getopt_long(argc, argv, "b:f:hm:lwr:sc:e:", long_opts, &index)) {
+    switch (getopt_long(argc, argv, "b:f:hm:lwr:sc:e:u:", long_opts, &index)) {
     case 'b':
       boot_rom_path = fs::path(optarg);
       continue;
     case 'c':
       color_palette = string(optarg);
       continue;
+    case 'u':
+      cpu_backend = string(optarg);
+      continue;
+    case 'D':
+      dma_hram_only = true;
+      continue;
+    case 'd':
+      dump_on_exit = true;
+      continue;
     case 'e':
       resolution_scaling = std::stoll(string(optarg));
       continue;
+    case 'a':
+      save_flush_ms = std::stoll(string(optarg));
+      continue;
     case 'f':
       fps_cap = std::stoll(string(optarg));
       continue;
@@ -47,12 +74,33 @@ void Options::InitOpts(int argc, char* argv[]) {
     case 'm':
       max_cycles = std::stoll(string(optarg));
       continue;
+    case 'p':
+      profile_path = fs::path(optarg);
+      continue;
+    case 'o':
+      profile_symbols_path = fs::path(optarg);
+      continue;
+    case 'g':
+      profile_stacks_path = fs::path(optarg);
+      continue;
+    case 'i':
+      profile_stacks_cycles = std::stoll(string(optarg));
+      continue;
+    case 'k':
+      quantum_cycles = std::stoll(string(optarg));
+      continue;
     case 'r':
       rom_path = fs::path(optarg);
       continue;
+    case 'z':
+      rtc_source = string(optarg);
+      continue;
     case 's':
       single_step = true;
       continue;
+    case 'j':
+      stats = true;
+      continue;
     case 'w':
       wait_for_gdb = true;
       continue;
@@ -68,6 +116,12 @@ void Options::InitOpts(int argc, char* argv[]) {
     case 'y':
       symbol_file = true;
       continue;
+    case 't':
+      trace_path = fs::path(optarg);
+      continue;
+    case 'v':
+      trace_mem_writes = true;
+      continue;
     case '?':
     case 'h':
     default:
@@ -77,21 +131,56 @@ void Options::InitOpts(int argc, char* argv[]) {
                 << "          --color-palette" << std::endl
                 << "          Color palette hex string with four RGB colors from bright to dark." << std::endl
                 << "          Default: f2ffd9aaaaaa555555000000." << std::endl
+                << "          --cpu-backend" << std::endl
+                << "          How the CPU executes instructions: interpreter or jit. Default: interpreter." << std::endl
+                << "          --dma-hram-only" << std::endl
+                << "          Only lets the CPU access HRAM and the registers during an OAM DMA." << std::endl
+                << "          --dump-on-exit" << std::endl
+                << "          Prints the last executed instructions of the flight recorder on exit." << std::endl
                 << "          --fps-cap" << std::endl
                 << "          Limits the maximum frames per second. Default 60." << std::endl
                 << "          --headless" << std::endl
                 << "          Runs the TLMBoy without any graphical output." << std::endl
                 << "          --max-cycles" << std::endl
                 << "          Maximum number of clock cycles to run. Default -1 = infinite." << std::endl
+                << "          --profile" << std::endl
+                << "          Counts executed instructions and cycles per address and opcode and writes a report to"
+                << std::endl
+                << "          the given file and a callgrind file (KCachegrind) to <file>.callgrind on exit."
+                << std::endl
+                << "          --profile-symbols" << std::endl
+                << "          rgbds symbol file (.sym) whose labels are used in the profile." << std::endl
+                << "          --profile-stacks" << std::endl
+                << "          Samples the call stack of the game and writes folded stacks (flame graph) to the given"
+                << std::endl
+                << "          file on exit." << std::endl
+                << "          --profile-stacks-cycles" << std::endl
+                << "          Clock cycles between two call stack samples. Default: 1000." << std::endl
+                << "          --quantum-cycles" << std::endl
+                << "          Lets the CPU run ahead of the other modules by up to this many clock cycles." << std::endl
+                << "          Default: 0 = synchronize whenever another module has pending activity." << std::endl
                 << "          --resolution-scaling" << std::endl
                 << "          Scaling of the game window's resolution. A value of 1 corresponds to the original "
                    "resolution of 160x144."
                 << std::endl
                 << "          Default: 4." << std::endl
+                << "          --rtc-source" << std::endl
+                << "          Time base of the cartridge's real-time clock: emulated or host. Default: emulated."
+                << std::endl
+                << "          --save-flush-ms" << std::endl
+                << "          Milliseconds between two write-backs of the battery-backed RAM. Default: 1000."
+                << std::endl
                 << "          --single-step" << std::endl
                 << "          Prints the CPU state before each instruction" << std::endl
+                << "          --stats" << std::endl
+                << "          Prints statistics of the emulation to stderr on exit." << std::endl
                 << "          --symbole-file" << std::endl
                 << "          Traces accesses to the ROM and dumps a symbol file (trace.sym) on exit." << std::endl
+                << "          --trace" << std::endl
+                << "          Records the registers and cycles of each instruction in a binary trace file." << std::endl
+                << "          Compare two traces with tlmboy_tracediff." << std::endl
+                << "          --trace-mem-writes" << std::endl
+                << "          Also records the memory writes in the trace." << std::endl
                 << "          --wait-for-gdb" << std::endl
                 << "          Wait for a GDB remote connection on port 1337." << std::endl
                 << "          --show-ext-game-window" << std::endl
@@ -116,4 +205,34 @@ void Options::InitOpts(int argc, char* argv[]) {
     std::cerr << "Invalid argument: Color palette needs to a hex string!!";
     std::exit(1);
   }
+
+  if (quantum_cycles < 0 || quantum_cycles > 0xFFFFFFFF) {
+    std::cerr << "Invalid argument: The quantum needs to be a positive number of clock cycles or 0!";
+    std::exit(1);
+  }
+
+  if (save_flush_ms <= 0) {
+    std::cerr << "Invalid argument: The save flush interval needs to be a positive number of milliseconds!";
+    std::exit(1);
+  }
+
+  if (profile_stacks_cycles <= 0) {
+    std::cerr << "Invalid argument: The call stack sampling period needs to be a positive number of clock cycles!";
+    std::exit(1);
+  }
+
+  if (cpu_backend != "interpreter" && cpu_backend != "jit") {
+    std::cerr << "Invalid argument: CPU backend needs to be interpreter or jit!";
+    std::exit(1);
+  }
+
+  if (rtc_source != "emulated" && rtc_source != "host") {
+    std::cerr << "Invalid argument: RTC source needs to be emulated or host!";
+    std::exit(1);
+  }
+
+  if (cpu_backend == "jit" && !Jit::IsSupported()) {
+    std::cerr << "Invalid argument: The JIT is only supported on x86-64 hosts!";
+    std::exit(1);
+  }
 }
@@ -11,17 +11,30 @@
 namespace fs = std::filesystem;
 
 struct Options {
+  bool dma_hram_only = false;
+  bool dump_on_exit = false;
   bool headless = false;
   bool quick_boot = false;
   bool symbol_file = false;
+  bool trace_mem_writes = false;
   bool single_step = false;
+  bool stats = false;
   bool wait_for_gdb = false;
   fs::path rom_path = "";
   fs::path boot_rom_path = "";
+  fs::path profile_path = "";
+  fs::path profile_symbols_path = "";
+  fs::path profile_stacks_path = "";
+  fs::path trace_path = "";
   int fps_cap = 60;
   i64 max_cycles = -1;
+  i64 profile_stacks_cycles = 1000;
+  i64 quantum_cycles = 0;
   i64 resolution_scaling = 4;
+  i64 save_flush_ms = 1000;
   string color_palette = "f2ffd9aaaaaa555555000000";
+  string cpu_backend = "interpreter";
+  string rtc_source = "emulated";
   bool show_ext_game_wndw = false;
   bool show_window_wndw = false;
 
@@ -278,7 +278,7 @@ void Ppu::CheckLycInterrupt() {
   bool ly_coinc = *reg_ly_comp == *reg_lcdc_y;
 
   if (ly_coinc_interrupt && ly_coinc) {
-    *reg_intr_pending_dmi |= kMaskLcdcStatIf;
+    RequestInterrupt(reg_intr_pending_dmi, kMaskLcdcStatIf, intr_event);
   }
 
   SetBit(reg_stat, ly_coinc, 2);
@@ -314,7 +314,7 @@ void Ppu::RenderLoop() {
       ++(*reg_lcdc_y);
 
       if (*reg_stat & gb_const::kMaskBit3) {
-        *reg_intr_pending_dmi |= kMaskLcdcStatIf;
+        RequestInterrupt(reg_intr_pending_dmi, kMaskLcdcStatIf, intr_event);
       }
 
       CheckLycInterrupt();
@@ -328,7 +328,7 @@ void Ppu::RenderLoop() {
     game_wndw->DrawToScreen(*this);
     window_wndw->DrawToScreen(*this);
     DBG_LOG_PPU(std::endl << StateStr());
-    *reg_intr_pending_dmi |= kMaskVBlankIE;  // V-Blank interrupt.
+    RequestInterrupt(reg_intr_pending_dmi, kMaskVBlankIE, intr_event);  // V-Blank interrupt.
 
     for (int i = 0; i < 10; ++i) {
       wait(vblank_time);  // The vblank period is 10 * 4560 = 4560 cycles.
@@ -26,6 +26,7 @@
 #include "SDL2/SDL.h"
 #include "common.h"
 #include "debug.h"
+#include "utils.h"
 
 struct PpuArgs {
   bool headless = false;
@@ -145,6 +146,7 @@ struct Ppu : public sc_module {
 
   // SystemC interfaces.
   tlm_utils::simple_initiator_socket<Ppu, gb_const::kBusDataWidth> init_socket;
+  sc_event* intr_event = nullptr;  // Notified on V-Blank and LCDC status interrupts.
   void start_of_simulation() override;
 
   class RenderWindow {
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+Profiler::Counter Profiler::GetCounter(u16 bank, u16 adr) const {
+  if (adr >= 0x8000)
+    return ram_counters_[adr - 0x8000];
+  const size_t ind = (adr < kBankSize) ? adr : bank * kBankSize + adr - kBankSize;
+  return (ind < rom_counters_.size()) ? rom_counters_[ind] : Counter{};
+}
+
+template <typename Func>
+void Profiler::ForEachCounter(Func func) const {
+  for (size_t ind = 0; ind < rom_counters_.size(); ++ind) {
+    const u16 bank = static_cast<u16>(ind / kBankSize);
+    const u16 adr = static_cast<u16>((bank == 0 ? 0 : kBankSize) + ind % kBankSize);
+    if (rom_counters_[ind].instrs != 0 || rom_counters_[ind].cycles != 0)
+      func(bank, adr, rom_counters_[ind]);
+  }
+  for (size_t ind = 0; ind < ram_counters_.size(); ++ind) {
+    if (ram_counters_[ind].instrs != 0 || ram_counters_[ind].cycles != 0)
+      func(0, static_cast<u16>(0x8000 + ind), ram_counters_[ind]);
+  }
+}
+
+void Profiler::WriteReport(std::ostream& os, const SymbolTable& symbols, size_t max_hot_spots) const {
+  Counter total;
+  std::vector<HotSpot> hot_spots;
+  ForEachCounter([&](u16 bank, u16 adr, const Counter& counter) {
+    total.instrs += counter.instrs;
+    total.cycles += counter.cycles;
+    hot_spots.push_back({bank, adr, counter});
+  });
+  const size_t num_hot_spots = std::min(max_hot_spots, hot_spots.size());
+  std::partial_sort(hot_spots.begin(), hot_spots.begin() + num_hot_spots, hot_spots.end(),
+                    [](const HotSpot& a, const HotSpot& b) { return a.counter.cycles > b.counter.cycles; });
+  const auto percent = [&total](u64 cycles) { return (total.cycles == 0) ? 0.0 : 100.0 * cycles / total.cycles; };
+
+  os << std::format("Executed instructions: {}\nClock cycles: {}\n\n", total.instrs, total.cycles);
+  os << std::format("Hot spots:\n{:>14} {:>7} {:>12}  {:<7}  {}\n", "cycles", "%", "instrs", "address", "symbol");
+  for (size_t i = 0; i < num_hot_spots; ++i) {
+    const HotSpot& spot = hot_spots[i];
+    os << std::format("{:>14} {:>6.2f}% {:>12}  {:02x}:{:04x}  {}\n", spot.counter.cycles,
+                      percent(spot.counter.cycles), spot.counter.instrs, spot.bank, spot.adr,
+                      symbols.GetName(spot.bank, spot.adr));
+  }
+
+  std::array<u16, kOpcodeTable.size()> opcodes;
+  for (size_t i = 0; i < opcodes.size(); ++i)
+    opcodes[i] = static_cast<u16>(i);
+  std::stable_sort(opcodes.begin(), opcodes.end(),
+                   [this](u16 a, u16 b) { return opcode_counters_[a].cycles > opcode_counters_[b].cycles; });
+  os << std::format("\nOpcodes:\n{:>14} {:>7} {:>12}  {:<7}  {}\n", "cycles", "%", "instrs", "opcode", "mnemonic");
+  for (u16 ind : opcodes) {
+    const Counter& counter = opcode_counters_[ind];
+    if (counter.instrs == 0 && counter.cycles == 0)
+      break;
+    const string opcode = (ind < 256) ? std::format("{:02x}", ind) : std::format("cb {:02x}", ind - 256);
+    const char* mnemonic = kOpcodeTable[ind].mnemonic;
+    os << std::format("{:>14} {:>6.2f}% {:>12}  {:<7}  {}\n", counter.cycles, percent(counter.cycles),
+                      counter.instrs, opcode, mnemonic ? mnemonic : "undefined");
+  }
+}
+
+// See: https://valgrind.org/docs/manual/cl-format.html
+void Profiler::WriteCallgrind(std::ostream& os, const SymbolTable& symbols) const {
+  os << "# callgrind format\nversion: 1\ncreator: TLMBoy\npositions: instr\nevents: Cycles Instructions\n";
+  string cur_fn;
+  Counter total;
+  ForEachCounter([&](u16 bank, u16 adr, const Counter& counter) {
+    const auto* symbol = symbols.Find(bank, adr);
+    string fn;
+    if (symbol != nullptr)
+      fn = std::format("{} ({:02x}:{:04x})", symbol->second, bank, symbol->first & 0xFFFF);
+    else
+      fn = (adr >= 0x8000) ? "ram" : std::format("bank_{:02x}", bank);
+    if (fn != cur_fn) {
+      os << "\nfn=" << fn << "\n";
+      cur_fn = fn;
+    }
+    os << std::format("0x{:04x} {} {}\n", adr, counter.cycles, counter.instrs);
+    total.instrs += counter.instrs;
+    total.cycles += counter.cycles;
+  });
+  os << std::format("\ntotals: {} {}\n", total.cycles, total.instrs);
+}
+
+void Profiler::WriteFiles(const std::filesystem::path& path, const SymbolTable& symbols) const {
+  std::ofstream report_file(path);
+  WriteReport(report_file, symbols);
+  std::filesystem::path callgrind_path = path;
+  callgrind_path += ".callgrind";
+  std::ofstream callgrind_file(callgrind_path);
+  WriteCallgrind(callgrind_file, symbols);
+  std::cout << std::format("Wrote profile to '{}' and '{}'\n", path.string(), callgrind_path.string());
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * The Profiler counts executed instructions and consumed clock cycles per address
+ * and per opcode. Like in the SymfileTracer, addresses of the switchable ROM bank
+ * are kept apart by their bank.
+ * On exit, it writes a report of the hot spots and a file in callgrind format
+ * that can be opened with KCachegrind. Both use the labels of a SymbolTable.
+ ******************************************************************************/
+
+#include <array>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "common.h"
+#include "opcodes.h"
+#include "symbol_table.h"
+
+class Profiler {
+ public:
+  constexpr static size_t kMaxBanks = 512;
+  constexpr static size_t kBankSize = 0x4000;
+
+  struct Counter {
+    u64 instrs = 0;
+    u64 cycles = 0;
+  };
+
+  // Counts num executions of the instruction at adr, which took the given clock cycles in total.
+  // The bank only matters for addresses of the switchable ROM bank (0x4000-0x7FFF).
+  void Count(u16 bank, u16 adr, const OpcodeInfo& opcode, u64 cycles, u64 num = 1) {
+    Counter& counter = CounterAt(bank, adr);
+    counter.instrs += num;
+    counter.cycles += cycles;
+    Counter& opcode_counter = opcode_counters_[GetOpcodeIndex(opcode)];
+    opcode_counter.instrs += num;
+    opcode_counter.cycles += cycles;
+  }
+
+  // Adds clock cycles to an instruction without counting an execution (e.g., the time HALT sleeps).
+  void AddCycles(u16 bank, u16 adr, const OpcodeInfo& opcode, u64 cycles) { Count(bank, adr, opcode, cycles, 0); }
+
+  Counter GetCounter(u16 bank, u16 adr) const;
+  Counter GetOpcodeCounter(u16 opcode_ind) const { return opcode_counters_[opcode_ind]; }
+
+  // Writes the hot spots and the statistics of the opcodes, sorted by clock cycles.
+  void WriteReport(std::ostream& os, const SymbolTable& symbols, size_t max_hot_spots = 100) const;
+  // Writes the profile in callgrind format. Every label becomes a function.
+  void WriteCallgrind(std::ostream& os, const SymbolTable& symbols) const;
+  // Writes the report to path and the callgrind file to path + ".callgrind".
+  void WriteFiles(const std::filesystem::path& path, const SymbolTable& symbols) const;
+
+ private:
+  struct HotSpot {
+    u16 bank;
+    u16 adr;
+    Counter counter;
+  };
+
+  Counter& CounterAt(u16 bank, u16 adr) {
+    if (adr >= 0x8000)
+      return ram_counters_[adr - 0x8000];
+    const size_t ind = (adr < kBankSize) ? adr : bank * kBankSize + adr - kBankSize;
+    if (ind >= rom_counters_.size()) [[unlikely]]
+      rom_counters_.resize((ind / kBankSize + 1) * kBankSize);
+    return rom_counters_[ind];
+  }
+
+  // Calls func(bank, adr, counter) for all executed addresses in ascending order.
+  template <typename Func>
+  void ForEachCounter(Func func) const;
+
+  // Index: bank * kBankSize + adr % kBankSize. Grows with the highest bank that is used.
+  // Bank 0 holds 0x0000-0x3FFF.
+  std::vector<Counter> rom_counters_ = std::vector<Counter>(kBankSize);
+  std::array<Counter, 0x8000> ram_counters_{};  // 0x8000-0xFFFF
+  std::array<Counter, kOpcodeTable.size()> opcode_counters_{};
+};
@@ -3,123 +3,103 @@
  * Copyright (C) 2022 chiken
  * Apache License, Version 2.0
  *
- * Here reside the implementations of the registers and the register file.
+ * Here resides the register file.
  * Note: Doesn't work on a big endian machine (see below, compiler will warn you)!
  ******************************************************************************/
 
+#include <array>
 #include <bit>
-#include <compare>
 #include <cstdint>
-#include <string>
-#include <vector>
+#include <type_traits>
 
 #include "common.h"
 
-// Template implementation of a register.
-template <typename T>
-class Reg {
- public:
-  const string name;
-  Reg(string name, T& value) : name(name), value_(value) {}
-  Reg(const Reg&) = delete;
-  Reg& operator=(Reg& other) {
-    value_ = other.value_;
-    return *this;
-  }
-
-  // In case you explicitly want to set/get the value.
-  T val() { return value_; }
-  void val(T val) { value_ = val; }
-
-  Reg& operator=(T value) {
-    value_ = value;
-    return *this;
-  }
-
-  operator T() const { return value_; }
+// Compile-time IDs of the registers. Instruction handlers are specialized with these.
+// The values of the 8-bit IDs are the offsets into the register file's data (see RegFile::GetDataPtr()).
+enum class Reg8 : u8 { kF = 0, kA = 1, kC = 2, kB = 3, kE = 4, kD = 5, kL = 6, kH = 7 };
+enum class Reg16 : u8 { kAF = 0, kBC = 1, kDE = 2, kHL = 3, kSP = 4, kPC = 5 };
 
-  auto operator<=>(const Reg& r) const { return value_ <=> r.value_; }
-
-  Reg& operator++() {
-    value_++;
-    return *this;
-  }
-
-  Reg& operator--() {
-    value_--;
-    return *this;
-  }
-
-  Reg& operator+=(const T& r) {
-    value_ += r;
-    return *this;
-  }
-
-  Reg& operator-=(const T& r) {
-    value_ -= r;
-    return *this;
-  }
-
-  Reg& operator^=(const T& r) {
-    value_ ^= r;
-    return *this;
-  }
-
-  Reg& operator&=(const T& r) {
-    value_ &= r;
-    return *this;
-  }
-
-  Reg& operator|=(const T& r) {
-    value_ |= r;
-    return *this;
-  }
-
-  Reg& operator<<=(const T& r) {
-    value_ <<= r;
-    return *this;
-  }
-
- private:
-  T& value_;
-};
+// Names of the 16-bit registers. Only needed for the single step output and GDB.
+constexpr std::array<const char*, 6> kReg16Names{"AF", "BC", "DE", "HL", "SP", "PC"};
 
 // Register file of the Game Boy.
 // 8-bit registers: A, F, B, C, D, E, H, L
 // 8-bit helper registers: SPmsb, SPlsb, PCmsb, PClsb
 // 16-bit registers: AF, BC, DE, HL, SP, PC
-// Note that registers might use a shared memory.
+// Each 16-bit register shares its memory with two 8-bit registers (e.g., HL with H and L).
+// The register file is a plain struct, so it can be copied as a whole.
 class RegFile {
   static_assert(std::endian::native == std::endian::little, "RegFile is not big endian compatible!");
 
  public:
-  Reg<u8> A, F, B, C, D, E, H, L, SPmsb, SPlsb, PCmsb, PClsb;
-  Reg<u16> AF, BC, DE, HL, SP, PC;
-  RegFile()
-      : A("A", _dat[1]),
-        F("F", _dat[0]),
-        B("B", _dat[3]),
-        C("C", _dat[2]),
-        D("D", _dat[5]),
-        E("E", _dat[4]),
-        H("H", _dat[7]),
-        L("L", _dat[6]),
-        SPmsb("SPmsb", _dat[9]),
-        SPlsb("SPlsb", _dat[8]),
-        PCmsb("PCmsb", _dat[11]),
-        PClsb("PClsb", _dat[10]),
-        AF("AF", reinterpret_cast<u16&>(_dat[0])),
-        BC("BC", reinterpret_cast<u16&>(_dat[2])),
-        DE("DE", reinterpret_cast<u16&>(_dat[4])),
-        HL("HL", reinterpret_cast<u16&>(_dat[6])),
-        SP("SP", reinterpret_cast<u16&>(_dat[8])),
-        PC("PC", reinterpret_cast<u16&>(_dat[10])) {}
+  union {
+    struct {
+      u8 F, A;
+    };
+    u16 AF;
+  };
+  union {
+    struct {
+      u8 C, B;
+    };
+    u16 BC;
+  };
+  union {
+    struct {
+      u8 E, D;
+    };
+    u16 DE;
+  };
+  union {
+    struct {
+      u8 L, H;
+    };
+    u16 HL;
+  };
+  union {
+    struct {
+      u8 SPlsb, SPmsb;
+    };
+    u16 SP;
+  };
+  union {
+    struct {
+      u8 PClsb, PCmsb;
+    };
+    u16 PC;
+  };
+
+  template <Reg8 kReg>
+  u8& Get() {
+    if constexpr (kReg == Reg8::kF) return F;
+    else if constexpr (kReg == Reg8::kA) return A;
+    else if constexpr (kReg == Reg8::kC) return C;
+    else if constexpr (kReg == Reg8::kB) return B;
+    else if constexpr (kReg == Reg8::kE) return E;
+    else if constexpr (kReg == Reg8::kD) return D;
+    else if constexpr (kReg == Reg8::kL) return L;
+    else return H;
+  }
 
-  // For the pupose of range-based for-loops á la "for (auto reg : reg_file)".
-  std::vector<Reg<u16>*>::iterator begin() { return reg_vec_.begin(); }
-  std::vector<Reg<u16>*>::iterator end() { return reg_vec_.end(); }
+  template <Reg16 kReg>
+  u16& Get() {
+    if constexpr (kReg == Reg16::kAF) return AF;
+    else if constexpr (kReg == Reg16::kBC) return BC;
+    else if constexpr (kReg == Reg16::kDE) return DE;
+    else if constexpr (kReg == Reg16::kHL) return HL;
+    else if constexpr (kReg == Reg16::kSP) return SP;
+    else return PC;
+  }
 
- private:
-  u8 _dat[12]{0};                                                 // Shared data of the registers.
-  std::vector<Reg<u16>*> reg_vec_{&AF, &BC, &DE, &HL, &SP, &PC};  // See begin() and end().
+  // Access of a 16-bit register whose ID is only known at run time.
+  u16& Get(Reg16 reg) {
+    u16* const regs[] = {&AF, &BC, &DE, &HL, &SP, &PC};
+    return *regs[static_cast<u8>(reg)];
+  }
+
+  // Raw data of the registers. Used by the JIT.
+  u8* GetDataPtr() { return &F; }
 };
+
+static_assert(std::is_trivially_copyable_v<RegFile>);
+static_assert(sizeof(RegFile) == 12);
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "rtc.h"
+
+namespace {
+constexpr u64 kNsPerSecond = 1'000'000'000;
+constexpr u64 kSecondsPerDay = 24 * 60 * 60;
+constexpr u16 kNumDays = 512;
+constexpr std::array<u8, Rtc::kNumRegs> kRegMasks = {0x3F, 0x3F, 0x1F, 0xFF, 0xC1};
+
+u64 GetLittleEndian(std::span<const u8> bytes) {
+  u64 val = 0;
+  for (size_t i = 0; i < bytes.size(); ++i)
+    val |= static_cast<u64>(bytes[i]) << (8 * i);
+  return val;
+}
+
+void SetLittleEndian(std::span<u8> bytes, u64 val) {
+  for (size_t i = 0; i < bytes.size(); ++i)
+    bytes[i] = static_cast<u8>(val >> (8 * i));
+}
+}  // namespace
+
+void Rtc::Latch(u64 now_ns) {
+  Update(now_ns);
+  for (uint reg = 0; reg < kNumRegs; ++reg)
+    latched_[reg] = GetReg(reg);
+}
+
+u8 Rtc::Read(uint reg) const {
+  return reg < kNumRegs ? latched_[reg] : 0;
+}
+
+void Rtc::Write(uint reg, u8 val, u64 now_ns) {
+  if (reg >= kNumRegs)
+    return;
+  Update(now_ns);
+  val &= kRegMasks[reg];
+  switch (reg) {
+  case kSeconds:
+    seconds_ = val;
+    sub_second_ns_ = 0;
+    break;
+  case kMinutes:
+    minutes_ = val;
+    break;
+  case kHours:
+    hours_ = val;
+    break;
+  case kDaysLow:
+    days_ = (days_ & 0x100) | val;
+    break;
+  case kDaysHigh:
+    days_ = (days_ & 0xFF) | ((val & 1) << 8);
+    halted_ = val & 0x40;
+    carry_ = val & 0x80;
+    break;
+  }
+  latched_[reg] = val;
+}
+
+// The registers may hold invalid values (e.g., 63 seconds). They overflow at their bit width without carry.
+// Hence, the clock ticks by single seconds until all registers are valid. Afterwards, it can jump.
+void Rtc::Update(u64 now_ns) {
+  const u64 passed_ns = (now_ns > last_ns_) ? now_ns - last_ns_ : 0;  // The host's clock might go back.
+  last_ns_ = now_ns;
+  if (halted_)
+    return;
+  sub_second_ns_ += passed_ns;
+  u64 secs = sub_second_ns_ / kNsPerSecond;
+  sub_second_ns_ %= kNsPerSecond;
+
+  for (; secs > 0 && (seconds_ >= 60 || minutes_ >= 60 || hours_ >= 24); --secs)
+    TickSecond();
+  if (secs == 0)
+    return;
+
+  const u64 time_of_day = seconds_ + 60 * minutes_ + 60 * 60 * hours_ + secs;
+  u64 days = days_ + time_of_day / kSecondsPerDay;
+  if (days >= kNumDays) {
+    carry_ = true;
+    days %= kNumDays;
+  }
+  days_ = static_cast<u16>(days);
+  seconds_ = time_of_day % 60;
+  minutes_ = (time_of_day / 60) % 60;
+  hours_ = (time_of_day / (60 * 60)) % 24;
+}
+
+void Rtc::TickSecond() {
+  seconds_ = (seconds_ + 1) & kRegMasks[kSeconds];
+  if (seconds_ != 60)
+    return;
+  seconds_ = 0;
+  minutes_ = (minutes_ + 1) & kRegMasks[kMinutes];
+  if (minutes_ != 60)
+    return;
+  minutes_ = 0;
+  hours_ = (hours_ + 1) & kRegMasks[kHours];
+  if (hours_ != 24)
+    return;
+  hours_ = 0;
+  if (++days_ == kNumDays) {
+    days_ = 0;
+    carry_ = true;
+  }
+}
+
+u8 Rtc::GetReg(uint reg) const {
+  switch (reg) {
+  case kSeconds:
+    return seconds_;
+  case kMinutes:
+    return minutes_;
+  case kHours:
+    return hours_;
+  case kDaysLow:
+    return static_cast<u8>(days_);
+  case kDaysHigh:
+    return static_cast<u8>((days_ >> 8) | (halted_ << 6) | (carry_ << 7));
+  default:
+    return 0;
+  }
+}
+
+void Rtc::SaveState(std::span<u8, kStateSize> state, u64 now_ns, i64 unix_time) {
+  Update(now_ns);
+  for (uint reg = 0; reg < kNumRegs; ++reg) {
+    SetLittleEndian(state.subspan(4 * reg, 4), GetReg(reg));
+    SetLittleEndian(state.subspan(4 * (kNumRegs + reg), 4), latched_[reg]);
+  }
+  SetLittleEndian(state.subspan(40, 8), unix_time);
+}
+
+void Rtc::LoadState(std::span<const u8, kStateSize> state, u64 last_ns) {
+  std::array<u8, kNumRegs> live;
+  for (uint reg = 0; reg < kNumRegs; ++reg)
+    live[reg] = static_cast<u8>(GetLittleEndian(state.subspan(4 * reg, 4))) & kRegMasks[reg];
+  seconds_ = live[kSeconds];
+  minutes_ = live[kMinutes];
+  hours_ = live[kHours];
+  days_ = live[kDaysLow] | ((live[kDaysHigh] & 1) << 8);
+  halted_ = live[kDaysHigh] & 0x40;
+  carry_ = live[kDaysHigh] & 0x80;
+  for (uint reg = 0; reg < kNumRegs; ++reg)
+    latched_[reg] = static_cast<u8>(GetLittleEndian(state.subspan(4 * (kNumRegs + reg), 4))) & kRegMasks[reg];
+  last_ns_ = last_ns;
+  sub_second_ns_ = 0;
+}
+
+i64 Rtc::GetUnixTime(std::span<const u8, kStateSize> state) {
+  return static_cast<i64>(GetLittleEndian(state.subspan(40, 8)));
+}
@@ -0,0 +1,61 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * The real-time clock of the MBC3. The clock counts seconds, minutes, hours,
+ * and 9 bits of days. DH (days high) holds day bit 8 in bit 0, the halt flag
+ * in bit 6, and the sticky day carry in bit 7.
+ * The game reads a copy of the registers that is latched by writing 0 and
+ * then 1 to 0x6000-0x7FFF. The clock isn't ticked in the background: it
+ * catches up with the time base when it's latched or written.
+ * The time base is either the simulation time, which keeps the clock in sync
+ * with the emulated speed and makes replays deterministic, or the host's clock.
+ * See: https://gbdev.io/pandocs/MBC3.html
+ ******************************************************************************/
+
+#include <array>
+#include <span>
+
+#include "common.h"
+
+enum class RtcSource { kEmulated, kHost };
+
+class Rtc {
+ public:
+  enum Reg : uint { kSeconds, kMinutes, kHours, kDaysLow, kDaysHigh, kNumRegs };
+
+  // Live and latched registers as u32 and the unix time of the save (u64), all little endian.
+  // That's the format of most emulators, so save files can be exchanged.
+  constexpr static size_t kStateSize = 48;
+
+  explicit Rtc(u64 now_ns = 0) : last_ns_(now_ns) {}
+
+  void Latch(u64 now_ns);
+  // Returns the latched register.
+  u8 Read(uint reg) const;
+  // Writes the live and the latched register. Writing the seconds resets the sub-second counter.
+  void Write(uint reg, u8 val, u64 now_ns);
+
+  void SaveState(std::span<u8, kStateSize> state, u64 now_ns, i64 unix_time);
+  // last_ns is the point of the time base at which the clock had the saved state.
+  void LoadState(std::span<const u8, kStateSize> state, u64 last_ns);
+  // Returns the unix time of the save. A state that has never been saved returns 0.
+  static i64 GetUnixTime(std::span<const u8, kStateSize> state);
+
+ private:
+  // Advances the live registers by the time passed since the last call.
+  void Update(u64 now_ns);
+  void TickSecond();
+  u8 GetReg(uint reg) const;
+
+  u8 seconds_ = 0;
+  u8 minutes_ = 0;
+  u8 hours_ = 0;
+  u16 days_ = 0;
+  bool halted_ = false;
+  bool carry_ = false;
+  std::array<u8, kNumRegs> latched_{};
+  u64 last_ns_;
+  u64 sub_second_ns_ = 0;
+};
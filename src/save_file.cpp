@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "save_file.h"
+
+#include <algorithm>
+
+SaveFile::SaveFile(const std::filesystem::path& path, size_t size, std::chrono::milliseconds flush_interval)
+    : file_(path, size, true),
+      flush_interval_(flush_interval),
+      num_pages_((size + MappedFile::GetPageSize() - 1) / MappedFile::GetPageSize()),
+      dirty_(std::make_unique<std::atomic<bool>[]>(num_pages_)) {
+  thread_ = std::thread(&SaveFile::FlushLoop, this);
+}
+
+SaveFile::~SaveFile() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+  SyncDirtyPages(false);
+}
+
+void SaveFile::MarkDirty(size_t offset, size_t size) {
+  const size_t page_size = MappedFile::GetPageSize();
+  for (size_t page = offset / page_size; page < std::min((offset + size + page_size - 1) / page_size, num_pages_);
+       ++page)
+    dirty_[page].store(true, std::memory_order_relaxed);
+}
+
+void SaveFile::BeginDirectAccess(size_t offset, size_t size) {
+  const size_t page_size = MappedFile::GetPageSize();
+  direct_begin_.store(offset / page_size, std::memory_order_relaxed);
+  direct_end_.store(std::min((offset + size + page_size - 1) / page_size, num_pages_), std::memory_order_relaxed);
+}
+
+// The pages of the grant may have been written after the last flush.
+void SaveFile::EndDirectAccess() {
+  const size_t begin = direct_begin_.exchange(0, std::memory_order_relaxed);
+  const size_t end = direct_end_.exchange(0, std::memory_order_relaxed);
+  for (size_t page = begin; page < end; ++page)
+    dirty_[page].store(true, std::memory_order_relaxed);
+}
+
+void SaveFile::RequestFlush() {
+  {
+    std::lock_guard lock(mutex_);
+    flush_requested_ = true;
+  }
+  cond_.notify_all();
+}
+
+void SaveFile::Flush() {
+  SyncDirtyPages(true);
+}
+
+// The dirty flag is cleared before the sync, so writes during the sync are caught by the next one.
+void SaveFile::SyncDirtyPages(bool wait) {
+  std::lock_guard lock(sync_mutex_);
+  const size_t page_size = MappedFile::GetPageSize();
+  const size_t direct_begin = direct_begin_.load(std::memory_order_relaxed);
+  const size_t direct_end = direct_end_.load(std::memory_order_relaxed);
+  for (size_t page = 0; page < num_pages_; ++page) {
+    const bool direct = direct_begin <= page && page < direct_end;
+    if (dirty_[page].exchange(false, std::memory_order_relaxed) || direct) {
+      file_.Sync(page * page_size, page_size, wait);
+      num_synced_pages_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void SaveFile::FlushLoop() {
+  std::unique_lock lock(mutex_);
+  while (!stop_) {
+    cond_.wait_for(lock, flush_interval_, [this] { return flush_requested_ || stop_; });
+    if (stop_)
+      return;
+    flush_requested_ = false;
+    lock.unlock();
+    SyncDirtyPages(true);
+    lock.lock();
+  }
+}
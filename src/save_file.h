@@ -0,0 +1,69 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * The SaveFile is the battery-backed cartridge RAM. The RAM lives in a shared
+ * mapping of the .save file, so a crash loses nothing that reached the page
+ * cache. A background thread writes the dirty pages back to the disk every
+ * flush interval and whenever a flush is requested, e.g. when the game
+ * disables the RAM after saving.
+ * Writes via the transport functions mark their pages as dirty. Initiators
+ * with a DMI pointer write without notice, so the range of such a grant is
+ * synced on every flush until the grant is revoked. Syncing clean pages
+ * costs nothing since the kernel only writes back modified ones.
+ * The destructor only schedules the write-back of the dirty pages.
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "common.h"
+#include "mapped_file.h"
+
+class SaveFile {
+ public:
+  // Throws a std::runtime_error if the file can't be mapped.
+  SaveFile(const std::filesystem::path& path, size_t size, std::chrono::milliseconds flush_interval);
+  ~SaveFile();
+  SaveFile(SaveFile const&) = delete;
+  void operator=(SaveFile const&) = delete;
+
+  u8* GetData() { return file_.GetData(); }
+  size_t GetSize() const { return file_.GetSize(); }
+
+  void MarkDirty(size_t offset, size_t size);
+  // [offset, offset + size) may be written via DMI until EndDirectAccess().
+  void BeginDirectAccess(size_t offset, size_t size);
+  void EndDirectAccess();
+  // Wakes up the flush thread.
+  void RequestFlush();
+  // Writes the dirty pages back and waits until they're on the disk.
+  void Flush();
+  // Number of pages that have been written back so far.
+  u64 GetNumSyncedPages() const { return num_synced_pages_.load(std::memory_order_relaxed); }
+
+ private:
+  void SyncDirtyPages(bool wait);
+  void FlushLoop();
+
+  MappedFile file_;
+  std::chrono::milliseconds flush_interval_;
+  size_t num_pages_;
+  std::unique_ptr<std::atomic<bool>[]> dirty_;
+  std::atomic<size_t> direct_begin_ = 0;  // First page of the DMI grant.
+  std::atomic<size_t> direct_end_ = 0;    // Page behind the DMI grant.
+  std::atomic<u64> num_synced_pages_ = 0;
+
+  std::mutex sync_mutex_;  // Serializes the write-backs.
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool flush_requested_ = false;
+  bool stop_ = false;
+  std::thread thread_;
+};
@@ -13,7 +13,7 @@ Serial::Serial(sc_module_name name, u8* reg_if) : sc_module(name), reg_if(reg_if
 }
 
 void Serial::SerialInterrupt() {
-  *reg_if |= gb_const::kSerialIOIf;
+  RequestInterrupt(reg_if, gb_const::kSerialIOIf, intr_event);
   reg_sc &= ~kMaskTransferStart;
   ongoing_transmission = false;
 }
@@ -31,6 +31,7 @@ struct Serial : public sc_module {
 
   // SystemC interfaces
   sc_event interrupt_event;
+  sc_event* intr_event = nullptr;  // Notified on a serial interrupt.
   tlm_utils::simple_target_socket<Serial, gb_const::kBusDataWidth> targ_socket;
   uint transport_dbg(tlm::tlm_generic_payload& trans);
   void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "symbol_table.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+// Lines look like "01:4abc Label". Everything after a ';' is a comment.
+void SymbolTable::Load(std::istream& is) {
+  string line;
+  while (std::getline(is, line)) {
+    line = line.substr(0, line.find(';'));
+    std::istringstream ss(line);
+    string location, name;
+    if (!(ss >> location >> name) || location.size() != 7 || location[2] != ':' || name[0] == '.')
+      continue;
+    try {
+      const u16 bank = static_cast<u16>(std::stoul(location.substr(0, 2), nullptr, 16));
+      const u16 adr = static_cast<u16>(std::stoul(location.substr(3, 4), nullptr, 16));
+      symbols_[MakeKey(bank, adr)] = name;
+    } catch (const std::logic_error&) {
+      continue;  // Not a label.
+    }
+  }
+}
+
+bool SymbolTable::LoadFile(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << std::format("Warning: Could not read symbol file '{}'!\n", path.string());
+    return false;
+  }
+  Load(file);
+  return true;
+}
+
+const std::pair<const u32, string>* SymbolTable::Find(u16 bank, u16 adr) const {
+  const u32 key = MakeKey(bank, adr);
+  auto it = symbols_.upper_bound(key);
+  if (it == symbols_.begin())
+    return nullptr;
+  --it;
+  // The label has to be in the same memory region.
+  const u16 sym_bank = it->first >> 16;
+  const u16 sym_adr = it->first & 0xFFFF;
+  const auto get_region = [](u16 a) { return std::min<size_t>(a / kBankSize, 2); };  // ROM0, ROMX, or RAM.
+  if (sym_bank != (key >> 16) || get_region(sym_adr) != get_region(adr))
+    return nullptr;
+  return &*it;
+}
+
+string SymbolTable::GetName(u16 bank, u16 adr) const {
+  const auto* symbol = Find(bank, adr);
+  if (symbol == nullptr)
+    return "";
+  const u16 offset = adr - (symbol->first & 0xFFFF);
+  return (offset == 0) ? symbol->second : std::format("{}+0x{:x}", symbol->second, offset);
+}
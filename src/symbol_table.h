@@ -0,0 +1,41 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * The labels of an rgbds symbol file. Used by the profilers to name addresses.
+ * Like in the SymfileTracer, addresses of the switchable ROM bank are kept apart
+ * by their bank. See: https://rgbds.gbdev.io/sym/
+ ******************************************************************************/
+
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <utility>
+
+#include "common.h"
+
+class SymbolTable {
+ public:
+  constexpr static size_t kBankSize = 0x4000;
+
+  // Reads the labels of an rgbds symbol file.
+  void Load(std::istream& is);
+  // Same as above but from a file. Prints a warning and returns false if the file can't be read.
+  bool LoadFile(const std::filesystem::path& path);
+
+  // Returns the address and name of the closest label at or before the given address or nullptr.
+  // The address is the lower 16 bits of the key.
+  const std::pair<const u32, string>* Find(u16 bank, u16 adr) const;
+  // Returns the closest label at or before the given address, e.g., "Main.loop+0x3".
+  // Returns an empty string if there's no label.
+  string GetName(u16 bank, u16 adr) const;
+
+  // Addresses outside the switchable ROM bank always have bank 0.
+  static u32 MakeKey(u16 bank, u16 adr) {
+    return ((kBankSize <= adr && adr < 2 * kBankSize) ? static_cast<u32>(bank) << 16 : 0) | adr;
+  }
+
+ private:
+  std::map<u32, string> symbols_;  // Key: see MakeKey().
+};
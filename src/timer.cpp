@@ -32,7 +32,7 @@ void Timer::TimerLoop() {
       u8 old_val = reg_tima_++;
       if (old_val > reg_tima_) {  // Overflow case.
         reg_tima_ = reg_tma_;
-        *reg_if_ |= gb_const::kTimerOfIf;
+        RequestInterrupt(reg_if_, gb_const::kTimerOfIf, intr_event);
       }
     }
   }
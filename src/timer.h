@@ -41,6 +41,7 @@ struct Timer : public sc_module {
 
   // SystemC interfaces
   tlm_utils::simple_target_socket<Timer, gb_const::kBusDataWidth> targ_socket;
+  sc_event* intr_event = nullptr;  // Notified on a timer interrupt.
   void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
   uint transport_dbg(tlm::tlm_generic_payload& trans);
 
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ ******************************************************************************/
+
+#include "trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "reg_file.h"
+
+namespace {
+constexpr std::array<char, 8> kMagic = {'T', 'L', 'M', 'B', 'T', 'R', 'C', 1};
+constexpr u8 kFlagWrites = 0x40;
+constexpr size_t kMaxVarintSize = 10;
+constexpr size_t kMaxRecordHeaderSize = 1 + 2 * kMaxVarintSize + 6 * sizeof(u16);
+constexpr u64 kMaxWrites = 0x10000;  // Per record. Protects against huge allocations for broken traces.
+
+size_t PutVarint(u8* out, u64 value) {
+  size_t len = 0;
+  while (value >= 0x80) {
+    out[len++] = static_cast<u8>(value) | 0x80;
+    value >>= 7;
+  }
+  out[len++] = static_cast<u8>(value);
+  return len;
+}
+}  // namespace
+
+string TraceRecord::ToString() const {
+  string str;
+  for (size_t i = 0; i < regs.size(); ++i)
+    str += std::format("{}:0x{:04x},", kReg16Names[i], regs[i]);
+  str += std::format("c:{}", cycles);
+  for (const TraceWrite& write : writes)
+    str += std::format(" [{:04x}]=0x{:02x}", write.adr, write.data);
+  return str;
+}
+
+TraceWriter::TraceWriter(const std::filesystem::path& path) : file_(path, std::ios::binary) {
+  if (!file_)
+    throw std::runtime_error(std::format("Cannot open trace file '{}'", path.string()));
+  file_.write(kMagic.data(), kMagic.size());
+  buffer_.reserve(kBufferSize + kMaxRecordHeaderSize);
+  full_buffer_.reserve(kBufferSize + kMaxRecordHeaderSize);
+  thread_ = std::thread(&TraceWriter::WriteLoop, this);
+}
+
+TraceWriter::~TraceWriter() {
+  Close();
+}
+
+void TraceWriter::Record(u64 cycles, const std::array<u16, 6>& regs) {
+  if (has_pending_)
+    Encode(pending_);
+  pending_.cycles = cycles;
+  pending_.regs = regs;
+  pending_.writes.clear();
+  has_pending_ = true;
+}
+
+void TraceWriter::Encode(const TraceRecord& record) {
+  u8 header[kMaxRecordHeaderSize];
+  size_t len = 1;
+  u8 flags = 0;
+  len += PutVarint(header + len, record.cycles - last_.cycles);
+  for (size_t i = 0; i < record.regs.size(); ++i) {
+    if (record.regs[i] != last_.regs[i]) {
+      flags |= 1 << i;
+      header[len++] = static_cast<u8>(record.regs[i]);
+      header[len++] = static_cast<u8>(record.regs[i] >> 8);
+    }
+  }
+  if (!record.writes.empty()) {
+    flags |= kFlagWrites;
+    len += PutVarint(header + len, record.writes.size());
+  }
+  header[0] = flags;
+  buffer_.insert(buffer_.end(), header, header + len);
+  for (const TraceWrite& write : record.writes) {
+    buffer_.push_back(static_cast<u8>(write.adr));
+    buffer_.push_back(static_cast<u8>(write.adr >> 8));
+    buffer_.push_back(write.data);
+  }
+
+  last_.cycles = record.cycles;
+  last_.regs = record.regs;
+  ++num_records_;
+  if (buffer_.size() >= kBufferSize)
+    Flush();
+}
+
+void TraceWriter::Flush() {
+  std::unique_lock lock(mutex_);
+  cond_.wait(lock, [this] { return full_buffer_.empty(); });
+  std::swap(buffer_, full_buffer_);
+  lock.unlock();
+  cond_.notify_all();
+}
+
+void TraceWriter::WriteLoop() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    cond_.wait(lock, [this] { return !full_buffer_.empty() || stop_; });
+    if (full_buffer_.empty())
+      return;  // Stopped and everything is written.
+    lock.unlock();
+    file_.write(reinterpret_cast<const char*>(full_buffer_.data()), full_buffer_.size());
+    lock.lock();
+    full_buffer_.clear();
+    cond_.notify_all();
+  }
+}
+
+void TraceWriter::Close() {
+  if (closed_)
+    return;
+  closed_ = true;
+  if (has_pending_)
+    Encode(pending_);
+  has_pending_ = false;
+  Flush();
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+  file_.close();
+}
+
+TraceReader::TraceReader(const std::filesystem::path& path) : file_(path, std::ios::binary), buffer_(kBufferSize) {
+  if (!file_)
+    throw std::runtime_error(std::format("Cannot open trace file '{}'", path.string()));
+  if (!Fill(kMagic.size()) || !std::equal(kMagic.begin(), kMagic.end(), buffer_.begin()))
+    throw std::runtime_error(std::format("'{}' is no TLMBoy trace", path.string()));
+  pos_ += kMagic.size();
+}
+
+bool TraceReader::Fill(size_t num) {
+  if (end_ - pos_ >= num)
+    return true;
+  std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+  bytes_consumed_ += pos_;
+  end_ -= pos_;
+  pos_ = 0;
+  if (buffer_.size() < num)
+    buffer_.resize(num);
+  file_.read(reinterpret_cast<char*>(buffer_.data() + end_), buffer_.size() - end_);
+  end_ += file_.gcount();
+  return end_ >= num;
+}
+
+u64 TraceReader::ReadVarint() {
+  u64 value = 0;
+  for (size_t i = 0; i < kMaxVarintSize; ++i) {
+    const u8 byte = buffer_[pos_++];
+    value |= static_cast<u64>(byte & 0x7F) << (7 * i);
+    if (!(byte & 0x80))
+      return value;
+  }
+  throw std::runtime_error("Invalid varint in trace");
+}
+
+// Near the end of the file, the header may be decoded from stale bytes behind end_.
+// This is safe since the buffer is always larger than a header. The check afterwards catches it.
+bool TraceReader::Next() {
+  Fill(kMaxRecordHeaderSize);
+  if (pos_ == end_)
+    return false;
+
+  const u8 flags = buffer_[pos_++];
+  if (flags & 0x80)
+    throw std::runtime_error(std::format("Invalid record {} in trace", num_records_));
+  record_.cycles += ReadVarint();
+  for (size_t i = 0; i < record_.regs.size(); ++i) {
+    if (flags & (1 << i)) {
+      record_.regs[i] = static_cast<u16>(buffer_[pos_] | buffer_[pos_ + 1] << 8);
+      pos_ += 2;
+    }
+  }
+  record_.writes.clear();
+  if (flags & kFlagWrites) {
+    const u64 num_writes = ReadVarint();
+    if (num_writes > kMaxWrites)
+      throw std::runtime_error(std::format("Invalid record {} in trace", num_records_));
+    if (pos_ > end_ || !Fill(3 * num_writes))
+      throw std::runtime_error(std::format("Trace is truncated at record {}", num_records_));
+    for (u64 i = 0; i < num_writes; ++i) {
+      record_.writes.push_back({static_cast<u16>(buffer_[pos_] | buffer_[pos_ + 1] << 8), buffer_[pos_ + 2]});
+      pos_ += 3;
+    }
+  }
+  if (pos_ > end_)
+    throw std::runtime_error(std::format("Trace is truncated at record {}", num_records_));
+  ++num_records_;
+  return true;
+}
+
+std::optional<u64> DiffTraces(TraceReader& trace_a, TraceReader& trace_b, std::ostream& os, size_t context) {
+  std::vector<TraceRecord> history(context);  // Ring buffer of the last records.
+  u64 ind = 0;
+  while (true) {
+    const bool has_a = trace_a.Next();
+    const bool has_b = trace_b.Next();
+    if (!has_a && !has_b) {
+      os << std::format("Traces are identical ({} instructions).\n", ind);
+      return std::nullopt;
+    }
+    if (has_a && has_b && trace_a.Get() == trace_b.Get()) {
+      if (context != 0)
+        history[ind % context] = trace_a.Get();
+      ++ind;
+      continue;
+    }
+
+    os << std::format("Traces diverge at instruction {}:\n", ind);
+    for (u64 i = ind - std::min<u64>(ind, context); i < ind; ++i)
+      os << std::format("  {:>12}  {}\n", i, history[i % context].ToString());
+    os << std::format("a {:>12}  {}\n", ind, has_a ? trace_a.Get().ToString() : "<end of trace>");
+    os << std::format("b {:>12}  {}\n", ind, has_b ? trace_b.Get().ToString() : "<end of trace>");
+    if (has_a && has_b) {
+      const TraceRecord& a = trace_a.Get();
+      const TraceRecord& b = trace_b.Get();
+      string diffs;
+      for (size_t i = 0; i < a.regs.size(); ++i) {
+        if (a.regs[i] != b.regs[i])
+          diffs += std::format(" {}", kReg16Names[i]);
+      }
+      if (a.cycles != b.cycles)
+        diffs += " cycles";
+      if (a.writes != b.writes)
+        diffs += " writes";
+      os << "Differences:" << diffs << "\n";
+    }
+    return ind;
+  }
+}
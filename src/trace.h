@@ -0,0 +1,121 @@
+#pragma once
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Binary execution traces. A trace holds one record per executed instruction:
+ * the register file before the instruction, the clock cycle count, and
+ * optionally the memory writes until the next record.
+ * Records are delta-encoded against the previous record:
+ *
+ *   u8      flags: bit i (0-5) = register i (AF, BC, DE, HL, SP, PC) changed,
+ *                  bit 6 = memory writes follow
+ *   varint  clock cycles since the previous record (LEB128)
+ *   u16     new value of each changed register (little endian)
+ *   varint  number of memory writes, then u16 address and u8 data per write
+ *
+ * A trace file starts with the magic "TLMBTRC" and a version byte.
+ * The TraceWriter hands full buffers to a background thread, so the simulation
+ * doesn't wait for the file system. The TraceReader streams a trace in big chunks.
+ ******************************************************************************/
+
+#include <array>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+
+struct TraceWrite {
+  u16 adr;
+  u8 data;
+
+  bool operator==(const TraceWrite&) const = default;
+};
+
+struct TraceRecord {
+  u64 cycles = 0;
+  std::array<u16, 6> regs{};  // AF, BC, DE, HL, SP, PC
+  std::vector<TraceWrite> writes;
+
+  bool operator==(const TraceRecord&) const = default;
+  // E.g., "AF:0x01b0,BC:0x0013,DE:0x00d8,HL:0x014d,SP:0xfffe,PC:0x0100,c:1234 [ff40]=0x91".
+  string ToString() const;
+};
+
+class TraceWriter {
+ public:
+  constexpr static size_t kBufferSize = 1 << 20;
+
+  // Throws a std::runtime_error if the file can't be opened.
+  explicit TraceWriter(const std::filesystem::path& path);
+  ~TraceWriter();
+
+  // Starts the record of the next instruction and completes the previous one.
+  void Record(u64 cycles, const std::array<u16, 6>& regs);
+  // Adds a memory write to the current record.
+  void RecordWrite(u16 adr, u8 data) { pending_.writes.push_back({adr, data}); }
+  // Completes the last record and waits until everything is written to the file.
+  void Close();
+
+  u64 GetNumRecords() const { return num_records_; }
+
+ private:
+  void Encode(const TraceRecord& record);
+  // Hands the buffer over to the writer thread. Waits if the thread is still busy with the last one.
+  void Flush();
+  void WriteLoop();
+
+  std::ofstream file_;
+  TraceRecord last_;     // The last encoded record.
+  TraceRecord pending_;  // The record of the current instruction.
+  bool has_pending_ = false;
+  bool closed_ = false;
+  u64 num_records_ = 0;
+
+  std::vector<u8> buffer_;       // Filled by the simulation.
+  std::vector<u8> full_buffer_;  // Written by the thread. Is empty if the thread is idle.
+  bool stop_ = false;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread thread_;
+};
+
+class TraceReader {
+ public:
+  constexpr static size_t kBufferSize = 4 << 20;
+
+  // Throws a std::runtime_error if the file can't be opened or is no trace.
+  explicit TraceReader(const std::filesystem::path& path);
+
+  // Decodes the next record. Returns false at the end of the trace.
+  // Throws a std::runtime_error if the trace is truncated.
+  bool Next();
+  const TraceRecord& Get() const { return record_; }
+  // Number of records that have been read so far.
+  u64 GetNumRecords() const { return num_records_; }
+  // Number of bytes that have been read so far.
+  u64 GetNumBytes() const { return bytes_consumed_ + pos_; }
+
+ private:
+  // Makes sure that num bytes are buffered. Returns false if the file has fewer bytes left.
+  bool Fill(size_t num);
+  u64 ReadVarint();
+
+  std::ifstream file_;
+  std::vector<u8> buffer_;
+  size_t pos_ = 0;
+  size_t end_ = 0;
+  u64 bytes_consumed_ = 0;  // Bytes before the current buffer.
+  u64 num_records_ = 0;
+  TraceRecord record_;
+};
+
+// Streams both traces and reports the first diverging record together with up to context preceding
+// records to os. Returns the index of the diverging record or std::nullopt if the traces are identical.
+std::optional<u64> DiffTraces(TraceReader& trace_a, TraceReader& trace_b, std::ostream& os, size_t context = 10);
@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * tlmboy_tracediff compares two binary execution traces (see trace.h), e.g., of
+ * two TLMBoy versions or CPU backends, and reports the first diverging
+ * instruction together with the instructions before it.
+ * Usage: tlmboy_tracediff [--context=N] <trace_a> <trace_b>
+ ******************************************************************************/
+
+#include <getopt.h>
+
+#include <chrono>
+#include <format>
+
+#include "trace.h"
+
+int sc_main(int argc, char* argv[]) {
+  const struct option long_opts[] = {{"context", required_argument, 0, 'c'},
+                                     {"help", no_argument, 0, 'h'},
+                                     {nullptr, 0, nullptr, 0}};
+  size_t context = 10;
+  int index;
+  int opt;
+  while ((opt = getopt_long(argc, argv, "c:h", long_opts, &index)) != -1) {
+    switch (opt) {
+    case 'c':
+      context = std::stoull(string(optarg));
+      break;
+    case 'h':
+    default:
+      std::cout << "Usage: tlmboy_tracediff [--context=N] <trace_a> <trace_b>" << std::endl
+                << "Reports the first diverging instruction and N instructions before it. Default N: 10." << std::endl;
+      return 2;
+    }
+  }
+  if (argc - optind != 2) {
+    std::cerr << "Expected two trace files!" << std::endl;
+    return 2;
+  }
+
+  try {
+    TraceReader trace_a(argv[optind]);
+    TraceReader trace_b(argv[optind + 1]);
+    const auto start = std::chrono::steady_clock::now();
+    const std::optional<u64> diff = DiffTraces(trace_a, trace_b, std::cout, context);
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    const double megabytes = (trace_a.GetNumBytes() + trace_b.GetNumBytes()) / 1e6;
+    std::cout << std::format("Read {:.1f} MB in {:.2f} s ({:.0f} MB/s).\n", megabytes, duration.count(),
+                             megabytes / std::max(duration.count(), 1e-9));
+    return diff.has_value() ? 1 : 0;
+  } catch (const std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+}
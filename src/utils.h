@@ -34,6 +34,51 @@ constexpr void SetBit(u8* dat, bool val, uint bit_index) noexcept {
   *dat = (*dat & ~(1 << bit_index)) | (val << bit_index);
 }
 
+// Sets the given bits of the interrupt flag register (0xFF0F).
+// The optional event is notified to wake up a halted CPU (see Cpu::intr_event).
+inline void RequestInterrupt(u8* reg_if, u8 mask, sc_event* intr_event) {
+  *reg_if |= mask;
+  if (intr_event != nullptr)
+    intr_event->notify(sc_core::SC_ZERO_TIME);
+}
+
 std::shared_ptr<tlm::tlm_generic_payload> MakeSharedPayloadPtr(tlm::tlm_command cmd, sc_dt::uint64 addr,
                                                                void* data = nullptr, bool dmi_allowed = false,
                                                                uint size = 1);
+
+// Invalidates DMI pointers to [start, end] via the backward path of a target socket.
+// Nothing happens as long as the socket isn't bound (e.g., in unit tests without elaboration).
+template <typename T>
+void InvalidateDirectMemPtr(T& targ_socket, sc_dt::uint64 start, sc_dt::uint64 end) {
+  if (targ_socket.get_base_port().size() > 0)
+    targ_socket->invalidate_direct_mem_ptr(start, end);
+}
+
+// Splits the burst trans into parts. part_size(adr) returns the maximum length of a part starting at adr.
+// func(trans) is called for each part with adjusted address, data pointer and length.
+// Stops at the first part with an error response. Returns the number of bytes of the successful parts.
+// Afterwards, trans is restored except for the response status.
+template <typename PartSize, typename Func>
+uint SplitBurst(tlm::tlm_generic_payload& trans, PartSize part_size, Func func) {
+  const sc_dt::uint64 adr = trans.get_address();
+  unsigned char* data = trans.get_data_ptr();
+  const uint length = trans.get_data_length();
+  uint done = 0;
+  while (done < length) {
+    const uint part = std::min<uint>(length - done, part_size(adr + done));
+    trans.set_address(adr + done);
+    trans.set_data_ptr(data + done);
+    trans.set_data_length(part);
+    trans.set_streaming_width(part);
+    trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+    func(trans);
+    if (trans.is_response_error())
+      break;
+    done += part;
+  }
+  trans.set_address(adr);
+  trans.set_data_ptr(data);
+  trans.set_data_length(length);
+  trans.set_streaming_width(length);
+  return done;
+}
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the decoding and invalidation of the CPU's block cache.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+
+#include "block_cache.h"
+
+struct BlockCacheTests : public ::testing::Test {
+  std::array<u8, 0x10000> memory{};
+  BlockCache cache;
+
+  const BlockCache::Block* Build(u16 adr, u16 bank = 0) {
+    return cache.Build(adr, bank, [this](u16 a) { return memory[a]; });
+  }
+};
+
+TEST_F(BlockCacheTests, EndsAtControlFlow) {
+  memory[0x100] = 0x00;  // NOP
+  memory[0x101] = 0x01;  // LD BC,0x4223
+  memory[0x102] = 0x23;
+  memory[0x103] = 0x42;
+  memory[0x104] = 0xCB;  // SWAP A
+  memory[0x105] = 0x37;
+  memory[0x106] = 0xC3;  // JP 0x0150
+  memory[0x107] = 0x50;
+  memory[0x108] = 0x01;
+  memory[0x109] = 0x3C;  // INC A
+
+  const BlockCache::Block* block = Build(0x100);
+  ASSERT_NE(block, nullptr);
+  ASSERT_EQ(block->start_adr, 0x100);
+  ASSERT_EQ(block->end_adr, 0x108);
+  ASSERT_EQ(block->instrs.size(), 4u);
+  ASSERT_EQ(block->instrs[1].adr, 0x101);
+  ASSERT_EQ(block->instrs[1].length, 3);
+  ASSERT_EQ(block->instrs[1].bytes[1], 0x23);
+  ASSERT_EQ(block->instrs[1].bytes[2], 0x42);
+  ASSERT_EQ(block->instrs[2].length, 2);
+  ASSERT_EQ(block->instrs[2].bytes[1], 0x37);
+  ASSERT_EQ(block->instrs[3].adr, 0x106);
+  // The instructions come with their handler and timing.
+  ASSERT_EQ(block->instrs[1].handler, 0x01);
+  ASSERT_EQ(block->instrs[1].info, &kOpcodes[0x01]);
+  ASSERT_EQ(block->instrs[2].handler, 0x137);
+  ASSERT_EQ(block->instrs[2].info->cycles, 8);
+  ASSERT_EQ(block->instrs[3].info->cycles_taken, 16);
+  ASSERT_EQ(cache.Find(0x100, 0), block);
+  ASSERT_EQ(cache.Find(0x101, 0), nullptr);
+}
+
+TEST_F(BlockCacheTests, EndsAtRegionBoundary) {
+  memory[0x3FFE] = 0x00;  // NOP
+  memory[0x3FFF] = 0x3E;  // LD A,u8 crossing into the switchable bank.
+
+  const BlockCache::Block* block = Build(0x3FFE);
+  ASSERT_NE(block, nullptr);
+  ASSERT_EQ(block->instrs.size(), 1u);
+  ASSERT_EQ(block->end_adr, 0x3FFE);
+  ASSERT_EQ(Build(0x3FFF), nullptr);
+  ASSERT_FALSE(BlockCache::IsCacheable(0x8000));
+  ASSERT_FALSE(BlockCache::IsCacheable(0xFF44));
+  ASSERT_TRUE(BlockCache::IsCacheable(0xFF80));
+}
+
+TEST_F(BlockCacheTests, KeyedByBank) {
+  memory[0x4000] = 0xC9;  // RET
+  const BlockCache::Block* block_bank1 = Build(0x4000, 1);
+  const BlockCache::Block* block_bank2 = Build(0x4000, 2);
+  ASSERT_NE(block_bank1, block_bank2);
+  ASSERT_EQ(cache.Find(0x4000, 1), block_bank1);
+  ASSERT_EQ(cache.Find(0x4000, 2), block_bank2);
+  ASSERT_EQ(cache.Find(0x4000, 3), nullptr);
+  ASSERT_EQ(cache.Size(), 2u);
+
+  // Writes can't change the ROM.
+  ASSERT_FALSE(cache.InvalidateWrite(0x4000));
+  ASSERT_TRUE(cache.Invalidate(0x4000, 0x7FFF));
+  ASSERT_EQ(cache.Size(), 0u);
+}
+
+TEST_F(BlockCacheTests, SelfModifyingCode) {
+  memory[0xC0FE] = 0x00;  // NOP, spanning two pages.
+  memory[0xC0FF] = 0x00;  // NOP
+  memory[0xC100] = 0x3C;  // INC A
+  memory[0xC101] = 0xC9;  // RET
+  memory[0xFF80] = 0xC9;  // RET
+  ASSERT_NE(Build(0xC0FE), nullptr);
+  ASSERT_NE(Build(0xFF80), nullptr);
+  ASSERT_EQ(cache.Size(), 2u);
+
+  ASSERT_FALSE(cache.InvalidateWrite(0xC102));  // Same page, but no code.
+  ASSERT_FALSE(cache.InvalidateWrite(0xC200));
+  ASSERT_FALSE(cache.InvalidateWrite(0xFF81));
+  ASSERT_EQ(cache.Size(), 2u);
+
+  ASSERT_TRUE(cache.InvalidateWrite(0xE100));  // Echo RAM.
+  ASSERT_EQ(cache.Find(0xC0FE, 0), nullptr);
+  ASSERT_FALSE(cache.InvalidateWrite(0xC0FE));
+
+  ASSERT_TRUE(cache.InvalidateWrite(0xFF80));
+  ASSERT_EQ(cache.Size(), 0u);
+}
+
+TEST_F(BlockCacheTests, DetectsIdleLoops) {
+  const u8 wait_for_ly[] = {
+      0xF0, 0x44,  // LDH A,(0x44), 12 cycles
+      0xFE, 0x90,  // CP A,0x90, 8 cycles
+      0x20, 0xFA,  // JR NZ,-6, 12 cycles
+  };
+  std::copy(std::begin(wait_for_ly), std::end(wait_for_ly), &memory[0x100]);
+  ASSERT_EQ(Build(0x100)->idle_loop_cycles, 32u);
+
+  const u8 wait_for_stat[] = {
+      0x21, 0x41, 0xFF,  // LD HL,0xFF41
+      0xCB, 0x4E,        // BIT 1,(HL), 12 cycles
+      0xC2, 0x03, 0x02,  // JP NZ,0x0203, 16 cycles
+  };
+  std::copy(std::begin(wait_for_stat), std::end(wait_for_stat), &memory[0x200]);
+  ASSERT_EQ(Build(0x200)->idle_loop_cycles, 0u);  // LD HL isn't part of the loop.
+  ASSERT_EQ(Build(0x203)->idle_loop_cycles, 28u);
+
+  const u8 delay_loop[] = {
+      0x05,        // DEC B
+      0x20, 0xFD,  // JR NZ,-3
+  };
+  std::copy(std::begin(delay_loop), std::end(delay_loop), &memory[0x300]);
+  ASSERT_EQ(Build(0x300)->idle_loop_cycles, 0u);  // B changes with every iteration.
+
+  const u8 store_loop[] = {
+      0xF0, 0x44,  // LDH A,(0x44)
+      0xE0, 0x80,  // LDH (0x80),A
+      0x18, 0xFA,  // JR -6
+  };
+  std::copy(std::begin(store_loop), std::end(store_loop), &memory[0x400]);
+  ASSERT_EQ(Build(0x400)->idle_loop_cycles, 0u);
+}
+
+int sc_main(int argc, char* argv[]) {
+  sc_set_time_resolution(1.0, SC_NS);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
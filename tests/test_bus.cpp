@@ -5,8 +5,8 @@
  *
  * Collection of unit test which test the functionality of the bus and
  * the payload factory.
- * The system comprises a "BusMaster" which is connected to two "BusSlaves"
- * (slave0: 0x0000-0x0FFF, slave1: 0x1000-0x1FFF) via a "Bus".
+ * The system comprises a "BusMaster" which is connected to three "BusSlaves"
+ * (slave0: 0x0000-0x0FFF, slave1: 0x1000-0x1FFF, slave2: 0x2000-0x207F) via a "Bus".
  ******************************************************************************/
 
 #include <gtest/gtest.h>
@@ -15,8 +15,12 @@
 #include <tlm_utils/simple_initiator_socket.h>
 #include <tlm_utils/simple_target_socket.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "bus.h"
 #include "gb_const.h"
@@ -26,7 +30,14 @@ struct BusMaster : public sc_module {
   SC_HAS_PROCESS(BusMaster);
   tlm_utils::simple_initiator_socket<BusMaster, gb_const::kBusDataWidth> init_socket;
 
-  explicit BusMaster(sc_module_name name) : sc_module(name), init_socket("init_socket") { SC_THREAD(BusMasterThread); }
+  std::vector<std::pair<sc_dt::uint64, sc_dt::uint64>> invalidations;
+
+  explicit BusMaster(sc_module_name name) : sc_module(name), init_socket("init_socket") {
+    SC_THREAD(BusMasterThread);
+    init_socket.register_invalidate_direct_mem_ptr(this, &BusMaster::invalidate_direct_mem_ptr);
+  }
+
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end) { invalidations.emplace_back(start, end); }
 
   void BusMasterThread() {
     int data = 1337;
@@ -78,6 +89,18 @@ struct BusMaster : public sc_module {
       data_ptr[i] = 23;
     }
 
+    // slave2 only covers the lower half of page 0x20.
+    payload->set_address(0x2080);
+    ASSERT_FALSE(init_socket->get_direct_mem_ptr(*payload, dmi_data));
+    payload->set_address(0x207F);
+    ASSERT_TRUE(init_socket->get_direct_mem_ptr(*payload, dmi_data));
+    ASSERT_EQ(dmi_data.get_start_address(), static_cast<sc_dt::uint64>(0));
+    ASSERT_EQ(dmi_data.get_end_address(), static_cast<sc_dt::uint64>(0x7F));  // Clamped to the bus range.
+    data_ptr = reinterpret_cast<u8*>(dmi_data.get_dmi_ptr());
+    for (int i = 0; i < 0x80; ++i) {
+      data_ptr[i] = 23;
+    }
+
     payload->set_address(0x0);
     ASSERT_TRUE(init_socket->get_direct_mem_ptr(*payload, dmi_data));
     ASSERT_EQ(dmi_data.get_start_address(), static_cast<sc_dt::uint64>(0x0000));
@@ -93,8 +116,10 @@ struct BusSlave : public sc_module {
   SC_HAS_PROCESS(BusSlave);
   tlm_utils::simple_target_socket<BusSlave, gb_const::kBusDataWidth> target_socket;
   u8 data[0x1000];
+  const size_t mapped_size;  // Bytes of data that are on the bus.
 
-  explicit BusSlave(sc_module_name name) : sc_module(name), target_socket("target_socket") {
+  explicit BusSlave(sc_module_name name, size_t mapped_size = 0x1000)
+      : sc_module(name), target_socket("target_socket"), mapped_size(mapped_size) {
     SC_THREAD(BusSlaveThread);
     target_socket.register_b_transport(this, &BusSlave::b_transport);
     target_socket.register_transport_dbg(this, &BusSlave::transport_dbg);
@@ -104,7 +129,9 @@ struct BusSlave : public sc_module {
   void BusSlaveThread() {
     wait(15, SC_NS);
     ASSERT_EQ(data[42], 23);
-    ASSERT_EQ(data[0x0FFF], 23);
+    ASSERT_EQ(data[mapped_size - 1], 23);
+    // Invalidates everything the slave ever granted.
+    target_socket->invalidate_direct_mem_ptr(0, ~0ull);
   }
 
   bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
@@ -148,22 +175,34 @@ struct Top : public sc_module {
   BusMaster test_master;
   BusSlave test_slave_0;
   BusSlave test_slave_1;
+  BusSlave test_slave_2;
 
   explicit Top(sc_module_name name)
       : sc_module(name),
         test_bus("test_bus"),
         test_master("test_master"),
         test_slave_0("test_slave_0"),
-        test_slave_1("test_slave_1") {
+        test_slave_1("test_slave_1"),
+        test_slave_2("test_slave_2", 0x80) {
     test_bus.AddBusMaster(&test_master.init_socket);
     test_bus.AddBusSlave(&test_slave_0.target_socket, 0x0000, 0x0FFF);
+    EXPECT_THROW(test_bus.AddBusSlave(&test_slave_1.target_socket, 0x0FFF, 0x1FFF), std::runtime_error);
+    EXPECT_THROW(test_bus.AddBusSlave(&test_slave_1.target_socket, 0x1FFF, 0x1000), std::runtime_error);
     test_bus.AddBusSlave(&test_slave_1.target_socket, 0x1000, 0x1FFF);
+    test_bus.AddBusSlave(&test_slave_2.target_socket, 0x2000, 0x207F);
   }
 };
 
 TEST(BusTests, GenericTest) {
   Top test_top("test_top");
   sc_start(30, SC_NS);
+
+  // The bus maps the invalidations of the slaves to their address ranges.
+  const std::vector<std::pair<sc_dt::uint64, sc_dt::uint64>> expected{{0x0000, 0x0FFF}, {0x1000, 0x1FFF},
+                                                                      {0x2000, 0x207F}};
+  auto invalidations = test_top.test_master.invalidations;
+  std::sort(invalidations.begin(), invalidations.end());
+  ASSERT_EQ(invalidations, expected);
 }
 
 int sc_main(int argc, char* argv[]) {
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the shadow call stack and the folded stacks of the CallStackSampler.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "call_stack_sampler.h"
+
+TEST(CallStackSamplerTests, CallsAndReturns) {
+  CallStackSampler sampler(100);
+  sampler.Call(0, 0x0200, 0xDFFC);
+  sampler.Call(1, 0x4000, 0xDFFA);
+  ASSERT_EQ(sampler.GetDepth(), 2u);
+  sampler.Return(0xDFF8);  // RET of a "PUSH HL; RET" jump doesn't pop a frame.
+  ASSERT_EQ(sampler.GetDepth(), 2u);
+  sampler.Return(0xDFFA);
+  ASSERT_EQ(sampler.GetDepth(), 1u);
+  sampler.Call(0, 0x0300, 0xDFFA);
+  sampler.Call(0, 0x0400, 0xDFF8);
+  sampler.Call(0, 0x0500, 0xDFFA);  // The callees above discarded their return addresses.
+  ASSERT_EQ(sampler.GetDepth(), 2u);
+  sampler.Return(0xDFFC);
+  ASSERT_EQ(sampler.GetDepth(), 0u);
+
+  for (u16 i = 0; i < CallStackSampler::kMaxDepth + 10; ++i)
+    sampler.Call(0, 0x0200, 0xDFFE - 2 * i);
+  ASSERT_EQ(sampler.GetDepth(), CallStackSampler::kMaxDepth);
+}
+
+TEST(CallStackSamplerTests, FoldedStacks) {
+  CallStackSampler sampler(100);
+  sampler.AddCycles(50);
+  sampler.Call(0, 0x0150, 0xDFFC);
+  sampler.AddCycles(50);
+  sampler.Call(2, 0x4000, 0xDFFA);
+  sampler.AddCycles(250);
+  sampler.Interrupt(0x40, 0xDFF8);  // VBlank
+  sampler.Call(2, 0x4100, 0xDFF6);
+  sampler.AddCycles(100);
+  sampler.Return(0xDFF6);
+  sampler.Return(0xDFF8);
+  sampler.Interrupt(0x50, 0xDFF8);  // Timer
+  sampler.AddCycles(100);
+  sampler.Interrupt(0x38, 0xDFF6);  // Not an interrupt vector.
+  sampler.Return(0xDFF8);
+  sampler.Return(0xDFFA);
+  sampler.AddCycles(49);
+  ASSERT_EQ(sampler.GetNumSamples(), 5u);
+  sampler.AddCycles(1);
+  ASSERT_EQ(sampler.GetNumSamples(), 6u);
+
+  SymbolTable symbols;
+  std::istringstream sym_file("00:0150 Main\n");
+  symbols.Load(sym_file);
+  std::stringstream folded;
+  sampler.WriteFolded(folded, symbols);
+  ASSERT_EQ(folded.str(),
+            "VBlank;02:4100 1\n"
+            "Timer 1\n"
+            "main;Main 2\n"
+            "main;Main;02:4000 2\n");
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -6,8 +6,19 @@
 #include <gtest/gtest.h>
 #include <systemc.h>
 #include <tlm.h>
+#include <tlm_utils/simple_initiator_socket.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "cartridge.h"
+#include "dmg_rom_data.h"
+#include "gb_const.h"
+#include "io_registers.h"
 #include "utils.h"
 
 const string tlm_boy_root = GetEnvVariable("TLMBOY_ROOT");
@@ -15,6 +26,21 @@ const string rom_dummy_path = tlm_boy_root + "/roms/dummy.gb";
 const string rom_flappyboy_path = tlm_boy_root + "/roms/flappyboy.gb";
 Cartridge* cart_mbc5;
 Cartridge* cart_no_mbc;
+Cartridge* cart_boot;  // Boot ROM is still mapped.
+IoRegisters* io_registers;
+
+// Records the DMI invalidations of a cartridge's ROM.
+struct DmiObserver : public sc_module {
+  tlm_utils::simple_initiator_socket<DmiObserver, gb_const::kBusDataWidth> init_socket;
+  std::vector<std::pair<sc_dt::uint64, sc_dt::uint64>> invalidations;
+
+  explicit DmiObserver(sc_module_name name) : sc_module(name), init_socket("init_socket") {
+    init_socket.register_invalidate_direct_mem_ptr(this, &DmiObserver::invalidate_direct_mem_ptr);
+  }
+
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end) { invalidations.emplace_back(start, end); }
+};
+DmiObserver* dmi_observer;
 
 TEST(CartridgeTestsMbc5, GameInfo) {
   ASSERT_EQ(cart_mbc5->game_info->GetCartridgeType(), "MBC5+BAT+RAM");
@@ -36,19 +62,27 @@ TEST(CartridgeTestsMbc5, Rom) {
   cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
   ASSERT_EQ(data, 0x91u);
 
-  // Read upper ROM Bank 0 (file offset 0x4000, first byte = 0xaf).
+  // Read upper ROM Bank 1, which is switched in after reset (file offset 0x4000, first byte = 0xaf).
   read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x4000, &data);
   cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
   ASSERT_EQ(data, 0xafu);
-  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 0);
+  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 1);
 
-  // Switch to Bank 1: write 1 to MBC5 ROM bank register (0x2000-0x2FFF).
-  data = 1;
+  // Unlike MBC1, MBC5 can switch bank 0 into the upper half.
+  data = 0;
   auto write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x2000, &data);
   cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
-  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 1);
+  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 0);
+  read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x5000, &data);
+  cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
+  ASSERT_EQ(data, 0x91u);
+
+  // Switch to Bank 2: write 2 to MBC5 ROM bank register (0x2000-0x2FFF).
+  data = 2;
+  cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
+  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 2);
 
-  // Read upper ROM Bank 1(file offset 0x8000, first byte = 0xf8).
+  // Read upper ROM Bank 2 (file offset 0x8000, first byte = 0xf8).
   read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x4000, &data);
   cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
   ASSERT_EQ(data, 0xf8u);
@@ -64,16 +98,71 @@ TEST(CartridgeTestsMbc5, Rom) {
   cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
   ASSERT_EQ(data, 0x09u);
 
-  // Switch to Bank 2: write 2 to 0x2000.
-  data = 2;
+  // Switch to Bank 3: write 3 to 0x2000.
+  data = 3;
   write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x2000, &data);
   cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
 
-  // Read Bank 2 (file offset 0xC000, first byte = 0x21).
+  // Read Bank 3 (file offset 0xC000, first byte = 0x21).
   read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x4000, &data);
   cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
   ASSERT_EQ(data, 0x21u);
-  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 2);
+  ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), 3);
+}
+
+TEST(CartridgeTestsMbc5, BankWrapping) {
+  sc_time delay = SC_ZERO_TIME;
+  u8 data = 0;
+
+  // The banks are sized by the header: 128 KiB ROM and 32 KiB RAM.
+  ASSERT_EQ(cart_mbc5->mbc->rom_high.GetNumBanks(), 8u);
+  ASSERT_EQ(cart_mbc5->mbc->ext_ram.GetNumBanks(), 4u);
+
+  // The last bank reads the last bank of the file.
+  std::ifstream file(rom_dummy_path, std::ios::binary);
+  const std::vector<u8> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(rom.size(), 8u * 0x4000);
+  data = 7;
+  auto last_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x2000, &data);
+  cart_mbc5->mbc->b_transport_rom(*last_payload, delay);
+  ASSERT_EQ(cart_mbc5->mbc->rom_high.GetCurrentBankIndex(), 7u);
+  std::array<u8, 0x4000> last_bank{};
+  last_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x4000, last_bank.data(), false, last_bank.size());
+  cart_mbc5->mbc->b_transport_rom(*last_payload, delay);
+  ASSERT_TRUE(std::equal(last_bank.begin(), last_bank.end(), rom.end() - 0x4000));
+
+  // Bank 9 and bank 0x101 (9th bank bit set) wrap around to bank 1.
+  for (u16 bank : {9, 0x101}) {
+    data = bank & 0xFF;
+    auto write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x2000, &data);
+    cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
+    data = bank >> 8;
+    write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x3000, &data);
+    cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
+    ASSERT_EQ(cart_mbc5->mbc->GetRomInd(), bank);
+
+    auto read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x4000, &data);
+    cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
+    ASSERT_EQ(data, 0xafu);
+  }
+
+  // RAM bank 5 of the enabled RAM wraps around to bank 1.
+  data = 0x0A;
+  auto enable_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x0000, &data);
+  cart_mbc5->mbc->b_transport_rom(*enable_payload, delay);
+  data = 5;
+  auto bank_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x4000, &data);
+  cart_mbc5->mbc->b_transport_rom(*bank_payload, delay);
+  ASSERT_EQ(cart_mbc5->mbc->ext_ram.GetCurrentBankIndex(), 1u);
+
+  // Back to ROM bank 0, RAM bank 0, and disabled RAM.
+  data = 0;
+  cart_mbc5->mbc->b_transport_rom(*bank_payload, delay);
+  cart_mbc5->mbc->b_transport_rom(*enable_payload, delay);
+  bank_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x2000, &data);
+  cart_mbc5->mbc->b_transport_rom(*bank_payload, delay);
+  bank_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x3000, &data);
+  cart_mbc5->mbc->b_transport_rom(*bank_payload, delay);
 }
 
 TEST(CartridgeTestsMbc5, Ram) {
@@ -142,6 +231,90 @@ TEST(CartridgeTestsMbc5, Ram) {
   ASSERT_EQ(data, 0x42u);
 }
 
+TEST(CartridgeTestsMbc5, Dmi) {
+  sc_time delay = SC_ZERO_TIME;
+  u8 data = 0;
+  tlm::tlm_dmi dmi_data;
+
+  // Switch to ROM bank 3 and get a read-only pointer to it.
+  data = 3;
+  auto write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x2000, &data);
+  cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
+  auto payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x4000, &data);
+  ASSERT_TRUE(cart_mbc5->mbc->get_direct_mem_ptr(*payload, dmi_data));
+  ASSERT_EQ(dmi_data.get_start_address(), 0x4000u);
+  ASSERT_EQ(dmi_data.get_end_address(), 0x7FFFu);
+  ASSERT_TRUE(dmi_data.is_read_allowed());
+  ASSERT_FALSE(dmi_data.is_write_allowed());
+  ASSERT_EQ(dmi_data.get_dmi_ptr()[0], 0x21u);
+
+  // After a bank switch, a new pointer leads to the new bank.
+  data = 2;
+  cart_mbc5->mbc->b_transport_rom(*write_payload, delay);
+  ASSERT_TRUE(cart_mbc5->mbc->get_direct_mem_ptr(*payload, dmi_data));
+  ASSERT_EQ(dmi_data.get_dmi_ptr()[0], 0xf8u);
+  ASSERT_EQ(dmi_data.get_dmi_ptr()[1], 0x09u);
+
+  // Enable the RAM. Its current bank is granted for reads and writes.
+  data = 0x0A;
+  auto enable_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x0000, &data);
+  cart_mbc5->mbc->b_transport_rom(*enable_payload, delay);
+  payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x0010, &data);
+  ASSERT_TRUE(cart_mbc5->mbc->get_direct_mem_ptr_ram(*payload, dmi_data));
+  ASSERT_EQ(dmi_data.get_start_address(), 0x0000u);
+  ASSERT_EQ(dmi_data.get_end_address(), 0x1FFFu);
+  ASSERT_TRUE(dmi_data.is_write_allowed());
+  dmi_data.get_dmi_ptr()[0] = 0x5A;
+  data = 0x00;
+  cart_mbc5->mbc->b_transport_ram(*payload, delay);
+  ASSERT_EQ(data, 0x5Au);
+
+  // Disabled RAM is not granted.
+  data = 0x00;
+  cart_mbc5->mbc->b_transport_rom(*enable_payload, delay);
+  ASSERT_FALSE(cart_mbc5->mbc->get_direct_mem_ptr_ram(*payload, dmi_data));
+}
+
+TEST(CartridgeTestsMbc5, Burst) {
+  sc_time delay = SC_ZERO_TIME;
+  u8 data = 0;
+  std::array<u8, 0x20> burst{};
+
+  // A burst across the fixed and the switchable ROM bank reads the same as single reads.
+  auto payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x3FF0, burst.data(), false, burst.size());
+  cart_mbc5->mbc->b_transport_rom(*payload, delay);
+  ASSERT_EQ(payload->get_response_status(), tlm::TLM_OK_RESPONSE);
+  ASSERT_EQ(payload->get_address(), 0x3FF0u);
+  for (u16 i = 0; i < burst.size(); ++i) {
+    auto read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x3FF0 + i, &data);
+    cart_mbc5->mbc->b_transport_rom(*read_payload, delay);
+    ASSERT_EQ(burst[i], data) << "at offset " << i;
+  }
+
+  // The same holds for debug accesses.
+  std::array<u8, 0x20> burst_dbg{};
+  payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x3FF0, burst_dbg.data(), false, burst_dbg.size());
+  ASSERT_EQ(cart_mbc5->mbc->transport_dbg_rom(*payload), burst_dbg.size());
+  ASSERT_EQ(burst_dbg, burst);
+
+  // RAM bursts.
+  data = 0x0A;
+  auto enable_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x0000, &data);
+  cart_mbc5->mbc->b_transport_rom(*enable_payload, delay);
+  for (u8 i = 0; i < burst.size(); ++i)
+    burst[i] = i;
+  payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x1FE0, burst.data(), false, burst.size());
+  cart_mbc5->mbc->b_transport_ram(*payload, delay);
+  auto read_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x1FFF, &data);
+  cart_mbc5->mbc->b_transport_ram(*read_payload, delay);
+  ASSERT_EQ(data, 0x1Fu);
+
+  std::array<u8, 0x20> ram_dbg{};
+  payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x1FE0, ram_dbg.data(), false, ram_dbg.size());
+  ASSERT_EQ(cart_mbc5->mbc->transport_dbg_ram(*payload), ram_dbg.size());
+  ASSERT_EQ(ram_dbg, burst);
+}
+
 TEST(CartridgeTestsNoMbc, GameInfo) {
   ASSERT_EQ(cart_no_mbc->game_info->GetCartridgeType(), "ROM ONLY");
   ASSERT_EQ(cart_no_mbc->game_info->GetLicenseCode(), "Unknown");
@@ -190,6 +363,41 @@ TEST(CartridgeTestsNoMbc, Rom) {
   ASSERT_EQ(data, 0x03u);
 }
 
+TEST(CartridgeTestsNoMbc, UnmapBootRom) {
+  sc_time delay = SC_ZERO_TIME;
+  std::array<u8, 0x100> data{};
+  std::array<u8, 0x100> game{};
+  tlm::tlm_dmi dmi_data;
+
+  // Until 0xFF50 is written, the boot ROM overlays the first 256 bytes of the game.
+  auto payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x0000, data.data(), false, data.size());
+  cart_boot->mbc->b_transport_rom(*payload, delay);
+  ASSERT_TRUE(std::equal(data.begin(), data.end(), dmg_rom::kSpan.begin()));
+  ASSERT_TRUE(cart_boot->mbc->get_direct_mem_ptr(*payload, dmi_data));
+  ASSERT_EQ(dmi_data.get_dmi_ptr()[0], dmg_rom::kSpan[0]);
+
+  // Writing 1 to 0xFF50 unmaps the boot ROM in the same transaction and revokes the DMI grants.
+  u8 val = 1;
+  auto write_payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0xFF50 - 0xFF10, &val);
+  io_registers->b_transport(*write_payload, delay);
+  const std::vector<std::pair<sc_dt::uint64, sc_dt::uint64>> expected{{0x0000, 0x3FFF}};
+  ASSERT_EQ(dmi_observer->invalidations, expected);
+
+  // The game's bytes are back right away.
+  auto game_payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x0000, game.data(), false, game.size());
+  cart_no_mbc->mbc->b_transport_rom(*game_payload, delay);
+  cart_boot->mbc->b_transport_rom(*payload, delay);
+  ASSERT_EQ(data, game);
+  ASSERT_TRUE(cart_boot->mbc->get_direct_mem_ptr(*payload, dmi_data));
+  ASSERT_TRUE(std::equal(game.begin(), game.end(), dmi_data.get_dmi_ptr()));
+
+  // Unmapping it again changes nothing.
+  cart_boot->mbc->UnmapBootRom();
+  cart_boot->mbc->b_transport_rom(*payload, delay);
+  ASSERT_EQ(data, game);
+  ASSERT_EQ(dmi_observer->invalidations, expected);
+}
+
 TEST(CartridgeTestsNoMbc, Ram) {
   sc_time delay = SC_ZERO_TIME;
   u8 data = 0xab;
@@ -211,6 +419,11 @@ int sc_main(int argc, char* argv[]) {
   cart_no_mbc = new Cartridge("cartridge_no_mbc", rom_flappyboy_path, "");
   cart_mbc5->mbc->UnmapBootRom();
   cart_no_mbc->mbc->UnmapBootRom();
+  cart_boot = new Cartridge("cartridge_boot", rom_flappyboy_path, "");
+  dmi_observer = new DmiObserver("dmi_observer");
+  dmi_observer->init_socket.bind(cart_boot->mbc->rom_socket_in);
+  io_registers = new IoRegisters("io_registers");
+  io_registers->unmap_boot_rom = [] { cart_boot->mbc->UnmapBootRom(); };
   sc_set_time_resolution(1.0, SC_NS);
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
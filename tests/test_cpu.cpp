@@ -74,6 +74,48 @@ TEST(CpuTests, Firstopcodes) {
   ASSERT_EQ(test_top.test_cpu.reg_file.C, 0x24);
 }
 
+// Unit test: Loads and stores via the CPU's DMI pages.
+TEST(CpuTests, LoadsAndStores) {
+  test_top.test_cpu.reg_file.PC = 0x0200;
+  u8* data = test_top.test_memory.GetDataPtr();
+  data[0x200] = 0x3E;  // LD A,0x42, 8 cycles
+  data[0x201] = 0x42;
+
+  data[0x202] = 0xEA;  // LD (0xC000),A, 16 cycles
+  data[0x203] = 0x00;
+  data[0x204] = 0xC0;
+
+  data[0x205] = 0xFA;  // LD A,(0xC001), 16 cycles
+  data[0x206] = 0x01;
+  data[0x207] = 0xC0;
+
+  data[0xC001] = 0x17;
+
+  sc_start(41 * gb_const::kNsPerClkCycle, SC_NS);
+  ASSERT_EQ(data[0xC000], 0x42);
+  ASSERT_EQ(test_top.test_cpu.reg_file.A, 0x17);
+}
+
+// Unit test: Flags of an ALU instruction are visible to PUSH AF.
+TEST(CpuTests, PushFlags) {
+  test_top.test_cpu.reg_file.PC = 0x0300;
+  test_top.test_cpu.reg_file.SP = 0xD000;
+  u8* data = test_top.test_memory.GetDataPtr();
+  data[0x300] = 0x3E;  // LD A,0x0F, 8 cycles
+  data[0x301] = 0x0F;
+
+  data[0x302] = 0xC6;  // ADD A,0x01, 8 cycles
+  data[0x303] = 0x01;
+
+  data[0x304] = 0xF5;  // PUSH AF, 16 cycles
+
+  data[0x305] = 0xC1;  // POP BC, 12 cycles
+
+  sc_start(45 * gb_const::kNsPerClkCycle, SC_NS);
+  ASSERT_EQ(test_top.test_cpu.reg_file.B, 0x10);
+  ASSERT_EQ(test_top.test_cpu.reg_file.C, 0x20);  // Only the H flag.
+}
+
 int sc_main(int argc, char* argv[]) {
   sc_set_time_resolution(1.0, SC_NS);
   ::testing::InitGoogleTest(&argc, argv);
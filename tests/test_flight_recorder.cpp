@@ -0,0 +1,43 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the ring buffer of the FlightRecorder.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "flight_recorder.h"
+
+namespace {
+std::vector<u16> GetPcs(const FlightRecorder& recorder) {
+  std::vector<u16> pcs;
+  recorder.ForEach([&pcs](const FlightRecorder::Entry& entry) { pcs.push_back(entry.pc); });
+  return pcs;
+}
+}  // namespace
+
+TEST(FlightRecorderTests, RingBuffer) {
+  FlightRecorder recorder;
+  ASSERT_TRUE(GetPcs(recorder).empty());
+
+  for (u16 i = 0; i < 3; ++i)
+    recorder.Next().pc = i;
+  ASSERT_EQ(GetPcs(recorder), (std::vector<u16>{0, 1, 2}));
+
+  // Older entries get overwritten.
+  for (u16 i = 3; i < FlightRecorder::kNumEntries + 10; ++i)
+    recorder.Next().pc = i;
+  const std::vector<u16> pcs = GetPcs(recorder);
+  ASSERT_EQ(pcs.size(), FlightRecorder::kNumEntries);
+  ASSERT_EQ(pcs.front(), 10);
+  ASSERT_EQ(pcs.back(), FlightRecorder::kNumEntries + 9);
+  ASSERT_EQ(recorder.GetNumRecorded(), FlightRecorder::kNumEntries + 10);
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
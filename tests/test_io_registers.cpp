@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2025 chciken/Niko
+ *
+ * This test connects the IO registers to a bus model and checks the OAM DMA
+ * from a source with DMI and from a source without DMI.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_target_socket.h>
+
+#include <array>
+#include <cstring>
+
+#include "gb_const.h"
+#include "io_registers.h"
+#include "utils.h"
+
+// The whole address space. Work RAM and OAM are accessible via DMI, the rest only via TLM.
+struct BusModel : public sc_module {
+  tlm_utils::simple_target_socket<BusModel, gb_const::kBusDataWidth> targ_socket;
+  std::array<u8, 0x10000> mem{};
+  int num_transports = 0;
+
+  explicit BusModel(sc_module_name name) : sc_module(name), targ_socket("targ_socket") {
+    targ_socket.register_b_transport(this, &BusModel::b_transport);
+    targ_socket.register_get_direct_mem_ptr(this, &BusModel::get_direct_mem_ptr);
+  }
+
+  void b_transport(tlm::tlm_generic_payload& trans, sc_time&) {
+    ++num_transports;
+    u8* adr = &mem[trans.get_address()];
+    if (trans.is_read())
+      std::memcpy(trans.get_data_ptr(), adr, trans.get_data_length());
+    else
+      std::memcpy(adr, trans.get_data_ptr(), trans.get_data_length());
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+  }
+
+  bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+    const sc_dt::uint64 adr = trans.get_address();
+    sc_dt::uint64 start;
+    sc_dt::uint64 end;
+    if (adr >= 0xC000 && adr <= 0xDFFF) {
+      start = 0xC000;
+      end = 0xDFFF;
+    } else if (adr >= IoRegisters::kOamAddress && adr < IoRegisters::kOamAddress + IoRegisters::kOamSize) {
+      start = IoRegisters::kOamAddress;
+      end = IoRegisters::kOamAddress + IoRegisters::kOamSize - 1;
+    } else {
+      return false;
+    }
+    dmi_data.set_dmi_ptr(&mem[adr]);
+    dmi_data.set_start_address(start);
+    dmi_data.set_end_address(end);
+    dmi_data.allow_read_write();
+    return true;
+  }
+};
+
+struct Top : public sc_module {
+  SC_HAS_PROCESS(Top);
+  IoRegisters io_registers;
+  BusModel bus;
+  std::array<sc_signal<bool>, 9> signals;
+  bool done = false;
+
+  explicit Top(sc_module_name name) : sc_module(name), io_registers("io_registers"), bus("bus") {
+    SC_THREAD(TopThread);
+    io_registers.init_socket.bind(bus.targ_socket);
+    io_registers.sig_unmap_rom_out(signals[0]);
+    io_registers.sig_reload_length_square1_out(signals[1]);
+    io_registers.sig_reload_length_square2_out(signals[2]);
+    io_registers.sig_reload_length_wave_out(signals[3]);
+    io_registers.sig_reload_length_noise_out(signals[4]);
+    io_registers.sig_trigger_square1_out(signals[5]);
+    io_registers.sig_trigger_square2_out(signals[6]);
+    io_registers.sig_trigger_wave_out(signals[7]);
+    io_registers.sig_trigger_noise_out(signals[8]);
+  }
+
+  // Writes byte to 0xFF46 at delay.
+  void StartDma(u8 byte, sc_time delay) {
+    auto payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0xFF46 - 0xFF10, &byte);
+    io_registers.b_transport(*payload, delay);
+  }
+
+  void ExpectOam(u16 src_adr) {
+    for (size_t i = 0; i < IoRegisters::kOamSize; ++i)
+      ASSERT_EQ(bus.mem[IoRegisters::kOamAddress + i], bus.mem[src_adr + i]) << "at OAM index " << i;
+  }
+
+  void TopThread() {
+    const sc_time dma_duration(IoRegisters::kDmaMachineCycles * gb_const::kNsPerMachineCycle, SC_NS);
+    const sc_time delay(10, SC_NS);
+    for (size_t i = 0; i < IoRegisters::kOamSize; ++i) {
+      bus.mem[0xC000 + i] = static_cast<u8>(i + 1);
+      bus.mem[0x8000 + i] = static_cast<u8>(0xFF - i);
+    }
+
+    // Work RAM and OAM via DMI.
+    sc_time start = sc_time_stamp();
+    StartDma(0xC0, delay);
+    ExpectOam(0xC000);
+    ASSERT_EQ(bus.num_transports, 0);
+    ASSERT_TRUE(io_registers.IsDmaActive());
+    ASSERT_TRUE(io_registers.IsDmaActive(delay + dma_duration - sc_time(1, SC_NS)));
+    ASSERT_FALSE(io_registers.IsDmaActive(delay + dma_duration));
+    wait(io_registers.dma_done_event);
+    ASSERT_EQ(sc_time_stamp() - start, delay + dma_duration);
+    ASSERT_FALSE(io_registers.IsDmaActive());
+
+    // VRAM without DMI: One burst read, the OAM is still written via DMI.
+    start = sc_time_stamp();
+    StartDma(0x80, SC_ZERO_TIME);
+    ExpectOam(0x8000);
+    ASSERT_EQ(bus.num_transports, 1);
+    wait(io_registers.dma_done_event);
+    ASSERT_EQ(sc_time_stamp() - start, dma_duration);
+    done = true;
+  }
+};
+
+TEST(IoRegistersTests, OamDma) {
+  Top test_top("test_top");
+  sc_start(1, SC_MS);
+  ASSERT_TRUE(test_top.done);
+}
+
+int sc_main(int argc, char* argv[]) {
+  sc_set_time_resolution(1.0, SC_NS);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
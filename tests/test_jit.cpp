@@ -0,0 +1,201 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the JIT's translation of a few blocks.
+ * The translated code runs on a plain 64 KiB memory.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+
+#include "block_cache.h"
+#include "jit.h"
+
+struct JitTests : public ::testing::Test {
+  std::array<u8, 0x10000> memory{};
+  std::array<u8, 12> regs{};  // Same layout as the register file.
+  bool ime = true;
+  u16 code_adr = 0;  // Writes to this address report a change of cached code.
+  std::array<u8*, 256> pages{};  // DMI pages, none by default.
+  int num_callbacks = 0;
+  BlockCache cache;
+  Jit jit;
+  JitContext ctx;
+
+  void SetUp() override {
+    if (!Jit::IsSupported())
+      GTEST_SKIP() << "JIT isn't supported on this host";
+    ctx.regs = regs.data();
+    ctx.ime = &ime;
+    ctx.read_pages = pages.data();
+    ctx.write_pages = pages.data();
+    ctx.code_pages = cache.GetCodePages();
+    ctx.opaque = this;
+    ctx.read = [](void* test, u16 adr) {
+      auto self = static_cast<JitTests*>(test);
+      ++self->num_callbacks;
+      return self->memory[adr];
+    };
+    ctx.write = [](void* test, u16 adr, u8 data) {
+      auto self = static_cast<JitTests*>(test);
+      ++self->num_callbacks;
+      self->memory[adr] = data;
+      return adr == self->code_adr;
+    };
+    ctx.stop = false;
+  }
+
+  // Translates the block at the given address and runs it once. Returns the executed cycles.
+  u32 Run(u16 adr) {
+    const BlockCache::Block* block = cache.Build(adr, 0, [this](u16 a) { return memory[a]; });
+    EXPECT_NE(block, nullptr);
+    u32 max_cycles = 0;
+    Jit::NativeBlock native_code = jit.Compile(*block, &max_cycles);
+    EXPECT_NE(native_code, nullptr);
+    const u32 cycles = native_code(&ctx);
+    EXPECT_LE(cycles, max_cycles);
+    return cycles;
+  }
+
+  u16 GetPc() const { return regs[10] | (regs[11] << 8); }
+  u16 GetSp() const { return regs[8] | (regs[9] << 8); }
+  void SetSp(u16 val) {
+    regs[8] = val & 0xFF;
+    regs[9] = val >> 8;
+  }
+};
+
+TEST_F(JitTests, AluAndFlags) {
+  const u8 code[] = {
+      0x3E, 0x0F,        // LD A,0x0F
+      0xC6, 0x01,        // ADD A,0x01
+      0x47,              // LD B,A
+      0xD6, 0x10,        // SUB A,0x10
+      0x37,              // SCF
+      0x88,              // ADC A,B
+      0x4F,              // LD C,A
+      0xAF,              // XOR A
+      0x05,              // DEC B
+      0xC3, 0x00, 0x02,  // JP 0x0200
+  };
+  std::memcpy(&memory[0x100], code, sizeof(code));
+
+  ASSERT_EQ(Run(0x100), 8u + 8 + 4 + 8 + 4 + 4 + 4 + 4 + 4 + 16);
+  ASSERT_EQ(GetPc(), 0x200);
+  ASSERT_EQ(regs[1], 0x00);  // A
+  ASSERT_EQ(regs[2], 0x11);  // C = 0x00 + 0x10 + carry
+  ASSERT_EQ(regs[3], 0x0F);  // B
+  ASSERT_EQ(regs[0], 0x60);  // F: XOR sets Z, then DEC B sets N and H.
+}
+
+TEST_F(JitTests, CallAndReturn) {
+  const u8 code[] = {
+      0x01, 0x34, 0x12,  // LD BC,0x1234
+      0xC5,              // PUSH BC
+      0xD1,              // POP DE
+      0xCD, 0x00, 0x03,  // CALL 0x0300
+  };
+  std::memcpy(&memory[0x100], code, sizeof(code));
+  memory[0x300] = 0xC9;  // RET
+  SetSp(0xDFF0);
+
+  ASSERT_EQ(Run(0x100), 12u + 16 + 12 + 24);
+  ASSERT_EQ(GetPc(), 0x300);
+  ASSERT_EQ(GetSp(), 0xDFEE);
+  ASSERT_EQ(memory[0xDFEF], 0x01);  // msb of the return address
+  ASSERT_EQ(memory[0xDFEE], 0x08);  // lsb of the return address
+  ASSERT_EQ(regs[4] | (regs[5] << 8), 0x1234);
+
+  ASSERT_EQ(Run(0x300), 16u);
+  ASSERT_EQ(GetPc(), 0x108);
+  ASSERT_EQ(GetSp(), 0xDFF0);
+}
+
+TEST_F(JitTests, LeavesIoToInterpreter) {
+  const u8 code[] = {
+      0x21, 0x44, 0xFF,  // LD HL,0xFF44
+      0x7E,              // LD A,(HL)
+      0x00,              // NOP
+  };
+  std::memcpy(&memory[0x100], code, sizeof(code));
+  memory[0xFF44] = 0x90;
+
+  ASSERT_EQ(Run(0x100), 12u);
+  ASSERT_EQ(GetPc(), 0x103);
+  ASSERT_EQ(regs[1], 0x00);
+
+  // Translation already stops at accesses of constant I/O addresses.
+  const u8 code_ldh[] = {
+      0xF0, 0x44,  // LDH A,(0x44)
+  };
+  std::memcpy(&memory[0x200], code_ldh, sizeof(code_ldh));
+  const BlockCache::Block* block = cache.Build(0x200, 0, [this](u16 a) { return memory[a]; });
+  u32 max_cycles;
+  ASSERT_EQ(jit.Compile(*block, &max_cycles), nullptr);
+  ASSERT_FALSE(jit.IsFull());
+}
+
+TEST_F(JitTests, StopsAfterChangingCode) {
+  const u8 code[] = {
+      0x21, 0x00, 0xC0,  // LD HL,0xC000
+      0x3E, 0x3C,        // LD A,0x3C
+      0x77,              // LD (HL),A
+      0x00,              // NOP
+  };
+  std::memcpy(&memory[0x100], code, sizeof(code));
+  code_adr = 0xC000;
+
+  ASSERT_EQ(Run(0x100), 12u + 8 + 8);
+  ASSERT_TRUE(ctx.stop);
+  ASSERT_EQ(GetPc(), 0x106);
+  ASSERT_EQ(memory[0xC000], 0x3C);
+}
+
+// Accesses of pages with a host pointer don't call back, unless a write hits a page with cached code.
+TEST_F(JitTests, UsesDmiPages) {
+  for (uint page = 0xC0; page <= 0xDF; ++page)
+    pages[page] = &memory[page << 8];
+  const u8 code[] = {
+      0x21, 0x00, 0xD0,  // LD HL,0xD000
+      0x7E,              // LD A,(HL)
+      0x3C,              // INC A
+      0x22,              // LD (HL+),A
+      0xC5,              // PUSH BC
+      0xC3, 0x00, 0x02,  // JP 0x0200
+  };
+  std::memcpy(&memory[0x100], code, sizeof(code));
+  memory[0xD000] = 0x41;
+  regs[2] = 0x34;  // C
+  regs[3] = 0x12;  // B
+  SetSp(0xDFF0);
+
+  ASSERT_EQ(Run(0x100), 12u + 8 + 4 + 8 + 16 + 16);
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_EQ(memory[0xD000], 0x42);
+  ASSERT_EQ(regs[6] | (regs[7] << 8), 0xD001);
+  ASSERT_EQ(memory[0xDFEF], 0x12);
+  ASSERT_EQ(memory[0xDFEE], 0x34);
+
+  // Cached code at 0xC000.
+  memory[0xC000] = 0x18;  // JR -2
+  memory[0xC001] = 0xFE;
+  ASSERT_NE(cache.Build(0xC000, 0, [this](u16 a) { return memory[a]; }), nullptr);
+  const u8 code_write[] = {
+      0x21, 0x80, 0xC0,  // LD HL,0xC080
+      0x77,              // LD (HL),A
+      0xC3, 0x00, 0x03,  // JP 0x0300
+  };
+  std::memcpy(&memory[0x200], code_write, sizeof(code_write));
+  ASSERT_EQ(Run(0x200), 12u + 8 + 16);
+  ASSERT_EQ(num_callbacks, 1);
+  ASSERT_EQ(memory[0xC080], 0x42);
+}
+
+int sc_main(int argc, char* argv[]) {
+  sc_set_time_resolution(1.0, SC_NS);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests that a MappedFile zero-fills behind the file and never writes back.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "mapped_file.h"
+
+TEST(MappedFileTests, Map) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "test_mapped_file.bin";
+  std::vector<u8> content(0x1234);
+  for (size_t i = 0; i < content.size(); ++i)
+    content[i] = static_cast<u8>(i * 7);
+  std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(content.data()), content.size());
+
+  {
+    MappedFile file(path, 0x8000);
+    ASSERT_EQ(file.GetSize(), 0x8000u);
+    ASSERT_EQ(file.GetFileSize(), content.size());
+    ASSERT_TRUE(std::equal(content.begin(), content.end(), file.GetData()));
+    for (size_t i = content.size(); i < file.GetSize(); ++i)
+      ASSERT_EQ(file.GetData()[i], 0x00u);
+
+    // Writes are private to the mapping.
+    file.GetData()[0] = 0xab;
+    file.GetData()[0x7FFF] = 0xcd;
+    MappedFile other(path, 0x100);
+    ASSERT_EQ(other.GetFileSize(), 0x100u);
+    ASSERT_EQ(other.GetData()[0], content[0]);
+  }
+
+  std::ifstream check(path, std::ios::binary);
+  ASSERT_EQ(check.get(), content[0]);
+  std::filesystem::remove(path);
+
+  EXPECT_THROW(MappedFile(path, 0x100), std::runtime_error);
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,8 +12,14 @@
 #include <tlm_utils/simple_initiator_socket.h>
 #include <tlm_utils/simple_target_socket.h>
 
+#include <array>
+#include <memory>
+#include <utility>
+
 #include "gb_const.h"
 #include "generic_memory.h"
+#include "io_registers.h"
+#include "memory_arena.h"
 #include "utils.h"
 
 struct MemRequester : public sc_module {
@@ -53,6 +59,44 @@ struct Top : public sc_module {
   }
 };
 
+// Memories on top of the arena are views at the offset of their address. Aliases share the data.
+TEST(MemoryTests, Arena) {
+  auto arena = std::make_unique<MemoryArena>();
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(arena->GetPtr(0)) % MemoryArena::kAlignment, 0u);
+  GenericMemory work_ram(4096, "arena_work_ram", arena->GetPtr(0xC000));
+  GenericMemory echo_ram(4096, "arena_echo_ram", arena->GetPtr(0xC000));
+
+  sc_time delay = SC_ZERO_TIME;
+  u8 data = 0x42;
+  auto payload = MakeSharedPayloadPtr(tlm::TLM_WRITE_COMMAND, 0x0123, &data);
+  work_ram.b_transport(*payload, delay);
+  ASSERT_EQ(*arena->GetPtr(0xC123), 0x42u);
+
+  auto snapshot = std::make_unique<std::array<u8, MemoryArena::kSize>>();
+  arena->SaveSnapshot(*snapshot);
+  data = 0x00;
+  work_ram.b_transport(*payload, delay);
+  arena->LoadSnapshot(*snapshot);
+
+  data = 0x00;
+  payload = MakeSharedPayloadPtr(tlm::TLM_READ_COMMAND, 0x0123, &data);
+  echo_ram.b_transport(*payload, delay);
+  ASSERT_EQ(data, 0x42u);
+
+  // Neighbouring views don't overlap, not even via their DMI grants.
+  GenericMemory io_registers(IoRegisters::kSize, "arena_io_registers", arena->GetPtr(IoRegisters::kAddress));
+  GenericMemory high_ram(127, "arena_high_ram", arena->GetPtr(0xFF80));
+  const auto get_dmi_range = [](GenericMemory& memory) {
+    tlm::tlm_generic_payload trans;
+    trans.set_address(0);
+    tlm::tlm_dmi dmi_data;
+    EXPECT_TRUE(memory.get_direct_mem_ptr(trans, dmi_data));
+    const u8* begin = dmi_data.get_dmi_ptr() - dmi_data.get_start_address();
+    return std::pair(begin, begin + dmi_data.get_end_address() + 1);
+  };
+  ASSERT_EQ(get_dmi_range(io_registers).second, get_dmi_range(high_ram).first);
+}
+
 TEST(MemoryTests, GenericTest) {
   Top test_top("test_top");
   sc_start(30, SC_NS);
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the opcode table and the disassembler.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <string>
+
+#include "opcodes.h"
+
+TEST(OpcodesTests, Timing) {
+  ASSERT_EQ(kOpcodes[0x00].cycles, 4);   // NOP
+  ASSERT_EQ(kOpcodes[0x08].cycles, 20);  // LD (u16),SP
+  ASSERT_EQ(kOpcodes[0x20].cycles, 8);   // JR NZ,i8
+  ASSERT_EQ(kOpcodes[0x20].cycles_taken, 12);
+  ASSERT_EQ(kOpcodes[0xC4].cycles, 12);  // CALL NZ,u16
+  ASSERT_EQ(kOpcodes[0xC4].cycles_taken, 24);
+  ASSERT_EQ(kOpcodes[0xD8].cycles, 8);  // RET C
+  ASSERT_EQ(kOpcodes[0xD8].cycles_taken, 20);
+  ASSERT_EQ(kOpcodesCb[0x46].cycles, 12);  // BIT 0,(HL)
+  ASSERT_EQ(kOpcodesCb[0xC6].cycles, 16);  // SET 0,(HL)
+
+  for (const OpcodeInfo& info : kOpcodes)
+    ASSERT_GE(info.cycles_taken, info.cycles);
+  for (const OpcodeInfo& info : kOpcodesCb)
+    ASSERT_EQ(info.length, 2);
+}
+
+TEST(OpcodesTests, MemAccess) {
+  ASSERT_EQ(kOpcodes[0x7E].mem_access, MemAccess::kRead);       // LD A,(HL)
+  ASSERT_EQ(kOpcodes[0x77].mem_access, MemAccess::kWrite);      // LD (HL),A
+  ASSERT_EQ(kOpcodes[0x34].mem_access, MemAccess::kReadWrite);  // INC (HL)
+  ASSERT_EQ(kOpcodes[0xC5].mem_access, MemAccess::kWrite);      // PUSH BC
+  ASSERT_EQ(kOpcodes[0x3C].mem_access, MemAccess::kNone);       // INC A
+  ASSERT_EQ(kOpcodesCb[0x7E].mem_access, MemAccess::kRead);     // BIT 7,(HL)
+}
+
+TEST(OpcodesTests, Disassemble) {
+  char out[kMaxDisassemblyLength];
+  auto disassemble = [&out](std::initializer_list<u8> bytes, u16 adr = 0x0100) {
+    const u8 length = Disassemble(bytes.begin(), adr, out, sizeof(out));
+    EXPECT_EQ(length, bytes.size());
+    return std::string(out);
+  };
+
+  ASSERT_EQ(disassemble({0x00}), "NOP");
+  ASSERT_EQ(disassemble({0x01, 0x23, 0x42}), "LD BC,0x4223");
+  ASSERT_EQ(disassemble({0xF0, 0x44}), "LDH A,(0x44)");
+  ASSERT_EQ(disassemble({0x20, 0xFA}), "JR NZ,0x00fc");
+  ASSERT_EQ(disassemble({0x18, 0x10}, 0x4000), "JR 0x4012");
+  ASSERT_EQ(disassemble({0xE8, 0xFE}), "ADD SP,-2");
+  ASSERT_EQ(disassemble({0xF8, 0x05}), "LD HL,SP+5");
+  ASSERT_EQ(disassemble({0xF8, 0x80}), "LD HL,SP-128");
+  ASSERT_EQ(disassemble({0xCB, 0x7E}), "BIT 7,(HL)");
+  ASSERT_EQ(disassemble({0xDD}), "DB 0xdd");
+
+  // The output is truncated but always terminated.
+  ASSERT_EQ(Disassemble(std::initializer_list<u8>{0xC3, 0x50, 0x01}.begin(), 0, out, 6), 3);
+  ASSERT_STREQ(out, "JP 0x");
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the counting and output of the Profiler.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "profiler.h"
+
+TEST(ProfilerTests, CountsPerBank) {
+  Profiler profiler;
+  profiler.Count(0, 0x0150, kOpcodes[0x00], 4);
+  profiler.Count(0, 0x0150, kOpcodes[0x00], 4);
+  profiler.Count(1, 0x4000, kOpcodes[0x20], 12);
+  profiler.Count(5, 0x4000, kOpcodes[0x20], 8);
+  profiler.Count(7, 0xC000, kOpcodesCb[0x37], 8);  // The bank doesn't matter outside of 0x4000-0x7FFF.
+  profiler.AddCycles(0, 0x0150, kOpcodes[0x00], 100);
+
+  ASSERT_EQ(profiler.GetCounter(0, 0x0150).instrs, 2u);
+  ASSERT_EQ(profiler.GetCounter(0, 0x0150).cycles, 108u);
+  ASSERT_EQ(profiler.GetCounter(3, 0x0150).instrs, 2u);
+  ASSERT_EQ(profiler.GetCounter(1, 0x4000).cycles, 12u);
+  ASSERT_EQ(profiler.GetCounter(5, 0x4000).cycles, 8u);
+  ASSERT_EQ(profiler.GetCounter(2, 0x4000).instrs, 0u);
+  ASSERT_EQ(profiler.GetCounter(100, 0x4000).instrs, 0u);
+  ASSERT_EQ(profiler.GetCounter(0, 0xC000).instrs, 1u);
+  ASSERT_EQ(profiler.GetOpcodeCounter(0x20).instrs, 2u);
+  ASSERT_EQ(profiler.GetOpcodeCounter(0x20).cycles, 20u);
+  ASSERT_EQ(profiler.GetOpcodeCounter(0x100 + 0x37).instrs, 1u);
+}
+
+TEST(ProfilerTests, Output) {
+  Profiler profiler;
+  SymbolTable symbols;
+  std::istringstream sym_file("00:0150 Main\n");
+  symbols.Load(sym_file);
+  profiler.Count(0, 0x0150, kOpcodes[0x00], 4);
+  profiler.Count(0, 0x0151, kOpcodes[0xC3], 16);
+  profiler.Count(2, 0x4000, kOpcodes[0xC9], 16);
+
+  std::stringstream report;
+  profiler.WriteReport(report, symbols);
+  std::string line;
+  std::getline(report, line);
+  ASSERT_EQ(line, "Executed instructions: 3");
+  std::getline(report, line);
+  ASSERT_EQ(line, "Clock cycles: 36");
+  ASSERT_NE(report.str().find("00:0151  Main+0x1"), std::string::npos);
+  ASSERT_NE(report.str().find("02:4000  \n"), std::string::npos);
+  ASSERT_NE(report.str().find("c3       JP u16"), std::string::npos);
+
+  std::stringstream callgrind;
+  profiler.WriteCallgrind(callgrind, symbols);
+  ASSERT_EQ(callgrind.str(),
+            "# callgrind format\n"
+            "version: 1\n"
+            "creator: TLMBoy\n"
+            "positions: instr\n"
+            "events: Cycles Instructions\n"
+            "\n"
+            "fn=Main (00:0150)\n"
+            "0x0150 4 1\n"
+            "0x0151 16 1\n"
+            "\n"
+            "fn=bank_02\n"
+            "0x4000 16 1\n"
+            "\n"
+            "totals: 36 3\n");
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the ticking, latching, halting, and the persistence of the MBC3's RTC.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "rtc.h"
+
+namespace {
+constexpr u64 kSecond = 1'000'000'000;
+constexpr u64 kDay = 24 * 60 * 60 * kSecond;
+}  // namespace
+
+TEST(RtcTests, Latch) {
+  Rtc rtc;
+  rtc.Latch(kDay + 3 * 60 * 60 * kSecond + 2 * 60 * kSecond + kSecond + kSecond / 2);
+  ASSERT_EQ(rtc.Read(Rtc::kSeconds), 1u);
+  ASSERT_EQ(rtc.Read(Rtc::kMinutes), 2u);
+  ASSERT_EQ(rtc.Read(Rtc::kHours), 3u);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysLow), 1u);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysHigh), 0u);
+
+  // The latched registers don't change until the next latch. Sub-seconds add up.
+  rtc.Write(Rtc::kMinutes, 59, kDay + 3 * 60 * 60 * kSecond + 2 * 60 * kSecond + kSecond + kSecond / 2);
+  ASSERT_EQ(rtc.Read(Rtc::kSeconds), 1u);
+  rtc.Latch(kDay + 3 * 60 * 60 * kSecond + 2 * 60 * kSecond + 60 * kSecond);
+  ASSERT_EQ(rtc.Read(Rtc::kSeconds), 0u);
+  ASSERT_EQ(rtc.Read(Rtc::kMinutes), 0u);
+  ASSERT_EQ(rtc.Read(Rtc::kHours), 4u);
+}
+
+TEST(RtcTests, HaltAndCarry) {
+  Rtc rtc;
+  rtc.Write(Rtc::kDaysLow, 0xFF, 0);
+  rtc.Write(Rtc::kDaysHigh, 0x41, 0);  // Day 511, halted.
+  rtc.Latch(10 * kDay);
+  ASSERT_EQ(rtc.Read(Rtc::kSeconds), 0u);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysLow), 0xFFu);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysHigh), 0x41u);
+
+  // After the day counter overflows, the carry stays until it's cleared.
+  rtc.Write(Rtc::kDaysHigh, 0x01, 10 * kDay);
+  rtc.Latch(12 * kDay);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysLow), 1u);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysHigh), 0x80u);
+  rtc.Latch(13 * kDay);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysHigh), 0x80u);
+  rtc.Write(Rtc::kDaysHigh, 0x00, 13 * kDay);
+  rtc.Latch(13 * kDay);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysHigh), 0x00u);
+}
+
+TEST(RtcTests, InvalidValues) {
+  // Invalid values count up to their bit width and wrap around without carry.
+  Rtc rtc;
+  rtc.Write(Rtc::kSeconds, 62, 0);
+  rtc.Latch(2 * kSecond);
+  ASSERT_EQ(rtc.Read(Rtc::kSeconds), 0u);
+  ASSERT_EQ(rtc.Read(Rtc::kMinutes), 0u);
+  rtc.Write(Rtc::kHours, 23, 2 * kSecond);
+  rtc.Write(Rtc::kMinutes, 59, 2 * kSecond);
+  rtc.Write(Rtc::kSeconds, 59, 2 * kSecond);
+  rtc.Latch(3 * kSecond);
+  ASSERT_EQ(rtc.Read(Rtc::kHours), 0u);
+  ASSERT_EQ(rtc.Read(Rtc::kDaysLow), 1u);
+}
+
+TEST(RtcTests, State) {
+  Rtc rtc;
+  rtc.Latch(5 * kDay + 7 * kSecond);
+  std::array<u8, Rtc::kStateSize> state{};
+  ASSERT_EQ(Rtc::GetUnixTime(state), 0);
+  rtc.SaveState(state, 5 * kDay + 9 * kSecond, 1234567890);
+  ASSERT_EQ(Rtc::GetUnixTime(state), 1234567890);
+  ASSERT_EQ(state[0], 9u);      // Live seconds.
+  ASSERT_EQ(state[4 * 3], 5u);  // Live days.
+  ASSERT_EQ(state[4 * 5], 7u);  // Latched seconds.
+
+  // The loaded clock continues from the point in time given.
+  Rtc loaded;
+  loaded.LoadState(state, 100 * kSecond);
+  ASSERT_EQ(loaded.Read(Rtc::kSeconds), 7u);
+  loaded.Latch(111 * kSecond);
+  ASSERT_EQ(loaded.Read(Rtc::kSeconds), 20u);
+  ASSERT_EQ(loaded.Read(Rtc::kDaysLow), 5u);
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
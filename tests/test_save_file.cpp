@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests that the SaveFile only writes back dirty pages and keeps the content.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "save_file.h"
+
+using namespace std::chrono_literals;
+
+TEST(SaveFileTests, DirtyPages) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "test_save_file.save";
+  std::filesystem::remove(path);
+  const size_t page_size = MappedFile::GetPageSize();
+  const u64 num_pages_a = (0x5000 / page_size != 0) ? 2 : 1;  // Pages of 0x0000 and 0x5000.
+
+  {
+    SaveFile save(path, 0x8000, 1h);
+    ASSERT_EQ(std::filesystem::file_size(path), 0x8000u);
+    save.GetData()[0x0000] = 0x12;
+    save.GetData()[0x5000] = 0x34;
+    save.MarkDirty(0x0000, 1);
+    save.MarkDirty(0x5000, 1);
+    save.Flush();
+    ASSERT_EQ(save.GetNumSyncedPages(), num_pages_a);
+
+    // Clean pages aren't written back again.
+    save.Flush();
+    ASSERT_EQ(save.GetNumSyncedPages(), num_pages_a);
+
+    // DMI grants are synced on every flush and once more after they end.
+    save.BeginDirectAccess(0, 1);
+    save.Flush();
+    save.Flush();
+    ASSERT_EQ(save.GetNumSyncedPages(), num_pages_a + 2);
+    save.EndDirectAccess();
+    save.Flush();
+    save.Flush();
+    ASSERT_EQ(save.GetNumSyncedPages(), num_pages_a + 3);
+
+    // A requested flush is done by the background thread.
+    save.GetData()[0x7FFF] = 0x56;
+    save.MarkDirty(0x7FFF, 1);
+    save.RequestFlush();
+    for (int i = 0; i < 1000 && save.GetNumSyncedPages() == num_pages_a + 3; ++i)
+      std::this_thread::sleep_for(1ms);
+    ASSERT_EQ(save.GetNumSyncedPages(), num_pages_a + 4);
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<char> content((std::istreambuf_iterator<char>(file)), {});
+  ASSERT_EQ(content.size(), 0x8000u);
+  ASSERT_EQ(content[0x0000], 0x12);
+  ASSERT_EQ(content[0x5000], 0x34);
+  ASSERT_EQ(content[0x7FFF], 0x56);
+
+  // The content is still there on the next start.
+  SaveFile save(path, 0x8000, 1h);
+  ASSERT_EQ(save.GetData()[0x5000], 0x34u);
+  std::filesystem::remove(path);
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
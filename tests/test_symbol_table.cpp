@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests the parsing of rgbds symbol files and the name resolution of the SymbolTable.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "symbol_table.h"
+
+TEST(SymbolTableTests, Names) {
+  SymbolTable symbols;
+  std::istringstream sym_file(
+      "; File generated by rgblink\n"
+      "00:0150 Main\n"
+      "00:0158 Main.loop\n"
+      "01:4000 BankedFunc ; comment\n"
+      "00:c000 wBuffer\n"
+      "00:0160 .data:10\n");
+  symbols.Load(sym_file);
+
+  ASSERT_EQ(symbols.GetName(0, 0x0100), "");
+  ASSERT_EQ(symbols.GetName(0, 0x0150), "Main");
+  ASSERT_EQ(symbols.GetName(0, 0x0153), "Main+0x3");
+  ASSERT_EQ(symbols.GetName(0, 0x015A), "Main.loop+0x2");
+  ASSERT_EQ(symbols.GetName(0, 0x3FFF), "Main.loop+0x3ea7");
+  ASSERT_EQ(symbols.GetName(1, 0x4010), "BankedFunc+0x10");
+  ASSERT_EQ(symbols.GetName(2, 0x4010), "");
+  ASSERT_EQ(symbols.GetName(0, 0x8000), "");
+  ASSERT_EQ(symbols.GetName(0, 0xC001), "wBuffer+0x1");
+  ASSERT_EQ(symbols.Find(1, 0x4010)->first, 0x14000u);
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
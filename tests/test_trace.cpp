@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Apache License, Version 2.0
+ * Copyright (c) 2026 chciken/Niko
+ *
+ * Tests writing, reading, and comparing binary execution traces.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <sstream>
+#include <vector>
+
+#include "trace.h"
+
+namespace {
+// Writes num records whose registers and cycles depend on the index. Record mod_ind gets a different PC.
+std::vector<TraceRecord> WriteTrace(const std::filesystem::path& path, u64 num, u64 mod_ind = ~0ull) {
+  std::vector<TraceRecord> records;
+  TraceWriter writer(path);
+  for (u64 i = 0; i < num; ++i) {
+    TraceRecord record;
+    record.cycles = 4 * i + (i % 3) * 1000000;
+    record.regs = {static_cast<u16>(i), 0x0013, static_cast<u16>(i / 7), 0x014D, 0xFFFE, static_cast<u16>(0x100 + i)};
+    if (i == mod_ind)
+      record.regs[5] = 0x1234;
+    writer.Record(record.cycles, record.regs);
+    for (u64 j = 0; j < i % 4; ++j) {
+      record.writes.push_back({static_cast<u16>(0xC000 + i), static_cast<u8>(j)});
+      writer.RecordWrite(record.writes.back().adr, record.writes.back().data);
+    }
+    records.push_back(record);
+  }
+  writer.Close();
+  EXPECT_EQ(writer.GetNumRecords(), num);
+  return records;
+}
+}  // namespace
+
+TEST(TraceTests, RoundTrip) {
+  // Enough records to fill several buffers of the writer.
+  const std::vector<TraceRecord> records = WriteTrace("test_trace_a.trace", 1000000);
+  TraceReader reader("test_trace_a.trace");
+  for (const TraceRecord& record : records) {
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ(reader.Get(), record);
+  }
+  ASSERT_FALSE(reader.Next());
+  ASSERT_EQ(reader.GetNumRecords(), records.size());
+  ASSERT_EQ(reader.GetNumBytes(), std::filesystem::file_size("test_trace_a.trace"));
+}
+
+TEST(TraceTests, Diff) {
+  WriteTrace("test_trace_a.trace", 1000);
+  WriteTrace("test_trace_b.trace", 1000);
+  WriteTrace("test_trace_c.trace", 1000, 500);
+  WriteTrace("test_trace_d.trace", 900);
+
+  std::stringstream report;
+  TraceReader trace_a("test_trace_a.trace");
+  TraceReader trace_b("test_trace_b.trace");
+  ASSERT_EQ(DiffTraces(trace_a, trace_b, report), std::nullopt);
+  ASSERT_EQ(report.str(), "Traces are identical (1000 instructions).\n");
+
+  report.str("");
+  TraceReader trace_a2("test_trace_a.trace");
+  TraceReader trace_c("test_trace_c.trace");
+  ASSERT_EQ(DiffTraces(trace_a2, trace_c, report, 2), 500u);
+  ASSERT_EQ(report.str(),
+            "Traces diverge at instruction 500:\n"
+            "           498  AF:0x01f2,BC:0x0013,DE:0x0047,HL:0x014d,SP:0xfffe,PC:0x02f2,c:1992 [c1f2]=0x00 "
+            "[c1f2]=0x01\n"
+            "           499  AF:0x01f3,BC:0x0013,DE:0x0047,HL:0x014d,SP:0xfffe,PC:0x02f3,c:1001996 [c1f3]=0x00 "
+            "[c1f3]=0x01 [c1f3]=0x02\n"
+            "a          500  AF:0x01f4,BC:0x0013,DE:0x0047,HL:0x014d,SP:0xfffe,PC:0x02f4,c:2002000\n"
+            "b          500  AF:0x01f4,BC:0x0013,DE:0x0047,HL:0x014d,SP:0xfffe,PC:0x1234,c:2002000\n"
+            "Differences: PC\n");
+
+  report.str("");
+  TraceReader trace_a3("test_trace_a.trace");
+  TraceReader trace_d("test_trace_d.trace");
+  ASSERT_EQ(DiffTraces(trace_a3, trace_d, report, 0), 900u);
+  ASSERT_NE(report.str().find("b          900  <end of trace>\n"), std::string::npos);
+}
+
+TEST(TraceTests, InvalidFiles) {
+  ASSERT_THROW(TraceReader("does_not_exist.trace"), std::runtime_error);
+  {
+    std::ofstream file("test_trace_invalid.trace");
+    file << "no trace";
+  }
+  ASSERT_THROW(TraceReader("test_trace_invalid.trace"), std::runtime_error);
+
+  WriteTrace("test_trace_a.trace", 10);
+  std::filesystem::resize_file("test_trace_a.trace", std::filesystem::file_size("test_trace_a.trace") - 1);
+  TraceReader reader("test_trace_a.trace");
+  ASSERT_THROW(
+      {
+        while (reader.Next()) {
+        }
+      },
+      std::runtime_error);
+}
+
+int sc_main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}